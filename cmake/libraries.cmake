@@ -30,4 +30,31 @@ FetchContent_Declare(
 	GIT_TAG main
 )
 
-set(FASTGLTF_ENABLE_DEPRECATED_EXT ON)
\ No newline at end of file
+FetchContent_Declare(
+	meshoptimizer
+	GIT_REPOSITORY https://github.com/zeux/meshoptimizer
+	GIT_TAG v0.22
+)
+
+FetchContent_Declare(
+	ktx
+	GIT_REPOSITORY https://github.com/KhronosGroup/KTX-Software
+	GIT_TAG v4.3.2
+)
+
+# HEADER ONLY, SOURCE_SUBDIR KEEPS ITS TEST PROGRAM OUT OF THE BUILD
+FetchContent_Declare(
+	bcdec
+	GIT_REPOSITORY https://github.com/iOrange/bcdec
+	GIT_TAG main
+	SOURCE_SUBDIR none
+)
+
+set(FASTGLTF_ENABLE_DEPRECATED_EXT ON)
+
+set(KTX_FEATURE_STATIC_LIBRARY ON)
+set(KTX_FEATURE_TESTS OFF)
+set(KTX_FEATURE_TOOLS OFF)
+set(KTX_FEATURE_DOC OFF)
+set(KTX_FEATURE_GL_UPLOAD OFF)
+set(KTX_FEATURE_VK_UPLOAD OFF)
\ No newline at end of file
@@ -5,12 +5,85 @@ using namespace Innsmouth;
 
 std::filesystem::path model_path;
 
-struct ModelMatrices {
+struct MeshCamera {
   Matrix4f projection = Matrix4f(1.0f);
   Matrix4f view = Matrix4f(1.0f);
   Matrix4f model = Matrix4f(1.0f);
+  Matrix4f inverse_view_projection = Matrix4f(1.0f);
+  Matrix4f previous_view_projection = Matrix4f(1.0f);
+  Vector4f camera_position = Vector4f(0.0f);
+  Vector4f light = Vector4f(0.0f, 500.0f, 0.0f, 2.0f);
 };
 
+struct ShadingConstants {
+  Vector2f inverse_visibility_size = Vector2f(1.0f);
+};
+
+struct DepthDescriptors {
+  DescriptorBufferInfo vertices;
+  DescriptorBufferInfo meshes;
+  DescriptorBufferInfo instances;
+  DescriptorBufferInfo camera;
+};
+
+struct MeshDescriptors {
+  DescriptorBufferInfo vertices;
+  DescriptorImageInfo visibility;
+  DescriptorBufferInfo meshes;
+  DescriptorBufferInfo instances;
+  DescriptorBufferInfo texture_slots;
+  DescriptorBufferInfo camera;
+};
+
+struct VisibilityConstants {
+  float ao_radius = 1.0f;
+  uint32_t rays_per_pixel = 1;
+  uint32_t resolution_scale = 2;
+  uint32_t frame = 0;
+  uint32_t history_valid = 0;
+};
+
+struct VisibilityDescriptors {
+  VkAccelerationStructureKHR tlas;
+  DescriptorImageInfo depth;
+  DescriptorImageInfo history;
+  DescriptorImageInfo output;
+  DescriptorBufferInfo camera;
+};
+
+struct DenoiseConstants {
+  uint32_t enabled = 1;
+  float depth_sigma = 0.05f;
+};
+
+struct DenoiseDescriptors {
+  DescriptorImageInfo input;
+  DescriptorImageInfo output;
+};
+
+struct LodConstants {
+  Matrix4f model_view = Matrix4f(1.0f);
+  float projection_scale = 1.0f;
+  float error_threshold = 1.0f;
+  uint32_t meshes_count = 0;
+};
+
+struct LodDescriptors {
+  DescriptorBufferInfo meshes;
+  DescriptorBufferInfo draw_commands;
+  DescriptorBufferInfo instances;
+};
+
+// 128 BYTES OF PUSH CONSTANTS IS ALL EVERY DEVICE GUARANTEES, MATRICES GO THROUGH THE CAMERA BUFFER
+static_assert(sizeof(ShadingConstants) <= 128);
+static_assert(sizeof(VisibilityConstants) <= 128);
+static_assert(sizeof(DenoiseConstants) <= 128);
+static_assert(sizeof(LodConstants) <= 128);
+
+constexpr uint32_t LOD_GROUP_SIZE = 64;
+constexpr uint32_t VISIBILITY_GROUP_SIZE = 8;
+constexpr Format VISIBILITY_FORMAT = Format::E_R16G16B16A16_SFLOAT;
+
 std::vector<DrawIndexedIndirectCommand> GetIndirectCommandsFromMeshes(std::span<const Mesh> meshes) {
   std::vector<DrawIndexedIndirectCommand> commands;
   for (const auto &mesh : meshes) {
@@ -18,8 +91,8 @@ std::vector<DrawIndexedIndirectCommand> GetIndirectCommandsFromMeshes(std::span<
     command.firstIndex = mesh.indices_offset;
     command.indexCount = mesh.indices_size;
     command.vertexOffset = 0;
-    command.firstInstance = 0;
-    command.instanceCount = 1;
+    command.firstInstance = mesh.instances_offset;
+    command.instanceCount = mesh.instances_count;
   }
   return commands;
 }
@@ -37,7 +110,21 @@ public:
     ImGui::DragFloat3("position", glm::value_ptr(position));
     ImGui::DragFloat("Yaw", &yaw);
     ImGui::DragFloat("Pitch", &pitch);
+    ImGui::DragFloat("LOD error (pixels)", &lod_constants.error_threshold, 0.1f, 0.0f, 64.0f);
+    ImGui::Text("Textures: %zu, resident %.1f MiB", texture_streamer.GetTexturesCount(), texture_streamer.GetResidentSize() / float(1_MiB));
+    ImGui::Text("Model: %s", model_asset->IsReady() ? "ready" : model_asset->IsGeometryReady() ? "building BLAS" : "parsing");
+    ImGui::End();
+
+    ImGui::Begin("Visibility");
+    ImGui::Combo("resolution", &pending_visibility_resolution, "full\0half\0quarter\0");
+    ImGui::SliderInt("rays per pixel", &rays_per_pixel, 1, 16);
+    ImGui::DragFloat("AO radius", &visibility_constants.ao_radius, 0.05f, 0.0f, 100.0f);
+    ImGui::DragFloat3("light", glm::value_ptr(camera_data.light));
+    ImGui::DragFloat("light radius", &camera_data.light.w, 0.1f, 0.0f, 100.0f);
+    ImGui::Checkbox("denoise", &denoise);
     ImGui::End();
+    visibility_constants.rays_per_pixel = rays_per_pixel;
+    denoise_constants.enabled = denoise;
     camera.SetPosition(position);
     camera.SetYaw(yaw);
     camera.SetPitch(pitch);
@@ -47,18 +134,193 @@ public:
     auto w = event.GetWidth();
     auto h = event.GetHeight();
     camera.SetAspect(float(w) / float(h));
-    depth_image = ImageDepth(w, h);
+    depth_image = ImageDepth(w, h, Format::E_D32_SFLOAT, ImageUsageMaskBits::E_SAMPLED_BIT);
+    CreateVisibilityImages(w, h);
     return true;
   }
 
+  void CreateVisibilityImages(uint32_t width, uint32_t height) {
+    auto scale = 1u << visibility_resolution;
+    auto visibility_width = (width + scale - 1) / scale;
+    auto visibility_height = (height + scale - 1) / scale;
+    for (auto &history_image : history_images) {
+      GraphicsContext::Get()->DeferDestruction(std::move(history_image));
+      history_image = Image2D(visibility_width, visibility_height, VISIBILITY_FORMAT, ImageUsageMaskBits::E_STORAGE_BIT);
+    }
+    GraphicsContext::Get()->DeferDestruction(std::move(visibility_image));
+    visibility_image = Image2D(visibility_width, visibility_height, VISIBILITY_FORMAT, ImageUsageMaskBits::E_STORAGE_BIT);
+    visibility_constants.resolution_scale = scale;
+    shading_constants.inverse_visibility_size = 1.0f / Vector2f(visibility_width * scale, visibility_height * scale);
+    history_valid = false;
+  }
+
   void OnEvent(Event &event) override {
     EventDispatcher dispatcher(event);
     dispatcher.Dispatch<WindowResizeEvent>(BIND_FUNCTION(MeshViewer::OnResize));
   }
 
+  void UpdateCamera(CommandBuffer &command_buffer) {
+    auto readers = PipelineStageMaskBits2::E_VERTEX_SHADER_BIT | PipelineStageMaskBits2::E_FRAGMENT_SHADER_BIT |
+                   PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT;
+    command_buffer.CommandMemoryBarrier(readers, AccessMask2(), PipelineStageMaskBits2::E_ALL_TRANSFER_BIT, AccessMask2());
+    command_buffer.CommandUpdateBuffer(camera_buffer.GetHandle(), 0, std::as_bytes(std::span(&camera_data, 1)));
+    command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_ALL_TRANSFER_BIT, AccessMaskBits2::E_TRANSFER_WRITE_BIT, readers,
+                                        AccessMaskBits2::E_SHADER_STORAGE_READ_BIT);
+  }
+
+  void SelectLods(CommandBuffer &command_buffer) {
+    command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_DRAW_INDIRECT_BIT, AccessMask2(), PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT,
+                                        AccessMask2());
+    command_buffer.CommandBindPipeline(lod_pipeline.GetPipeline(), PipelineBindPoint::E_COMPUTE);
+    command_buffer.CommandPushConstants(lod_pipeline.GetPipelineLayout(), ShaderStageMaskBits::E_COMPUTE_BIT, lod_constants);
+    command_buffer.CommandPushDescriptorSet(lod_pipeline.GetPushDescriptorTemplate(), lod_descriptors);
+    command_buffer.CommandDispatch((lod_constants.meshes_count + LOD_GROUP_SIZE - 1) / LOD_GROUP_SIZE);
+    command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT, AccessMaskBits2::E_SHADER_STORAGE_WRITE_BIT,
+                                        PipelineStageMaskBits2::E_DRAW_INDIRECT_BIT, AccessMaskBits2::E_INDIRECT_COMMAND_READ_BIT);
+  }
+
+  void RequestTextures() {
+    const auto &model = model_asset->GetModel();
+    auto texture_handles = model_asset->GetTextureHandles();
+    auto instance_transforms = model.GetInstanceTransforms();
+    for (const auto &mesh : model.GetMeshes()) {
+      if (mesh.color_texture_index < 0 && mesh.normal_texture_index < 0) continue;
+      auto screen_size = 0.0f;
+      for (auto i = mesh.instances_offset; i < mesh.instances_offset + mesh.instances_count; i++) {
+        auto model_view = lod_constants.model_view * instance_transforms[i];
+        auto center = Vector3f(model_view * Vector4f(mesh.center, 1.0f));
+        auto scale = std::max({glm::length(model_view[0]), glm::length(model_view[1]), glm::length(model_view[2])});
+        auto distance = std::max(-center.z - mesh.radius * scale, 0.1f);
+        screen_size = std::max(screen_size, 2.0f * mesh.radius * scale * lod_constants.projection_scale / distance);
+      }
+      // NORMAL MAPS COVER THE SAME SURFACE, SO THEY GET THE SAME RESIDENCY AS THE COLOR
+      for (auto texture_index : {mesh.color_texture_index, mesh.normal_texture_index}) {
+        if (texture_index >= 0) texture_streamer.Request(texture_handles[texture_index], screen_size);
+      }
+    }
+  }
+
+  void OnGeometryReady() {
+    const auto &model = model_asset->GetModel();
+    const auto &report = model.GetOptimizationReport();
+    std::println("ACMR {0:.3f} -> {1:.3f}, ATVR {2:.3f} -> {3:.3f}, vertices {4} -> {5}", report.before_.acmr_, report.after_.acmr_,
+                 report.before_.atvr_, report.after_.atvr_, report.vertices_before_, report.vertices_after_);
+
+    auto commands = GetIndirectCommandsFromMeshes(model.GetMeshes());
+    indirect_buffer = Buffer(std::max(commands.size(), std::size_t(1)) * sizeof(DrawIndexedIndirectCommand),
+                             BufferUsageMaskBits::E_INDIRECT_BUFFER_BIT | BufferUsageMaskBits::E_STORAGE_BUFFER_BIT,
+                             AllocationCreateMaskBits::E_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+    indirect_buffer.SetData<DrawIndexedIndirectCommand>(commands);
+
+    descriptors.vertices = model_asset->GetPackedVertexBuffer().GetDescriptor();
+    descriptors.meshes = model_asset->GetMeshBuffer().GetDescriptor();
+    descriptors.instances = model_asset->GetInstanceBuffer().GetDescriptor();
+    descriptors.texture_slots = texture_streamer.GetSlotTableDescriptor();
+
+    depth_descriptors.vertices = model_asset->GetPackedVertexBuffer().GetDescriptor();
+    depth_descriptors.meshes = model_asset->GetMeshBuffer().GetDescriptor();
+    depth_descriptors.instances = model_asset->GetInstanceBuffer().GetDescriptor();
+
+    lod_constants.meshes_count = model.GetMeshes().size();
+    lod_descriptors.meshes = model_asset->GetMeshBuffer().GetDescriptor();
+    lod_descriptors.draw_commands = indirect_buffer.GetDescriptor();
+    lod_descriptors.instances = model_asset->GetInstanceBuffer().GetDescriptor();
+  }
+
+  void BuildTopLevel(CommandBuffer &command_buffer) {
+    const auto &model = model_asset->GetModel();
+    auto blases = model_asset->GetBottomLevelStructures();
+
+    Transform transform(Vector3f(0.0f), Vector3f(0.1f));
+
+    // UNTIL EVERY BLAS IS BUILT THE TLAS STAYS EMPTY, RASTER GEOMETRY IS DRAWN WITHOUT SHADOWS
+    std::vector<BottomLevelAccelerationStructureInstances> bottom_instances(blases.size());
+    for (const auto &instance : model.GetMeshInstances()) {
+      if (instance.group_index_ >= blases.size()) continue;
+      bottom_instances[instance.group_index_].instances_.emplace_back(transform.GetModelMatrix() * instance.transform_);
+    }
+    for (auto i = 0; i < blases.size(); i++) {
+      bottom_instances[i].acceleration_structure_ = blases[i].GetAccelerationStructure();
+    }
+    std::erase_if(bottom_instances, [](const auto &bottom_instance) { return bottom_instance.instances_.empty(); });
+
+    std::vector<Buffer> build_buffers;
+    GraphicsContext::Get()->DeferDestruction(std::move(tlas));
+    tlas = AccelerationStructure(command_buffer, bottom_instances, build_buffers);
+    for (auto &build_buffer : build_buffers) {
+      GraphicsContext::Get()->DeferDestruction(std::move(build_buffer));
+    }
+    command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                                        AccessMaskBits2::E_ACCELERATION_STRUCTURE_WRITE_BIT_KHR, PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT,
+                                        AccessMaskBits2::E_ACCELERATION_STRUCTURE_READ_BIT_KHR);
+    visibility_descriptors.tlas = tlas.GetAccelerationStructure();
+    tlas_complete = model_asset->IsReady();
+  }
+
+  void DrawMeshes(CommandBuffer &command_buffer, const Extent2D &extent) {
+    command_buffer.CommandBindIndexBuffer(model_asset->GetIndexBuffer().GetHandle(), 0);
+    command_buffer.CommandSetViewport(0.0f, extent.height, extent.width, -float(extent.height));
+    command_buffer.CommandSetScissor(0, 0, extent.width, extent.height);
+    command_buffer.CommandDrawIndexedIndirect(indirect_buffer.GetHandle(), 0, lod_constants.meshes_count);
+  }
+
+  void TraceVisibility(CommandBuffer &command_buffer) {
+    auto &history_image = history_images[history_index];
+    auto &previous_image = history_images[history_index ^ 1];
+    auto extent = visibility_image.GetExtent();
+    auto groups_x = (extent.width + VISIBILITY_GROUP_SIZE - 1) / VISIBILITY_GROUP_SIZE;
+    auto groups_y = (extent.height + VISIBILITY_GROUP_SIZE - 1) / VISIBILITY_GROUP_SIZE;
+
+    // HISTORY STAYS IN GENERAL, LAYOUT TRANSITIONS DO NOT ORDER THE PING PONG
+    history_image.SetImageLayout(ImageLayout::E_GENERAL, &command_buffer);
+    previous_image.SetImageLayout(ImageLayout::E_GENERAL, &command_buffer);
+    visibility_image.SetImageLayout(ImageLayout::E_GENERAL, &command_buffer);
+    command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT, AccessMaskBits2::E_SHADER_STORAGE_WRITE_BIT,
+                                        PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT,
+                                        AccessMaskBits2::E_SHADER_STORAGE_READ_BIT | AccessMaskBits2::E_SHADER_STORAGE_WRITE_BIT);
+
+    visibility_constants.history_valid = history_valid;
+    visibility_descriptors.depth = depth_image.GetDescriptor();
+    visibility_descriptors.history = previous_image.GetDescriptor();
+    visibility_descriptors.output = history_image.GetDescriptor();
+    command_buffer.CommandBindPipeline(visibility_pipeline.GetPipeline(), PipelineBindPoint::E_COMPUTE);
+    command_buffer.CommandPushConstants(visibility_pipeline.GetPipelineLayout(), ShaderStageMaskBits::E_COMPUTE_BIT, visibility_constants);
+    command_buffer.CommandPushDescriptorSet(visibility_pipeline.GetPushDescriptorTemplate(), visibility_descriptors);
+    command_buffer.CommandDispatch(groups_x, groups_y);
+    command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT, AccessMaskBits2::E_SHADER_STORAGE_WRITE_BIT,
+                                        PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT, AccessMaskBits2::E_SHADER_STORAGE_READ_BIT);
+
+    denoise_descriptors.input = history_image.GetDescriptor();
+    denoise_descriptors.output = visibility_image.GetDescriptor();
+    command_buffer.CommandBindPipeline(denoise_pipeline.GetPipeline(), PipelineBindPoint::E_COMPUTE);
+    command_buffer.CommandPushConstants(denoise_pipeline.GetPipelineLayout(), ShaderStageMaskBits::E_COMPUTE_BIT, denoise_constants);
+    command_buffer.CommandPushDescriptorSet(denoise_pipeline.GetPushDescriptorTemplate(), denoise_descriptors);
+    command_buffer.CommandDispatch(groups_x, groups_y);
+    visibility_image.SetImageLayout(ImageLayout::E_SHADER_READ_ONLY_OPTIMAL, &command_buffer);
+
+    descriptors.visibility = visibility_image.GetDescriptor();
+    history_index ^= 1;
+    history_valid = true;
+  }
+
   void OnUpdate(CommandBuffer &command_buffer) override {
     auto &swapchain = Application::Get()->GetSwapchain();
 
+    // OnImGui RUNS AFTER THIS FRAME IS RECORDED, THE IMAGES ARE ONLY REPLACED BEFORE ANYTHING RECORDS THEM
+    if (pending_visibility_resolution != visibility_resolution) {
+      visibility_resolution = pending_visibility_resolution;
+      CreateVisibilityImages(swapchain.GetExtent().width, swapchain.GetExtent().height);
+    }
+
+    auto geometry_ready = model_asset->IsGeometryReady();
+    model_loader.Update(command_buffer);
+    if (geometry_ready == false && model_asset->IsGeometryReady()) {
+      OnGeometryReady();
+      BuildTopLevel(command_buffer);
+    } else if (tlas_complete == false && model_asset->IsReady()) {
+      BuildTopLevel(command_buffer);
+    }
+
     std::array<RenderingAttachmentInfo, 1> rendering_ai = {};
     {
       rendering_ai[0].imageView = swapchain.GetCurrentImageView();
@@ -73,106 +335,87 @@ public:
     depth_ai.imageLayout = ImageLayout::E_DEPTH_ATTACHMENT_OPTIMAL;
     depth_ai.loadOp = AttachmentLoadOp::E_CLEAR;
     depth_ai.storeOp = AttachmentStoreOp::E_STORE;
-    depth_ai.clearValue.color = {0.0f, 0.0f, 0.0f, 1.0f};
     depth_ai.clearValue.depthStencil = {1.0f, 0};
 
     auto extent = swapchain.GetExtent();
 
-    Transform transform(Vector3f(0.0f), Vector3f(0.1f));
-
-    matrices.projection = camera.GetProjectionMatrix();
-    matrices.view = camera.GetViewMatrix();
-    matrices.model = transform.GetModelMatrix();
-
-    command_buffer.CommandBeginRendering(swapchain.GetExtent(), rendering_ai, depth_ai);
-    command_buffer.CommandBindPipeline(graphics_pipeline.GetPipeline(), PipelineBindPoint::E_GRAPHICS);
-    command_buffer.CommandEnableDepthTest(true);
-    command_buffer.CommandEnableDepthWrite(true);
-    command_buffer.CommandBindIndexBuffer(index_buffer.GetHandle(), 0);
-    command_buffer.CommandPushConstants(graphics_pipeline.GetPipelineLayout(), ShaderStageMaskBits::E_VERTEX_BIT, matrices);
-    command_buffer.CommandPushDescriptorSet(graphics_pipeline.GetPipelineLayout(), 0, 0, vertex_buffer.GetHandle(),
-                                            PipelineBindPoint::E_GRAPHICS);
-    command_buffer.CommandPushDescriptorSet(graphics_pipeline.GetPipelineLayout(), 0, 1, tlas.GetAccelerationStructure(),
-                                            PipelineBindPoint::E_GRAPHICS);
-    command_buffer.CommandPushDescriptorSet(graphics_pipeline.GetPipelineLayout(), 0, 2, mesh_buffer.GetHandle(), PipelineBindPoint::E_GRAPHICS);
-    command_buffer.CommandBindDescriptorSet(graphics_pipeline.GetPipelineLayout(), descriptor_set.GetHandle(), 1);
-    command_buffer.CommandSetViewport(0.0f, extent.height, extent.width, -float(extent.height));
-    command_buffer.CommandSetScissor(0, 0, extent.width, extent.height);
-    command_buffer.CommandDrawIndexedIndirect(indirect_buffer.GetHandle(), 0, model.GetMeshes().size());
-    command_buffer.CommandEndRendering();
-  }
-
-  void BuildAcceleration() {
+    depth_image.SetImageLayout(ImageLayout::E_DEPTH_ATTACHMENT_OPTIMAL, &command_buffer);
 
-    BottomLevelGeometry geometry;
-    TriangleGeometrySpecification specification;
-    specification.vertices_count_ = model.GetVerticesNumber();
-    specification.indices_count_ = model.GetIndicesNumber();
-    specification.vbo_offset_ = vertex_buffer.GetBufferAddress();
-    specification.ibo_offset_ = index_buffer.GetBufferAddress();
-    specification.vertex_stride_ = sizeof(Vertex);
-    geometry.AddTriangleGeometry(specification);
-
-    blas = AccelerationStructure(geometry);
+    if (model_asset->IsGeometryReady() == false) {
+      command_buffer.CommandBeginRendering(extent, rendering_ai, depth_ai);
+      command_buffer.CommandEndRendering();
+      return;
+    }
 
     Transform transform(Vector3f(0.0f), Vector3f(0.1f));
 
-    std::array<BottomLevelAccelerationStructureInstances, 1> bottom_instances;
-    bottom_instances[0].instances_.emplace_back(transform.GetModelMatrix());
-    bottom_instances[0].acceleration_structure_ = blas.GetAccelerationStructure();
-
-    tlas = AccelerationStructure(bottom_instances);
-  }
-
-  void OnAttach() override {
-    auto &swapchain = Application::Get()->GetSwapchain();
-    auto extent = swapchain.GetExtent();
-    depth_image = ImageDepth(extent.width, extent.height);
-    model = Model(model_path);
-
-    CommandBuffer command_buffer(GraphicsContext::Get()->GetGraphicsQueueIndex());
-    Buffer staging(400_MiB, BufferUsageMaskBits::E_TRANSFER_SRC_BIT, AllocationCreateMaskBits::E_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+    camera_data.projection = camera.GetProjectionMatrix();
+    camera_data.view = camera.GetViewMatrix();
+    camera_data.model = transform.GetModelMatrix();
 
-    BufferUsageMask usage = BufferUsageMaskBits::E_SHADER_DEVICE_ADDRESS_BIT | BufferUsageMaskBits::E_TRANSFER_DST_BIT |
-                            BufferUsageMaskBits::E_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
+    lod_constants.model_view = camera_data.view * camera_data.model;
+    lod_constants.projection_scale = camera_data.projection[1][1] * float(extent.height) * 0.5f;
 
-    vertex_buffer = Buffer(400_MiB, BufferUsageMaskBits::E_STORAGE_BUFFER_BIT | usage, {});
-    index_buffer = Buffer(400_MiB, BufferUsageMaskBits::E_INDEX_BUFFER_BIT | usage, {});
-    indirect_buffer = Buffer(40_MiB, BufferUsageMaskBits::E_INDIRECT_BUFFER_BIT, AllocationCreateMaskBits::E_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
-    mesh_buffer = Buffer(40_MiB, BufferUsageMaskBits::E_STORAGE_BUFFER_BIT, AllocationCreateMaskBits::E_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+    auto view_projection = camera_data.projection * camera_data.view;
+    camera_data.inverse_view_projection = glm::inverse(view_projection);
+    camera_data.previous_view_projection = history_valid ? previous_view_projection : view_projection;
+    camera_data.camera_position = Vector4f(camera.GetPosition(), 1.0f);
+    visibility_constants.frame++;
+    previous_view_projection = view_projection;
 
-    auto commands = GetIndirectCommandsFromMeshes(model.GetMeshes());
-    indirect_buffer.SetData<DrawIndexedIndirectCommand>(commands);
+    UpdateCamera(command_buffer);
 
-    mesh_buffer.SetData<Mesh>(model.GetMeshes());
+    RequestTextures();
+    texture_streamer.Update(command_buffer);
 
-    auto offset = model.GetVerticesNumber() * sizeof(Vertex);
+    SelectLods(command_buffer);
 
-    staging.SetData(model.GetVertices());
-    staging.SetData(model.GetIndices(), offset);
+    // DEPTH PREPASS, RAYS ARE TRACED ONLY FOR THE VISIBLE SURFACE
+    command_buffer.CommandBeginRendering(extent, {}, depth_ai);
+    command_buffer.CommandBindPipeline(depth_pipeline.GetPipeline(), PipelineBindPoint::E_GRAPHICS);
+    command_buffer.CommandEnableDepthTest(true);
+    command_buffer.CommandEnableDepthWrite(true);
+    command_buffer.CommandSetDepthCompareOp(CompareOp::E_LESS);
+    command_buffer.CommandPushDescriptorSet(depth_pipeline.GetPushDescriptorTemplate(), depth_descriptors);
+    DrawMeshes(command_buffer, extent);
+    command_buffer.CommandEndRendering();
 
-    command_buffer.Begin();
-    command_buffer.CommandCopyBuffer(staging.GetHandle(), vertex_buffer.GetHandle(), 0, 0, offset);
-    command_buffer.CommandCopyBuffer(staging.GetHandle(), index_buffer.GetHandle(), offset, 0, model.GetIndicesNumber() * sizeof(uint32_t));
+    depth_image.SetImageLayout(ImageLayout::E_DEPTH_STENCIL_READ_ONLY_OPTIMAL, &command_buffer);
 
-    command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_COPY_BIT, AccessMaskBits2::E_TRANSFER_WRITE_BIT,
-                                        PipelineStageMaskBits2::E_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, AccessMaskBits2::E_SHADER_READ_BIT);
+    TraceVisibility(command_buffer);
 
-    command_buffer.End();
-    command_buffer.Submit();
+    // SHADING, EVERY PIXEL IS SHADED ONCE AGAINST THE PREPASS DEPTH
+    depth_ai.imageLayout = ImageLayout::E_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+    depth_ai.loadOp = AttachmentLoadOp::E_LOAD;
+    depth_ai.storeOp = AttachmentStoreOp::E_NONE;
 
-    BuildAcceleration();
+    command_buffer.CommandBeginRendering(extent, rendering_ai, depth_ai);
+    command_buffer.CommandBindPipeline(graphics_pipeline.GetPipeline(), PipelineBindPoint::E_GRAPHICS);
+    command_buffer.CommandEnableDepthTest(true);
+    command_buffer.CommandEnableDepthWrite(false);
+    command_buffer.CommandSetDepthCompareOp(CompareOp::E_LESS_OR_EQUAL);
+    command_buffer.CommandPushConstants(graphics_pipeline.GetPipelineLayout(), ShaderStageMaskBits::E_FRAGMENT_BIT, shading_constants);
+    command_buffer.CommandPushDescriptorSet(graphics_pipeline.GetPushDescriptorTemplate(), descriptors);
+    BindlessTable::Get()->CommandBind(command_buffer, graphics_pipeline.GetPipelineLayout(), PipelineBindPoint::E_GRAPHICS);
+    DrawMeshes(command_buffer, extent);
+    command_buffer.CommandEndRendering();
+  }
 
-    DescriptorPoolSize descriptor_pool_size[1];
-    descriptor_pool_size[0].type = DescriptorType::E_COMBINED_IMAGE_SAMPLER;
-    descriptor_pool_size[0].descriptorCount = model.GetImages().size();
+  void OnAttach() override {
+    auto &swapchain = Application::Get()->GetSwapchain();
+    auto extent = swapchain.GetExtent();
+    depth_image = ImageDepth(extent.width, extent.height, Format::E_D32_SFLOAT, ImageUsageMaskBits::E_SAMPLED_BIT);
+    CreateVisibilityImages(extent.width, extent.height);
 
-    descriptor_pool = DescriptorPool(descriptor_pool_size, DescriptorPoolCreateMaskBits::E_UPDATE_AFTER_BIND_BIT, 1);
+    camera_buffer = Buffer(sizeof(MeshCamera), BufferUsageMaskBits::E_STORAGE_BUFFER_BIT | BufferUsageMaskBits::E_TRANSFER_DST_BIT, {});
+    descriptors.camera = camera_buffer.GetDescriptor();
+    depth_descriptors.camera = camera_buffer.GetDescriptor();
+    visibility_descriptors.camera = camera_buffer.GetDescriptor();
 
-    std::vector<DescriptorImageInfo> image_infos;
-    for (const auto &image : model.GetImages()) {
-      image_infos.emplace_back(image.GetDescriptor());
-    }
+    ModelSpecification model_specification;
+    model_specification.pack_vertices_ = true;
+    model_specification.lods_count_ = MESH_MAX_LODS;
+    model_asset = model_loader.Load(model_path, model_specification);
 
     auto shader_directory = GetInnsmouthShadersDirectory();
 
@@ -181,27 +424,54 @@ public:
     pipeline_specification.depth_format_ = Format::E_D32_SFLOAT;
     pipeline_specification.dynamic_states_.emplace_back(DynamicState::E_DEPTH_TEST_ENABLE);
     pipeline_specification.dynamic_states_.emplace_back(DynamicState::E_DEPTH_WRITE_ENABLE);
-    pipeline_specification.shader_paths_ = {shader_directory / "mesh" / "mesh.vert.spv", shader_directory / "mesh" / "mesh_indirect.frag.spv"};
+    pipeline_specification.dynamic_states_.emplace_back(DynamicState::E_DEPTH_COMPARE_OP);
+    pipeline_specification.shader_paths_ = {shader_directory / "mesh" / "mesh_packed.vert.spv",
+                                            shader_directory / "mesh" / "mesh_indirect.frag.spv"};
     graphics_pipeline = GraphicsPipeline(pipeline_specification);
 
-    descriptor_set = DescriptorSet(descriptor_pool.GetHandle(), graphics_pipeline.GetDescriptorSetLayouts()[1], model.GetImages().size());
-    descriptor_set.Update(image_infos, 0, DescriptorType::E_COMBINED_IMAGE_SAMPLER, 0);
+    pipeline_specification.color_formats_.clear();
+    pipeline_specification.shader_paths_ = {shader_directory / "mesh" / "mesh_packed.vert.spv"};
+    depth_pipeline = GraphicsPipeline(pipeline_specification);
+
+    lod_pipeline = ComputePipeline(shader_directory / "mesh" / "mesh_lod.comp.spv");
+    visibility_pipeline = ComputePipeline(shader_directory / "mesh" / "visibility_trace.comp.spv");
+    denoise_pipeline = ComputePipeline(shader_directory / "mesh" / "visibility_denoise.comp.spv");
   }
 
 private:
   ImageDepth depth_image;
-  Buffer vertex_buffer;
-  Buffer index_buffer;
+  std::array<Image2D, 2> history_images;
+  Image2D visibility_image;
+  uint32_t history_index = 0;
+  bool history_valid = false;
+  Matrix4f previous_view_projection = Matrix4f(1.0f);
   Buffer indirect_buffer;
-  Buffer mesh_buffer;
+  Buffer camera_buffer;
   GraphicsPipeline graphics_pipeline;
+  GraphicsPipeline depth_pipeline;
+  ComputePipeline lod_pipeline;
+  ComputePipeline visibility_pipeline;
+  ComputePipeline denoise_pipeline;
   Camera camera;
-  Model model;
-  ModelMatrices matrices;
-  DescriptorPool descriptor_pool;
-  DescriptorSet descriptor_set;
-  AccelerationStructure blas;
+  MeshCamera camera_data;
+  ShadingConstants shading_constants;
+  MeshDescriptors descriptors;
+  DepthDescriptors depth_descriptors;
+  VisibilityConstants visibility_constants;
+  VisibilityDescriptors visibility_descriptors;
+  DenoiseConstants denoise_constants;
+  DenoiseDescriptors denoise_descriptors;
+  int32_t visibility_resolution = 1; // FULL, HALF, QUARTER
+  int32_t pending_visibility_resolution = 1;
+  int32_t rays_per_pixel = 1;
+  bool denoise = true;
+  LodConstants lod_constants;
+  LodDescriptors lod_descriptors;
   AccelerationStructure tlas;
+  bool tlas_complete = false;
+  TextureStreamer texture_streamer;
+  ModelLoader model_loader{texture_streamer};
+  std::shared_ptr<const ModelAsset> model_asset;
 };
 
 int main(int argc, char **argv) {
@@ -0,0 +1,244 @@
+#include "innsmouth/common/innsmouth.h"
+#include <print>
+
+using namespace Innsmouth;
+
+std::filesystem::path model_path;
+
+struct MeshletCamera {
+  Matrix4f projection = Matrix4f(1.0f);
+  Matrix4f view = Matrix4f(1.0f);
+  Matrix4f model = Matrix4f(1.0f);
+  Matrix4f normal_matrix = Matrix4f(1.0f);
+};
+
+struct MeshletConstants {
+  Vector3f camera_position = Vector3f(0.0f);
+  uint32_t meshlets_count = 0;
+};
+
+struct MeshletDescriptors {
+  DescriptorBufferInfo vertices;
+  DescriptorBufferInfo meshlets;
+  DescriptorBufferInfo meshlet_vertices;
+  DescriptorBufferInfo meshlet_triangles;
+  DescriptorBufferInfo camera;
+};
+
+struct CullDescriptors {
+  DescriptorBufferInfo meshlets;
+  DescriptorBufferInfo draw_commands;
+  DescriptorBufferInfo draw_count;
+  DescriptorBufferInfo camera;
+};
+
+constexpr uint32_t MESHLET_TASK_GROUP_SIZE = 32;
+
+template <typename T> Buffer CreateStorageBuffer(std::span<const T> data, BufferUsageMask usage = BufferUsageMask()) {
+  Buffer buffer(std::max(data.size_bytes(), sizeof(T)), BufferUsageMaskBits::E_STORAGE_BUFFER_BIT | usage, Buffer::CPU);
+  buffer.SetData(data);
+  return buffer;
+}
+
+class MeshletViewer : public Innsmouth::Layer {
+public:
+  void OnImGui() override {
+    auto position = camera.GetPosition();
+    auto yaw = camera.GetYaw();
+    auto pitch = camera.GetPitch();
+    ImGui::Begin("Camera");
+    ImGui::Text("%s: %zu meshlets", mesh_shading ? "mesh shading" : "compute fallback", model.GetMeshlets().size());
+    ImGui::DragFloat3("position", glm::value_ptr(position));
+    ImGui::DragFloat("Yaw", &yaw);
+    ImGui::DragFloat("Pitch", &pitch);
+    ImGui::End();
+    camera.SetPosition(position);
+    camera.SetYaw(yaw);
+    camera.SetPitch(pitch);
+  }
+
+  bool OnResize(WindowResizeEvent &event) {
+    auto w = event.GetWidth();
+    auto h = event.GetHeight();
+    camera.SetAspect(float(w) / float(h));
+    depth_image = ImageDepth(w, h);
+    return true;
+  }
+
+  void OnEvent(Event &event) override {
+    EventDispatcher dispatcher(event);
+    dispatcher.Dispatch<WindowResizeEvent>(BIND_FUNCTION(MeshletViewer::OnResize));
+  }
+
+  void UpdateCamera(CommandBuffer &command_buffer) {
+    auto readers = PipelineStageMaskBits2::E_TASK_SHADER_BIT_EXT | PipelineStageMaskBits2::E_MESH_SHADER_BIT_EXT |
+                   PipelineStageMaskBits2::E_VERTEX_SHADER_BIT | PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT;
+    command_buffer.CommandMemoryBarrier(readers, AccessMask2(), PipelineStageMaskBits2::E_ALL_TRANSFER_BIT, AccessMask2());
+    command_buffer.CommandUpdateBuffer(camera_buffer.GetHandle(), 0, std::as_bytes(std::span(&camera_data, 1)));
+    command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_ALL_TRANSFER_BIT, AccessMaskBits2::E_TRANSFER_WRITE_BIT, readers,
+                                        AccessMaskBits2::E_SHADER_STORAGE_READ_BIT);
+  }
+
+  void CullMeshlets(CommandBuffer &command_buffer) {
+    command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_DRAW_INDIRECT_BIT, AccessMask2(),
+                                        PipelineStageMaskBits2::E_CLEAR_BIT | PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT, AccessMask2());
+    command_buffer.CommandFillBuffer(draw_count_buffer.GetHandle(), 0, sizeof(uint32_t), 0);
+    command_buffer.CommandBufferMemoryBarrier(draw_count_buffer.GetHandle(), PipelineStageMaskBits2::E_CLEAR_BIT,
+                                              AccessMaskBits2::E_TRANSFER_WRITE_BIT, PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT,
+                                              AccessMaskBits2::E_SHADER_STORAGE_READ_BIT | AccessMaskBits2::E_SHADER_STORAGE_WRITE_BIT);
+
+    command_buffer.CommandBindPipeline(cull_pipeline.GetPipeline(), PipelineBindPoint::E_COMPUTE);
+    command_buffer.CommandPushConstants(cull_pipeline.GetPipelineLayout(), ShaderStageMaskBits::E_COMPUTE_BIT, constants);
+    command_buffer.CommandPushDescriptorSet(cull_pipeline.GetPushDescriptorTemplate(), cull_descriptors);
+    command_buffer.CommandDispatch((constants.meshlets_count + MESHLET_TASK_GROUP_SIZE - 1) / MESHLET_TASK_GROUP_SIZE);
+
+    command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT, AccessMaskBits2::E_SHADER_STORAGE_WRITE_BIT,
+                                        PipelineStageMaskBits2::E_DRAW_INDIRECT_BIT, AccessMaskBits2::E_INDIRECT_COMMAND_READ_BIT);
+  }
+
+  void OnUpdate(CommandBuffer &command_buffer) override {
+    auto &swapchain = Application::Get()->GetSwapchain();
+    auto extent = swapchain.GetExtent();
+
+    std::array<RenderingAttachmentInfo, 1> rendering_ai = {};
+    {
+      rendering_ai[0].imageView = swapchain.GetCurrentImageView();
+      rendering_ai[0].imageLayout = ImageLayout::E_COLOR_ATTACHMENT_OPTIMAL;
+      rendering_ai[0].loadOp = AttachmentLoadOp::E_CLEAR;
+      rendering_ai[0].storeOp = AttachmentStoreOp::E_STORE;
+      rendering_ai[0].clearValue.color = {0.0f, 0.0f, 0.0f, 1.0f};
+    }
+
+    RenderingAttachmentInfo depth_ai;
+    depth_ai.imageView = depth_image.GetImageView();
+    depth_ai.imageLayout = ImageLayout::E_DEPTH_ATTACHMENT_OPTIMAL;
+    depth_ai.loadOp = AttachmentLoadOp::E_CLEAR;
+    depth_ai.storeOp = AttachmentStoreOp::E_STORE;
+    depth_ai.clearValue.depthStencil = {1.0f, 0};
+
+    Transform transform(Vector3f(0.0f), Vector3f(0.0f), Vector3f(0.1f));
+
+    auto model_inverse = glm::inverse(transform.GetModelMatrix());
+    camera_data.projection = camera.GetProjectionMatrix();
+    camera_data.view = camera.GetViewMatrix();
+    camera_data.model = transform.GetModelMatrix();
+    camera_data.normal_matrix = glm::transpose(model_inverse);
+    constants.camera_position = Vector3f(model_inverse * Vector4f(camera.GetPosition(), 1.0f));
+
+    UpdateCamera(command_buffer);
+
+    if (mesh_shading == false) {
+      CullMeshlets(command_buffer);
+    }
+
+    command_buffer.CommandBeginRendering(extent, rendering_ai, depth_ai);
+    command_buffer.CommandBindPipeline(graphics_pipeline.GetPipeline(), PipelineBindPoint::E_GRAPHICS);
+    command_buffer.CommandEnableDepthTest(true);
+    command_buffer.CommandEnableDepthWrite(true);
+    if (mesh_shading) {
+      command_buffer.CommandPushConstants(graphics_pipeline.GetPipelineLayout(), ShaderStageMaskBits::E_TASK_BIT_EXT, constants);
+    }
+    command_buffer.CommandPushDescriptorSet(graphics_pipeline.GetPushDescriptorTemplate(), descriptors);
+    command_buffer.CommandSetViewport(0.0f, extent.height, extent.width, -float(extent.height));
+    command_buffer.CommandSetScissor(0, 0, extent.width, extent.height);
+    if (mesh_shading) {
+      command_buffer.CommandDrawMeshTasks((constants.meshlets_count + MESHLET_TASK_GROUP_SIZE - 1) / MESHLET_TASK_GROUP_SIZE);
+    } else {
+      command_buffer.CommandDrawIndirectCount(draw_commands_buffer.GetHandle(), 0, draw_count_buffer.GetHandle(), 0, constants.meshlets_count);
+    }
+    command_buffer.CommandEndRendering();
+  }
+
+  void CreatePipelines() {
+    auto &swapchain = Application::Get()->GetSwapchain();
+    auto shader_directory = GetInnsmouthShadersDirectory() / "mesh";
+
+    GraphicsPipelineSpecification pipeline_specification;
+    pipeline_specification.color_formats_ = {swapchain.GetFormat()};
+    pipeline_specification.depth_format_ = Format::E_D32_SFLOAT;
+    pipeline_specification.dynamic_states_.emplace_back(DynamicState::E_DEPTH_TEST_ENABLE);
+    pipeline_specification.dynamic_states_.emplace_back(DynamicState::E_DEPTH_WRITE_ENABLE);
+
+    if (mesh_shading) {
+      pipeline_specification.shader_paths_ = {shader_directory / "meshlet.task.spv", shader_directory / "meshlet.mesh.spv",
+                                              shader_directory / "meshlet.frag.spv"};
+    } else {
+      pipeline_specification.shader_paths_ = {shader_directory / "meshlet.vert.spv", shader_directory / "meshlet.frag.spv"};
+      cull_pipeline = ComputePipeline(shader_directory / "meshlet_cull.comp.spv");
+    }
+
+    graphics_pipeline = GraphicsPipeline(pipeline_specification);
+  }
+
+  void OnAttach() override {
+    auto &swapchain = Application::Get()->GetSwapchain();
+    auto extent = swapchain.GetExtent();
+    depth_image = ImageDepth(extent.width, extent.height);
+
+    ModelSpecification model_specification;
+    model_specification.build_meshlets_ = true;
+    model = Model(model_path, model_specification);
+
+    mesh_shading = GraphicsContext::Get()->IsMeshShaderEnabled();
+    constants.meshlets_count = model.GetMeshlets().size();
+
+    vertex_buffer = CreateStorageBuffer(model.GetVertices());
+    meshlet_buffer = CreateStorageBuffer(model.GetMeshlets());
+    meshlet_vertices_buffer = CreateStorageBuffer(model.GetMeshletVertices());
+    meshlet_triangles_buffer = CreateStorageBuffer(model.GetMeshletTriangles());
+
+    BufferUsageMask indirect_usage = BufferUsageMaskBits::E_STORAGE_BUFFER_BIT | BufferUsageMaskBits::E_INDIRECT_BUFFER_BIT;
+    draw_commands_buffer = Buffer(std::max(constants.meshlets_count, 1u) * sizeof(DrawIndirectCommand), indirect_usage, {});
+    draw_count_buffer = Buffer(sizeof(uint32_t), indirect_usage | BufferUsageMaskBits::E_TRANSFER_DST_BIT, {});
+    camera_buffer = Buffer(sizeof(MeshletCamera), BufferUsageMaskBits::E_STORAGE_BUFFER_BIT | BufferUsageMaskBits::E_TRANSFER_DST_BIT, {});
+
+    descriptors.vertices = vertex_buffer.GetDescriptor();
+    descriptors.meshlets = meshlet_buffer.GetDescriptor();
+    descriptors.meshlet_vertices = meshlet_vertices_buffer.GetDescriptor();
+    descriptors.meshlet_triangles = meshlet_triangles_buffer.GetDescriptor();
+    descriptors.camera = camera_buffer.GetDescriptor();
+
+    cull_descriptors.meshlets = meshlet_buffer.GetDescriptor();
+    cull_descriptors.draw_commands = draw_commands_buffer.GetDescriptor();
+    cull_descriptors.draw_count = draw_count_buffer.GetDescriptor();
+    cull_descriptors.camera = camera_buffer.GetDescriptor();
+
+    CreatePipelines();
+  }
+
+private:
+  ImageDepth depth_image;
+  Buffer vertex_buffer;
+  Buffer meshlet_buffer;
+  Buffer meshlet_vertices_buffer;
+  Buffer meshlet_triangles_buffer;
+  Buffer draw_commands_buffer;
+  Buffer draw_count_buffer;
+  Buffer camera_buffer;
+  GraphicsPipeline graphics_pipeline;
+  ComputePipeline cull_pipeline;
+  Camera camera;
+  Model model;
+  MeshletCamera camera_data;
+  MeshletConstants constants;
+  MeshletDescriptors descriptors;
+  CullDescriptors cull_descriptors;
+  bool mesh_shading = false;
+};
+
+int main(int argc, char **argv) {
+
+  if (argc == 1) return 0;
+
+  model_path = argv[1];
+
+  Application application;
+
+  MeshletViewer meshlet_viewer;
+
+  application.AddLayer(&meshlet_viewer);
+
+  application.Run();
+
+  return 0;
+}
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include "innsmouth/common/innsmouth.h"
+#include "innsmouth/core/include/parallel_for.h"
+#include <chrono>
+#include <fstream>
 #include <print>
+#include <ranges>
 
 using namespace Innsmouth;
 
@@ -7,6 +11,198 @@ std::filesystem::path model_path;
 
 bool dirty = false;
 
+constexpr ImageUsageMask TARGET_USAGE =
+  ImageUsageMaskBits::E_SAMPLED_BIT | ImageUsageMaskBits::E_STORAGE_BIT | ImageUsageMaskBits::E_TRANSFER_DST_BIT;
+
+constexpr uint32_t POSES_COUNT = 4;
+constexpr uint32_t LODS_COUNT = 3;
+constexpr uint32_t JOINTS_COUNT = 2;
+constexpr uint32_t SKINNING_GROUP_SIZE = 64;
+constexpr std::size_t SKINNING_CHUNK_SIZE = 4096;
+
+struct RayDescriptors {
+  VkAccelerationStructureKHR tlas;
+  DescriptorImageInfo target;
+  DescriptorBufferInfo vertices;
+  DescriptorBufferInfo indices;
+};
+
+struct GeometryRecord {
+  uint32_t first_index;
+  uint32_t mesh_index;
+  int32_t color_texture_index; // BINDLESS SLOT
+  int32_t normal_texture_index;
+  uint32_t vertex_offset;
+  float alpha_cutoff;
+};
+
+struct SkinVertex {
+  float weights[4];
+  uint32_t joints;
+};
+
+struct SkinningConstants {
+  uint32_t vertices_count;
+  uint32_t joints_count;
+};
+
+struct SkinningDescriptors {
+  DescriptorBufferInfo rest_vertices;
+  DescriptorBufferInfo vertices;
+  DescriptorBufferInfo skin;
+  DescriptorBufferInfo joints;
+};
+
+struct RayConstants {
+  Vector3f camera_position;
+  uint32_t accumulated_samples;
+  uint32_t samples_per_frame;
+  uint32_t max_bounces;
+  uint32_t progressive;
+};
+
+std::vector<Matrix4f> GetInstanceTransforms(const Vector3f &rotation) {
+  std::vector<Matrix4f> transforms;
+  for (auto x = 0; x < 10; x++) {
+    for (auto z = 0; z < 10; z++) {
+      Transform transform;
+      transform.SetPosition(Vector3f(30.0f * x, 0.0f, 30.0f * z));
+      transform.SetOrientation(rotation);
+      transform.SetScale(Vector3f(0.2f));
+      transforms.emplace_back(transform.GetModelMatrix());
+    }
+  }
+  return transforms;
+}
+
+// THE LOADERS CARRY NO SKINS, A TWO JOINT RIG BENDS EVERY MODEL ABOVE ITS BASE
+std::vector<SkinVertex> GetSwayRig(const Model &model, const BoundingBox &bounds) {
+  std::vector<SkinVertex> skin;
+  auto height = std::max(bounds.max_.y - bounds.min_.y, 1.0e-6f);
+  for (const auto &vertex : model.GetVertices()) {
+    auto weight = glm::smoothstep(0.2f, 1.0f, (vertex.position_.y - bounds.min_.y) / height);
+    skin.push_back({{1.0f - weight, weight, 0.0f, 0.0f}, 0u | (1u << 8)});
+  }
+  return skin;
+}
+
+std::array<Matrix4f, JOINTS_COUNT> GetSwayPose(const BoundingBox &bounds, float time, uint32_t pose) {
+  auto pivot = Vector3f(bounds.GetCenter().x, bounds.min_.y, bounds.GetCenter().z);
+  auto angle = 0.35f * std::sin(1.5f * time + 1.7f * pose);
+  auto bend = glm::translate(Matrix4f(1.0f), pivot) * glm::rotate(Matrix4f(1.0f), angle, Vector3f(0.0f, 0.0f, 1.0f)) *
+              glm::translate(Matrix4f(1.0f), -pivot);
+  return {Matrix4f(1.0f), bend};
+}
+
+// SAME BLEND AS skinning.comp
+void SkinVertices(std::span<const Vertex> vertices, std::span<const SkinVertex> skin, std::span<const Matrix4f> joints,
+                  std::span<Vertex> out_vertices) {
+  ParallelFor((vertices.size() + SKINNING_CHUNK_SIZE - 1) / SKINNING_CHUNK_SIZE, [&](std::size_t chunk) {
+    auto end = std::min(vertices.size(), (chunk + 1) * SKINNING_CHUNK_SIZE);
+    for (auto index = chunk * SKINNING_CHUNK_SIZE; index < end; index++) {
+      auto transform = Matrix4f(0.0f);
+      for (auto i = 0; i < 4; i++) {
+        transform += skin[index].weights[i] * joints[(skin[index].joints >> (8 * i)) & 0xff];
+      }
+      out_vertices[index] = vertices[index];
+      out_vertices[index].position_ = Vector3f(transform * Vector4f(vertices[index].position_, 1.0f));
+      out_vertices[index].normal_ = glm::normalize(glm::mat3(transform) * vertices[index].normal_);
+    }
+  });
+}
+
+// EVERY SKINNED VERTEX IS A CONVEX BLEND OF ITS JOINT TRANSFORMS, SO THE TRANSFORMED REST BOXES BOUND THE POSE
+BoundingBox GetPoseBounds(const BoundingBox &bounds, std::span<const Matrix4f> joints) {
+  BoundingBox pose_bounds;
+  for (const auto &joint : joints) {
+    for (auto corner = 0; corner < 8; corner++) {
+      auto x = (corner & 1) ? bounds.max_.x : bounds.min_.x;
+      auto y = (corner & 2) ? bounds.max_.y : bounds.min_.y;
+      auto z = (corner & 4) ? bounds.max_.z : bounds.min_.z;
+      pose_bounds.Extend(Vector3f(joint * Vector4f(x, y, z, 1.0f)));
+    }
+  }
+  return pose_bounds;
+}
+
+// SAME CAMERA AS mesh.rgen
+Vector3f GetRayDirection(const Vector2f &pixel, float width) {
+  auto uv = pixel / width;
+  auto direction = glm::normalize(Vector3f(uv * 2.0f - 1.0f, -1.0f));
+  auto c = std::cos(1.5f), s = std::sin(1.5f);
+  return Vector3f(direction.x * c + direction.z * s, direction.y, -direction.x * s + direction.z * c);
+}
+
+// CPU FALLBACK OF THE DIRECT SHADING PATH, ONE OBJECT SPACE BVH TRAVERSED PER INSTANCE
+// ONE BVH AND ONE RUN OF VERTICES PER POSE, INSTANCE i SHOWS POSE i % POSES LIKE THE TOP LEVEL DOES
+struct CPUScene {
+  CPUScene(std::span<const BoundingVolumeHierarchy> bvhs, std::span<const Vertex> vertices, const Vector3f &rotation)
+    : bvhs(bvhs), vertices(vertices), transforms(GetInstanceTransforms(rotation)) {
+    std::ranges::transform(transforms, std::back_inserter(inverse_transforms), [](const auto &m) { return glm::inverse(m); });
+  }
+
+  RayHit Intersect(const Ray &ray, uint32_t &instance_index) const {
+    RayHit closest;
+    for (auto i = 0; i < transforms.size(); i++) {
+      // THE DIRECTION STAYS UNNORMALIZED SO t IS THE SAME IN BOTH SPACES
+      Ray object_ray = ray;
+      object_ray.origin_ = Vector3f(inverse_transforms[i] * Vector4f(ray.origin_, 1.0f));
+      object_ray.direction_ = Vector3f(inverse_transforms[i] * Vector4f(ray.direction_, 0.0f));
+      object_ray.t_max_ = closest.t_;
+      auto hit = GetBoundingVolumeHierarchy(i).Intersect(object_ray);
+      if (hit.IsHit() == false) continue;
+      closest = hit;
+      instance_index = i;
+    }
+    return closest;
+  }
+
+  Vector3f Shade(const Ray &ray) const {
+    uint32_t instance_index = 0;
+    auto hit = Intersect(ray, instance_index);
+    if (hit.IsHit() == false) {
+      auto t = 0.5f * ray.direction_.y + 0.5f;
+      return glm::mix(Vector3f(0.6f, 0.1f, 0.1f), Vector3f(0.9f, 0.8f, 0.7f), t);
+    }
+    const auto &triangle = GetBoundingVolumeHierarchy(instance_index).GetTriangle(hit.triangle_index_);
+    auto pose_vertices_count = vertices.size() / bvhs.size();
+    auto pose_vertices = vertices.subspan((instance_index % bvhs.size()) * pose_vertices_count, pose_vertices_count);
+    auto normal = (1.0f - hit.u_ - hit.v_) * pose_vertices[triangle.indices_[0]].normal_ +
+                  hit.u_ * pose_vertices[triangle.indices_[1]].normal_ + hit.v_ * pose_vertices[triangle.indices_[2]].normal_;
+    normal = glm::normalize(glm::transpose(glm::mat3(inverse_transforms[instance_index])) * glm::normalize(normal));
+    auto sun = glm::normalize(Vector3f(1.0f, 1.0f, 0.0f));
+    return Vector3f(0.3f) + std::clamp(glm::dot(sun, normal), 0.0f, 1.0f) * Vector3f(0.4f, 0.4f, 0.1f);
+  }
+
+  void Render(uint32_t width, uint32_t height, const Vector3f &camera_position, std::span<Vector4f> pixels) const {
+    ParallelFor(height, [&](std::size_t y) {
+      for (auto x = 0; x < width; x++) {
+        Ray ray;
+        ray.origin_ = camera_position;
+        ray.direction_ = GetRayDirection(Vector2f(x, y) + Vector2f(0.5f), float(width));
+        ray.t_min_ = 0.01f;
+        pixels[y * width + x] = Vector4f(Shade(ray), 1.0f);
+      }
+    });
+  }
+
+  const BoundingVolumeHierarchy &GetBoundingVolumeHierarchy(uint32_t instance_index) const {
+    return bvhs[instance_index % bvhs.size()];
+  }
+
+  std::span<const BoundingVolumeHierarchy> bvhs;
+  std::span<const Vertex> vertices;
+  std::vector<Matrix4f> transforms;
+  std::vector<Matrix4f> inverse_transforms;
+};
+
+struct PickResult {
+  uint32_t instance_index;
+  uint32_t mesh_index;
+  uint32_t triangle_index;
+  float t;
+};
+
 class RayTracer : public Innsmouth::Layer {
 public:
   void OnImGui() override {
@@ -15,61 +211,291 @@ public:
     ImGui::Begin("Settings");
     ImGui::DragFloat3("camera position", glm::value_ptr(position));
     ImGui::DragFloat3("model rotation", glm::value_ptr(temp_rotation));
+    ImGui::Checkbox("cpu fallback", &cpu_fallback);
+    ImGui::Checkbox("wavefront", &wavefront);
+    ImGui::Checkbox("progressive", &progressive);
+    ImGui::SliderInt("samples per frame", &samples_per_frame, 1, 64);
+    ImGui::SliderInt("max bounces", &max_bounces, 0, 16);
+    ImGui::Checkbox("animate", &animate);
+    ImGui::SliderInt("max refits", &max_refits, 0, 600);
+    ImGui::DragFloat("max bounds growth", &max_bounds_growth, 0.01f, 1.0f, 4.0f);
+    ImGui::Text("refits: %u, rebuilds: %u", dynamic_structures.GetRefitsCount(), dynamic_structures.GetRebuildsCount());
+    auto temp_culling = culling;
+    ImGui::DragFloat("max instance distance", &temp_culling.max_distance_, 1.0f, 0.0f, 1000.0f);
+    ImGui::DragFloat("ray relevance extent", &relevance_extent, 1.0f, 0.0f, 1000.0f);
+    ImGui::DragFloat("lod error threshold", &temp_culling.error_threshold_, 0.05f, 0.0f, 16.0f);
+    if (opacity_micromap.GetMicromap() != VK_NULL_HANDLE) {
+      const auto &statistics = micromap_statistics;
+      ImGui::Text("micromap: %.1f KiB", opacity_micromap.GetSize() / 1024.0f);
+      ImGui::Text("triangles opaque: %u, transparent: %u, subdivided: %u, any-hit: %u", statistics.opaque_triangles_,
+                  statistics.transparent_triangles_, statistics.subdivided_triangles_, statistics.unknown_triangles_);
+      ImGui::Text("unknown micro-triangles: %llu of %llu", (unsigned long long)statistics.unknown_micro_triangles_,
+                  (unsigned long long)statistics.micro_triangles_);
+    }
+    if (progressive && cpu_fallback == false) {
+      auto seconds = accumulation_seconds;
+      auto extent = Application::Get()->GetSwapchain().GetExtent();
+      auto samples = double(accumulated_samples) * extent.width * extent.height;
+      ImGui::Text("samples per pixel: %u", accumulated_samples);
+      ImGui::Text("converging for: %.2f s", seconds);
+      ImGui::Text("throughput: %.2f Msamples/s", seconds > 0.0f ? samples / seconds / 1.0e6 : 0.0);
+    }
+    if (wavefront && cpu_fallback == false) {
+      const auto &ms = wavefront_tracer.GetStageMilliseconds();
+      ImGui::Text("generate: %.3f ms, extend: %.3f ms, sort: %.3f ms", ms[0], ms[1], ms[2]);
+      ImGui::Text("shade: %.3f ms, shadow: %.3f ms, resolve: %.3f ms", ms[3], ms[4], ms[5]);
+    }
+    Pick(position);
     ImGui::End();
+    temp_culling.camera_position_ = position;
+    temp_culling.relevance_min_ = position - Vector3f(relevance_extent);
+    temp_culling.relevance_max_ = position + Vector3f(relevance_extent);
+    auto culling_changed = temp_culling.camera_position_ != culling.camera_position_ || temp_culling.max_distance_ != culling.max_distance_ ||
+                           temp_culling.relevance_min_ != culling.relevance_min_ || temp_culling.error_threshold_ != culling.error_threshold_;
+    bool reset = position != camera.GetPosition() || temp_rotation != rotation || culling_changed;
+    reset = reset || cpu_fallback != last_cpu_fallback || progressive != last_progressive || wavefront != last_wavefront;
+    reset = reset || samples_per_frame != last_samples_per_frame || max_bounces != last_max_bounces || animate;
+    if (reset) ResetAccumulation();
     camera.SetPosition(position);
-    dirty = temp_rotation != rotation;
+    dirty = dirty || temp_rotation != rotation || culling_changed;
+    instances_dirty = instances_dirty || temp_rotation != rotation;
     rotation = temp_rotation;
+    culling = temp_culling;
+    last_cpu_fallback = cpu_fallback;
+    last_wavefront = wavefront;
+    last_progressive = progressive;
+    last_samples_per_frame = samples_per_frame;
+    last_max_bounces = max_bounces;
+    if (animate) animation_time += ImGui::GetIO().DeltaTime;
+    skinned = skinned && animate == false;
+    dynamic_structures.SetPolicy(RefitPolicy(max_refits, max_bounds_growth));
+  }
+
+  // THE CPU POSES ARE ONLY REFIT ON A CLICK, HOVERING KEEPS SHOWING THE LAST PICK
+  void Pick(const Vector3f &camera_position) {
+    auto &io = ImGui::GetIO();
+    if (io.WantCaptureMouse == false && ImGui::IsMouseClicked(ImGuiMouseButton_Left)) {
+      auto extent = Application::Get()->GetSwapchain().GetExtent();
+      Ray ray;
+      ray.origin_ = camera_position;
+      ray.direction_ = GetRayDirection(Vector2f(io.MousePos.x, io.MousePos.y), float(extent.width));
+      UpdateCPUPoses();
+      uint32_t instance_index = 0;
+      auto scene = CPUScene(pose_bvhs, pose_vertices, rotation);
+      auto hit = scene.Intersect(ray, instance_index);
+      pick_result.reset();
+      if (hit.IsHit()) {
+        const auto &triangle = scene.GetBoundingVolumeHierarchy(instance_index).GetTriangle(hit.triangle_index_);
+        pick_result = PickResult(instance_index, triangle.mesh_index_, hit.triangle_index_, hit.t_);
+      }
+    }
+    if (pick_result) {
+      const auto &[instance_index, mesh_index, triangle_index, t] = *pick_result;
+      ImGui::Text("picked: instance %u, mesh %u, triangle %u, t %.2f", instance_index, mesh_index, triangle_index, t);
+    } else {
+      ImGui::Text("picked: nothing");
+    }
+  }
+
+  void RenderCPU(CommandBuffer &command_buffer, const Extent2D &extent) {
+    Buffer staging_buffer(std::size_t(extent.width) * extent.height * sizeof(Vector4f), BufferUsageMaskBits::E_TRANSFER_SRC_BIT, Buffer::MAPPED);
+    UpdateCPUPoses();
+    auto pixels = staging_buffer.GetMappedData<Vector4f>();
+    CPUScene(pose_bvhs, pose_vertices, rotation).Render(extent.width, extent.height, camera.GetPosition(), pixels);
+    staging_buffer.Flush();
+    target_image.CommandSetImageData(command_buffer, staging_buffer.GetHandle(), 0, staging_buffer.GetSize());
+    GraphicsContext::Get()->DeferDestruction(std::move(staging_buffer));
+  }
+
+  // THE CPU HIERARCHIES ARE REFIT TO THE POSES Skin UPLOADS, AT MOST ONCE PER FRAME AND ONLY FOR A PICK OR THE CPU FALLBACK
+  void UpdateCPUPoses() {
+    if (cpu_pose_time == animation_time) return;
+    auto vertices_count = model.GetVerticesNumber();
+    pose_vertices.resize(POSES_COUNT * vertices_count);
+    std::vector<Vector3f> positions(vertices_count);
+    for (auto pose = 0; pose < POSES_COUNT; pose++) {
+      auto vertices = std::span(pose_vertices).subspan(pose * vertices_count, vertices_count);
+      SkinVertices(model.GetVertices(), sway_rig, GetSwayPose(rest_bounds, animation_time, pose), vertices);
+      std::ranges::transform(vertices, positions.begin(), [](const Vertex &vertex) { return vertex.position_; });
+      pose_bvhs[pose].Refit(positions);
+    }
+    cpu_pose_time = animation_time;
+  }
+
+  void ResetAccumulation() {
+    accumulated_samples = 0;
+    accumulation_seconds = 0.0f;
+    accumulation_start = std::chrono::steady_clock::now();
   }
 
   void OnSwapchain() override {
     auto &swapchain = Application::Get()->GetSwapchain();
     auto &[width, height] = swapchain.GetExtent();
-    target_image = Image2D(width, height, Format::E_R32G32B32A32_SFLOAT, ImageUsageMaskBits::E_SAMPLED_BIT | ImageUsageMaskBits::E_STORAGE_BIT);
+    target_image = Image2D(width, height, Format::E_R32G32B32A32_SFLOAT, TARGET_USAGE);
+    GraphicsContext::Get()->DeferDestruction(std::move(wavefront_tracer));
+    wavefront_tracer = WavefrontTracer(width, height);
+    ResetAccumulation();
+    dirty = true;
+  }
+
+  void Skin(CommandBuffer &command_buffer) {
+    std::vector<Matrix4f> joints;
+    for (auto pose = 0; pose < POSES_COUNT; pose++) {
+      auto pose_joints = GetSwayPose(rest_bounds, animation_time, pose);
+      auto pose_bounds = GetPoseBounds(rest_bounds, pose_joints);
+      joints.insert(joints.end(), pose_joints.begin(), pose_joints.end());
+      // EVERY LOD OF EVERY POSE IS REFIT: THE PREPARATION PASS PICKS THE LODS ON THE DEVICE, SO THE HOST CANNOT SKIP THE
+      // UNUSED ONES WITHOUT A READBACK, AND A STALE ONE COULD BE PICKED BY THE NEXT CULL. EACH LOD HALVES THE TRIANGLES,
+      // SO THE TWO COARSER ONES ADD ABOUT THREE QUARTERS OF THE COST OF REFITTING THE FULL DETAIL ONE
+      for (auto lod = 0; lod < LODS_COUNT; lod++) {
+        dynamic_structures.Update(pose * LODS_COUNT + lod, pose_bounds.min_, pose_bounds.max_);
+      }
+    }
+
+    // EARLIER FRAMES MAY STILL READ THE JOINTS AND THE SKINNED VERTICES
+    auto readers = PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT | PipelineStageMaskBits2::E_RAY_TRACING_SHADER_BIT_KHR |
+                   PipelineStageMaskBits2::E_ACCELERATION_STRUCTURE_BUILD_BIT_KHR;
+    command_buffer.CommandMemoryBarrier(readers, AccessMask2(), PipelineStageMaskBits2::E_ALL_TRANSFER_BIT, AccessMask2());
+    command_buffer.CommandUpdateBuffer(joint_buffer.GetHandle(), 0, std::as_bytes(std::span(joints)));
+    command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_ALL_TRANSFER_BIT, AccessMaskBits2::E_TRANSFER_WRITE_BIT,
+                                        PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT, AccessMaskBits2::E_SHADER_STORAGE_READ_BIT);
+
+    command_buffer.CommandBindPipeline(skinning_pipeline.GetPipeline(), PipelineBindPoint::E_COMPUTE);
+    command_buffer.CommandPushConstants(skinning_pipeline.GetPipelineLayout(), ShaderStageMaskBits::E_COMPUTE_BIT, skinning_constants);
+    command_buffer.CommandPushDescriptorSet(skinning_pipeline.GetPushDescriptorTemplate(), skinning_descriptors);
+    command_buffer.CommandDispatch((skinning_constants.vertices_count + SKINNING_GROUP_SIZE - 1) / SKINNING_GROUP_SIZE, POSES_COUNT);
+    // THE WAVEFRONT TRACER READS THE SKINNED VERTICES AS A STORAGE BUFFER IN COMPUTE
+    command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT, AccessMaskBits2::E_SHADER_STORAGE_WRITE_BIT,
+                                        PipelineStageMaskBits2::E_ACCELERATION_STRUCTURE_BUILD_BIT_KHR |
+                                          PipelineStageMaskBits2::E_RAY_TRACING_SHADER_BIT_KHR | PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT,
+                                        AccessMaskBits2::E_SHADER_READ_BIT | AccessMaskBits2::E_SHADER_STORAGE_READ_BIT);
+
+    // ONE BATCH REFITS EVERY POSE, THE POLICY REBUILDS THE ONES THAT DRIFTED TOO FAR
+    dynamic_structures.Record(command_buffer);
+  }
+
+  // EVERY POSE HAS A RUN OF LODS_COUNT STRUCTURES, THE PREPARATION PASS PICKS ONE OF THEM PER INSTANCE
+  std::vector<TopLevelInstance> GetTopLevelInstances() const {
+    // THE SWAY ROTATES ABOUT THE PIVOT, A SPHERE AROUND IT BOUNDS EVERY POSE
+    auto pivot = Vector3f(rest_bounds.GetCenter().x, rest_bounds.min_.y, rest_bounds.GetCenter().z);
+    auto extent = rest_bounds.max_ - rest_bounds.min_;
+    auto radius = glm::length(Vector3f(0.5f * extent.x, extent.y, 0.5f * extent.z));
+    std::vector<TopLevelInstance> instances;
+    for (const auto &[instance_index, transform] : std::views::enumerate(GetInstanceTransforms(rotation))) {
+      auto pose = uint32_t(instance_index % POSES_COUNT);
+      auto &instance = instances.emplace_back();
+      instance.transform_ = ConvertTransform(transform);
+      instance.center_ = pivot;
+      instance.radius_ = radius;
+      instance.custom_index_ = uint32_t(instance_index);
+      instance.lods_offset_ = pose * LODS_COUNT;
+      instance.lods_count_ = LODS_COUNT;
+    }
+    return instances;
+  }
+
+  std::vector<TopLevelLod> GetTopLevelLods() const {
+    std::vector<TopLevelLod> lods;
+    for (auto pose = 0; pose < POSES_COUNT; pose++) {
+      for (auto lod = 0; lod < LODS_COUNT; lod++) {
+        auto acceleration_structure = dynamic_structures.GetAccelerationStructure(pose * LODS_COUNT + lod);
+        auto error = 0.0f;
+        for (const auto &mesh : model.GetMeshes()) {
+          error = std::max(error, mesh.lods[std::min(uint32_t(lod), mesh.lods_count - 1)].error);
+        }
+        auto shader_binding_table_offset = uint32_t((pose * LODS_COUNT + lod) * model.GetMeshes().size());
+        lods.emplace_back(GetBottomLevelAccelerationStructuresAddress(acceleration_structure), error, shader_binding_table_offset);
+      }
+    }
+    return lods;
   }
 
   void OnUpdate(CommandBuffer &command_buffer) override {
     auto &swapchain = Application::Get()->GetSwapchain();
     auto extent = swapchain.GetExtent();
 
-    std::array<BottomLevelAccelerationStructureInstances, 1> bottom_instances;
+    // REFITTED BOUNDS ONLY REACH THE RAYS THROUGH A NEW TLAS
+    if (skinned == false) {
+      Skin(command_buffer);
+      skinned = true;
+      dirty = true;
+    }
 
-    for (auto x = 0; x < 10; x++) {
-      for (auto z = 0; z < 10; z++) {
-        Transform transform;
-        transform.SetPosition(Vector3f(30.0f * x, 0.0f, 30.0f * z));
-        transform.SetOrientation(rotation);
-        transform.SetScale(Vector3f(0.2f));
-        bottom_instances[0].instances_.emplace_back(transform.GetModelMatrix());
+    if (instances_dirty) {
+      std::vector<Buffer> build_buffers;
+      instance_preparation.CommandSetInstances(command_buffer, 0, GetTopLevelInstances(), build_buffers);
+      for (auto &build_buffer : build_buffers) {
+        GraphicsContext::Get()->DeferDestruction(std::move(build_buffer));
       }
+      instances_dirty = false;
     }
 
-    bottom_instances[0].acceleration_structure_ = blas.GetAccelerationStructure();
-
     if (dirty) {
-      tlas = AccelerationStructure(bottom_instances);
+      // THE RAYGEN CAMERA HAS A 90 DEGREE HORIZONTAL FIELD OF VIEW
+      culling.projection_scale_ = 0.5f * extent.width;
+      instance_preparation.Record(command_buffer, culling);
       dirty = false;
     }
 
-    target_image.SetImageLayout(ImageLayout::E_GENERAL, &command_buffer);
+    // THE TARGET DOUBLES AS THE ACCUMULATION BUFFER, A CONVERGED STATIC VIEW IS ONLY BLITTED
+    bool single_sample = progressive == false || cpu_fallback;
+    bool converged = accumulated_samples > 0 && (single_sample || accumulated_samples >= max_accumulated_samples);
 
-    command_buffer.CommandBindPipeline(ray_tracing_pipeline.GetPipeline(), PipelineBindPoint::E_RAY_TRACING_KHR);
-    command_buffer.CommandPushDescriptorSet(ray_tracing_pipeline.GetPipelineLayout(), 0, 0, tlas.GetAccelerationStructure(),
-                                            PipelineBindPoint::E_RAY_TRACING_KHR);
-    command_buffer.CommandPushDescriptorSet(std::array{target_image.GetDescriptor()}, ray_tracing_pipeline.GetPipelineLayout(), 0, 1,
-                                            DescriptorType::E_STORAGE_IMAGE, PipelineBindPoint::E_RAY_TRACING_KHR);
+    if (converged == false && cpu_fallback) {
+      RenderCPU(command_buffer, extent);
+      accumulated_samples = 1;
+    } else if (converged == false && wavefront) {
+      target_image.SetImageLayout(ImageLayout::E_GENERAL, &command_buffer);
 
-    command_buffer.CommandPushDescriptorSet(ray_tracing_pipeline.GetPipelineLayout(), 0, 2, vertex_buffer.GetHandle(),
-                                            PipelineBindPoint::E_RAY_TRACING_KHR);
+      WavefrontScene scene;
+      scene.tlas_ = instance_preparation.GetAccelerationStructure();
+      scene.instances_ = instance_preparation.GetInstanceBuffer().GetDescriptor();
+      scene.vertices_ = skinned_buffer.GetDescriptor();
+      scene.indices_ = index_buffer.GetDescriptor();
+      scene.geometry_records_ = geometry_record_buffer.GetDescriptor();
 
-    command_buffer.CommandPushDescriptorSet(ray_tracing_pipeline.GetPipelineLayout(), 0, 3, index_buffer.GetHandle(),
-                                            PipelineBindPoint::E_RAY_TRACING_KHR);
+      WavefrontSettings settings;
+      settings.camera_position_ = camera.GetPosition();
+      settings.accumulated_samples_ = accumulated_samples;
+      settings.samples_per_frame_ = samples_per_frame;
+      settings.max_bounces_ = max_bounces;
+      settings.progressive_ = progressive;
 
-    command_buffer.CommandPushConstants(ray_tracing_pipeline.GetPipelineLayout(), ShaderStageMaskBits::E_RAYGEN_BIT_KHR, camera.GetPosition());
+      wavefront_tracer.Record(command_buffer, scene, settings, target_image.GetDescriptor());
 
-    command_buffer.CommandTraceRay(shader_binding_table.raygen_shader_binding_table_, shader_binding_table.miss_shader_binding_table_,
-                                   shader_binding_table.hit_shader_binding_table_, extent.width, extent.height, 1);
+      target_image.SetImageLayout(ImageLayout::E_SHADER_READ_ONLY_OPTIMAL, &command_buffer);
 
-    target_image.SetImageLayout(ImageLayout::E_SHADER_READ_ONLY_OPTIMAL, &command_buffer);
+      accumulated_samples += progressive ? samples_per_frame : 1;
+      accumulation_seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - accumulation_start).count();
+    } else if (converged == false) {
+      target_image.SetImageLayout(ImageLayout::E_GENERAL, &command_buffer);
+
+      command_buffer.CommandBindPipeline(ray_tracing_pipeline.GetPipeline(), PipelineBindPoint::E_RAY_TRACING_KHR);
+
+      descriptors.tlas = instance_preparation.GetAccelerationStructure();
+      descriptors.target = target_image.GetDescriptor();
+
+      command_buffer.CommandPushDescriptorSet(ray_tracing_pipeline.GetPushDescriptorTemplate(), descriptors);
+      BindlessTable::Get()->CommandBind(command_buffer, ray_tracing_pipeline.GetPipelineLayout(), PipelineBindPoint::E_RAY_TRACING_KHR);
+
+      RayConstants ray_constants;
+      ray_constants.camera_position = camera.GetPosition();
+      ray_constants.accumulated_samples = accumulated_samples;
+      ray_constants.samples_per_frame = samples_per_frame;
+      ray_constants.max_bounces = max_bounces;
+      ray_constants.progressive = progressive;
+
+      command_buffer.CommandPushConstants(ray_tracing_pipeline.GetPipelineLayout(), ShaderStageMaskBits::E_RAYGEN_BIT_KHR, ray_constants);
+
+      command_buffer.CommandTraceRay(shader_binding_table.raygen_shader_binding_table_, shader_binding_table.miss_shader_binding_table_,
+                                     shader_binding_table.hit_shader_binding_table_, shader_binding_table.callable_shader_binding_table_,
+                                     extent.width, extent.height, 1);
+
+      target_image.SetImageLayout(ImageLayout::E_SHADER_READ_ONLY_OPTIMAL, &command_buffer);
+
+      accumulated_samples += progressive ? samples_per_frame : 1;
+      accumulation_seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - accumulation_start).count();
+    }
 
     std::array<RenderingAttachmentInfo, 1> rendering_ai = {};
 
@@ -84,8 +510,7 @@ public:
     command_buffer.CommandSetScissor(0, 0, extent.width, extent.height);
     command_buffer.CommandBindPipeline(graphics_pipeline_.GetPipeline(), PipelineBindPoint::E_GRAPHICS);
 
-    command_buffer.CommandPushDescriptorSet(std::array{target_image.GetDescriptor()}, graphics_pipeline_.GetPipelineLayout(), 0, 0,
-                                            DescriptorType::E_COMBINED_IMAGE_SAMPLER, PipelineBindPoint::E_GRAPHICS);
+    command_buffer.CommandPushDescriptorSet(graphics_pipeline_.GetPushDescriptorTemplate(), target_image.GetDescriptor());
 
     command_buffer.CommandDraw(6);
     command_buffer.CommandEndRendering();
@@ -100,40 +525,73 @@ public:
     dispatcher.Dispatch<WindowResizeEvent>(BIND_FUNCTION(RayTracer::OnResize));
   }
 
-  void BuildAcceleration() {
-
-    BottomLevelGeometry geometry;
-    TriangleGeometrySpecification specification;
-    specification.vertices_count_ = model.GetVerticesNumber();
-    specification.indices_count_ = model.GetIndicesNumber();
-    specification.vbo_offset_ = vertex_buffer.GetBufferAddress();
-    specification.ibo_offset_ = index_buffer.GetBufferAddress();
-    specification.vertex_stride_ = sizeof(Vertex);
-    geometry.AddTriangleGeometry(specification);
-
-    blas = AccelerationStructure(geometry);
-
-    std::array<BottomLevelAccelerationStructureInstances, 1> bottom_instances;
+  // ALPHA TESTED MESHES ARE NON OPAQUE, THE MICROMAP RESOLVES WHAT IT CAN SO ANY-HIT ONLY RUNS ON PARTIALLY COVERED MICRO-TRIANGLES
+  std::vector<std::vector<MicromapUsageEXT>> BakeOpacityMicromap() {
+    if (GraphicsContext::Get()->IsOpacityMicromapEnabled() == false) return {};
+    OpacityMicromapBakeSpecification bake_specification;
+    auto max_level = GraphicsContext::Get()->GetOpacityMicromapProperties().maxOpacity4StateSubdivisionLevel;
+    bake_specification.max_subdivision_level_ = std::min(bake_specification.max_subdivision_level_, max_level);
+    auto baked = Innsmouth::BakeOpacityMicromap(model, bake_specification);
+    micromap_statistics = baked.statistics_;
 
-    rotation = Vector3f(0.0f, PI_ / 2.0f, 0.0f);
+    std::vector<Buffer> micromap_buffers;
+    CommandBuffer command_buffer(GraphicsContext::Get()->GetGraphicsQueueIndex());
+    command_buffer.Begin();
+    opacity_micromap = OpacityMicromap(command_buffer, baked.data_, baked.triangles_, baked.indices_, micromap_buffers);
+    auto micromap_build = PipelineStageMaskBits2::E_MICROMAP_BUILD_BIT_EXT;
+    auto acceleration_build = PipelineStageMaskBits2::E_ACCELERATION_STRUCTURE_BUILD_BIT_KHR;
+    command_buffer.CommandMemoryBarrier(micromap_build, AccessMaskBits2::E_MICROMAP_WRITE_BIT_EXT, acceleration_build,
+                                        AccessMaskBits2::E_MICROMAP_READ_BIT_EXT);
+    command_buffer.End();
+    command_buffer.Submit();
+    return baked.mesh_usage_counts_;
+  }
 
-    for (auto x = 0; x < 10; x++) {
-      for (auto z = 0; z < 10; z++) {
-        Transform transform;
-        transform.SetPosition(Vector3f(30.0f * x, 0.0f, 30.0f * z));
-        transform.SetOrientation(rotation);
-        transform.SetScale(Vector3f(0.2f));
-        bottom_instances[0].instances_.emplace_back(transform.GetModelMatrix());
+  void BuildAcceleration() {
+    auto mesh_usage_counts = BakeOpacityMicromap();
+
+    // ONE BLAS PER POSE AND LOD OVER THE COPY OF THE SKINNED VERTICES OF THE POSE, BUILT BY THE FIRST Skin
+    std::vector<BottomLevelGeometry> geometries(POSES_COUNT * LODS_COUNT);
+    for (auto pose = 0; pose < POSES_COUNT; pose++) {
+      for (auto lod = 0; lod < LODS_COUNT; lod++) {
+        for (const auto &[mesh_index, mesh] : std::views::enumerate(model.GetMeshes())) {
+          const auto &mesh_lod = mesh.lods[std::min(uint32_t(lod), mesh.lods_count - 1)];
+          TriangleGeometrySpecification specification;
+          specification.vertices_count_ = model.GetVerticesNumber();
+          specification.indices_count_ = mesh_lod.indices_size;
+          specification.vbo_offset_ = skinned_buffer.GetBufferAddress() + pose * model.GetVerticesNumber() * sizeof(Vertex);
+          specification.ibo_offset_ = index_buffer.GetBufferAddress();
+          specification.first_index_ = mesh_lod.indices_offset;
+          specification.vertex_stride_ = sizeof(Vertex);
+          specification.opaque_ = mesh.alpha_cutoff <= 0.0f;
+          // THE MICROMAP IS BAKED FOR THE FULL DETAIL TRIANGLES ONLY, SIMPLIFIED ONES LEAVE THE TEST TO ANY-HIT
+          auto baked = mesh_lod.indices_offset == mesh.indices_offset;
+          if (specification.opaque_ == false && baked && opacity_micromap.GetMicromap() != VK_NULL_HANDLE) {
+            specification.opacity_micromap_ = opacity_micromap.GetMicromap();
+            specification.opacity_micromap_indices_ = opacity_micromap.GetIndicesAddress(mesh.indices_offset / 3);
+            specification.opacity_micromap_usage_counts_ = mesh_usage_counts[mesh_index];
+          }
+          geometries[pose * LODS_COUNT + lod].AddTriangleGeometry(specification);
+        }
       }
     }
+    dynamic_structures = DynamicAccelerationStructures(geometries, RefitPolicy(max_refits, max_bounds_growth));
+    instance_preparation = InstancePreparation(GetTopLevelInstances(), GetTopLevelLods());
 
-    bottom_instances[0].acceleration_structure_ = blas.GetAccelerationStructure();
+    rotation = Vector3f(0.0f, PI_ / 2.0f, 0.0f);
+    dirty = true;
+    instances_dirty = true;
 
-    tlas = AccelerationStructure(bottom_instances);
+    BoundingVolumeHierarchySpecification bvh_specification;
+    bvh_specification.flatten_instances_ = false;
+    pose_bvhs.fill(BoundingVolumeHierarchy(model, bvh_specification));
+    cpu_pose_time = -1.0f;
   }
 
   void SetBuffers() {
-    model = Model(model_path);
+    ModelSpecification model_specification;
+    model_specification.lods_count_ = LODS_COUNT;
+    model = Model(model_path, model_specification);
 
     CommandBuffer command_buffer(GraphicsContext::Get()->GetGraphicsQueueIndex());
     Buffer staging(400_MiB, BufferUsageMaskBits::E_TRANSFER_SRC_BIT, AllocationCreateMaskBits::E_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
@@ -158,6 +616,27 @@ public:
 
     command_buffer.End();
     command_buffer.Submit();
+
+    for (const auto &vertex : model.GetVertices()) {
+      rest_bounds.Extend(vertex.position_);
+    }
+    sway_rig = GetSwayRig(model, rest_bounds);
+
+    BufferUsageMask storage_usage = BufferUsageMaskBits::E_STORAGE_BUFFER_BIT | BufferUsageMaskBits::E_TRANSFER_DST_BIT;
+    skinned_buffer = Buffer(POSES_COUNT * offset, BufferUsageMaskBits::E_STORAGE_BUFFER_BIT | usage, {});
+    skin_buffer = Buffer(sway_rig.size() * sizeof(SkinVertex), storage_usage, Buffer::CPU);
+    skin_buffer.SetData<SkinVertex>(sway_rig);
+    joint_buffer = Buffer(POSES_COUNT * JOINTS_COUNT * sizeof(Matrix4f), storage_usage, {});
+
+    skinning_constants.vertices_count = model.GetVerticesNumber();
+    skinning_constants.joints_count = JOINTS_COUNT;
+    skinning_descriptors.rest_vertices = vertex_buffer.GetDescriptor();
+    skinning_descriptors.vertices = skinned_buffer.GetDescriptor();
+    skinning_descriptors.skin = skin_buffer.GetDescriptor();
+    skinning_descriptors.joints = joint_buffer.GetDescriptor();
+
+    descriptors.vertices = skinned_buffer.GetDescriptor();
+    descriptors.indices = index_buffer.GetDescriptor();
   }
 
   void CreateGraphicsPipeline() {
@@ -167,45 +646,156 @@ public:
     graphics_pipeline_ = GraphicsPipeline(specification);
   }
 
+  ~RayTracer() {
+    for (auto texture_slot : texture_slots) {
+      BindlessTable::Get()->Release(BindlessBinding::E_TEXTURE, texture_slot);
+    }
+  }
+
   void OnAttach() override {
     auto root = GetInnsmouthShadersDirectory();
     std::vector<ShaderGroupPaths> shader_groups = {{root / "ray" / "mesh.rgen.spv"},
                                                    {root / "ray" / "mesh.rmiss.spv"},
-                                                   {root / "ray" / "mesh.rchit.spv"}};
-    ray_tracing_pipeline = RayTracingPipeline(shader_groups, 1);
-
-    shader_binding_table = ShaderBindingTable(ray_tracing_pipeline.GetPipeline(), {1, 1, 1, 0});
+                                                   {root / "ray" / "mesh.rchit.spv", root / "ray" / "mesh.rahit.spv"}};
+    PipelineCreateMask pipeline_create_mask;
+    if (GraphicsContext::Get()->IsOpacityMicromapEnabled()) {
+      pipeline_create_mask = PipelineCreateMaskBits::E_RAY_TRACING_OPACITY_MICROMAP_BIT_EXT;
+    }
+    ray_tracing_pipeline = RayTracingPipeline(shader_groups, 1, pipeline_create_mask);
+    skinning_pipeline = ComputePipeline(root / "ray" / "skinning.comp.spv");
 
     SetBuffers();
+
+    // A FULL TABLE GIVES INVALID_SLOT, WHICH THE RECORDS READ AS -1 AND SHADE UNTEXTURED
+    for (const auto &image : model.GetImages()) {
+      texture_slots.emplace_back(BindlessTable::Get()->AddTexture(image.GetDescriptor()));
+    }
+
+    // ONE HIT RECORD PER GEOMETRY, POSE AND LOD, THE INSTANCE OFFSET SELECTS THE STRUCTURE AND gl_GeometryIndexEXT THE MESH
+    // THE WAVEFRONT TRACER READS THE SAME RECORDS FROM A STORAGE BUFFER
+    std::vector<GeometryRecord> geometry_records;
+    ShaderBindingTableBuilder builder({1, 1, 1, 0});
+    builder.AddRecord(ShaderRecordRegion::E_RAYGEN, 0);
+    builder.AddRecord(ShaderRecordRegion::E_MISS, 0);
+    for (auto pose = 0; pose < POSES_COUNT; pose++) {
+      auto vertex_offset = uint32_t(pose * model.GetVerticesNumber());
+      for (auto lod = 0; lod < LODS_COUNT; lod++) {
+        for (const auto &[mesh_index, mesh] : std::views::enumerate(model.GetMeshes())) {
+          const auto &mesh_lod = mesh.lods[std::min(uint32_t(lod), mesh.lods_count - 1)];
+          // RECORDS HOLD BINDLESS SLOTS, NOT MODEL IMAGE INDICES
+          auto color_texture_slot = mesh.color_texture_index < 0 ? -1 : int32_t(texture_slots[mesh.color_texture_index]);
+          auto normal_texture_slot = mesh.normal_texture_index < 0 ? -1 : int32_t(texture_slots[mesh.normal_texture_index]);
+          auto geometry_record = GeometryRecord(mesh_lod.indices_offset, uint32_t(mesh_index), color_texture_slot, normal_texture_slot,
+                                                vertex_offset, mesh.alpha_cutoff);
+          builder.AddRecord(ShaderRecordRegion::E_HIT, 0, geometry_record);
+          geometry_records.emplace_back(geometry_record);
+        }
+      }
+    }
+    shader_binding_table = ShaderBindingTable(ray_tracing_pipeline.GetPipeline(), builder);
+    geometry_record_buffer = Buffer(geometry_records.size() * sizeof(GeometryRecord), BufferUsageMaskBits::E_STORAGE_BUFFER_BIT, Buffer::CPU);
+    geometry_record_buffer.SetData<GeometryRecord>(geometry_records);
+
     BuildAcceleration();
     CreateGraphicsPipeline();
 
     auto &swapchain = Application::Get()->GetSwapchain();
     auto &[width, height] = swapchain.GetExtent();
 
-    target_image = Image2D(width, height, Format::E_R32G32B32A32_SFLOAT, ImageUsageMaskBits::E_SAMPLED_BIT | ImageUsageMaskBits::E_STORAGE_BIT);
+    target_image = Image2D(width, height, Format::E_R32G32B32A32_SFLOAT, TARGET_USAGE);
+    wavefront_tracer = WavefrontTracer(width, height);
+    ResetAccumulation();
   }
 
 private:
   Buffer vertex_buffer;
   Buffer index_buffer;
+  Buffer skinned_buffer;
+  Buffer skin_buffer;
+  Buffer joint_buffer;
   RayTracingPipeline ray_tracing_pipeline;
   GraphicsPipeline graphics_pipeline_;
+  ComputePipeline skinning_pipeline;
   ShaderBindingTable shader_binding_table;
-  AccelerationStructure blas;
-  AccelerationStructure tlas;
+  Buffer geometry_record_buffer;
+  WavefrontTracer wavefront_tracer;
+  DynamicAccelerationStructures dynamic_structures;
+  OpacityMicromap opacity_micromap;
+  OpacityMicromapStatistics micromap_statistics;
+  std::vector<uint32_t> texture_slots;
+  InstancePreparation instance_preparation;
+  InstanceCullingSpecification culling = {Vector3f(0.0f), 400.0f};
+  float relevance_extent = 300.0f;
+  bool instances_dirty = false;
+  SkinningConstants skinning_constants;
+  SkinningDescriptors skinning_descriptors;
+  BoundingBox rest_bounds;
+  float animation_time = 0.0f;
+  bool animate = false;
+  bool skinned = false;
+  int32_t max_refits = 120;
+  float max_bounds_growth = 1.5f;
   Image2D target_image;
   Camera camera;
   Vector3f rotation;
+  std::vector<SkinVertex> sway_rig;
+  std::array<BoundingVolumeHierarchy, POSES_COUNT> pose_bvhs;
+  std::vector<Vertex> pose_vertices;
+  float cpu_pose_time = -1.0f;
+  std::optional<PickResult> pick_result;
+  bool cpu_fallback = false;
+  bool last_cpu_fallback = false;
+  bool wavefront = false;
+  bool last_wavefront = false;
+  bool progressive = true;
+  bool last_progressive = true;
+  int32_t samples_per_frame = 4;
+  int32_t last_samples_per_frame = 4;
+  int32_t max_bounces = 4;
+  int32_t last_max_bounces = 4;
+  uint32_t accumulated_samples = 0;
+  uint32_t max_accumulated_samples = 16384;
+  std::chrono::steady_clock::time_point accumulation_start;
+  float accumulation_seconds = 0.0f;
+  RayDescriptors descriptors;
   Model model;
 };
 
+// HEADLESS CPU RENDER TO A PORTABLE FLOAT MAP, NEEDS NO VULKAN DEVICE
+int RenderOffline(const std::filesystem::path &output_path) {
+  ModelSpecification model_specification;
+  model_specification.load_images_ = false;
+  Model model(model_path, model_specification);
+
+  BoundingVolumeHierarchySpecification bvh_specification;
+  bvh_specification.flatten_instances_ = false;
+  BoundingVolumeHierarchy bvh(model, bvh_specification);
+
+  constexpr uint32_t width = 1280;
+  constexpr uint32_t height = 720;
+  std::vector<Vector4f> pixels(width * height);
+  // NO ANIMATION CLOCK HERE, EVERY INSTANCE SHOWS THE REST POSE
+  CPUScene(std::span(&bvh, 1), model.GetVertices(), Vector3f(0.0f, PI_ / 2.0f, 0.0f)).Render(width, height, Camera().GetPosition(), pixels);
+
+  std::ofstream file(output_path, std::ios::binary);
+  file << "PF\n" << width << " " << height << "\n-1.0\n";
+  for (auto y = height; y-- > 0;) {
+    for (auto x = 0; x < width; x++) {
+      file.write(reinterpret_cast<const char *>(&pixels[y * width + x]), 3 * sizeof(float));
+    }
+  }
+  std::println("{0} triangles, {1} nodes, written {2}", bvh.GetTrianglesCount(), bvh.GetNodes().size(), output_path.string());
+  return 0;
+}
+
 int main(int argc, char **argv) {
 
   if (argc == 1) return 0;
 
   model_path = argv[1];
 
+  if (argc == 4 && std::string_view(argv[2]) == "--cpu") return RenderOffline(argv[3]);
+
   Application application;
 
   RayTracer ray_tracer;
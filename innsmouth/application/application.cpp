@@ -1,10 +1,16 @@
 #include "application.h"
 #include "innsmouth/graphics/core/structure_tools.h"
+#include <array>
 
 namespace Innsmouth {
 
 Application *Application::application_instance_ = nullptr;
 
+DeferredDeletionFlush::~DeferredDeletionFlush() {
+  vkDeviceWaitIdle(GraphicsContext::Get()->GetDevice());
+  GraphicsContext::Get()->GetDeletionQueue().Flush();
+}
+
 Application *Application::Get() {
   return application_instance_;
 }
@@ -13,6 +19,10 @@ Application::Application()
   : main_window_("Innsmouth", 800, 600),                                                                                   //
     graphics_context_(),                                                                                                   //
     graphics_allocator_(),                                                                                                 //
+    bindless_table_(),                                                                                                     //
+    sampler_cache_(),                                                                                                      //
+    image_view_cache_(),                                                                                                   //
+    deferred_deletion_flush_(),                                                                                            //
     command_pool_(GraphicsContext::Get()->GetGraphicsQueueIndex(), CommandPoolCreateMaskBits::E_RESET_COMMAND_BUFFER_BIT), //
     swapchain_(main_window_.GetNativeWindow()), imgui_layer_(&main_window_), imgui_renderer_(swapchain_.GetFormat()) {
   Initialize();
@@ -25,7 +35,7 @@ Application::Application()
 
 void Application::Initialize() {
   for (const auto &image_view : swapchain_.GetImageViews()) {
-    fences_.emplace_back(FenceCreateMaskBits::E_SIGNALED_BIT);
+    frame_timeline_values_.emplace_back(0);
     command_buffers_.emplace_back(command_pool_.GetHandle());
     image_available_semaphores.emplace_back();
     render_finished_semaphores.emplace_back();
@@ -44,13 +54,13 @@ void Application::OnEvent(Event &event) {
 }
 
 void Application::Run() {
-
-  VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+  auto &graphics_timeline = GraphicsContext::Get()->GetGraphicsTimeline();
 
   while (main_window_.ShouldClose() == false) {
     main_window_.PollEvents();
 
-    fences_[current_frame_].Wait();
+    graphics_timeline.Wait(frame_timeline_values_[current_frame_]);
+    GraphicsContext::Get()->RetireFrame(frame_timeline_values_[current_frame_]);
 
     auto result = swapchain_.AcquireNextImage(image_available_semaphores[current_frame_]);
 
@@ -64,8 +74,6 @@ void Application::Run() {
       VK_CHECK(result);
     }
 
-    fences_[current_frame_].Reset();
-
     command_buffers_[current_frame_].Reset();
     command_buffers_[current_frame_].Begin();
 
@@ -98,19 +106,10 @@ void Application::Run() {
     auto index = swapchain_.GetCurrentImageIndex();
     auto &render_finished_semaphore = render_finished_semaphores[index];
 
-    VkSubmitInfo submit_info{};
-    {
-      submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-      submit_info.waitSemaphoreCount = 1;
-      submit_info.pWaitSemaphores = image_available_semaphores[current_frame_].get();
-      submit_info.pWaitDstStageMask = wait_stages;
-      submit_info.commandBufferCount = 1;
-      submit_info.pCommandBuffers = command_buffers_[current_frame_].get();
-      submit_info.signalSemaphoreCount = 1;
-      submit_info.pSignalSemaphores = render_finished_semaphore.get();
-    }
+    std::array wait_semaphores = {image_available_semaphores[current_frame_].GetSubmitInfo(PipelineStageMaskBits2::E_COLOR_ATTACHMENT_OUTPUT_BIT)};
+    std::array signal_semaphores = {render_finished_semaphore.GetSubmitInfo(PipelineStageMaskBits2::E_ALL_COMMANDS_BIT)};
 
-    VK_CHECK(vkQueueSubmit(GraphicsContext::Get()->GetGraphicsQueue(), 1, &submit_info, fences_[current_frame_].GetHandle()));
+    frame_timeline_values_[current_frame_] = command_buffers_[current_frame_].Submit(wait_semaphores, signal_semaphores);
 
     result = swapchain_.Present(render_finished_semaphore.get());
 
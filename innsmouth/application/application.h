@@ -5,16 +5,24 @@
 #include "innsmouth/graphics/presentation/swapchain.h"
 #include "innsmouth/graphics/graphics_context/graphics_context.h"
 #include "innsmouth/graphics/graphics_context/graphics_allocator.h"
-#include "innsmouth/graphics/synchronization/fence.h"
+#include "innsmouth/graphics/synchronization/timeline_semaphore.h"
 #include "innsmouth/graphics/synchronization/semaphore.h"
 #include "innsmouth/graphics/command/command_buffer.h"
 #include "innsmouth/graphics/command/command_pool.h"
+#include "innsmouth/graphics/descriptors/bindless_table.h"
+#include "innsmouth/graphics/image/sampler_cache.h"
+#include "innsmouth/graphics/image/image_view_cache.h"
 #include "innsmouth/gui/imgui/imgui_layer.h"
 #include "innsmouth/gui/imgui/imgui_renderer.h"
 #include "layer.h"
 
 namespace Innsmouth {
 
+// RUNS EVERY DEFERRED DELETER WHEN DESTROYED
+struct DeferredDeletionFlush {
+  ~DeferredDeletionFlush();
+};
+
 class Application {
 
 public:
@@ -38,11 +46,16 @@ private:
   Window main_window_;
   GraphicsContext graphics_context_;
   GraphicsAllocator graphics_allocator_;
+  BindlessTable bindless_table_;
+  SamplerCache sampler_cache_;
+  ImageViewCache image_view_cache_;
+  // DESTROYED AFTER EVERY MEMBER BELOW AND BEFORE THE CACHES AND THE ALLOCATOR ABOVE, WHICH THE DELETERS STILL USE
+  DeferredDeletionFlush deferred_deletion_flush_;
   CommandPool command_pool_;
   Swapchain swapchain_;
   ImGuiLayer imgui_layer_;
   ImGuiRenderer imgui_renderer_;
-  std::vector<Fence> fences_;
+  std::vector<uint64_t> frame_timeline_values_;
   std::vector<Semaphore> image_available_semaphores;
   std::vector<Semaphore> render_finished_semaphores;
   std::vector<CommandBuffer> command_buffers_;
@@ -0,0 +1,658 @@
+#include "innsmouth/asset/include/bounding_volume_hierarchy.h"
+#include "innsmouth/asset/include/model.h"
+#include "innsmouth/core/include/core.h"
+#include "innsmouth/core/include/parallel_for.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <future>
+#include <ranges>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Innsmouth {
+
+constexpr uint32_t BVH_STACK_SIZE = 256;
+constexpr uint32_t BVH_CHUNK_SIZE = 4096;
+constexpr float SAH_TRAVERSAL_COST = 1.0f;
+constexpr float SAH_BLOCK_COST = 1.0f;
+constexpr float MINIMUM_DIRECTION = 1.0e-20f;
+
+bool RayHit::IsHit() const {
+  return triangle_index_ != BVH_INVALID_INDEX;
+}
+
+void BoundingBox::Extend(const Vector3f &point) {
+  min_ = glm::min(min_, point);
+  max_ = glm::max(max_, point);
+}
+
+void BoundingBox::Extend(const BoundingBox &bounding_box) {
+  min_ = glm::min(min_, bounding_box.min_);
+  max_ = glm::max(max_, bounding_box.max_);
+}
+
+Vector3f BoundingBox::GetCenter() const {
+  return 0.5f * (min_ + max_);
+}
+
+float BoundingBox::GetSurfaceArea() const {
+  if (IsValid() == false) return 0.0f;
+  auto extent = max_ - min_;
+  return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+}
+
+bool BoundingBox::IsValid() const {
+  return min_.x <= max_.x && min_.y <= max_.y && min_.z <= max_.z;
+}
+
+// BUILD
+
+struct BuildNode {
+  BoundingBox bounds_;
+  uint32_t left_ = 0;
+  uint32_t right_ = 0;
+  uint32_t first_ = 0;
+  uint32_t count_ = 0;
+};
+
+struct BuildBin {
+  BoundingBox bounds_;
+  uint32_t count_ = 0;
+};
+
+struct BuildSplit {
+  float cost_ = std::numeric_limits<float>::max();
+  uint32_t axis_ = 0;
+  uint32_t bin_ = 0;
+};
+
+// PER THREAD, SIZED ONCE FOR THE BIN COUNT AND REUSED BY EVERY NODE THE THREAD SPLITS
+struct BuildScratch {
+  std::vector<BuildBin> bins_;
+  std::vector<float> right_areas_;
+  std::vector<uint32_t> right_counts_;
+
+  explicit BuildScratch(uint32_t bins_count) : bins_(bins_count), right_areas_(bins_count), right_counts_(bins_count) {
+  }
+};
+
+struct BuildContext {
+  std::span<const BoundingBox> triangle_bounds_;
+  std::span<const Vector3f> centroids_;
+  std::span<uint32_t> triangle_ids_;
+  BoundingVolumeHierarchySpecification specification_;
+};
+
+uint32_t GetBlocksCount(uint32_t triangles_count) {
+  return (triangles_count + BVH_WIDTH - 1) / BVH_WIDTH;
+}
+
+uint32_t GetBin(float centroid, float minimum, float scale, uint32_t bins_count) {
+  return std::min(bins_count - 1, uint32_t(std::max(0.0f, (centroid - minimum) * scale)));
+}
+
+BuildSplit FindSplit(const BuildContext &context, BuildScratch &scratch, uint32_t begin, uint32_t end, const BoundingBox &bounds,
+                     const BoundingBox &centroid_bounds) {
+  auto bins_count = context.specification_.bins_count_;
+  auto &bins = scratch.bins_;
+  auto &right_areas = scratch.right_areas_;
+  auto &right_counts = scratch.right_counts_;
+  BuildSplit split;
+
+  for (auto axis = 0; axis < 3; axis++) {
+    auto extent = centroid_bounds.max_[axis] - centroid_bounds.min_[axis];
+    if (extent <= 0.0f) continue;
+    auto scale = float(bins_count) / extent;
+
+    std::ranges::fill(bins, BuildBin());
+    for (auto i = begin; i < end; i++) {
+      auto triangle = context.triangle_ids_[i];
+      auto &bin = bins[GetBin(context.centroids_[triangle][axis], centroid_bounds.min_[axis], scale, bins_count)];
+      bin.bounds_.Extend(context.triangle_bounds_[triangle]);
+      bin.count_++;
+    }
+
+    // SWEEP FROM THE RIGHT ONCE, THEN EVALUATE EVERY PLANE FROM THE LEFT
+    BoundingBox right_bounds;
+    uint32_t right_count = 0;
+    for (auto i = bins_count - 1; i > 0; i--) {
+      right_bounds.Extend(bins[i].bounds_);
+      right_count += bins[i].count_;
+      right_areas[i] = right_bounds.GetSurfaceArea();
+      right_counts[i] = right_count;
+    }
+
+    BoundingBox left_bounds;
+    uint32_t left_count = 0;
+    for (auto i = 1; i < bins_count; i++) {
+      left_bounds.Extend(bins[i - 1].bounds_);
+      left_count += bins[i - 1].count_;
+      if (left_count == 0 || right_counts[i] == 0) continue;
+      auto cost = left_bounds.GetSurfaceArea() * GetBlocksCount(left_count) + right_areas[i] * GetBlocksCount(right_counts[i]);
+      if (cost < split.cost_) split = BuildSplit(cost, axis, i);
+    }
+  }
+
+  split.cost_ = SAH_TRAVERSAL_COST + SAH_BLOCK_COST * split.cost_ / std::max(bounds.GetSurfaceArea(), std::numeric_limits<float>::min());
+  return split;
+}
+
+uint32_t BuildRecursive(const BuildContext &context, BuildScratch &scratch, uint32_t begin, uint32_t end, std::vector<BuildNode> &nodes) {
+  auto node_index = uint32_t(nodes.size());
+  nodes.emplace_back();
+
+  BoundingBox bounds;
+  BoundingBox centroid_bounds;
+  for (auto i = begin; i < end; i++) {
+    auto triangle = context.triangle_ids_[i];
+    bounds.Extend(context.triangle_bounds_[triangle]);
+    centroid_bounds.Extend(context.centroids_[triangle]);
+  }
+  nodes[node_index].bounds_ = bounds;
+
+  auto count = end - begin;
+  auto make_leaf = [&] {
+    nodes[node_index].first_ = begin;
+    nodes[node_index].count_ = count;
+    return node_index;
+  };
+
+  if (count == 1) return make_leaf();
+
+  auto split = FindSplit(context, scratch, begin, end, bounds, centroid_bounds);
+  auto fits_leaf = count <= context.specification_.max_leaf_size_;
+  if (fits_leaf && split.cost_ >= SAH_BLOCK_COST * GetBlocksCount(count)) return make_leaf();
+
+  auto ids = context.triangle_ids_.subspan(begin, count);
+  auto middle = end;
+  if (split.cost_ < std::numeric_limits<float>::max()) {
+    auto axis = split.axis_;
+    auto minimum = centroid_bounds.min_[axis];
+    auto scale = float(context.specification_.bins_count_) / (centroid_bounds.max_[axis] - minimum);
+    auto is_left = [&](uint32_t triangle) {
+      return GetBin(context.centroids_[triangle][axis], minimum, scale, context.specification_.bins_count_) < split.bin_;
+    };
+    middle = begin + uint32_t(std::ranges::partition(ids, is_left).begin() - ids.begin());
+  }
+
+  if (middle == begin || middle == end) {
+    if (fits_leaf) return make_leaf();
+    // EVERY CENTROID FELL INTO ONE BIN, HALVE THE RANGE ALONG THE LONGEST CENTROID AXIS
+    auto extent = centroid_bounds.max_ - centroid_bounds.min_;
+    auto axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+    middle = begin + count / 2;
+    std::ranges::nth_element(ids, ids.begin() + count / 2, {}, [&](uint32_t triangle) { return context.centroids_[triangle][axis]; });
+  }
+
+  uint32_t left = 0;
+  uint32_t right = 0;
+  if (count > context.specification_.parallel_threshold_) {
+    // LARGE SUBTREES BUILD CONCURRENTLY INTO THEIR OWN ARRAYS AND ARE SPLICED BACK WITH REBASED CHILD INDICES
+    std::vector<BuildNode> right_nodes;
+    auto right_future = std::async(std::launch::async, [&] {
+      BuildScratch right_scratch(context.specification_.bins_count_);
+      BuildRecursive(context, right_scratch, middle, end, right_nodes);
+    });
+    left = BuildRecursive(context, scratch, begin, middle, nodes);
+    right_future.get();
+    right = uint32_t(nodes.size());
+    for (auto &right_node : right_nodes) {
+      if (right_node.count_ > 0) continue;
+      right_node.left_ += right;
+      right_node.right_ += right;
+    }
+    nodes.insert(nodes.end(), right_nodes.begin(), right_nodes.end());
+  } else {
+    left = BuildRecursive(context, scratch, begin, middle, nodes);
+    right = BuildRecursive(context, scratch, middle, end, nodes);
+  }
+
+  nodes[node_index].left_ = left;
+  nodes[node_index].right_ = right;
+  return node_index;
+}
+
+// COLLAPSE
+
+struct CollapseContext {
+  std::span<const BuildNode> build_nodes_;
+  std::span<const uint32_t> triangle_ids_;
+  std::span<const Vector3f> positions_;
+  std::vector<BoundingVolumeNode> &nodes_;
+  std::vector<TriangleBlock> &triangle_blocks_;
+  uint32_t depth_ = 0;
+};
+
+uint32_t EmitLeaf(CollapseContext &context, uint32_t first, uint32_t count) {
+  auto block_index = uint32_t(context.triangle_blocks_.size());
+  for (auto i = 0; i < count; i += BVH_WIDTH) {
+    // PADDING LANES KEEP ZERO EDGES, THEIR DETERMINANT IS ZERO AND THEY NEVER HIT
+    TriangleBlock block = {};
+    std::ranges::fill(block.triangles_, BVH_INVALID_INDEX);
+    for (auto lane = 0; lane < BVH_WIDTH && i + lane < count; lane++) {
+      auto triangle = context.triangle_ids_[first + i + lane];
+      const auto &p0 = context.positions_[3 * triangle + 0];
+      auto edge1 = context.positions_[3 * triangle + 1] - p0;
+      auto edge2 = context.positions_[3 * triangle + 2] - p0;
+      for (auto axis = 0; axis < 3; axis++) {
+        block.v0_[axis][lane] = p0[axis];
+        block.edge1_[axis][lane] = edge1[axis];
+        block.edge2_[axis][lane] = edge2[axis];
+      }
+      block.triangles_[lane] = triangle;
+    }
+    context.triangle_blocks_.emplace_back(block);
+  }
+  return block_index;
+}
+
+uint32_t CollapseNode(CollapseContext &context, uint32_t build_index, uint32_t depth) {
+  context.depth_ = std::max(context.depth_, depth);
+  const auto &build_node = context.build_nodes_[build_index];
+
+  std::array<uint32_t, BVH_WIDTH> children;
+  uint32_t children_count = 0;
+  if (build_node.count_ > 0) {
+    children[children_count++] = build_index;
+  } else {
+    children[children_count++] = build_node.left_;
+    children[children_count++] = build_node.right_;
+  }
+
+  // OPEN THE LARGEST INTERIOR CHILD UNTIL THE NODE IS FULL
+  while (children_count < BVH_WIDTH) {
+    auto largest = BVH_INVALID_INDEX;
+    auto largest_area = -1.0f;
+    for (auto i = 0; i < children_count; i++) {
+      const auto &child = context.build_nodes_[children[i]];
+      if (child.count_ > 0 || child.bounds_.GetSurfaceArea() <= largest_area) continue;
+      largest = i;
+      largest_area = child.bounds_.GetSurfaceArea();
+    }
+    if (largest == BVH_INVALID_INDEX) break;
+    const auto &opened = context.build_nodes_[children[largest]];
+    children[largest] = opened.left_;
+    children[children_count++] = opened.right_;
+  }
+
+  // EMPTY LANES HAVE INVERTED BOUNDS, THE NEAR PLANE IS ALWAYS BEHIND THE FAR PLANE
+  BoundingVolumeNode node;
+  for (auto lane = 0; lane < BVH_WIDTH; lane++) {
+    for (auto axis = 0; axis < 3; axis++) {
+      node.bounds_[axis][lane] = std::numeric_limits<float>::max();
+      node.bounds_[axis + 3][lane] = std::numeric_limits<float>::lowest();
+    }
+    node.children_[lane] = BVH_INVALID_INDEX;
+    node.blocks_count_[lane] = 0;
+  }
+
+  auto node_index = uint32_t(context.nodes_.size());
+  context.nodes_.emplace_back();
+
+  for (auto lane = 0; lane < children_count; lane++) {
+    const auto &child = context.build_nodes_[children[lane]];
+    for (auto axis = 0; axis < 3; axis++) {
+      node.bounds_[axis][lane] = child.bounds_.min_[axis];
+      node.bounds_[axis + 3][lane] = child.bounds_.max_[axis];
+    }
+    if (child.count_ > 0) {
+      node.children_[lane] = EmitLeaf(context, child.first_, child.count_);
+      node.blocks_count_[lane] = GetBlocksCount(child.count_);
+    } else {
+      node.children_[lane] = CollapseNode(context, children[lane], depth + 1);
+    }
+  }
+
+  context.nodes_[node_index] = node;
+  return node_index;
+}
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(const Model &model, const BoundingVolumeHierarchySpecification &specification) {
+  auto vertices = model.GetVertices();
+  auto indices = model.GetIndices();
+  auto meshes = model.GetMeshes();
+
+  std::vector<Vector3f> positions;
+  auto add_mesh = [&](uint32_t mesh_index, uint32_t instance_index, const Matrix4f &transform) {
+    const auto &mesh = meshes[mesh_index];
+    for (auto i = mesh.indices_offset; i + 2 < mesh.indices_offset + mesh.indices_size; i += 3) {
+      auto &triangle = triangles_.emplace_back(BoundingVolumeTriangle{{indices[i], indices[i + 1], indices[i + 2]}, mesh_index, instance_index});
+      for (auto index : triangle.indices_) {
+        positions.emplace_back(transform * Vector4f(vertices[index].position_, 1.0f));
+      }
+    }
+  };
+
+  if (specification.flatten_instances_) {
+    auto mesh_groups = model.GetMeshGroups();
+    for (const auto &[instance_index, instance] : std::views::enumerate(model.GetMeshInstances())) {
+      const auto &[meshes_offset, meshes_count] = mesh_groups[instance.group_index_];
+      for (auto mesh_index = meshes_offset; mesh_index < meshes_offset + meshes_count; mesh_index++) {
+        add_mesh(mesh_index, uint32_t(instance_index), instance.transform_);
+      }
+    }
+  } else {
+    for (auto mesh_index = 0; mesh_index < meshes.size(); mesh_index++) {
+      add_mesh(mesh_index, BVH_INVALID_INDEX, Matrix4f(1.0f));
+    }
+  }
+
+  Build(positions, specification);
+}
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(std::span<const Vector3f> positions,
+                                                 const BoundingVolumeHierarchySpecification &specification) {
+  for (auto i = 0u; i < positions.size() / 3; i++) {
+    triangles_.emplace_back(BoundingVolumeTriangle{{3 * i + 0, 3 * i + 1, 3 * i + 2}, 0, BVH_INVALID_INDEX});
+  }
+  Build(positions, specification);
+}
+
+void BoundingVolumeHierarchy::Build(std::span<const Vector3f> positions, const BoundingVolumeHierarchySpecification &specification) {
+  auto triangles_count = uint32_t(positions.size() / 3);
+  if (triangles_count == 0) return;
+
+  std::vector<BoundingBox> triangle_bounds(triangles_count);
+  std::vector<Vector3f> centroids(triangles_count);
+  std::vector<uint32_t> triangle_ids(triangles_count);
+
+  ParallelFor((triangles_count + BVH_CHUNK_SIZE - 1) / BVH_CHUNK_SIZE, [&](std::size_t chunk) {
+    auto end = std::min<std::size_t>(triangles_count, (chunk + 1) * BVH_CHUNK_SIZE);
+    for (auto i = chunk * BVH_CHUNK_SIZE; i < end; i++) {
+      BoundingBox bounds;
+      bounds.Extend(positions[3 * i + 0]);
+      bounds.Extend(positions[3 * i + 1]);
+      bounds.Extend(positions[3 * i + 2]);
+      triangle_bounds[i] = bounds;
+      centroids[i] = bounds.GetCenter();
+      triangle_ids[i] = i;
+    }
+  });
+
+  BuildContext build_context(triangle_bounds, centroids, triangle_ids, specification);
+  BuildScratch build_scratch(specification.bins_count_);
+  std::vector<BuildNode> build_nodes;
+  build_nodes.reserve(2 * triangles_count);
+  BuildRecursive(build_context, build_scratch, 0, triangles_count, build_nodes);
+  bounds_ = build_nodes[0].bounds_;
+
+  CollapseContext collapse_context(build_nodes, triangle_ids, positions, nodes_, triangle_blocks_);
+  CollapseNode(collapse_context, 0, 1);
+  CORE_ASSERT((BVH_WIDTH - 1) * collapse_context.depth_ + 1 <= BVH_STACK_SIZE, "BVH is too deep for the traversal stack");
+}
+
+// REFIT
+
+void BoundingVolumeHierarchy::Refit(std::span<const Vector3f> vertex_positions) {
+  CORE_ASSERT(triangles_.empty() || triangles_[0].instance_index_ == BVH_INVALID_INDEX, "Flattened instances cannot be refit");
+  if (nodes_.empty()) return;
+
+  ParallelFor((triangle_blocks_.size() + BVH_CHUNK_SIZE - 1) / BVH_CHUNK_SIZE, [&](std::size_t chunk) {
+    auto end = std::min(triangle_blocks_.size(), (chunk + 1) * BVH_CHUNK_SIZE);
+    for (auto i = chunk * BVH_CHUNK_SIZE; i < end; i++) {
+      auto &block = triangle_blocks_[i];
+      for (auto lane = 0; lane < BVH_WIDTH && block.triangles_[lane] != BVH_INVALID_INDEX; lane++) {
+        const auto &indices = triangles_[block.triangles_[lane]].indices_;
+        const auto &p0 = vertex_positions[indices[0]];
+        auto edge1 = vertex_positions[indices[1]] - p0;
+        auto edge2 = vertex_positions[indices[2]] - p0;
+        for (auto axis = 0; axis < 3; axis++) {
+          block.v0_[axis][lane] = p0[axis];
+          block.edge1_[axis][lane] = edge1[axis];
+          block.edge2_[axis][lane] = edge2[axis];
+        }
+      }
+    }
+  });
+
+  auto get_lane_bounds = [](const BoundingVolumeNode &node) {
+    BoundingBox bounds;
+    for (auto lane = 0; lane < BVH_WIDTH && node.children_[lane] != BVH_INVALID_INDEX; lane++) {
+      bounds.Extend(BoundingBox(Vector3f(node.bounds_[0][lane], node.bounds_[1][lane], node.bounds_[2][lane]),
+                                Vector3f(node.bounds_[3][lane], node.bounds_[4][lane], node.bounds_[5][lane])));
+    }
+    return bounds;
+  };
+
+  // CHILDREN ARE EMITTED AFTER THEIR PARENT, A REVERSE SWEEP SEES EVERY CHILD BEFORE ITS PARENT
+  for (auto &node : std::views::reverse(nodes_)) {
+    for (auto lane = 0; lane < BVH_WIDTH && node.children_[lane] != BVH_INVALID_INDEX; lane++) {
+      BoundingBox bounds;
+      if (node.blocks_count_[lane] > 0) {
+        for (auto block = node.children_[lane]; block < node.children_[lane] + node.blocks_count_[lane]; block++) {
+          for (auto triangle : triangle_blocks_[block].triangles_) {
+            if (triangle == BVH_INVALID_INDEX) continue;
+            for (auto index : triangles_[triangle].indices_) {
+              bounds.Extend(vertex_positions[index]);
+            }
+          }
+        }
+      } else {
+        bounds = get_lane_bounds(nodes_[node.children_[lane]]);
+      }
+      for (auto axis = 0; axis < 3; axis++) {
+        node.bounds_[axis][lane] = bounds.min_[axis];
+        node.bounds_[axis + 3][lane] = bounds.max_[axis];
+      }
+    }
+  }
+  bounds_ = get_lane_bounds(nodes_[0]);
+}
+
+// TRAVERSAL
+
+struct TraversalRay {
+  Vector3f origin_;
+  Vector3f direction_;
+  Vector3f inverse_direction_;
+  std::array<uint32_t, 3> near_planes_;
+  std::array<uint32_t, 3> far_planes_;
+  float t_min_;
+};
+
+TraversalRay GetTraversalRay(const Ray &ray) {
+  TraversalRay traversal_ray;
+  traversal_ray.origin_ = ray.origin_;
+  traversal_ray.direction_ = ray.direction_;
+  traversal_ray.t_min_ = ray.t_min_;
+  for (auto axis = 0; axis < 3; axis++) {
+    auto direction = ray.direction_[axis];
+    auto safe_direction = std::abs(direction) < MINIMUM_DIRECTION ? std::copysign(MINIMUM_DIRECTION, direction) : direction;
+    traversal_ray.inverse_direction_[axis] = 1.0f / safe_direction;
+    // THE SIGN PICKS THE SLAB PLANES ONCE PER RAY, NO PER NODE MIN/MAX SWAP
+    traversal_ray.near_planes_[axis] = safe_direction < 0.0f ? axis + 3 : axis;
+    traversal_ray.far_planes_[axis] = safe_direction < 0.0f ? axis : axis + 3;
+  }
+  return traversal_ray;
+}
+
+uint32_t IntersectNode(const BoundingVolumeNode &node, const TraversalRay &ray, float t_max, std::array<float, BVH_WIDTH> &distances) {
+#if defined(__SSE2__)
+  auto t_near = _mm_set1_ps(ray.t_min_);
+  auto t_far = _mm_set1_ps(t_max);
+  for (auto axis = 0; axis < 3; axis++) {
+    auto origin = _mm_set1_ps(ray.origin_[axis]);
+    auto inverse_direction = _mm_set1_ps(ray.inverse_direction_[axis]);
+    auto near_plane = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.bounds_[ray.near_planes_[axis]]), origin), inverse_direction);
+    auto far_plane = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.bounds_[ray.far_planes_[axis]]), origin), inverse_direction);
+    t_near = _mm_max_ps(t_near, near_plane);
+    t_far = _mm_min_ps(t_far, far_plane);
+  }
+  _mm_storeu_ps(distances.data(), t_near);
+  return _mm_movemask_ps(_mm_cmple_ps(t_near, t_far));
+#else
+  uint32_t mask = 0;
+  for (auto lane = 0; lane < BVH_WIDTH; lane++) {
+    auto t_near = ray.t_min_;
+    auto t_far = t_max;
+    for (auto axis = 0; axis < 3; axis++) {
+      auto near_plane = (node.bounds_[ray.near_planes_[axis]][lane] - ray.origin_[axis]) * ray.inverse_direction_[axis];
+      auto far_plane = (node.bounds_[ray.far_planes_[axis]][lane] - ray.origin_[axis]) * ray.inverse_direction_[axis];
+      t_near = std::max(t_near, near_plane);
+      t_far = std::min(t_far, far_plane);
+    }
+    distances[lane] = t_near;
+    mask |= uint32_t(t_near <= t_far) << lane;
+  }
+  return mask;
+#endif
+}
+
+bool IntersectBlock(const TriangleBlock &block, const TraversalRay &ray, float &t_max, RayHit &hit) {
+  std::array<float, BVH_WIDTH> t, u, v;
+  uint32_t mask = 0;
+#if defined(__SSE2__)
+  auto dx = _mm_set1_ps(ray.direction_.x), dy = _mm_set1_ps(ray.direction_.y), dz = _mm_set1_ps(ray.direction_.z);
+  auto e1x = _mm_load_ps(block.edge1_[0]), e1y = _mm_load_ps(block.edge1_[1]), e1z = _mm_load_ps(block.edge1_[2]);
+  auto e2x = _mm_load_ps(block.edge2_[0]), e2y = _mm_load_ps(block.edge2_[1]), e2z = _mm_load_ps(block.edge2_[2]);
+
+  auto px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+  auto py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+  auto pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+  auto determinant = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+  auto inverse_determinant = _mm_div_ps(_mm_set1_ps(1.0f), determinant);
+
+  auto tx = _mm_sub_ps(_mm_set1_ps(ray.origin_.x), _mm_load_ps(block.v0_[0]));
+  auto ty = _mm_sub_ps(_mm_set1_ps(ray.origin_.y), _mm_load_ps(block.v0_[1]));
+  auto tz = _mm_sub_ps(_mm_set1_ps(ray.origin_.z), _mm_load_ps(block.v0_[2]));
+  auto lane_u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), inverse_determinant);
+
+  auto qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+  auto qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+  auto qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+  auto lane_v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inverse_determinant);
+  auto lane_t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inverse_determinant);
+
+  auto zero = _mm_setzero_ps();
+  auto valid = _mm_and_ps(_mm_cmpneq_ps(determinant, zero), _mm_cmpge_ps(lane_u, zero));
+  valid = _mm_and_ps(valid, _mm_cmpge_ps(lane_v, zero));
+  valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_add_ps(lane_u, lane_v), _mm_set1_ps(1.0f)));
+  valid = _mm_and_ps(valid, _mm_cmpgt_ps(lane_t, _mm_set1_ps(ray.t_min_)));
+  valid = _mm_and_ps(valid, _mm_cmplt_ps(lane_t, _mm_set1_ps(t_max)));
+  mask = _mm_movemask_ps(valid);
+  if (mask == 0) return false;
+
+  _mm_storeu_ps(t.data(), lane_t);
+  _mm_storeu_ps(u.data(), lane_u);
+  _mm_storeu_ps(v.data(), lane_v);
+#else
+  for (auto lane = 0; lane < BVH_WIDTH; lane++) {
+    auto edge1 = Vector3f(block.edge1_[0][lane], block.edge1_[1][lane], block.edge1_[2][lane]);
+    auto edge2 = Vector3f(block.edge2_[0][lane], block.edge2_[1][lane], block.edge2_[2][lane]);
+    auto p = glm::cross(ray.direction_, edge2);
+    auto determinant = glm::dot(edge1, p);
+    if (determinant == 0.0f) continue;
+    auto s = ray.origin_ - Vector3f(block.v0_[0][lane], block.v0_[1][lane], block.v0_[2][lane]);
+    auto q = glm::cross(s, edge1);
+    u[lane] = glm::dot(s, p) / determinant;
+    v[lane] = glm::dot(ray.direction_, q) / determinant;
+    t[lane] = glm::dot(edge2, q) / determinant;
+    auto inside = u[lane] >= 0.0f && v[lane] >= 0.0f && u[lane] + v[lane] <= 1.0f;
+    mask |= uint32_t(inside && t[lane] > ray.t_min_ && t[lane] < t_max) << lane;
+  }
+  if (mask == 0) return false;
+#endif
+
+  for (auto lane = 0; lane < BVH_WIDTH; lane++) {
+    if ((mask & (1u << lane)) == 0 || t[lane] >= t_max) continue;
+    t_max = t[lane];
+    hit = RayHit(t[lane], u[lane], v[lane], block.triangles_[lane]);
+  }
+  return true;
+}
+
+template <bool ANY_HIT> bool BoundingVolumeHierarchy::Traverse(const Ray &in_ray, RayHit &hit) const {
+  if (nodes_.empty()) return false;
+
+  struct StackEntry {
+    uint32_t index_;
+    uint32_t blocks_count_;
+    float distance_;
+  };
+
+  auto ray = GetTraversalRay(in_ray);
+  auto t_max = in_ray.t_max_;
+  auto found = false;
+
+  std::array<StackEntry, BVH_STACK_SIZE> stack;
+  uint32_t stack_size = 0;
+  stack[stack_size++] = StackEntry(0, 0, ray.t_min_);
+
+  while (stack_size > 0) {
+    auto entry = stack[--stack_size];
+    if (entry.distance_ > t_max) continue;
+
+    if (entry.blocks_count_ > 0) {
+      for (auto block = entry.index_; block < entry.index_ + entry.blocks_count_; block++) {
+        if (IntersectBlock(triangle_blocks_[block], ray, t_max, hit) == false) continue;
+        found = true;
+        if constexpr (ANY_HIT) return true;
+      }
+      continue;
+    }
+
+    const auto &node = nodes_[entry.index_];
+    std::array<float, BVH_WIDTH> distances;
+    auto mask = IntersectNode(node, ray, t_max, distances);
+
+    // PUSH FAR TO NEAR SO THE NEAREST CHILD IS POPPED FIRST AND SHRINKS t_max EARLY
+    std::array<uint32_t, BVH_WIDTH> order;
+    uint32_t order_size = 0;
+    for (auto lane = 0; lane < BVH_WIDTH; lane++) {
+      if ((mask & (1u << lane)) == 0) continue;
+      auto position = order_size++;
+      for (; position > 0 && distances[order[position - 1]] < distances[lane]; position--) {
+        order[position] = order[position - 1];
+      }
+      order[position] = lane;
+    }
+    for (auto i = 0; i < order_size; i++) {
+      auto lane = order[i];
+      stack[stack_size++] = StackEntry(node.children_[lane], node.blocks_count_[lane], distances[lane]);
+    }
+  }
+  return found;
+}
+
+RayHit BoundingVolumeHierarchy::Intersect(const Ray &ray) const {
+  RayHit hit;
+  Traverse<false>(ray, hit);
+  return hit;
+}
+
+bool BoundingVolumeHierarchy::IsOccluded(const Ray &ray) const {
+  RayHit hit;
+  return Traverse<true>(ray, hit);
+}
+
+const BoundingBox &BoundingVolumeHierarchy::GetBounds() const {
+  return bounds_;
+}
+
+const BoundingVolumeTriangle &BoundingVolumeHierarchy::GetTriangle(uint32_t triangle_index) const {
+  return triangles_[triangle_index];
+}
+
+std::span<const BoundingVolumeNode> BoundingVolumeHierarchy::GetNodes() const {
+  return nodes_;
+}
+
+std::span<const TriangleBlock> BoundingVolumeHierarchy::GetTriangleBlocks() const {
+  return triangle_blocks_;
+}
+
+std::size_t BoundingVolumeHierarchy::GetTrianglesCount() const {
+  return triangles_.size();
+}
+
+Ray GetPickingRay(const Matrix4f &view, const Matrix4f &projection, const Vector2f &ndc) {
+  auto far_point = glm::inverse(projection * view) * Vector4f(ndc, 1.0f, 1.0f);
+  Ray ray;
+  ray.origin_ = Vector3f(glm::inverse(view)[3]);
+  ray.direction_ = glm::normalize(Vector3f(far_point) / far_point.w - ray.origin_);
+  return ray;
+}
+
+} // namespace Innsmouth
\ No newline at end of file
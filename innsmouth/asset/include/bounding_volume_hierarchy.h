@@ -0,0 +1,114 @@
+#ifndef INNSMOUTH_BOUNDING_VOLUME_HIERARCHY_H
+#define INNSMOUTH_BOUNDING_VOLUME_HIERARCHY_H
+
+#include "mesh.h"
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace Innsmouth {
+
+class Model;
+
+constexpr uint32_t BVH_WIDTH = 4;
+constexpr uint32_t BVH_INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+struct Ray {
+  Vector3f origin_{0.0f};
+  Vector3f direction_{0.0f, 0.0f, -1.0f};
+  float t_min_ = 0.0f;
+  float t_max_ = std::numeric_limits<float>::max();
+};
+
+struct RayHit {
+  float t_ = std::numeric_limits<float>::max();
+  float u_ = 0.0f;
+  float v_ = 0.0f;
+  uint32_t triangle_index_ = BVH_INVALID_INDEX;
+
+  bool IsHit() const;
+};
+
+struct BoundingBox {
+  Vector3f min_{std::numeric_limits<float>::max()};
+  Vector3f max_{std::numeric_limits<float>::lowest()};
+
+  void Extend(const Vector3f &point);
+  void Extend(const BoundingBox &bounding_box);
+
+  Vector3f GetCenter() const;
+  float GetSurfaceArea() const;
+  bool IsValid() const;
+};
+
+struct BoundingVolumeTriangle {
+  uint32_t indices_[3];
+  uint32_t mesh_index_;
+  uint32_t instance_index_;
+};
+
+struct BoundingVolumeHierarchySpecification {
+  bool flatten_instances_ = true;
+  uint32_t bins_count_ = 16;
+  uint32_t max_leaf_size_ = 8;
+  uint32_t parallel_threshold_ = 16384;
+};
+
+// FOUR CHILDREN PER NODE IN SOA, ONE SSE REGISTER PER SLAB PLANE, TWO CACHE LINES
+struct alignas(64) BoundingVolumeNode {
+  float bounds_[6][BVH_WIDTH];
+  uint32_t children_[BVH_WIDTH];
+  uint32_t blocks_count_[BVH_WIDTH];
+};
+
+// FOUR TRIANGLES IN SOA, PRECOMPUTED FOR MOLLER-TRUMBORE
+struct alignas(16) TriangleBlock {
+  float v0_[3][BVH_WIDTH];
+  float edge1_[3][BVH_WIDTH];
+  float edge2_[3][BVH_WIDTH];
+  uint32_t triangles_[BVH_WIDTH];
+};
+
+class BoundingVolumeHierarchy {
+public:
+  BoundingVolumeHierarchy() = default;
+
+  BoundingVolumeHierarchy(const Model &model,
+                          const BoundingVolumeHierarchySpecification &specification = BoundingVolumeHierarchySpecification());
+
+  // A TRIANGLE SOUP, THREE POSITIONS PER TRIANGLE, TRIANGLE i INDEXES POSITIONS 3i TO 3i + 2
+  BoundingVolumeHierarchy(std::span<const Vector3f> positions,
+                          const BoundingVolumeHierarchySpecification &specification = BoundingVolumeHierarchySpecification());
+
+  // MOVES THE TRIANGLES AND KEEPS THE TOPOLOGY, vertex_positions IS INDEXED LIKE THE VERTICES THE HIERARCHY WAS BUILT FROM
+  // (THE POSITIONS OF A SOUP), A HIERARCHY WITH FLATTENED INSTANCES CANNOT BE REFIT
+  void Refit(std::span<const Vector3f> vertex_positions);
+
+  RayHit Intersect(const Ray &ray) const;
+  bool IsOccluded(const Ray &ray) const;
+
+  const BoundingBox &GetBounds() const;
+  const BoundingVolumeTriangle &GetTriangle(uint32_t triangle_index) const;
+
+  std::span<const BoundingVolumeNode> GetNodes() const;
+  std::span<const TriangleBlock> GetTriangleBlocks() const;
+  std::size_t GetTrianglesCount() const;
+
+protected:
+  void Build(std::span<const Vector3f> positions, const BoundingVolumeHierarchySpecification &specification);
+
+  template <bool ANY_HIT> bool Traverse(const Ray &ray, RayHit &hit) const;
+
+private:
+  std::vector<BoundingVolumeNode> nodes_;
+  std::vector<TriangleBlock> triangle_blocks_;
+  std::vector<BoundingVolumeTriangle> triangles_;
+  BoundingBox bounds_;
+};
+
+// WORLD SPACE RAY THROUGH A POINT IN NORMALIZED DEVICE COORDINATES, FOR PICKING
+Ray GetPickingRay(const Matrix4f &view, const Matrix4f &projection, const Vector2f &ndc);
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_BOUNDING_VOLUME_HIERARCHY_H
\ No newline at end of file
@@ -5,18 +5,63 @@
 
 namespace Innsmouth {
 
+// COUNTS THE BASE LEVEL, SO A MESH HAS AT MOST THREE SIMPLIFIED LEVELS, KEEP IN SYNC WITH mesh.glsl
+constexpr uint32_t MESH_MAX_LODS = 4;
+
 struct Vertex {
   Vector3f position_;
   Vector3f normal_;
   Vector2f uv_;
 };
 
+struct PackedVertex {
+  uint16_t position_[4];
+  int16_t normal_[2];
+  uint16_t uv_[2];
+};
+
+struct MeshLod {
+  uint32_t indices_offset;
+  uint32_t indices_size;
+  float error;
+};
+
 struct Mesh {
   int32_t color_texture_index;
   int32_t normal_texture_index;
   uint32_t vertices_offset;
   uint32_t indices_offset;
   uint32_t indices_size;
+  Vector3f position_offset;
+  Vector3f position_scale;
+  Vector3f center;
+  float radius;
+  uint32_t lods_count;
+  MeshLod lods[MESH_MAX_LODS];
+  uint32_t instances_offset;
+  uint32_t instances_count;
+  float alpha_cutoff; // ZERO FOR OPAQUE MESHES, OTHERWISE BASE COLOR ALPHA BELOW IT IS A HOLE
+};
+
+struct MeshGroup {
+  uint32_t meshes_offset_;
+  uint32_t meshes_count_;
+};
+
+struct MeshInstance {
+  Matrix4f transform_;
+  uint32_t group_index_;
+};
+
+struct Meshlet {
+  Vector3f center;
+  float radius;
+  Vector3f cone_axis;
+  float cone_cutoff;
+  uint32_t vertices_offset;
+  uint32_t triangles_offset;
+  uint32_t vertices_count;
+  uint32_t triangles_count;
 };
 
 } // namespace Innsmouth
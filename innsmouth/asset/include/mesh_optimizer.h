@@ -0,0 +1,46 @@
+#ifndef INNSMOUTH_MESH_OPTIMIZER_H
+#define INNSMOUTH_MESH_OPTIMIZER_H
+
+#include "mesh.h"
+#include <span>
+#include <vector>
+
+namespace Innsmouth {
+
+constexpr uint32_t MESHLET_MAX_VERTICES = 64;
+constexpr uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+struct VertexCacheStatistics {
+  float acmr_{0.0f};
+  float atvr_{0.0f};
+};
+
+struct MeshOptimizationReport {
+  VertexCacheStatistics before_;
+  VertexCacheStatistics after_;
+  std::size_t vertices_before_{0};
+  std::size_t vertices_after_{0};
+};
+
+struct MeshLodLevel {
+  std::vector<uint32_t> indices_;
+  float error_{0.0f};
+};
+
+struct MeshletData {
+  std::vector<Meshlet> meshlets_;
+  std::vector<uint32_t> vertices_;
+  std::vector<uint32_t> triangles_;
+};
+
+VertexCacheStatistics AnalyzeVertexCache(std::span<const uint32_t> indices, std::size_t vertices_count);
+
+MeshOptimizationReport OptimizeMesh(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices);
+
+std::vector<MeshLodLevel> SimplifyMesh(std::span<const Vertex> vertices, std::span<const uint32_t> indices, uint32_t lods_count);
+
+void BuildMeshlets(std::span<const Vertex> vertices, std::span<const uint32_t> indices, uint32_t vertices_offset, MeshletData &out_meshlets);
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_MESH_OPTIMIZER_H
\ No newline at end of file
@@ -1,35 +1,76 @@
 #ifndef INNSMOUTH_MODEL_H
 #define INNSMOUTH_MODEL_H
 
-#include "mesh.h"
+#include "mesh_optimizer.h"
+#include "vertex_quantization.h"
 #include "innsmouth/graphics/image/image2D.h"
 #include <span>
 #include <filesystem>
 
 namespace Innsmouth {
 
+struct ModelSpecification {
+  bool optimize_ = true;
+  bool build_meshlets_ = false;
+  bool pack_vertices_ = false;
+  bool load_images_ = true;
+  uint32_t lods_count_ = 1; // INCLUDES THE BASE LEVEL, CLAMPED TO [1, MESH_MAX_LODS]
+};
+
 class Model {
 public:
   Model() = default;
 
-  Model(const std::filesystem::path &path);
+  Model(const std::filesystem::path &path, const ModelSpecification &specification = ModelSpecification());
 
   std::size_t GetVerticesNumber() const;
   std::size_t GetIndicesNumber() const;
 
   std::span<const Vertex> GetVertices() const;
+  std::span<const PackedVertex> GetPackedVertices() const;
   std::span<const uint32_t> GetIndices() const;
+  std::span<const uint32_t> GetBaseIndices() const;
   std::span<const Mesh> GetMeshes() const;
+  std::span<const MeshGroup> GetMeshGroups() const;
+  std::span<const MeshInstance> GetMeshInstances() const;
+  std::span<const Matrix4f> GetInstanceTransforms() const;
   std::span<const Image2D> GetImages() const;
+  std::span<const std::filesystem::path> GetImagePaths() const;
+  std::span<const std::filesystem::path> GetSourcePaths() const;
+  const MeshOptimizationReport &GetOptimizationReport() const;
+
+  std::span<const Meshlet> GetMeshlets() const;
+  std::span<const uint32_t> GetMeshletVertices() const;
+  std::span<const uint32_t> GetMeshletTriangles() const;
 
 protected:
   void LoadKhronos(const std::filesystem::path &path);
+  void LoadWavefront(const std::filesystem::path &path);
+
+  void LoadImages();
+  void BuildInstances();
+  void Optimize();
+  void GenerateLods(uint32_t lods_count);
+  void BuildMeshlets();
+  void PackVertices();
+
+  std::size_t GetMeshVerticesEnd(std::size_t mesh_index) const;
+  std::vector<uint32_t> GetMeshLocalIndices(std::size_t mesh_index) const;
 
 private:
   std::vector<Vertex> vertices_;
+  std::vector<PackedVertex> packed_vertices_;
   std::vector<uint32_t> indices_;
+  std::size_t base_indices_count_{0};
   std::vector<Mesh> meshes_;
+  std::vector<MeshGroup> mesh_groups_;
+  std::vector<MeshInstance> mesh_instances_;
+  std::vector<Matrix4f> instance_transforms_;
   std::vector<Image2D> images_;
+  std::vector<std::filesystem::path> image_paths_;
+  std::vector<std::filesystem::path> source_paths_; // EXTERNAL BUFFERS AND MATERIAL LIBRARIES THE GEOMETRY WAS READ FROM
+  MeshOptimizationReport optimization_report_;
+  MeshletData meshlet_data_;
 };
 
 } // namespace Innsmouth
@@ -0,0 +1,105 @@
+#ifndef INNSMOUTH_MODEL_LOADER_H
+#define INNSMOUTH_MODEL_LOADER_H
+
+#include "model.h"
+#include "innsmouth/graphics/buffer/buffer.h"
+#include "innsmouth/graphics/raytracing/acceleration_structure.h"
+#include "innsmouth/graphics/command/query_pool.h"
+#include "innsmouth/core/include/mapped_file.h"
+#include <future>
+#include <memory>
+
+namespace Innsmouth {
+
+class CommandBuffer;
+class TextureStreamer;
+
+enum class ModelLoadStage : uint32_t {
+  E_PARSING,
+  E_GEOMETRY,
+  E_READY,
+};
+
+struct ModelLoaderSpecification {
+  uint32_t blas_builds_per_frame_ = 16;
+  // SERIALIZED BOTTOM LEVELS ARE KEPT NEXT TO THE MODEL AS <model>.blas
+  bool cache_acceleration_structures_ = true;
+};
+
+class ModelAsset {
+public:
+  ModelLoadStage GetStage() const;
+  bool IsGeometryReady() const;
+  bool IsReady() const;
+
+  const Model &GetModel() const;
+
+  const Buffer &GetVertexBuffer() const;
+  const Buffer &GetPackedVertexBuffer() const;
+  const Buffer &GetIndexBuffer() const;
+  const Buffer &GetMeshBuffer() const;
+  const Buffer &GetInstanceBuffer() const;
+
+  std::span<const AccelerationStructure> GetBottomLevelStructures() const;
+  std::span<const uint32_t> GetTextureHandles() const;
+
+private:
+  friend class ModelLoader;
+
+  ModelLoadStage stage_{ModelLoadStage::E_PARSING};
+  std::filesystem::path path_;
+  ModelSpecification specification_;
+  std::future<Model> model_future_;
+  Model model_;
+  Buffer vertex_buffer_;
+  Buffer packed_vertex_buffer_;
+  Buffer index_buffer_;
+  Buffer mesh_buffer_;
+  Buffer instance_buffer_;
+  std::vector<AccelerationStructure> blases_;
+  std::vector<uint32_t> texture_handles_;
+  MappedFile blas_cache_;
+  std::vector<std::span<const std::byte>> cached_blases_;
+};
+
+// A FRESHLY BUILT MODEL ON ITS WAY TO THE CACHE, EVERY STEP WAITS FOR THE FRAME THAT RECORDED THE PREVIOUS ONE TO RETIRE
+struct BottomLevelCacheWrite {
+  std::shared_ptr<ModelAsset> model_asset_;
+  std::unique_ptr<QueryPool> query_pool_;
+  std::vector<uint64_t> sizes_;
+  Buffer readback_buffer_;
+  uint64_t frame_value_ = 0;
+};
+
+class ModelLoader {
+public:
+  ModelLoader(TextureStreamer &texture_streamer, const ModelLoaderSpecification &specification = ModelLoaderSpecification());
+
+  ModelLoader(const ModelLoader &) = delete;
+  ModelLoader &operator=(const ModelLoader &) = delete;
+
+  std::shared_ptr<const ModelAsset> Load(const std::filesystem::path &path, const ModelSpecification &specification = ModelSpecification());
+
+  void Update(CommandBuffer &command_buffer);
+
+  std::size_t GetPendingCount() const;
+
+protected:
+  void UploadGeometry(CommandBuffer &command_buffer, ModelAsset &model_asset);
+  uint32_t BuildBottomLevel(CommandBuffer &command_buffer, ModelAsset &model_asset, uint32_t budget);
+
+  void ReadBottomLevelCache(ModelAsset &model_asset);
+  void UpdateBottomLevelCache(CommandBuffer &command_buffer);
+
+private:
+  TextureStreamer *texture_streamer_{nullptr};
+  ModelLoaderSpecification specification_;
+  std::vector<std::shared_ptr<ModelAsset>> pending_assets_;
+  std::vector<BottomLevelCacheWrite> cache_writes_;
+  std::vector<std::future<void>> cache_files_;
+  std::vector<Buffer> build_buffers_;
+};
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_MODEL_LOADER_H
\ No newline at end of file
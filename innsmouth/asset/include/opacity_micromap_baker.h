@@ -0,0 +1,55 @@
+#ifndef INNSMOUTH_OPACITY_MICROMAP_BAKER_H
+#define INNSMOUTH_OPACITY_MICROMAP_BAKER_H
+
+#include "mesh.h"
+#include "innsmouth/graphics/core/graphics_types.h"
+#include <array>
+#include <span>
+#include <vector>
+
+namespace Innsmouth {
+
+class Model;
+
+// 4 STATE ENCODING, THE UNKNOWN STATES INVOKE ANY-HIT
+enum class MicroTriangleOpacity : uint8_t {
+  E_TRANSPARENT = 0,
+  E_OPAQUE = 1,
+  E_UNKNOWN_TRANSPARENT = 2,
+  E_UNKNOWN_OPAQUE = 3,
+};
+
+struct OpacityMicromapBakeSpecification {
+  uint32_t max_subdivision_level_ = 6;
+  float texels_per_micro_triangle_ = 4.0f;
+  float samples_per_texel_ = 2.0f; // ALONG A MICRO-TRIANGLE EDGE
+};
+
+struct OpacityMicromapStatistics {
+  uint32_t opaque_triangles_ = 0;
+  uint32_t transparent_triangles_ = 0;
+  uint32_t unknown_triangles_ = 0;
+  uint32_t subdivided_triangles_ = 0;
+  uint64_t micro_triangles_ = 0;
+  uint64_t unknown_micro_triangles_ = 0;
+};
+
+struct OpacityMicromapData {
+  std::vector<std::byte> data_;
+  std::vector<MicromapTriangleEXT> triangles_;
+  // ONE PER TRIANGLE OF THE MODEL INDICES, NEGATIVE VALUES ARE OpacityMicromapSpecialIndexEXT
+  std::vector<int32_t> indices_;
+  std::vector<std::vector<MicromapUsageEXT>> mesh_usage_counts_;
+  OpacityMicromapStatistics statistics_;
+};
+
+// CLASSIFIES EVERY MICRO-TRIANGLE OF THE ALPHA TESTED MESHES AGAINST THE BASE COLOR ALPHA, OPAQUE MESHES STAY FULLY OPAQUE
+OpacityMicromapData BakeOpacityMicromap(const Model &model,
+                                        const OpacityMicromapBakeSpecification &specification = OpacityMicromapBakeSpecification());
+
+// BARYCENTRICS OF THE MICRO-TRIANGLE VERTICES IN THE BIRD CURVE ORDER OF VK_EXT_opacity_micromap
+std::array<Vector2f, 3> GetMicroTriangleBarycentrics(uint32_t index, uint32_t subdivision_level);
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_OPACITY_MICROMAP_BAKER_H
\ No newline at end of file
@@ -0,0 +1,18 @@
+#ifndef INNSMOUTH_VERTEX_QUANTIZATION_H
+#define INNSMOUTH_VERTEX_QUANTIZATION_H
+
+#include "mesh.h"
+#include <span>
+#include <vector>
+
+namespace Innsmouth {
+
+Vector2f EncodeOctahedral(const Vector3f &normal);
+
+PackedVertex PackVertex(const Vertex &vertex, const Vector3f &position_offset, const Vector3f &position_scale);
+
+void PackVertices(std::span<const Vertex> vertices, Mesh &mesh, std::vector<PackedVertex> &out_vertices);
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_VERTEX_QUANTIZATION_H
\ No newline at end of file
@@ -1,9 +1,12 @@
 #include "fastgltf/glm_element_traits.hpp"
 #include "fastgltf/core.hpp"
+#include "fastgltf/tools.hpp"
 #include "innsmouth/asset/include/model.h"
 #include "innsmouth/core/include/image_wrapper.h"
 #include "innsmouth/core/include/core.h"
+#include "innsmouth/core/include/mapped_file.h"
 #include <print>
+#include <unordered_map>
 
 namespace Innsmouth {
 
@@ -59,34 +62,80 @@ auto LoadVertices(const fgf::Asset &asset, const fgf::Primitive &primitive, std:
   return vertices_offset + position_accessor.count;
 }
 
-void LoadPrimitives(const fgf::Asset &asset, std::span<Vertex> out_vertices, std::span<uint32_t> out_indices, std::vector<Mesh> &meshes) {
+void LoadPrimitives(const fgf::Asset &asset, std::span<Vertex> out_vertices, std::span<uint32_t> out_indices, std::vector<Mesh> &meshes,
+                    std::vector<MeshGroup> &mesh_groups) {
   std::size_t vertices_offset = 0, indices_offset = 0;
   for (const auto &mesh : asset.meshes) {
+    mesh_groups.emplace_back(meshes.size(), mesh.primitives.size());
     for (auto &primitive : mesh.primitives) {
       auto indices_accessor_index = primitive.indicesAccessor;
       const auto &indices_accessor = asset.accessors[primitive.indicesAccessor.value()];
       auto &material = asset.materials[primitive.materialIndex.value_or(0)];
       auto color_texture_index = LoadTexture<fgf::TextureInfo>(material.pbrData.baseColorTexture);
       auto normal_texture_index = LoadTexture<fgf::NormalTextureInfo>(material.normalTexture);
-      meshes.emplace_back(color_texture_index, normal_texture_index, vertices_offset, indices_offset, indices_accessor.count);
+      auto &mesh = meshes.emplace_back(color_texture_index, normal_texture_index, vertices_offset, indices_offset, indices_accessor.count);
+      mesh.alpha_cutoff = material.alphaMode == fgf::AlphaMode::Mask ? material.alphaCutoff : 0.0f;
       indices_offset = LoadIndices(asset, primitive.indicesAccessor.value(), indices_offset, vertices_offset, out_indices);
       vertices_offset = LoadVertices(asset, primitive, vertices_offset, out_vertices);
     }
   }
 }
 
-void LoadImages(const fgf::Asset &asset, const std::filesystem::path &path) {
-  for (const auto &image : asset.images) {
-    auto image_name = std::get<fastgltf::sources::URI>(image.data).uri.path();
-    auto image_path = path.parent_path() / image_name;
+void LoadNodes(fgf::Asset &asset, std::vector<MeshInstance> &mesh_instances) {
+  if (asset.scenes.empty()) {
+    for (auto i = 0; i < asset.meshes.size(); i++) {
+      mesh_instances.emplace_back(Matrix4f(1.0f), i);
+    }
+    return;
+  }
+  auto scene_index = asset.defaultScene.value_or(0);
+  fgf::iterateSceneNodes(asset, scene_index, fgf::math::fmat4x4(), [&](fgf::Node &node, const fgf::math::fmat4x4 &matrix) {
+    if (node.meshIndex.has_value()) {
+      mesh_instances.emplace_back(glm::make_mat4(matrix.data()), node.meshIndex.value());
+    }
+  });
+}
+
+std::vector<int32_t> LoadImagePaths(const fgf::Asset &asset, const std::filesystem::path &path, std::vector<std::filesystem::path> &images) {
+  // KHR_TEXTURE_BASISU SOURCES WIN OVER THE FALLBACK IMAGE, ONLY REFERENCED IMAGES ARE KEPT
+  std::vector<int32_t> texture_images(asset.textures.size(), -1);
+  std::unordered_map<std::size_t, int32_t> loaded_images;
+  for (auto i = 0; i < asset.textures.size(); i++) {
+    const auto &texture = asset.textures[i];
+    auto image_index = texture.basisuImageIndex.has_value() ? texture.basisuImageIndex : texture.imageIndex;
+    if (image_index.has_value() == false) continue;
+    auto [loaded_image, inserted] = loaded_images.try_emplace(image_index.value(), images.size());
+    if (inserted) {
+      auto image_name = std::get<fastgltf::sources::URI>(asset.images[image_index.value()].data).uri.path();
+      images.emplace_back(path.parent_path() / image_name);
+    }
+    texture_images[i] = loaded_image->second;
   }
+  return texture_images;
+}
+
+// STANDS IN FOR Options::LoadExternalBuffers, WHICH DROPS THE URIS THE BLAS CACHE HASHES, THE MAPPINGS MUST OUTLIVE EVERY ACCESSOR READ
+std::vector<MappedFile> LoadExternalBuffers(fgf::Asset &asset, const std::filesystem::path &path,
+                                            std::vector<std::filesystem::path> &buffer_paths) {
+  std::vector<MappedFile> buffer_files;
+  buffer_files.reserve(asset.buffers.size());
+  for (auto &buffer : asset.buffers) {
+    auto uri = std::get_if<fgf::sources::URI>(&buffer.data);
+    if (uri == nullptr || uri->uri.isLocalPath() == false) continue;
+    const auto &buffer_path = buffer_paths.emplace_back(path.parent_path() / uri->uri.path());
+    const auto &buffer_file = buffer_files.emplace_back(buffer_path);
+    CORE_ASSERT(buffer_file.GetSize() >= uri->fileByteOffset + buffer.byteLength, "glTF buffer is truncated");
+    auto bytes = reinterpret_cast<const std::byte *>(buffer_file.GetData().data()) + uri->fileByteOffset;
+    buffer.data = fgf::sources::ByteView(fgf::span<const std::byte>(bytes, buffer.byteLength), uri->mimeType);
+  }
+  return buffer_files;
 }
 
 void Model::LoadKhronos(const std::filesystem::path &path) {
   auto extensions = fgf::Extensions::KHR_mesh_quantization | fgf::Extensions::KHR_texture_transform | fgf::Extensions::KHR_materials_variants |
-                    fgf::Extensions::KHR_materials_pbrSpecularGlossiness;
+                    fgf::Extensions::KHR_materials_pbrSpecularGlossiness | fgf::Extensions::KHR_texture_basisu;
 
-  auto options = fgf::Options::DontRequireValidAssetMember | fgf::Options::LoadExternalBuffers | fgf::Options::GenerateMeshIndices;
+  auto options = fgf::Options::DontRequireValidAssetMember | fgf::Options::GenerateMeshIndices;
 
   fastgltf::Parser parser(extensions);
 
@@ -94,6 +143,7 @@ void Model::LoadKhronos(const std::filesystem::path &path) {
   auto asset = parser.loadGltf(gltf_file.get(), path.parent_path(), options);
 
   CORE_ASSERT(asset.error() == fgf::Error::None, fastgltf::getErrorMessage(asset.error()));
+  auto buffer_files = LoadExternalBuffers(asset.get(), path, source_paths_);
 
   std::size_t vertices_count = 0, indices_count = 0;
   GetModelProperties(asset.get(), vertices_count, indices_count);
@@ -101,16 +151,13 @@ void Model::LoadKhronos(const std::filesystem::path &path) {
   vertices_.resize(vertices_count);
   indices_.resize(indices_count);
 
-  LoadPrimitives(asset.get(), vertices_, indices_, meshes_);
-
-  SamplerSpecification sampler_specification;
-  sampler_specification.address_mode_ = SamplerAddressMode::E_REPEAT;
+  LoadPrimitives(asset.get(), vertices_, indices_, meshes_, mesh_groups_);
+  LoadNodes(asset.get(), mesh_instances_);
 
-  // images_.reserve(asset->images.size());
-  for (auto &image : asset->images) {
-    auto image_name = std::get<fastgltf::sources::URI>(image.data).uri.path();
-    auto image_path = path.parent_path() / image_name;
-    images_.emplace_back(image_path, sampler_specification);
+  auto texture_images = LoadImagePaths(asset.get(), path, image_paths_);
+  for (auto &mesh : meshes_) {
+    mesh.color_texture_index = mesh.color_texture_index < 0 ? -1 : texture_images[mesh.color_texture_index];
+    mesh.normal_texture_index = mesh.normal_texture_index < 0 ? -1 : texture_images[mesh.normal_texture_index];
   }
 }
 
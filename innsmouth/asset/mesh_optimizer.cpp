@@ -0,0 +1,111 @@
+#include "innsmouth/asset/include/mesh_optimizer.h"
+#include "meshoptimizer.h"
+#include <algorithm>
+
+namespace Innsmouth {
+
+constexpr uint32_t VERTEX_CACHE_SIZE = 16;
+constexpr uint32_t VERTEX_WARP_SIZE = 0;
+constexpr uint32_t VERTEX_PRIMGROUP_SIZE = 0;
+constexpr float OVERDRAW_THRESHOLD = 1.05f;
+constexpr float MESHLET_CONE_WEIGHT = 0.25f;
+constexpr float LOD_REDUCTION = 0.5f;
+constexpr float LOD_MINIMUM_REDUCTION = 0.95f;
+constexpr float LOD_TARGET_ERROR = 0.1f;
+
+VertexCacheStatistics AnalyzeVertexCache(std::span<const uint32_t> indices, std::size_t vertices_count) {
+  if (indices.empty()) return VertexCacheStatistics();
+  auto statistics = meshopt_analyzeVertexCache(indices.data(), indices.size(), vertices_count, VERTEX_CACHE_SIZE, VERTEX_WARP_SIZE,
+                                               VERTEX_PRIMGROUP_SIZE);
+  return VertexCacheStatistics(statistics.acmr, statistics.atvr);
+}
+
+MeshOptimizationReport OptimizeMesh(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices) {
+  MeshOptimizationReport report;
+  report.vertices_before_ = vertices.size();
+  report.before_ = AnalyzeVertexCache(indices, vertices.size());
+  if (indices.empty()) return report;
+
+  // WELD
+  std::vector<uint32_t> remap(vertices.size());
+  auto vertices_count =
+    meshopt_generateVertexRemap(remap.data(), indices.data(), indices.size(), vertices.data(), vertices.size(), sizeof(Vertex));
+  meshopt_remapIndexBuffer(indices.data(), indices.data(), indices.size(), remap.data());
+  meshopt_remapVertexBuffer(vertices.data(), vertices.data(), vertices.size(), sizeof(Vertex), remap.data());
+  vertices.resize(vertices_count);
+
+  // VERTEX CACHE
+  meshopt_optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertices.size());
+
+  // OVERDRAW
+  meshopt_optimizeOverdraw(indices.data(), indices.data(), indices.size(), &vertices[0].position_.x, vertices.size(), sizeof(Vertex),
+                           OVERDRAW_THRESHOLD);
+
+  // VERTEX FETCH
+  meshopt_optimizeVertexFetch(vertices.data(), indices.data(), indices.size(), vertices.data(), vertices.size(), sizeof(Vertex));
+
+  report.vertices_after_ = vertices.size();
+  report.after_ = AnalyzeVertexCache(indices, vertices.size());
+  return report;
+}
+
+std::vector<MeshLodLevel> SimplifyMesh(std::span<const Vertex> vertices, std::span<const uint32_t> indices, uint32_t lods_count) {
+  std::vector<MeshLodLevel> lods;
+  if (indices.empty()) return lods;
+  auto positions = &vertices[0].position_.x;
+  auto scale = meshopt_simplifyScale(positions, vertices.size(), sizeof(Vertex));
+  auto previous_count = indices.size();
+  auto target_count = float(indices.size());
+  float error = 0.0f;
+  for (auto level = 1; level < lods_count; level++) {
+    target_count *= LOD_REDUCTION;
+    std::vector<uint32_t> lod_indices(indices.size());
+    float lod_error = 0.0f;
+    auto count = meshopt_simplify(lod_indices.data(), indices.data(), indices.size(), positions, vertices.size(), sizeof(Vertex),
+                                  std::size_t(target_count) / 3 * 3, LOD_TARGET_ERROR, 0, &lod_error);
+    // STOP WHEN SIMPLIFICATION STALLS
+    if (count == 0 || count > previous_count * LOD_MINIMUM_REDUCTION) break;
+    lod_indices.resize(count);
+    meshopt_optimizeVertexCache(lod_indices.data(), lod_indices.data(), count, vertices.size());
+    error = std::max(error, lod_error * scale);
+    lods.emplace_back(std::move(lod_indices), error);
+    previous_count = count;
+  }
+  return lods;
+}
+
+void BuildMeshlets(std::span<const Vertex> vertices, std::span<const uint32_t> indices, uint32_t vertices_offset, MeshletData &out_meshlets) {
+  if (indices.empty()) return;
+  auto positions = &vertices[0].position_.x;
+  auto max_meshlets = meshopt_buildMeshletsBound(indices.size(), MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES);
+  std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+  std::vector<uint32_t> meshlet_vertices(max_meshlets * MESHLET_MAX_VERTICES);
+  std::vector<uint8_t> meshlet_triangles(max_meshlets * MESHLET_MAX_TRIANGLES * 3);
+  auto meshlets_count = meshopt_buildMeshlets(meshlets.data(), meshlet_vertices.data(), meshlet_triangles.data(), indices.data(), indices.size(),
+                                              positions, vertices.size(), sizeof(Vertex), MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES,
+                                              MESHLET_CONE_WEIGHT);
+  for (auto i = 0; i < meshlets_count; i++) {
+    const auto &meshlet = meshlets[i];
+    auto local_vertices = std::span(meshlet_vertices).subspan(meshlet.vertex_offset, meshlet.vertex_count);
+    auto local_triangles = std::span(meshlet_triangles).subspan(meshlet.triangle_offset, meshlet.triangle_count * 3);
+    auto bounds = meshopt_computeMeshletBounds(local_vertices.data(), local_triangles.data(), meshlet.triangle_count, positions, vertices.size(),
+                                               sizeof(Vertex));
+    auto &out_meshlet = out_meshlets.meshlets_.emplace_back();
+    out_meshlet.center = Vector3f(bounds.center[0], bounds.center[1], bounds.center[2]);
+    out_meshlet.radius = bounds.radius;
+    out_meshlet.cone_axis = Vector3f(bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2]);
+    out_meshlet.cone_cutoff = bounds.cone_cutoff;
+    out_meshlet.vertices_offset = out_meshlets.vertices_.size();
+    out_meshlet.triangles_offset = out_meshlets.triangles_.size();
+    out_meshlet.vertices_count = meshlet.vertex_count;
+    out_meshlet.triangles_count = meshlet.triangle_count;
+    for (auto vertex : local_vertices) {
+      out_meshlets.vertices_.emplace_back(vertex + vertices_offset);
+    }
+    for (auto t = 0; t < local_triangles.size(); t += 3) {
+      out_meshlets.triangles_.emplace_back(local_triangles[t] | local_triangles[t + 1] << 8 | local_triangles[t + 2] << 16);
+    }
+  }
+}
+
+} // namespace Innsmouth
\ No newline at end of file
@@ -1,9 +1,150 @@
 #include "innsmouth/asset/include/model.h"
+#include <algorithm>
+#include <limits>
 
 namespace Innsmouth {
 
-Model::Model(const std::filesystem::path &path) {
-  LoadKhronos(path);
+Model::Model(const std::filesystem::path &path, const ModelSpecification &specification) {
+  if (path.extension() == ".obj") {
+    LoadWavefront(path);
+  } else {
+    LoadKhronos(path);
+  }
+  if (specification.load_images_) {
+    LoadImages();
+  }
+  BuildInstances();
+  if (specification.optimize_) {
+    Optimize();
+  }
+  GenerateLods(std::clamp(specification.lods_count_, 1u, MESH_MAX_LODS));
+  if (specification.build_meshlets_) {
+    BuildMeshlets();
+  }
+  if (specification.pack_vertices_) {
+    PackVertices();
+  }
+}
+
+std::size_t Model::GetMeshVerticesEnd(std::size_t mesh_index) const {
+  return (mesh_index + 1 < meshes_.size()) ? meshes_[mesh_index + 1].vertices_offset : vertices_.size();
+}
+
+std::vector<uint32_t> Model::GetMeshLocalIndices(std::size_t mesh_index) const {
+  const auto &mesh = meshes_[mesh_index];
+  std::vector<uint32_t> mesh_indices(indices_.begin() + mesh.indices_offset, indices_.begin() + mesh.indices_offset + mesh.indices_size);
+  for (auto &index : mesh_indices) {
+    index -= mesh.vertices_offset;
+  }
+  return mesh_indices;
+}
+
+void Model::LoadImages() {
+  // COLOR TEXTURES STAY 8 BIT sRGB FOR THE SAMPLER TO LINEARIZE, HDR SOURCES STAY 16F, NORMAL MAPS KEEP THE TWO CHANNELS Z COMES FROM
+  std::vector<ImageConversion> conversions(image_paths_.size(), ImageConversion::E_RGBA8);
+  for (const auto &mesh : meshes_) {
+    if (mesh.normal_texture_index >= 0) conversions[mesh.normal_texture_index] = ImageConversion::E_RG8_NORMAL;
+  }
+  for (const auto &mesh : meshes_) {
+    if (mesh.color_texture_index >= 0) conversions[mesh.color_texture_index] = ImageConversion::E_RGBA8_SRGB;
+  }
+  SamplerSpecification sampler_specification;
+  sampler_specification.address_mode_ = SamplerAddressMode::E_REPEAT;
+  images_ = Image2D::Load(image_paths_, sampler_specification, conversions);
+}
+
+void Model::BuildInstances() {
+  std::vector<std::vector<Matrix4f>> group_transforms(mesh_groups_.size());
+  for (const auto &instance : mesh_instances_) {
+    group_transforms[instance.group_index_].emplace_back(instance.transform_);
+  }
+  instance_transforms_.clear();
+  // EVERY PRIMITIVE OF A GROUP SHARES THE GROUP'S RUN OF TRANSFORMS
+  for (auto i = 0; i < mesh_groups_.size(); i++) {
+    const auto &[meshes_offset, meshes_count] = mesh_groups_[i];
+    for (auto &mesh : std::span(meshes_).subspan(meshes_offset, meshes_count)) {
+      mesh.instances_offset = instance_transforms_.size();
+      mesh.instances_count = group_transforms[i].size();
+    }
+    instance_transforms_.insert(instance_transforms_.end(), group_transforms[i].begin(), group_transforms[i].end());
+  }
+}
+
+void Model::Optimize() {
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  vertices.reserve(vertices_.size());
+  indices.reserve(indices_.size());
+  optimization_report_ = MeshOptimizationReport();
+  float transformed_before = 0.0f, transformed_after = 0.0f;
+  for (auto i = 0; i < meshes_.size(); i++) {
+    auto &mesh = meshes_[i];
+    std::vector<Vertex> mesh_vertices(vertices_.begin() + mesh.vertices_offset, vertices_.begin() + GetMeshVerticesEnd(i));
+    auto mesh_indices = GetMeshLocalIndices(i);
+    auto report = OptimizeMesh(mesh_vertices, mesh_indices);
+    mesh.vertices_offset = vertices.size();
+    mesh.indices_offset = indices.size();
+    for (auto index : mesh_indices) {
+      indices.emplace_back(index + mesh.vertices_offset);
+    }
+    vertices.insert(vertices.end(), mesh_vertices.begin(), mesh_vertices.end());
+    optimization_report_.vertices_before_ += report.vertices_before_;
+    optimization_report_.vertices_after_ += report.vertices_after_;
+    transformed_before += report.before_.acmr_ * mesh.indices_size / 3.0f;
+    transformed_after += report.after_.acmr_ * mesh.indices_size / 3.0f;
+  }
+  vertices_ = std::move(vertices);
+  indices_ = std::move(indices);
+  if (indices_.empty()) return;
+  auto triangles_count = indices_.size() / 3.0f;
+  auto &[before, after, vertices_before, vertices_after] = optimization_report_;
+  before = VertexCacheStatistics(transformed_before / triangles_count, transformed_before / vertices_before);
+  after = VertexCacheStatistics(transformed_after / triangles_count, transformed_after / vertices_after);
+}
+
+void Model::GenerateLods(uint32_t lods_count) {
+  base_indices_count_ = indices_.size();
+  for (auto i = 0; i < meshes_.size(); i++) {
+    auto &mesh = meshes_[i];
+    auto mesh_vertices = std::span(vertices_).subspan(mesh.vertices_offset, GetMeshVerticesEnd(i) - mesh.vertices_offset);
+    auto minimum = Vector3f(std::numeric_limits<float>::max());
+    auto maximum = Vector3f(std::numeric_limits<float>::lowest());
+    for (const auto &vertex : mesh_vertices) {
+      minimum = glm::min(minimum, vertex.position_);
+      maximum = glm::max(maximum, vertex.position_);
+    }
+    mesh.center = mesh_vertices.empty() ? Vector3f(0.0f) : 0.5f * (minimum + maximum);
+    mesh.radius = mesh_vertices.empty() ? 0.0f : 0.5f * glm::length(maximum - minimum);
+    mesh.lods[0] = MeshLod(mesh.indices_offset, mesh.indices_size, 0.0f);
+    mesh.lods_count = 1;
+    if (lods_count == 1) continue;
+    for (const auto &lod : SimplifyMesh(mesh_vertices, GetMeshLocalIndices(i), lods_count)) {
+      mesh.lods[mesh.lods_count++] = MeshLod(indices_.size(), lod.indices_.size(), lod.error_);
+      for (auto index : lod.indices_) {
+        indices_.emplace_back(index + mesh.vertices_offset);
+      }
+    }
+  }
+}
+
+void Model::BuildMeshlets() {
+  meshlet_data_ = MeshletData();
+  for (auto i = 0; i < meshes_.size(); i++) {
+    const auto &mesh = meshes_[i];
+    auto mesh_vertices = std::span(vertices_).subspan(mesh.vertices_offset, GetMeshVerticesEnd(i) - mesh.vertices_offset);
+    auto mesh_indices = GetMeshLocalIndices(i);
+    Innsmouth::BuildMeshlets(mesh_vertices, mesh_indices, mesh.vertices_offset, meshlet_data_);
+  }
+}
+
+void Model::PackVertices() {
+  packed_vertices_.clear();
+  packed_vertices_.reserve(vertices_.size());
+  for (auto i = 0; i < meshes_.size(); i++) {
+    auto &mesh = meshes_[i];
+    auto mesh_vertices = std::span(vertices_).subspan(mesh.vertices_offset, GetMeshVerticesEnd(i) - mesh.vertices_offset);
+    Innsmouth::PackVertices(mesh_vertices, mesh, packed_vertices_);
+  }
 }
 
 std::size_t Model::GetVerticesNumber() const {
@@ -18,16 +159,60 @@ std::span<const Vertex> Model::GetVertices() const {
   return vertices_;
 }
 
+std::span<const PackedVertex> Model::GetPackedVertices() const {
+  return packed_vertices_;
+}
+
 std::span<const uint32_t> Model::GetIndices() const {
   return indices_;
 }
 
+std::span<const uint32_t> Model::GetBaseIndices() const {
+  return std::span(indices_).first(base_indices_count_);
+}
+
 std::span<const Mesh> Model::GetMeshes() const {
   return meshes_;
 }
 
+std::span<const MeshGroup> Model::GetMeshGroups() const {
+  return mesh_groups_;
+}
+
+std::span<const MeshInstance> Model::GetMeshInstances() const {
+  return mesh_instances_;
+}
+
+std::span<const Matrix4f> Model::GetInstanceTransforms() const {
+  return instance_transforms_;
+}
+
 std::span<const Image2D> Model::GetImages() const {
   return images_;
 }
 
+std::span<const std::filesystem::path> Model::GetImagePaths() const {
+  return image_paths_;
+}
+
+std::span<const std::filesystem::path> Model::GetSourcePaths() const {
+  return source_paths_;
+}
+
+const MeshOptimizationReport &Model::GetOptimizationReport() const {
+  return optimization_report_;
+}
+
+std::span<const Meshlet> Model::GetMeshlets() const {
+  return meshlet_data_.meshlets_;
+}
+
+std::span<const uint32_t> Model::GetMeshletVertices() const {
+  return meshlet_data_.vertices_;
+}
+
+std::span<const uint32_t> Model::GetMeshletTriangles() const {
+  return meshlet_data_.triangles_;
+}
+
 } // namespace Innsmouth
\ No newline at end of file
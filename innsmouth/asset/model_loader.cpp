@@ -0,0 +1,366 @@
+#include "innsmouth/asset/include/model_loader.h"
+#include "innsmouth/graphics/command/command_buffer.h"
+#include "innsmouth/graphics/image/texture_streamer.h"
+#include "innsmouth/graphics/synchronization/timeline_semaphore.h"
+#include "innsmouth/core/include/type_tools.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+namespace Innsmouth {
+
+constexpr uint32_t BLAS_CACHE_MAGIC = 0x53414c42;
+constexpr uint32_t BLAS_CACHE_VERSION = 2;
+
+// FOLLOWED BY ONE 64 BIT SIZE PER BOTTOM LEVEL, THEN THE SERIALIZED BLOBS
+struct BottomLevelCacheHeader {
+  uint32_t magic_ = BLAS_CACHE_MAGIC;
+  uint32_t version_ = BLAS_CACHE_VERSION;
+  uint64_t source_size_ = 0;
+  int64_t source_time_ = 0;
+  uint32_t optimize_ = 0;
+  uint32_t lods_count_ = 0;
+  uint32_t blases_count_ = 0;
+  uint32_t padding_ = 0;
+  uint64_t dependencies_hash_ = 0;
+};
+
+std::filesystem::path GetBottomLevelCachePath(const std::filesystem::path &path) {
+  auto cache_path = path;
+  cache_path += ".blas";
+  return cache_path;
+}
+
+// EXTERNAL BUFFERS, MATERIAL LIBRARIES AND IMAGES, A MISSING FILE HASHES AS EMPTY SO IT STILL INVALIDATES ONCE IT APPEARS
+std::vector<std::filesystem::path> GetBottomLevelCacheDependencies(const Model &model) {
+  std::vector<std::filesystem::path> dependencies(model.GetSourcePaths().begin(), model.GetSourcePaths().end());
+  dependencies.insert(dependencies.end(), model.GetImagePaths().begin(), model.GetImagePaths().end());
+  return dependencies;
+}
+
+uint64_t HashDependencies(std::span<const std::filesystem::path> dependencies) {
+  std::size_t seed = 0;
+  for (const auto &dependency : dependencies) {
+    std::error_code size_error, time_error;
+    auto size = std::filesystem::file_size(dependency, size_error);
+    auto time = std::filesystem::last_write_time(dependency, time_error);
+    HashCombine(seed, dependency.generic_string());
+    HashCombine(seed, size_error ? uintmax_t(0) : size);
+    HashCombine(seed, time_error ? int64_t(0) : int64_t(time.time_since_epoch().count()));
+  }
+  return seed;
+}
+
+BottomLevelCacheHeader GetBottomLevelCacheHeader(const std::filesystem::path &path, std::span<const std::filesystem::path> dependencies,
+                                                 const ModelSpecification &specification, uint32_t blases_count) {
+  BottomLevelCacheHeader header;
+  header.source_size_ = std::filesystem::file_size(path);
+  header.source_time_ = std::filesystem::last_write_time(path).time_since_epoch().count();
+  header.dependencies_hash_ = HashDependencies(dependencies);
+  header.optimize_ = specification.optimize_;
+  header.lods_count_ = specification.lods_count_;
+  header.blases_count_ = blases_count;
+  return header;
+}
+
+ModelLoadStage ModelAsset::GetStage() const {
+  return stage_;
+}
+
+bool ModelAsset::IsGeometryReady() const {
+  return stage_ != ModelLoadStage::E_PARSING;
+}
+
+bool ModelAsset::IsReady() const {
+  return stage_ == ModelLoadStage::E_READY;
+}
+
+const Model &ModelAsset::GetModel() const {
+  return model_;
+}
+
+const Buffer &ModelAsset::GetVertexBuffer() const {
+  return vertex_buffer_;
+}
+
+const Buffer &ModelAsset::GetPackedVertexBuffer() const {
+  return packed_vertex_buffer_;
+}
+
+const Buffer &ModelAsset::GetIndexBuffer() const {
+  return index_buffer_;
+}
+
+const Buffer &ModelAsset::GetMeshBuffer() const {
+  return mesh_buffer_;
+}
+
+const Buffer &ModelAsset::GetInstanceBuffer() const {
+  return instance_buffer_;
+}
+
+std::span<const AccelerationStructure> ModelAsset::GetBottomLevelStructures() const {
+  return blases_;
+}
+
+std::span<const uint32_t> ModelAsset::GetTextureHandles() const {
+  return texture_handles_;
+}
+
+ModelLoader::ModelLoader(TextureStreamer &texture_streamer, const ModelLoaderSpecification &specification)
+  : texture_streamer_(&texture_streamer), specification_(specification) {
+}
+
+std::shared_ptr<const ModelAsset> ModelLoader::Load(const std::filesystem::path &path, const ModelSpecification &specification) {
+  auto model_asset = std::make_shared<ModelAsset>();
+  model_asset->path_ = path;
+  model_asset->specification_ = specification;
+  // PARSE, OPTIMIZE AND LOD GENERATION STAY ON THE CPU, IMAGES ARE DECODED BY THE TEXTURE STREAMER
+  model_asset->model_future_ = std::async(std::launch::async, [path, specification] {
+    auto model_specification = specification;
+    model_specification.load_images_ = false;
+    return Model(path, model_specification);
+  });
+  pending_assets_.emplace_back(model_asset);
+  return model_asset;
+}
+
+template <typename T> std::size_t StageData(Buffer &staging_buffer, std::size_t offset, std::span<const T> data) {
+  staging_buffer.SetData(data, offset);
+  return AlignUp(offset + data.size_bytes(), 16);
+}
+
+void ModelLoader::UploadGeometry(CommandBuffer &command_buffer, ModelAsset &model_asset) {
+  const auto &model = model_asset.model_;
+
+  // NORMAL MAPS ARE DATA, ONLY COLOR TEXTURES ARE DECODED AS sRGB
+  auto image_paths = model.GetImagePaths();
+  std::vector<ImageConversion> conversions(image_paths.size(), ImageConversion::E_RGBA8_SRGB);
+  for (const auto &mesh : model.GetMeshes()) {
+    if (mesh.normal_texture_index >= 0) conversions[mesh.normal_texture_index] = ImageConversion::E_RGBA8;
+  }
+  SamplerSpecification sampler_specification;
+  sampler_specification.address_mode_ = SamplerAddressMode::E_REPEAT;
+  for (auto i = 0; i < image_paths.size(); i++) {
+    model_asset.texture_handles_.emplace_back(texture_streamer_->Register(image_paths[i], sampler_specification, conversions[i]));
+  }
+
+  std::vector<Mesh> meshes(model.GetMeshes().begin(), model.GetMeshes().end());
+  for (auto &mesh : meshes) {
+    const auto &handles = model_asset.texture_handles_;
+    mesh.color_texture_index = mesh.color_texture_index < 0 ? -1 : int32_t(handles[mesh.color_texture_index]);
+    mesh.normal_texture_index = mesh.normal_texture_index < 0 ? -1 : int32_t(handles[mesh.normal_texture_index]);
+  }
+
+  auto vertices = model.GetVertices();
+  auto packed_vertices = model.GetPackedVertices();
+  auto indices = model.GetIndices();
+  auto instance_transforms = model.GetInstanceTransforms();
+
+  BufferUsageMask geometry_usage = BufferUsageMaskBits::E_SHADER_DEVICE_ADDRESS_BIT | BufferUsageMaskBits::E_TRANSFER_DST_BIT |
+                                   BufferUsageMaskBits::E_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
+  BufferUsageMask storage_usage = BufferUsageMaskBits::E_STORAGE_BUFFER_BIT | BufferUsageMaskBits::E_TRANSFER_DST_BIT;
+
+  auto &vertex_buffer = model_asset.vertex_buffer_;
+  auto &packed_vertex_buffer = model_asset.packed_vertex_buffer_;
+  auto &index_buffer = model_asset.index_buffer_;
+  auto &mesh_buffer = model_asset.mesh_buffer_;
+  auto &instance_buffer = model_asset.instance_buffer_;
+
+  vertex_buffer = Buffer(std::max(vertices.size_bytes(), sizeof(Vertex)), geometry_usage | BufferUsageMaskBits::E_STORAGE_BUFFER_BIT, {});
+  packed_vertex_buffer = Buffer(std::max(packed_vertices.size_bytes(), sizeof(PackedVertex)), storage_usage, {});
+  index_buffer = Buffer(std::max(indices.size_bytes(), sizeof(uint32_t)), geometry_usage | BufferUsageMaskBits::E_INDEX_BUFFER_BIT, {});
+  mesh_buffer = Buffer(std::max(meshes.size() * sizeof(Mesh), sizeof(Mesh)), storage_usage, {});
+  instance_buffer = Buffer(std::max(instance_transforms.size_bytes(), sizeof(Matrix4f)), storage_usage, {});
+
+  auto staging_size = AlignUp(vertices.size_bytes(), 16) + AlignUp(packed_vertices.size_bytes(), 16) + AlignUp(indices.size_bytes(), 16) +
+                      AlignUp(meshes.size() * sizeof(Mesh), 16) + AlignUp(instance_transforms.size_bytes(), 16);
+  Buffer staging_buffer(std::max(staging_size, std::size_t(16)), BufferUsageMaskBits::E_TRANSFER_SRC_BIT, Buffer::CPU);
+
+  std::array<std::size_t, 5> offsets = {0};
+  offsets[1] = StageData(staging_buffer, offsets[0], vertices);
+  offsets[2] = StageData(staging_buffer, offsets[1], packed_vertices);
+  offsets[3] = StageData(staging_buffer, offsets[2], indices);
+  offsets[4] = StageData<Mesh>(staging_buffer, offsets[3], meshes);
+  StageData(staging_buffer, offsets[4], instance_transforms);
+
+  auto copy = [&](const Buffer &destination, uint32_t index, std::size_t size) {
+    if (size > 0) command_buffer.CommandCopyBuffer(staging_buffer.GetHandle(), destination.GetHandle(), offsets[index], 0, size);
+  };
+  copy(vertex_buffer, 0, vertices.size_bytes());
+  copy(packed_vertex_buffer, 1, packed_vertices.size_bytes());
+  copy(index_buffer, 2, indices.size_bytes());
+  copy(mesh_buffer, 3, meshes.size() * sizeof(Mesh));
+  copy(instance_buffer, 4, instance_transforms.size_bytes());
+
+  command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_COPY_BIT, AccessMaskBits2::E_TRANSFER_WRITE_BIT,
+                                      PipelineStageMaskBits2::E_ALL_COMMANDS_BIT, AccessMaskBits2::E_MEMORY_READ_BIT);
+
+  build_buffers_.emplace_back(std::move(staging_buffer));
+}
+
+uint32_t ModelLoader::BuildBottomLevel(CommandBuffer &command_buffer, ModelAsset &model_asset, uint32_t budget) {
+  const auto &model = model_asset.model_;
+  auto meshes = model.GetMeshes();
+  auto mesh_groups = model.GetMeshGroups();
+  auto vertex_address = model_asset.vertex_buffer_.GetBufferAddress();
+  auto index_address = model_asset.index_buffer_.GetBufferAddress();
+
+  uint32_t builds = 0;
+  for (; builds < budget && model_asset.blases_.size() < mesh_groups.size(); builds++) {
+    if (model_asset.cached_blases_.empty() == false) {
+      model_asset.blases_.emplace_back(command_buffer, model_asset.cached_blases_[model_asset.blases_.size()], build_buffers_);
+      continue;
+    }
+    const auto &[meshes_offset, meshes_count] = mesh_groups[model_asset.blases_.size()];
+    BottomLevelGeometry geometry;
+    for (const auto &mesh : meshes.subspan(meshes_offset, meshes_count)) {
+      TriangleGeometrySpecification specification;
+      specification.vertices_count_ = model.GetVerticesNumber();
+      specification.indices_count_ = mesh.indices_size;
+      specification.vbo_offset_ = vertex_address;
+      specification.ibo_offset_ = index_address;
+      specification.first_index_ = mesh.indices_offset;
+      specification.vertex_stride_ = sizeof(Vertex);
+      geometry.AddTriangleGeometry(specification);
+    }
+    model_asset.blases_.emplace_back(command_buffer, geometry, build_buffers_);
+  }
+  return builds;
+}
+
+void ModelLoader::ReadBottomLevelCache(ModelAsset &model_asset) {
+  auto cache_path = GetBottomLevelCachePath(model_asset.path_);
+  if (specification_.cache_acceleration_structures_ == false || std::filesystem::exists(cache_path) == false) return;
+
+  auto blases_count = model_asset.model_.GetMeshGroups().size();
+  auto dependencies = GetBottomLevelCacheDependencies(model_asset.model_);
+  auto expected_header = GetBottomLevelCacheHeader(model_asset.path_, dependencies, model_asset.specification_, blases_count);
+  auto table_size = sizeof(BottomLevelCacheHeader) + blases_count * sizeof(uint64_t);
+
+  MappedFile blas_cache(cache_path);
+  auto data = std::as_bytes(blas_cache.GetData());
+  if (data.size() < table_size || std::memcmp(data.data(), &expected_header, sizeof(expected_header)) != 0) return;
+
+  std::vector<uint64_t> sizes(blases_count);
+  std::memcpy(sizes.data(), data.data() + sizeof(BottomLevelCacheHeader), blases_count * sizeof(uint64_t));
+
+  // A DRIVER UPDATE INVALIDATES THE WHOLE FILE, THE BOTTOM LEVELS ARE REBUILT AND WRITTEN AGAIN
+  std::vector<std::span<const std::byte>> cached_blases;
+  auto offset = table_size;
+  for (auto size : sizes) {
+    if (offset + size > data.size()) return;
+    auto blob = data.subspan(offset, size);
+    if (AccelerationStructure::IsCompatible(blob) == false) return;
+    cached_blases.emplace_back(blob);
+    offset += size;
+  }
+  model_asset.blas_cache_ = std::move(blas_cache);
+  model_asset.cached_blases_ = std::move(cached_blases);
+}
+
+// RUNS ON A WORKER, THE FILES ARE STATTED HERE TOO SO THE FRAME NEVER TOUCHES THE DISK
+void WriteBottomLevelCache(const std::filesystem::path &path, std::span<const std::filesystem::path> dependencies,
+                           const ModelSpecification &specification, std::span<const std::vector<std::byte>> serialized_blases) {
+  auto header = GetBottomLevelCacheHeader(path, dependencies, specification, serialized_blases.size());
+  std::vector<uint64_t> sizes;
+  for (const auto &serialized_blas : serialized_blases) {
+    sizes.emplace_back(serialized_blas.size());
+  }
+
+  // WRITTEN UNDER A TEMPORARY NAME SO AN INTERRUPTED WRITE NEVER LEAVES A TRUNCATED CACHE
+  auto cache_path = GetBottomLevelCachePath(path);
+  auto temporary_path = cache_path;
+  temporary_path += ".tmp";
+  {
+    std::ofstream file(temporary_path, std::ios::binary);
+    if (file.is_open() == false) return;
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(sizes.data()), sizes.size() * sizeof(uint64_t));
+    for (const auto &serialized_blas : serialized_blases) {
+      file.write(reinterpret_cast<const char *>(serialized_blas.data()), serialized_blas.size());
+    }
+    if (file.good() == false) return;
+  }
+  std::error_code error_code;
+  std::filesystem::rename(temporary_path, cache_path, error_code);
+}
+
+void ModelLoader::UpdateBottomLevelCache(CommandBuffer &command_buffer) {
+  auto retired_value = GraphicsContext::Get()->GetRetiredFrameValue();
+  auto frame_value = GraphicsContext::Get()->GetGraphicsTimeline().GetNextValue();
+  for (auto &cache_write : cache_writes_) {
+    if (cache_write.frame_value_ > retired_value) continue;
+    auto &model_asset = *cache_write.model_asset_;
+    if (cache_write.sizes_.empty()) {
+      cache_write.sizes_ = cache_write.query_pool_->GetResults(0, model_asset.blases_.size());
+      cache_write.readback_buffer_ = AccelerationStructure::CommandSerialize(command_buffer, model_asset.blases_, cache_write.sizes_);
+      cache_write.frame_value_ = frame_value;
+      continue;
+    }
+    // ONLY THE COPY OUT OF THE MAPPED BUFFER STAYS ON THIS THREAD
+    auto serialized_blases = AccelerationStructure::ReadSerialized(cache_write.readback_buffer_, cache_write.sizes_);
+    auto dependencies = GetBottomLevelCacheDependencies(model_asset.model_);
+    cache_files_.emplace_back(std::async(std::launch::async, [path = model_asset.path_, dependencies = std::move(dependencies),
+                                                             specification = model_asset.specification_,
+                                                             serialized_blases = std::move(serialized_blases)] {
+      WriteBottomLevelCache(path, dependencies, specification, serialized_blases);
+    }));
+    cache_write.model_asset_.reset();
+  }
+  std::erase_if(cache_writes_, [](const auto &cache_write) { return cache_write.model_asset_ == nullptr; });
+  std::erase_if(cache_files_, [](const auto &cache_file) { return cache_file.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+}
+
+void ModelLoader::Update(CommandBuffer &command_buffer) {
+  UpdateBottomLevelCache(command_buffer);
+
+  auto budget = specification_.blas_builds_per_frame_;
+  for (auto &model_asset : pending_assets_) {
+    if (model_asset->stage_ == ModelLoadStage::E_PARSING) {
+      if (model_asset->model_future_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) continue;
+      model_asset->model_ = model_asset->model_future_.get();
+      ReadBottomLevelCache(*model_asset);
+      UploadGeometry(command_buffer, *model_asset);
+      model_asset->stage_ = ModelLoadStage::E_GEOMETRY;
+      continue;
+    }
+    budget -= BuildBottomLevel(command_buffer, *model_asset, budget);
+    if (model_asset->blases_.size() == model_asset->model_.GetMeshGroups().size()) {
+      model_asset->stage_ = ModelLoadStage::E_READY;
+      // THE SIZE QUERY IS RECORDED AFTER THE BUILD BARRIER BELOW
+      if (specification_.cache_acceleration_structures_ && model_asset->cached_blases_.empty() && model_asset->blases_.empty() == false) {
+        auto query_pool = std::make_unique<QueryPool>(QueryType::E_ACCELERATION_STRUCTURE_SERIALIZATION_SIZE_KHR, model_asset->blases_.size());
+        cache_writes_.emplace_back(model_asset, std::move(query_pool));
+      }
+      model_asset->cached_blases_.clear();
+      model_asset->blas_cache_ = MappedFile();
+    }
+  }
+
+  if (budget != specification_.blas_builds_per_frame_) {
+    command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                                        AccessMaskBits2::E_ACCELERATION_STRUCTURE_WRITE_BIT_KHR, PipelineStageMaskBits2::E_ALL_COMMANDS_BIT,
+                                        AccessMaskBits2::E_ACCELERATION_STRUCTURE_READ_BIT_KHR);
+  }
+
+  for (auto &cache_write : cache_writes_) {
+    if (cache_write.frame_value_ != 0) continue;
+    AccelerationStructure::CommandWriteSerializedSizes(command_buffer, cache_write.model_asset_->blases_, *cache_write.query_pool_);
+    cache_write.frame_value_ = GraphicsContext::Get()->GetGraphicsTimeline().GetNextValue();
+  }
+
+  // BUILD INPUTS LIVE UNTIL THE FRAME THEY WERE RECORDED INTO COMPLETES
+  for (auto &build_buffer : build_buffers_) {
+    GraphicsContext::Get()->DeferDestruction(std::move(build_buffer));
+  }
+  build_buffers_.clear();
+
+  std::erase_if(pending_assets_, [](const auto &model_asset) { return model_asset->IsReady(); });
+}
+
+std::size_t ModelLoader::GetPendingCount() const {
+  return pending_assets_.size();
+}
+
+} // namespace Innsmouth
\ No newline at end of file
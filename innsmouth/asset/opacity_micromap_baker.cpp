@@ -0,0 +1,243 @@
+#include "innsmouth/asset/include/opacity_micromap_baker.h"
+#include "innsmouth/asset/include/model.h"
+#include "innsmouth/core/include/image_wrapper.h"
+#include "innsmouth/core/include/parallel_for.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <ranges>
+
+namespace Innsmouth {
+
+constexpr uint32_t MAX_SAMPLES_PER_EDGE = 32;
+
+struct AlphaTexture {
+  int32_t width_ = 0;
+  int32_t height_ = 0;
+  std::vector<uint8_t> alpha_;
+
+  bool IsValid() const {
+    return width_ > 0 && height_ > 0;
+  }
+
+  float Fetch(int32_t x, int32_t y) const {
+    x = (x % width_ + width_) % width_;
+    y = (y % height_ + height_) % height_;
+    return alpha_[y * width_ + x] * (1.0f / 255.0f);
+  }
+
+  // BILINEAR WITH REPEAT, AS THE ANY-HIT SAMPLES LEVEL ZERO
+  float Sample(const Vector2f &uv) const {
+    auto position = uv * Vector2f(width_, height_) - 0.5f;
+    auto base = glm::floor(position);
+    auto fraction = position - base;
+    auto x = int32_t(base.x), y = int32_t(base.y);
+    auto top = glm::mix(Fetch(x, y), Fetch(x + 1, y), fraction.x);
+    auto bottom = glm::mix(Fetch(x, y + 1), Fetch(x + 1, y + 1), fraction.x);
+    return glm::mix(top, bottom, fraction.y);
+  }
+};
+
+struct BakedTriangle {
+  int32_t special_index_ = int32_t(OpacityMicromapSpecialIndexEXT::E_FULLY_OPAQUE_EXT);
+  uint32_t subdivision_level_ = 0;
+  std::vector<std::byte> data_;
+  uint32_t unknown_count_ = 0;
+};
+
+AlphaTexture LoadAlphaTexture(const std::filesystem::path &path) {
+  ImageWrapper image(path);
+  AlphaTexture texture;
+  if (image.GetData().data() == nullptr) return texture;
+  texture.width_ = image.GetWidth();
+  texture.height_ = image.GetHeight();
+  auto pixels = image.GetData();
+  texture.alpha_.resize(texture.width_ * texture.height_);
+  for (auto i = 0; i < texture.alpha_.size(); i++) {
+    texture.alpha_[i] = uint8_t(pixels[4 * i + 3]);
+  }
+  return texture;
+}
+
+uint32_t ExtractEvenBits(uint32_t x) {
+  x &= 0x55555555;
+  x = (x | (x >> 1)) & 0x33333333;
+  x = (x | (x >> 2)) & 0x0f0f0f0f;
+  x = (x | (x >> 4)) & 0x00ff00ff;
+  x = (x | (x >> 8)) & 0x0000ffff;
+  return x;
+}
+
+uint32_t PrefixXor(uint32_t x) {
+  x ^= x >> 1;
+  x ^= x >> 2;
+  x ^= x >> 4;
+  x ^= x >> 8;
+  return x;
+}
+
+std::array<Vector2f, 3> GetMicroTriangleBarycentrics(uint32_t index, uint32_t subdivision_level) {
+  auto b0 = ExtractEvenBits(index);
+  auto b1 = ExtractEvenBits(index >> 1);
+  auto fx = PrefixXor(b0);
+  auto fy = PrefixXor(b0 & ~b1);
+  auto t = fy ^ b1;
+  auto u = (fx & ~t) | (b0 & ~t) | (~b0 & ~fx & t);
+  auto v = fy ^ b0;
+  auto w = (~fx & ~t) | (b0 & ~t) | (~b0 & fx & t);
+
+  // PARITY BEFORE MASKING, AT LEVEL ZERO THE MASK CLEARS EVERY BIT
+  auto upright = ((u ^ v ^ w) & 1) != 0;
+  auto mask = (1u << subdivision_level) - 1;
+  u &= mask;
+  v &= mask;
+  if (upright == false) {
+    u++;
+    v++;
+  }
+
+  auto scale = 1.0f / float(1u << subdivision_level);
+  auto step = upright ? 1.0f : -1.0f;
+  Vector2f corner(u, v);
+  return {corner * scale, (corner + Vector2f(step, 0.0f)) * scale, (corner + Vector2f(0.0f, step)) * scale};
+}
+
+uint32_t GetDataSize(uint32_t subdivision_level) {
+  return std::max(1u, (1u << (2 * subdivision_level)) / 4);
+}
+
+uint32_t GetSubdivisionLevel(const std::array<Vector2f, 3> &texels, const OpacityMicromapBakeSpecification &specification) {
+  auto edge_1 = texels[1] - texels[0];
+  auto edge_2 = texels[2] - texels[0];
+  auto area = 0.5f * std::abs(edge_1.x * edge_2.y - edge_1.y * edge_2.x);
+  auto ratio = area / specification.texels_per_micro_triangle_;
+  auto level = ratio > 1.0f ? uint32_t(std::ceil(0.5f * std::log2(ratio))) : 0u;
+  return std::min(level, specification.max_subdivision_level_);
+}
+
+MicroTriangleOpacity ClassifyMicroTriangle(const AlphaTexture &texture, const std::array<Vector2f, 3> &uvs, float alpha_cutoff,
+                                           const OpacityMicromapBakeSpecification &specification) {
+  auto size = Vector2f(texture.width_, texture.height_);
+  auto edge = std::max({glm::length((uvs[1] - uvs[0]) * size), glm::length((uvs[2] - uvs[0]) * size), glm::length((uvs[2] - uvs[1]) * size)});
+  auto samples = std::clamp(uint32_t(std::ceil(edge * specification.samples_per_texel_)), 1u, MAX_SAMPLES_PER_EDGE);
+
+  uint32_t opaque = 0, total = 0;
+  for (uint32_t i = 0; i <= samples; i++) {
+    for (uint32_t j = 0; j <= samples - i; j++) {
+      auto u = float(i) / samples, v = float(j) / samples;
+      auto uv = (1.0f - u - v) * uvs[0] + u * uvs[1] + v * uvs[2];
+      opaque += texture.Sample(uv) >= alpha_cutoff ? 1 : 0;
+      total++;
+    }
+  }
+
+  if (opaque == total) return MicroTriangleOpacity::E_OPAQUE;
+  if (opaque == 0) return MicroTriangleOpacity::E_TRANSPARENT;
+  return 2 * opaque >= total ? MicroTriangleOpacity::E_UNKNOWN_OPAQUE : MicroTriangleOpacity::E_UNKNOWN_TRANSPARENT;
+}
+
+BakedTriangle BakeTriangle(const AlphaTexture &texture, const std::array<Vector2f, 3> &uvs, float alpha_cutoff,
+                           const OpacityMicromapBakeSpecification &specification) {
+  BakedTriangle baked;
+  auto size = Vector2f(texture.width_, texture.height_);
+  baked.subdivision_level_ = GetSubdivisionLevel({uvs[0] * size, uvs[1] * size, uvs[2] * size}, specification);
+  baked.data_.resize(GetDataSize(baked.subdivision_level_));
+
+  auto micro_triangles = 1u << (2 * baked.subdivision_level_);
+  std::array<uint32_t, 4> counts{};
+  for (uint32_t i = 0; i < micro_triangles; i++) {
+    auto barycentrics = GetMicroTriangleBarycentrics(i, baked.subdivision_level_);
+    std::array<Vector2f, 3> micro_uvs;
+    for (auto k = 0; k < 3; k++) {
+      micro_uvs[k] = (1.0f - barycentrics[k].x - barycentrics[k].y) * uvs[0] + barycentrics[k].x * uvs[1] + barycentrics[k].y * uvs[2];
+    }
+    auto state = uint8_t(ClassifyMicroTriangle(texture, micro_uvs, alpha_cutoff, specification));
+    baked.data_[i / 4] |= std::byte(state << (2 * (i % 4)));
+    counts[state]++;
+  }
+  baked.unknown_count_ = counts[2] + counts[3];
+
+  // UNIFORM TRIANGLES NEED NO DATA
+  using enum OpacityMicromapSpecialIndexEXT;
+  if (counts[0] == micro_triangles) baked.special_index_ = int32_t(E_FULLY_TRANSPARENT_EXT);
+  else if (counts[1] == micro_triangles) baked.special_index_ = int32_t(E_FULLY_OPAQUE_EXT);
+  else if (counts[2] == micro_triangles) baked.special_index_ = int32_t(E_FULLY_UNKNOWN_TRANSPARENT_EXT);
+  else if (counts[3] == micro_triangles) baked.special_index_ = int32_t(E_FULLY_UNKNOWN_OPAQUE_EXT);
+  else baked.special_index_ = 0;
+  return baked;
+}
+
+OpacityMicromapData BakeOpacityMicromap(const Model &model, const OpacityMicromapBakeSpecification &specification) {
+  OpacityMicromapData out;
+  auto vertices = model.GetVertices();
+  auto indices = model.GetIndices();
+  auto meshes = model.GetMeshes();
+  out.indices_.resize(indices.size() / 3, int32_t(OpacityMicromapSpecialIndexEXT::E_FULLY_OPAQUE_EXT));
+  out.mesh_usage_counts_.resize(meshes.size());
+
+  std::map<int32_t, std::unique_ptr<AlphaTexture>> textures;
+  for (const auto &mesh : meshes) {
+    if (mesh.alpha_cutoff <= 0.0f || mesh.color_texture_index < 0 || textures.contains(mesh.color_texture_index)) continue;
+    textures[mesh.color_texture_index] = std::make_unique<AlphaTexture>();
+  }
+  auto paths = model.GetImagePaths();
+  ParallelFor(textures.size(), [&](std::size_t index) {
+    auto texture = std::next(textures.begin(), index);
+    *texture->second = LoadAlphaTexture(paths[texture->first]);
+  });
+
+  for (const auto &[mesh_index, mesh] : std::views::enumerate(meshes)) {
+    if (mesh.alpha_cutoff <= 0.0f || mesh.color_texture_index < 0) continue;
+    const auto &texture = *textures[mesh.color_texture_index];
+    auto first_triangle = mesh.indices_offset / 3;
+    auto triangles_count = mesh.indices_size / 3;
+
+    // A TEXTURE THE BAKER CANNOT DECODE LEAVES EVERY TEST TO ANY-HIT
+    if (texture.IsValid() == false) {
+      std::fill_n(out.indices_.begin() + first_triangle, triangles_count, int32_t(OpacityMicromapSpecialIndexEXT::E_FULLY_UNKNOWN_OPAQUE_EXT));
+      out.statistics_.unknown_triangles_ += triangles_count;
+      continue;
+    }
+
+    std::vector<BakedTriangle> baked(triangles_count);
+    ParallelFor(triangles_count, [&](std::size_t triangle) {
+      auto index = mesh.indices_offset + 3 * triangle;
+      std::array<Vector2f, 3> uvs = {vertices[indices[index]].uv_, vertices[indices[index + 1]].uv_, vertices[indices[index + 2]].uv_};
+      baked[triangle] = BakeTriangle(texture, uvs, mesh.alpha_cutoff, specification);
+    });
+
+    std::map<uint32_t, uint32_t> level_counts;
+    for (auto triangle = 0; triangle < triangles_count; triangle++) {
+      const auto &baked_triangle = baked[triangle];
+      auto &statistics = out.statistics_;
+      statistics.micro_triangles_ += 1u << (2 * baked_triangle.subdivision_level_);
+      statistics.unknown_micro_triangles_ += baked_triangle.unknown_count_;
+      using enum OpacityMicromapSpecialIndexEXT;
+      switch (OpacityMicromapSpecialIndexEXT(baked_triangle.special_index_)) {
+      case E_FULLY_OPAQUE_EXT: statistics.opaque_triangles_++; break;
+      case E_FULLY_TRANSPARENT_EXT: statistics.transparent_triangles_++; break;
+      case E_FULLY_UNKNOWN_OPAQUE_EXT:
+      case E_FULLY_UNKNOWN_TRANSPARENT_EXT: statistics.unknown_triangles_++; break;
+      default: statistics.subdivided_triangles_++; break;
+      }
+      if (baked_triangle.special_index_ < 0) {
+        out.indices_[first_triangle + triangle] = baked_triangle.special_index_;
+        continue;
+      }
+      out.indices_[first_triangle + triangle] = out.triangles_.size();
+      auto format = uint16_t(OpacityMicromapFormatEXT::E_4_STATE_EXT);
+      out.triangles_.emplace_back(uint32_t(out.data_.size()), uint16_t(baked_triangle.subdivision_level_), format);
+      out.data_.insert(out.data_.end(), baked_triangle.data_.begin(), baked_triangle.data_.end());
+      level_counts[baked_triangle.subdivision_level_]++;
+    }
+
+    for (auto [level, count] : level_counts) {
+      out.mesh_usage_counts_[mesh_index].emplace_back(count, level, uint32_t(OpacityMicromapFormatEXT::E_4_STATE_EXT));
+    }
+  }
+
+  return out;
+}
+
+} // namespace Innsmouth
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "innsmouth/asset/include/vertex_quantization.h"
+#include "meshoptimizer.h"
+#include <limits>
+
+namespace Innsmouth {
+
+Vector2f EncodeOctahedral(const Vector3f &normal) {
+  auto length = glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z);
+  if (length == 0.0f) return Vector2f(0.0f);
+  auto n = normal / length;
+  auto encoded = Vector2f(n.x, n.y);
+  if (n.z < 0.0f) {
+    auto sign = Vector2f(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+    encoded = (Vector2f(1.0f) - glm::abs(Vector2f(n.y, n.x))) * sign;
+  }
+  return encoded;
+}
+
+PackedVertex PackVertex(const Vertex &vertex, const Vector3f &position_offset, const Vector3f &position_scale) {
+  PackedVertex packed_vertex;
+  for (auto i = 0; i < 3; i++) {
+    auto position = position_scale[i] > 0.0f ? (vertex.position_[i] - position_offset[i]) / position_scale[i] : 0.0f;
+    packed_vertex.position_[i] = meshopt_quantizeUnorm(position, 16);
+  }
+  packed_vertex.position_[3] = 0;
+  auto normal = EncodeOctahedral(vertex.normal_);
+  packed_vertex.normal_[0] = meshopt_quantizeSnorm(normal.x, 16);
+  packed_vertex.normal_[1] = meshopt_quantizeSnorm(normal.y, 16);
+  packed_vertex.uv_[0] = meshopt_quantizeHalf(vertex.uv_.x);
+  packed_vertex.uv_[1] = meshopt_quantizeHalf(vertex.uv_.y);
+  return packed_vertex;
+}
+
+void PackVertices(std::span<const Vertex> vertices, Mesh &mesh, std::vector<PackedVertex> &out_vertices) {
+  auto minimum = Vector3f(std::numeric_limits<float>::max());
+  auto maximum = Vector3f(std::numeric_limits<float>::lowest());
+  for (const auto &vertex : vertices) {
+    minimum = glm::min(minimum, vertex.position_);
+    maximum = glm::max(maximum, vertex.position_);
+  }
+  mesh.position_offset = vertices.empty() ? Vector3f(0.0f) : minimum;
+  mesh.position_scale = vertices.empty() ? Vector3f(0.0f) : maximum - minimum;
+  for (const auto &vertex : vertices) {
+    out_vertices.emplace_back(PackVertex(vertex, mesh.position_offset, mesh.position_scale));
+  }
+}
+
+} // namespace Innsmouth
\ No newline at end of file
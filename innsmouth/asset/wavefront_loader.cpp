@@ -1,6 +1,315 @@
 #include "innsmouth/asset/include/model.h"
-#include "innsmouth/core/include/image_wrapper.h"
+#include "innsmouth/core/include/mapped_file.h"
+#include "innsmouth/core/include/parallel_for.h"
+#include "innsmouth/core/include/type_tools.h"
 #include "innsmouth/core/include/core.h"
-#include <print>
+#include "tiny_obj_loader.h"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <map>
+#include <ranges>
+#include <thread>
+#include <unordered_map>
 
-namespace Innsmouth {} // namespace Innsmouth
\ No newline at end of file
+namespace Innsmouth {
+
+constexpr std::size_t OBJ_MINIMUM_CHUNK_SIZE = 1_MiB;
+
+struct ObjCorner {
+  int32_t position_;
+  int32_t uv_;
+  int32_t normal_;
+
+  bool operator==(const ObjCorner &other) const = default;
+};
+
+struct ObjCornerHash {
+  std::size_t operator()(const ObjCorner &corner) const {
+    std::size_t seed = 0;
+    HashCombine(seed, corner.position_);
+    HashCombine(seed, corner.uv_);
+    HashCombine(seed, corner.normal_);
+    return seed;
+  }
+};
+
+struct ObjFaceRun {
+  uint32_t material_index_;
+  std::vector<ObjCorner> corners_;
+};
+
+struct ObjIndexedRun {
+  std::vector<Vertex> vertices_;
+  std::vector<uint32_t> indices_;
+};
+
+struct ObjChunk {
+  std::string_view text_;
+  std::size_t positions_count_ = 0;
+  std::size_t normals_count_ = 0;
+  std::size_t uvs_count_ = 0;
+  std::size_t positions_offset_ = 0;
+  std::size_t normals_offset_ = 0;
+  std::size_t uvs_offset_ = 0;
+  std::string_view last_material_;
+  std::vector<std::string_view> material_libraries_;
+  std::vector<ObjFaceRun> runs_;
+};
+
+std::vector<ObjChunk> SplitObjChunks(std::string_view text) {
+  auto hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+  auto chunks_count = std::clamp<std::size_t>(text.size() / OBJ_MINIMUM_CHUNK_SIZE, 1, hardware_threads);
+  std::vector<ObjChunk> chunks;
+  std::size_t begin = 0;
+  for (auto i = 1; i <= chunks_count && begin < text.size(); i++) {
+    auto end = (i == chunks_count) ? text.size() : std::max(begin, i * text.size() / chunks_count);
+    end = std::min(text.find('\n', end), text.size());
+    end = (end == text.size()) ? end : end + 1;
+    chunks.emplace_back().text_ = text.substr(begin, end - begin);
+    begin = end;
+  }
+  return chunks;
+}
+
+std::string_view TrimObjLine(std::string_view line) {
+  auto begin = line.find_first_not_of(" \t");
+  auto end = line.find_last_not_of(" \t\r");
+  return (begin == std::string_view::npos) ? std::string_view() : line.substr(begin, end - begin + 1);
+}
+
+template <typename Function> void ForEachObjLine(std::string_view text, Function &&function) {
+  while (text.empty() == false) {
+    auto line_end = std::min(text.find('\n'), text.size());
+    if (auto line = TrimObjLine(text.substr(0, line_end)); line.empty() == false && line.front() != '#') {
+      auto keyword_end = std::min(line.find_first_of(" \t"), line.size());
+      function(line.substr(0, keyword_end), TrimObjLine(line.substr(keyword_end)));
+    }
+    text.remove_prefix(std::min(line_end + 1, text.size()));
+  }
+}
+
+// PASS 1: COUNT ATTRIBUTES SO EVERY CHUNK KNOWS ITS GLOBAL OFFSETS BEFORE PARSING FACES
+
+void CountObjChunk(ObjChunk &chunk) {
+  ForEachObjLine(chunk.text_, [&](std::string_view keyword, std::string_view arguments) {
+    if (keyword == "v") {
+      chunk.positions_count_++;
+    } else if (keyword == "vn") {
+      chunk.normals_count_++;
+    } else if (keyword == "vt") {
+      chunk.uvs_count_++;
+    } else if (keyword == "usemtl") {
+      chunk.last_material_ = arguments;
+    } else if (keyword == "mtllib") {
+      chunk.material_libraries_.emplace_back(arguments);
+    }
+  });
+}
+
+const char *ParseObjFloat(const char *begin, const char *end, float &value) {
+  while (begin < end && (*begin == ' ' || *begin == '\t')) begin++;
+  value = 0.0f;
+  return std::from_chars(begin, end, value).ptr;
+}
+
+int32_t ResolveObjIndex(int64_t index, std::size_t count) {
+  return (index > 0) ? int32_t(index - 1) : (index < 0) ? int32_t(int64_t(count) + index) : -1;
+}
+
+ObjCorner ParseObjCorner(std::string_view token, const ObjChunk &chunk, std::size_t positions, std::size_t normals, std::size_t uvs) {
+  std::array<int64_t, 3> values = {0, 0, 0};
+  auto begin = token.data(), end = token.data() + token.size();
+  for (auto i = 0; i < values.size() && begin < end; i++) {
+    begin = (*begin == '/') ? begin : std::from_chars(begin, end, values[i]).ptr;
+    begin = (begin < end && *begin == '/') ? begin + 1 : end;
+  }
+  ObjCorner corner;
+  corner.position_ = ResolveObjIndex(values[0], chunk.positions_offset_ + positions);
+  corner.uv_ = ResolveObjIndex(values[1], chunk.uvs_offset_ + uvs);
+  corner.normal_ = ResolveObjIndex(values[2], chunk.normals_offset_ + normals);
+  return corner;
+}
+
+// PASS 2: PARSE ATTRIBUTES STRAIGHT INTO THE SHARED ARRAYS AND TRIANGULATE FACES INTO PER-MATERIAL RUNS
+
+void ParseObjChunk(ObjChunk &chunk, uint32_t material_index, uint32_t default_material,
+                   const std::unordered_map<std::string_view, uint32_t> &material_indices, std::span<Vector3f> positions,
+                   std::span<Vector3f> normals, std::span<Vector2f> uvs) {
+  std::size_t positions_count = 0, normals_count = 0, uvs_count = 0;
+  std::vector<ObjCorner> polygon;
+  ForEachObjLine(chunk.text_, [&](std::string_view keyword, std::string_view arguments) {
+    auto begin = arguments.data(), end = arguments.data() + arguments.size();
+    if (keyword == "v") {
+      auto &position = positions[chunk.positions_offset_ + positions_count++];
+      begin = ParseObjFloat(begin, end, position.x);
+      begin = ParseObjFloat(begin, end, position.y);
+      ParseObjFloat(begin, end, position.z);
+    } else if (keyword == "vn") {
+      auto &normal = normals[chunk.normals_offset_ + normals_count++];
+      begin = ParseObjFloat(begin, end, normal.x);
+      begin = ParseObjFloat(begin, end, normal.y);
+      ParseObjFloat(begin, end, normal.z);
+    } else if (keyword == "vt") {
+      auto &uv = uvs[chunk.uvs_offset_ + uvs_count++];
+      begin = ParseObjFloat(begin, end, uv.x);
+      ParseObjFloat(begin, end, uv.y);
+      uv.y = 1.0f - uv.y;
+    } else if (keyword == "usemtl") {
+      auto material = material_indices.find(arguments);
+      material_index = (material == material_indices.end()) ? default_material : material->second;
+    } else if (keyword == "f") {
+      polygon.clear();
+      while (arguments.empty() == false) {
+        auto token_end = std::min(arguments.find_first_of(" \t"), arguments.size());
+        polygon.emplace_back(ParseObjCorner(arguments.substr(0, token_end), chunk, positions_count, normals_count, uvs_count));
+        arguments = TrimObjLine(arguments.substr(token_end));
+      }
+      if (chunk.runs_.empty() || chunk.runs_.back().material_index_ != material_index) {
+        chunk.runs_.emplace_back(material_index);
+      }
+      auto &corners = chunk.runs_.back().corners_;
+      for (auto i = 2; i < polygon.size(); i++) {
+        corners.insert(corners.end(), {polygon[0], polygon[i - 1], polygon[i]});
+      }
+    }
+  });
+}
+
+// PASS 3: HASH-BASED DEDUPLICATION OF EACH RUN, MISSING NORMALS ARE ACCUMULATED FROM FACES
+
+ObjIndexedRun IndexObjRun(const ObjFaceRun &run, std::span<const Vector3f> positions, std::span<const Vector3f> normals,
+                          std::span<const Vector2f> uvs) {
+  ObjIndexedRun indexed_run;
+  std::unordered_map<ObjCorner, uint32_t, ObjCornerHash> vertex_indices;
+  vertex_indices.reserve(run.corners_.size() / 3);
+  indexed_run.indices_.reserve(run.corners_.size());
+  for (const auto &corner : run.corners_) {
+    auto [iterator, inserted] = vertex_indices.try_emplace(corner, indexed_run.vertices_.size());
+    if (inserted) {
+      auto &vertex = indexed_run.vertices_.emplace_back();
+      vertex.position_ = (corner.position_ >= 0 && corner.position_ < positions.size()) ? positions[corner.position_] : Vector3f(0.0f);
+      vertex.normal_ = (corner.normal_ >= 0 && corner.normal_ < normals.size()) ? normals[corner.normal_] : Vector3f(0.0f);
+      vertex.uv_ = (corner.uv_ >= 0 && corner.uv_ < uvs.size()) ? uvs[corner.uv_] : Vector2f(0.0f);
+    }
+    indexed_run.indices_.emplace_back(iterator->second);
+  }
+  auto &vertices = indexed_run.vertices_;
+  auto &indices = indexed_run.indices_;
+  for (auto i = 0; i < indices.size(); i += 3) {
+    auto &a = vertices[indices[i + 0]], &b = vertices[indices[i + 1]], &c = vertices[indices[i + 2]];
+    auto face_normal = glm::cross(b.position_ - a.position_, c.position_ - a.position_);
+    for (auto j = 0; j < 3; j++) {
+      if (run.corners_[i + j].normal_ < 0) vertices[indices[i + j]].normal_ += face_normal;
+    }
+  }
+  for (auto i = 0; i < run.corners_.size(); i++) {
+    auto &normal = vertices[indices[i]].normal_;
+    if (run.corners_[i].normal_ < 0 && glm::length(normal) > 0.0f) normal = glm::normalize(normal);
+  }
+  return indexed_run;
+}
+
+std::vector<tinyobj::material_t> LoadObjMaterials(const std::filesystem::path &path, std::span<const ObjChunk> chunks,
+                                                  std::vector<std::filesystem::path> &library_paths) {
+  std::vector<tinyobj::material_t> materials;
+  std::map<std::string, int> material_map;
+  for (const auto &chunk : chunks) {
+    for (auto library : chunk.material_libraries_) {
+      library_paths.emplace_back(path.parent_path() / library);
+      std::ifstream material_stream(library_paths.back());
+      std::string warning, error;
+      tinyobj::LoadMtl(&material_map, &materials, &material_stream, &warning, &error);
+    }
+  }
+  return materials;
+}
+
+void Model::LoadWavefront(const std::filesystem::path &path) {
+  MappedFile mapped_file(path);
+  auto text = std::string_view(mapped_file.GetData().data(), mapped_file.GetSize());
+  auto chunks = SplitObjChunks(text);
+
+  ParallelFor(chunks.size(), [&](std::size_t index) { CountObjChunk(chunks[index]); });
+
+  std::size_t positions_count = 0, normals_count = 0, uvs_count = 0;
+  for (auto &chunk : chunks) {
+    chunk.positions_offset_ = std::exchange(positions_count, positions_count + chunk.positions_count_);
+    chunk.normals_offset_ = std::exchange(normals_count, normals_count + chunk.normals_count_);
+    chunk.uvs_offset_ = std::exchange(uvs_count, uvs_count + chunk.uvs_count_);
+  }
+
+  auto materials = LoadObjMaterials(path, chunks, source_paths_);
+  uint32_t default_material = materials.size();
+
+  std::unordered_map<std::string_view, uint32_t> material_indices;
+  for (const auto &[index, material] : std::views::enumerate(materials)) {
+    material_indices.try_emplace(material.name, index);
+  }
+
+  // A CHUNK STARTS WITH THE MATERIAL THAT WAS ACTIVE AT THE END OF THE PREVIOUS ONE
+  std::vector<uint32_t> chunk_materials(chunks.size(), default_material);
+  for (auto i = 1; i < chunks.size(); i++) {
+    auto previous_material = material_indices.find(chunks[i - 1].last_material_);
+    auto inherited = (previous_material == material_indices.end()) ? default_material : previous_material->second;
+    chunk_materials[i] = chunks[i - 1].last_material_.empty() ? chunk_materials[i - 1] : inherited;
+  }
+
+  std::vector<Vector3f> positions(positions_count), normals(normals_count);
+  std::vector<Vector2f> uvs(uvs_count);
+
+  ParallelFor(chunks.size(), [&](std::size_t index) {
+    ParseObjChunk(chunks[index], chunk_materials[index], default_material, material_indices, positions, normals, uvs);
+  });
+
+  std::vector<const ObjFaceRun *> runs;
+  for (const auto &chunk : chunks) {
+    for (const auto &run : chunk.runs_) {
+      runs.emplace_back(&run);
+    }
+  }
+
+  std::vector<ObjIndexedRun> indexed_runs(runs.size());
+  ParallelFor(runs.size(), [&](std::size_t index) { indexed_runs[index] = IndexObjRun(*runs[index], positions, normals, uvs); });
+
+  std::unordered_map<std::string, int32_t> texture_indices;
+  auto load_texture = [&](const std::string &texture_name) {
+    if (texture_name.empty()) return -1;
+    auto [texture, inserted] = texture_indices.try_emplace(texture_name, image_paths_.size());
+    if (inserted) image_paths_.emplace_back(path.parent_path() / texture_name);
+    return texture->second;
+  };
+
+  // RUNS OF ONE MATERIAL ARE CONCATENATED INTO A SINGLE MESH, IN FILE ORDER
+  for (uint32_t material_index = 0; material_index <= default_material; material_index++) {
+    Mesh mesh{};
+    mesh.color_texture_index = -1;
+    mesh.normal_texture_index = -1;
+    if (material_index < materials.size()) {
+      const auto &material = materials[material_index];
+      mesh.color_texture_index = load_texture(material.diffuse_texname);
+      mesh.normal_texture_index = load_texture(material.normal_texname.empty() ? material.bump_texname : material.normal_texname);
+      // A map_d CUTOUT IS ASSUMED TO BE BAKED INTO THE DIFFUSE ALPHA AS WELL
+      mesh.alpha_cutoff = material.alpha_texname.empty() ? 0.0f : 0.5f;
+    }
+    mesh.vertices_offset = vertices_.size();
+    mesh.indices_offset = indices_.size();
+    for (auto i = 0; i < runs.size(); i++) {
+      if (runs[i]->material_index_ != material_index) continue;
+      auto vertices_offset = vertices_.size();
+      for (auto index : indexed_runs[i].indices_) {
+        indices_.emplace_back(index + vertices_offset);
+      }
+      vertices_.insert(vertices_.end(), indexed_runs[i].vertices_.begin(), indexed_runs[i].vertices_.end());
+    }
+    mesh.indices_size = indices_.size() - mesh.indices_offset;
+    if (mesh.indices_size > 0) {
+      meshes_.emplace_back(mesh);
+    }
+  }
+
+  mesh_groups_.emplace_back(0, meshes_.size());
+  mesh_instances_.emplace_back(Matrix4f(1.0f), 0);
+}
+
+} // namespace Innsmouth
\ No newline at end of file
@@ -4,16 +4,33 @@
 #include "innsmouth/application/application.h"
 #include "innsmouth/graphics/pipeline/graphics_pipeline.h"
 #include "innsmouth/graphics/pipeline/ray_tracing_pipeline.h"
+#include "innsmouth/graphics/pipeline/compute_pipeline.h"
 #include "innsmouth/graphics/descriptors/descriptor_pool.h"
 #include "innsmouth/graphics/descriptors/descriptor_set.h"
+#include "innsmouth/graphics/descriptors/bindless_table.h"
 #include "innsmouth/graphics/buffer/buffer.h"
 #include "innsmouth/graphics/image/image_depth.h"
 #include "innsmouth/graphics/image/image2D.h"
+#include "innsmouth/graphics/image/sampler_cache.h"
+#include "innsmouth/graphics/image/image_view_cache.h"
+#include "innsmouth/graphics/image/texture_streamer.h"
 #include "innsmouth/scene/include/camera.h"
 #include "innsmouth/asset/include/model.h"
+#include "innsmouth/asset/include/model_loader.h"
+#include "innsmouth/asset/include/mesh_optimizer.h"
+#include "innsmouth/asset/include/vertex_quantization.h"
+#include "innsmouth/asset/include/bounding_volume_hierarchy.h"
+#include "innsmouth/asset/include/opacity_micromap_baker.h"
 #include "innsmouth/core/include/image_wrapper.h"
+#include "innsmouth/core/include/image_ingest.h"
+#include "innsmouth/core/include/mapped_file.h"
+#include "innsmouth/core/include/ktx_wrapper.h"
 #include "innsmouth/graphics/raytracing/acceleration_structure.h"
+#include "innsmouth/graphics/raytracing/dynamic_acceleration_structures.h"
 #include "innsmouth/graphics/raytracing/shader_binding_table.h"
+#include "innsmouth/graphics/raytracing/opacity_micromap.h"
+#include "innsmouth/graphics/raytracing/instance_preparation.h"
+#include "innsmouth/graphics/raytracing/wavefront_tracer.h"
 #include "innsmouth/mathematics/include/transform.h"
 
 #endif // INNSMOUTH_H
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include "innsmouth/core/include/image_ingest.h"
+#include "innsmouth/core/include/core.h"
+#include "innsmouth/core/include/mapped_file.h"
+#include "innsmouth/core/include/parallel_for.h"
+#include "stb_image.h"
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Innsmouth {
+
+static_assert(std::endian::native == std::endian::little, "Image kernels assume little endian texels");
+
+constexpr uint16_t HALF_ONE = 0x3c00;
+
+std::size_t ImageIngestInfo::GetSize() const {
+  switch (conversion_) {
+  case ImageConversion::E_RGBA16F_LINEAR:
+  case ImageConversion::E_RGBA16F_HDR:
+    return std::size_t(width_) * height_ * 8;
+  case ImageConversion::E_RG8_NORMAL:
+    return std::size_t(width_) * height_ * 2;
+  default:
+    return std::size_t(width_) * height_ * 4;
+  }
+}
+
+uint16_t FloatToHalf(float value) {
+  auto bits = std::bit_cast<uint32_t>(value);
+  auto sign = (bits >> 16) & 0x8000u;
+  auto magnitude = bits & 0x7fffffffu;
+  if (magnitude >= 0x47800000u) return sign | (magnitude > 0x7f800000u ? 0x7e00u : 0x7c00u);
+  if (magnitude < 0x38800000u) return sign | (std::bit_cast<uint32_t>(std::bit_cast<float>(magnitude) + 0.5f) - 0x3f000000u);
+  return sign | ((magnitude + 0xc8000fffu + ((magnitude >> 13) & 1u)) >> 13);
+}
+
+#if defined(__SSE2__)
+// FOUR LANES OF FloatToHalf, HALVES COME BACK SIGN EXTENDED SO _mm_packs_epi32 KEEPS THEIR BITS
+__m128i FloatToHalf4(__m128 value) {
+  auto sign = _mm_and_ps(value, _mm_castsi128_ps(_mm_set1_epi32(int32_t(0x80000000u))));
+  auto magnitude = _mm_xor_ps(value, sign);
+  auto magnitude_bits = _mm_castps_si128(magnitude);
+
+  auto is_nan = _mm_castps_si128(_mm_cmpunord_ps(magnitude, magnitude));
+  auto is_regular = _mm_cmpgt_epi32(_mm_set1_epi32(0x47800000), magnitude_bits);
+  auto is_subnormal = _mm_cmpgt_epi32(_mm_set1_epi32(0x38800000), magnitude_bits);
+  auto inf_or_nan = _mm_or_si128(_mm_and_si128(is_nan, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7c00));
+
+  auto subnormal_magic = _mm_set1_epi32(0x3f000000);
+  auto subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(magnitude, _mm_castsi128_ps(subnormal_magic))), subnormal_magic);
+
+  auto mantissa_odd = _mm_srai_epi32(_mm_slli_epi32(magnitude_bits, 18), 31);
+  auto normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(magnitude_bits, _mm_set1_epi32(int32_t(0xc8000fffu))), mantissa_odd), 13);
+
+  auto finite = _mm_or_si128(_mm_and_si128(is_subnormal, subnormal), _mm_andnot_si128(is_subnormal, normal));
+  auto half = _mm_or_si128(_mm_and_si128(is_regular, finite), _mm_andnot_si128(is_regular, inf_or_nan));
+  return _mm_or_si128(half, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+}
+#endif
+
+const std::array<uint16_t, 256> &GetSRGBTable() {
+  static const auto table = [] {
+    std::array<uint16_t, 256> out;
+    for (auto i = 0; i < out.size(); i++) {
+      auto value = float(i) / 255.0f;
+      out[i] = FloatToHalf(value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f));
+    }
+    return out;
+  }();
+  return table;
+}
+
+const std::array<uint16_t, 256> &GetUnormTable() {
+  static const auto table = [] {
+    std::array<uint16_t, 256> out;
+    for (auto i = 0; i < out.size(); i++) {
+      out[i] = FloatToHalf(float(i) / 255.0f);
+    }
+    return out;
+  }();
+  return table;
+}
+
+void ExpandToRGBA8(std::span<const uint8_t> source, uint32_t channels, std::span<std::byte> destination) {
+  auto pixels = source.size() / channels;
+  auto output = reinterpret_cast<uint8_t *>(destination.data());
+  std::size_t i = 0;
+  if (channels == 4) {
+    std::memcpy(output, source.data(), pixels * 4);
+    return;
+  }
+  if (channels == 3) {
+#if defined(__SSE2__)
+    // FOUR TEXELS PER 16 BYTE LOAD, TEXEL k IS SHIFTED k BYTES UP INTO LANE k AND MASKED TO ITS THREE BYTES
+    auto alpha = _mm_set1_epi32(int32_t(0xff000000u));
+    auto lane_0 = _mm_setr_epi32(0x00ffffff, 0, 0, 0);
+    auto lane_1 = _mm_setr_epi32(0, 0x00ffffff, 0, 0);
+    auto lane_2 = _mm_setr_epi32(0, 0, 0x00ffffff, 0);
+    auto lane_3 = _mm_setr_epi32(0, 0, 0, 0x00ffffff);
+    for (; 3 * i + 16 <= source.size(); i += 4) {
+      auto texels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source.data() + 3 * i));
+      auto rgba = _mm_or_si128(_mm_and_si128(texels, lane_0), _mm_and_si128(_mm_slli_si128(texels, 1), lane_1));
+      rgba = _mm_or_si128(rgba, _mm_and_si128(_mm_slli_si128(texels, 2), lane_2));
+      rgba = _mm_or_si128(rgba, _mm_and_si128(_mm_slli_si128(texels, 3), lane_3));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 4 * i), _mm_or_si128(rgba, alpha));
+    }
+#endif
+    // FOUR TEXELS PER STEP, THREE WORD LOADS TURN INTO FOUR WORD STORES WITH SHIFTS ONLY
+    for (; i + 4 <= pixels; i += 4) {
+      std::array<uint32_t, 3> words;
+      std::memcpy(words.data(), source.data() + 3 * i, sizeof(words));
+      std::array<uint32_t, 4> texels = {words[0] | 0xff000000u, (words[0] >> 24) | (words[1] << 8) | 0xff000000u,
+                                        (words[1] >> 16) | (words[2] << 16) | 0xff000000u, (words[2] >> 8) | 0xff000000u};
+      std::memcpy(output + 4 * i, texels.data(), sizeof(texels));
+    }
+  }
+  for (; i < pixels; i++) {
+    auto texel = source.data() + channels * i;
+    auto gray = channels < 3;
+    output[4 * i + 0] = texel[0];
+    output[4 * i + 1] = gray ? texel[0] : texel[1];
+    output[4 * i + 2] = gray ? texel[0] : texel[2];
+    output[4 * i + 3] = channels == 2 ? texel[1] : 0xff;
+  }
+}
+
+void LinearizeToRGBA16F(std::span<const uint8_t> source, uint32_t channels, std::span<std::byte> destination) {
+  const auto &srgb_table = GetSRGBTable();
+  const auto &unorm_table = GetUnormTable();
+  auto pixels = source.size() / channels;
+  auto gray = channels < 3;
+  for (auto i = 0; i < pixels; i++) {
+    auto texel = source.data() + channels * i;
+    std::array<uint16_t, 4> halves = {srgb_table[texel[0]], srgb_table[gray ? texel[0] : texel[1]], srgb_table[gray ? texel[0] : texel[2]],
+                                      (channels == 2 || channels == 4) ? unorm_table[texel[channels - 1]] : HALF_ONE};
+    std::memcpy(destination.data() + 8 * i, halves.data(), sizeof(halves));
+  }
+}
+
+void ConvertToRGBA16F(std::span<const float> source, uint32_t channels, std::span<std::byte> destination) {
+  auto pixels = source.size() / channels;
+  auto gray = channels < 3;
+  for (auto i = 0; i < pixels; i++) {
+    auto texel = source.data() + channels * i;
+    std::array<float, 4> rgba = {texel[0], gray ? texel[0] : texel[1], gray ? texel[0] : texel[2],
+                                 (channels == 2 || channels == 4) ? texel[channels - 1] : 1.0f};
+#if defined(__SSE2__)
+    auto halves = FloatToHalf4(_mm_loadu_ps(rgba.data()));
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(destination.data() + 8 * i), _mm_packs_epi32(halves, halves));
+#else
+    std::array<uint16_t, 4> halves = {FloatToHalf(rgba[0]), FloatToHalf(rgba[1]), FloatToHalf(rgba[2]), FloatToHalf(rgba[3])};
+    std::memcpy(destination.data() + 8 * i, halves.data(), sizeof(halves));
+#endif
+  }
+}
+
+void PackNormalRG8(std::span<const uint8_t> source, uint32_t channels, std::span<std::byte> destination) {
+  CORE_ASSERT(channels >= 2, "Normal map needs at least two channels");
+  auto pixels = source.size() / channels;
+  auto output = reinterpret_cast<uint8_t *>(destination.data());
+  std::size_t i = 0;
+#if defined(__SSE2__)
+  if (channels == 4) {
+    // EIGHT TEXELS PER STEP, RG IS SIGN EXTENDED FROM EACH LANE SO _mm_packs_epi32 KEEPS ITS BITS
+    for (; i + 8 <= pixels; i += 8) {
+      auto low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source.data() + 4 * i));
+      auto high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source.data() + 4 * i + 16));
+      low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+      high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 2 * i), _mm_packs_epi32(low, high));
+    }
+  }
+#endif
+  for (; i < pixels; i++) {
+    output[2 * i + 0] = source[channels * i + 0];
+    output[2 * i + 1] = source[channels * i + 1];
+  }
+}
+
+ImageIngestInfo ProbeImage(const std::filesystem::path &path, const std::optional<ImageConversion> &conversion) {
+  MappedFile mapped_file(path);
+  auto data = reinterpret_cast<const stbi_uc *>(mapped_file.GetData().data());
+  auto size = int32_t(mapped_file.GetSize());
+  int32_t width = 0, height = 0, channels = 0;
+  CORE_ASSERT(stbi_info_from_memory(data, size, &width, &height, &channels) != 0, "Failed to read image header");
+  ImageIngestInfo info;
+  info.width_ = width;
+  info.height_ = height;
+  info.channels_ = channels;
+  info.conversion_ = conversion.value_or(stbi_is_hdr_from_memory(data, size) ? ImageConversion::E_RGBA16F_HDR : ImageConversion::E_RGBA8);
+  return info;
+}
+
+void IngestImage(const std::filesystem::path &path, const ImageIngestInfo &info, std::span<std::byte> destination) {
+  CORE_ASSERT(destination.size() >= info.GetSize(), "Image destination is too small");
+  MappedFile mapped_file(path);
+  auto data = reinterpret_cast<const stbi_uc *>(mapped_file.GetData().data());
+  auto size = int32_t(mapped_file.GetSize());
+  int32_t width = 0, height = 0, channels = 0;
+
+  // STB KEEPS THE NATIVE CHANNEL COUNT, THE KERNELS WRITE THE ONLY CONVERTED COPY STRAIGHT INTO THE DESTINATION
+  if (info.conversion_ == ImageConversion::E_RGBA16F_HDR) {
+    auto pixels = stbi_loadf_from_memory(data, size, &width, &height, &channels, 0);
+    CORE_ASSERT(pixels != nullptr, "Failed to decode HDR image");
+    ConvertToRGBA16F(std::span<const float>(pixels, std::size_t(width) * height * channels), channels, destination);
+    stbi_image_free(pixels);
+    return;
+  }
+
+  auto pixels = stbi_load_from_memory(data, size, &width, &height, &channels, 0);
+  CORE_ASSERT(pixels != nullptr, "Failed to decode image");
+  auto source = std::span<const uint8_t>(pixels, std::size_t(width) * height * channels);
+  switch (info.conversion_) {
+  case ImageConversion::E_RGBA16F_LINEAR:
+    LinearizeToRGBA16F(source, channels, destination);
+    break;
+  case ImageConversion::E_RG8_NORMAL:
+    PackNormalRG8(source, channels, destination);
+    break;
+  default:
+    ExpandToRGBA8(source, channels, destination);
+    break;
+  }
+  stbi_image_free(pixels);
+}
+
+std::vector<ImageIngestInfo> ProbeImages(std::span<const std::filesystem::path> paths, std::span<const ImageConversion> conversions) {
+  std::vector<ImageIngestInfo> infos(paths.size());
+  ParallelFor(paths.size(), [&](std::size_t index) {
+    auto &info = infos[index] = ProbeImage(paths[index]);
+    // HDR SOURCES KEEP THEIR RANGE, A NORMAL MAP NEEDS THE TWO CHANNELS IT IS PACKED FROM
+    if (index >= conversions.size() || info.conversion_ == ImageConversion::E_RGBA16F_HDR) return;
+    if (conversions[index] == ImageConversion::E_RG8_NORMAL && info.channels_ < 2) return;
+    info.conversion_ = conversions[index];
+  });
+  return infos;
+}
+
+void IngestImages(std::span<const std::filesystem::path> paths, std::span<const ImageIngestInfo> infos, std::span<const std::size_t> offsets,
+                  std::span<std::byte> destination) {
+  ParallelFor(paths.size(), [&](std::size_t index) {
+    IngestImage(paths[index], infos[index], destination.subspan(offsets[index], infos[index].GetSize()));
+  });
+}
+
+} // namespace Innsmouth
\ No newline at end of file
@@ -0,0 +1,50 @@
+#ifndef INNSMOUTH_IMAGE_INGEST_H
+#define INNSMOUTH_IMAGE_INGEST_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Innsmouth {
+
+enum class ImageConversion : uint32_t {
+  E_RGBA8,
+  E_RGBA8_SRGB,
+  E_RGBA16F_LINEAR,
+  E_RGBA16F_HDR,
+  E_RG8_NORMAL,
+};
+
+struct ImageIngestInfo {
+  uint32_t width_{0};
+  uint32_t height_{0};
+  uint32_t channels_{0};
+  ImageConversion conversion_{ImageConversion::E_RGBA8};
+
+  std::size_t GetSize() const;
+};
+
+ImageIngestInfo ProbeImage(const std::filesystem::path &path, const std::optional<ImageConversion> &conversion = std::nullopt);
+
+void IngestImage(const std::filesystem::path &path, const ImageIngestInfo &info, std::span<std::byte> destination);
+
+// CONVERSIONS ARE PER PATH, PATHS WITHOUT ONE KEEP THE CONVERSION ProbeImage PICKS
+std::vector<ImageIngestInfo> ProbeImages(std::span<const std::filesystem::path> paths, std::span<const ImageConversion> conversions = {});
+
+void IngestImages(std::span<const std::filesystem::path> paths, std::span<const ImageIngestInfo> infos, std::span<const std::size_t> offsets,
+                  std::span<std::byte> destination);
+
+// KERNELS
+
+void ExpandToRGBA8(std::span<const uint8_t> source, uint32_t channels, std::span<std::byte> destination);
+void LinearizeToRGBA16F(std::span<const uint8_t> source, uint32_t channels, std::span<std::byte> destination);
+void ConvertToRGBA16F(std::span<const float> source, uint32_t channels, std::span<std::byte> destination);
+void PackNormalRG8(std::span<const uint8_t> source, uint32_t channels, std::span<std::byte> destination);
+
+uint16_t FloatToHalf(float value);
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_IMAGE_INGEST_H
\ No newline at end of file
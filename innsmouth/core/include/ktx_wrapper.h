@@ -0,0 +1,31 @@
+#ifndef INNSMOUTH_KTX_WRAPPER_H
+#define INNSMOUTH_KTX_WRAPPER_H
+
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace Innsmouth {
+
+class KtxWrapper {
+public:
+  KtxWrapper(const std::filesystem::path &image_path, bool block_compression);
+
+  uint32_t GetWidth() const;
+  uint32_t GetHeight() const;
+  uint32_t GetLevelCount() const;
+  uint32_t GetFormat() const;
+
+  std::span<const std::byte> GetData() const;
+
+private:
+  uint32_t width_{0};
+  uint32_t height_{0};
+  uint32_t levels_{0};
+  uint32_t format_{0};
+  std::vector<std::byte> data_;
+};
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_KTX_WRAPPER_H
\ No newline at end of file
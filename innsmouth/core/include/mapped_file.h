@@ -0,0 +1,33 @@
+#ifndef INNSMOUTH_MAPPED_FILE_H
+#define INNSMOUTH_MAPPED_FILE_H
+
+#include <filesystem>
+#include <span>
+
+namespace Innsmouth {
+
+class MappedFile {
+public:
+  MappedFile() = default;
+
+  MappedFile(const std::filesystem::path &path);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+
+  std::span<const char> GetData() const;
+  std::size_t GetSize() const;
+
+private:
+  char *mapped_data_{nullptr};
+  std::size_t size_{0};
+};
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_MAPPED_FILE_H
\ No newline at end of file
@@ -0,0 +1,26 @@
+#ifndef INNSMOUTH_PARALLEL_FOR_H
+#define INNSMOUTH_PARALLEL_FOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace Innsmouth {
+
+template <typename Function> void ParallelFor(std::size_t count, Function &&function) {
+  auto threads_count = std::min<std::size_t>(count, std::max(1u, std::thread::hardware_concurrency()));
+  std::atomic<std::size_t> next_index = 0;
+  std::vector<std::jthread> threads;
+  for (auto i = 0; i < threads_count; i++) {
+    threads.emplace_back([&] {
+      for (auto index = next_index++; index < count; index = next_index++) {
+        function(index);
+      }
+    });
+  }
+}
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_PARALLEL_FOR_H
\ No newline at end of file
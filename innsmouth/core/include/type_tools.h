@@ -1,6 +1,7 @@
 #ifndef INNSMOUTH_TYPE_TOOLS_H
 #define INNSMOUTH_TYPE_TOOLS_H
 
+#include <functional>
 #include <tuple>
 
 namespace Innsmouth {
@@ -15,6 +16,10 @@ template <typename R, typename... A> struct FunctionTraits<R(A...)> {
   using arguments_t = std::tuple<A...>;
 };
 
+template <typename T> inline void HashCombine(std::size_t &seed, const T &value) {
+  seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
 } // namespace Innsmouth
 
 #endif // INNSMOUTH_TYPE_TOOLS_H
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "innsmouth/core/include/ktx_wrapper.h"
+#include "innsmouth/core/include/core.h"
+#include <vulkan/vulkan_core.h>
+#include <ktx.h>
+#define BCDEC_IMPLEMENTATION
+#include "bcdec.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace Innsmouth {
+
+ktx_transcode_fmt_e GetTranscodeTarget(ktxTexture2 *texture, bool block_compression) {
+  if (block_compression == false) return KTX_TTF_RGBA32;
+  return (ktxTexture2_GetNumComponents(texture) <= 2) ? KTX_TTF_BC5_RG : KTX_TTF_BC7_RGBA;
+}
+
+// FORMAT A BC PAYLOAD IS DECODED TO WHEN THE DEVICE CANNOT SAMPLE IT, UNDEFINED FOR EVERYTHING ELSE
+uint32_t GetDecodedFormat(uint32_t format) {
+  switch (format) {
+  case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+  case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+  case VK_FORMAT_BC2_SRGB_BLOCK:
+  case VK_FORMAT_BC3_SRGB_BLOCK:
+  case VK_FORMAT_BC7_SRGB_BLOCK:
+    return VK_FORMAT_R8G8B8A8_SRGB;
+  case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+  case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+  case VK_FORMAT_BC2_UNORM_BLOCK:
+  case VK_FORMAT_BC3_UNORM_BLOCK:
+  case VK_FORMAT_BC4_UNORM_BLOCK:
+  case VK_FORMAT_BC5_UNORM_BLOCK:
+  case VK_FORMAT_BC7_UNORM_BLOCK:
+    return VK_FORMAT_R8G8B8A8_UNORM;
+  default:
+    return VK_FORMAT_UNDEFINED;
+  }
+}
+
+// TWO ENDPOINTS AND SIXTEEN 3-BIT INDICES INTO ONE CHANNEL OF A 4x4 RGBA8 TILE
+void DecodeBC4Block(const std::byte *block, std::byte *tile, uint32_t channel) {
+  auto e0 = uint32_t(block[0]), e1 = uint32_t(block[1]);
+  std::array<uint32_t, 8> palette = {e0, e1};
+  for (auto i = 2u; i < 8; i++) {
+    if (e0 > e1) {
+      palette[i] = ((8 - i) * e0 + (i - 1) * e1) / 7;
+    } else {
+      palette[i] = (i < 6) ? ((6 - i) * e0 + (i - 1) * e1) / 5 : (i == 6 ? 0 : 255);
+    }
+  }
+  uint64_t indices = 0;
+  for (auto i = 0; i < 6; i++) {
+    indices |= uint64_t(block[2 + i]) << (8 * i);
+  }
+  for (auto texel = 0; texel < 16; texel++) {
+    tile[4 * texel + channel] = std::byte(palette[(indices >> (3 * texel)) & 7]);
+  }
+}
+
+void DecodeBlock(uint32_t format, const std::byte *block, std::byte *tile) {
+  switch (format) {
+  case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+  case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+    bcdec_bc1(block, tile, 16);
+    for (auto texel = 0; texel < 16; texel++) {
+      tile[4 * texel + 3] = std::byte(255);
+    }
+    break;
+  case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+  case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+    bcdec_bc1(block, tile, 16);
+    break;
+  case VK_FORMAT_BC2_SRGB_BLOCK:
+  case VK_FORMAT_BC2_UNORM_BLOCK:
+    bcdec_bc2(block, tile, 16);
+    break;
+  case VK_FORMAT_BC3_SRGB_BLOCK:
+  case VK_FORMAT_BC3_UNORM_BLOCK:
+    bcdec_bc3(block, tile, 16);
+    break;
+  case VK_FORMAT_BC4_UNORM_BLOCK:
+    DecodeBC4Block(block, tile, 0);
+    break;
+  case VK_FORMAT_BC5_UNORM_BLOCK:
+    DecodeBC4Block(block, tile, 0);
+    DecodeBC4Block(block + 8, tile, 1);
+    break;
+  case VK_FORMAT_BC7_SRGB_BLOCK:
+  case VK_FORMAT_BC7_UNORM_BLOCK:
+    bcdec_bc7(block, tile, 16);
+    break;
+  default:
+    CORE_ASSERT(false, "Unsupported block compressed format");
+  }
+}
+
+std::vector<std::byte> DecodeBlocks(std::span<const std::byte> data, uint32_t format, uint32_t width, uint32_t height, uint32_t levels) {
+  auto bc1 = format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+  auto block_size = (bc1 || format == VK_FORMAT_BC4_UNORM_BLOCK) ? 8u : 16u;
+  std::vector<std::byte> decoded;
+  std::size_t offset = 0;
+  for (auto level = 0u; level < levels; level++) {
+    auto level_width = std::max(width >> level, 1u), level_height = std::max(height >> level, 1u);
+    auto level_offset = decoded.size();
+    decoded.resize(level_offset + 4 * level_width * level_height);
+    for (auto block_y = 0u; block_y < level_height; block_y += 4) {
+      for (auto block_x = 0u; block_x < level_width; block_x += 4) {
+        // BC4 AND BC5 ONLY WRITE THEIR CHANNELS
+        std::array<std::byte, 64> tile{};
+        for (auto texel = 0; texel < 16; texel++) {
+          tile[4 * texel + 3] = std::byte(255);
+        }
+        DecodeBlock(format, data.data() + offset, tile.data());
+        offset += block_size;
+        // BLOCKS PAST THE EDGE OF THE LEVEL ARE CLIPPED
+        for (auto y = 0u; y < std::min(4u, level_height - block_y); y++) {
+          auto row = decoded.data() + level_offset + 4 * ((block_y + y) * level_width + block_x);
+          std::memcpy(row, tile.data() + 16 * y, 4 * std::min(4u, level_width - block_x));
+        }
+      }
+    }
+  }
+  return decoded;
+}
+
+KtxWrapper::KtxWrapper(const std::filesystem::path &image_path, bool block_compression) {
+  ktxTexture2 *texture = nullptr;
+  auto result = ktxTexture2_CreateFromNamedFile(image_path.c_str(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture);
+  CORE_ASSERT(result == KTX_SUCCESS, ktxErrorString(result));
+
+  // BASISU (ETC1S AND UASTC) PAYLOADS ARE TRANSCODED, BC PAYLOADS ARE UPLOADED AS STORED
+  if (ktxTexture2_NeedsTranscoding(texture)) {
+    result = ktxTexture2_TranscodeBasis(texture, GetTranscodeTarget(texture, block_compression), 0);
+    CORE_ASSERT(result == KTX_SUCCESS, ktxErrorString(result));
+  }
+
+  width_ = texture->baseWidth;
+  height_ = texture->baseHeight;
+  levels_ = texture->numLevels;
+  format_ = texture->vkFormat;
+
+  // KTX2 STORES THE SMALLEST LEVEL FIRST, REPACK FROM LEVEL 0 DOWN
+  auto texture_data = ktxTexture_GetData(ktxTexture(texture));
+  for (auto level = 0; level < levels_; level++) {
+    ktx_size_t offset = 0;
+    ktxTexture_GetImageOffset(ktxTexture(texture), level, 0, 0, &offset);
+    auto level_data = std::as_bytes(std::span(texture_data + offset, ktxTexture_GetImageSize(ktxTexture(texture), level)));
+    data_.insert(data_.end(), level_data.begin(), level_data.end());
+  }
+
+  ktxTexture_Destroy(ktxTexture(texture));
+
+  // BC PAYLOADS STORED IN THE FILE NEED textureCompressionBC, WITHOUT IT THEY ARE DECODED TO RGBA8
+  auto decoded_format = GetDecodedFormat(format_);
+  if (block_compression == false && decoded_format != VK_FORMAT_UNDEFINED) {
+    data_ = DecodeBlocks(data_, format_, width_, height_, levels_);
+    format_ = decoded_format;
+  }
+}
+
+uint32_t KtxWrapper::GetWidth() const {
+  return width_;
+}
+
+uint32_t KtxWrapper::GetHeight() const {
+  return height_;
+}
+
+uint32_t KtxWrapper::GetLevelCount() const {
+  return levels_;
+}
+
+uint32_t KtxWrapper::GetFormat() const {
+  return format_;
+}
+
+std::span<const std::byte> KtxWrapper::GetData() const {
+  return data_;
+}
+
+} // namespace Innsmouth
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "innsmouth/core/include/mapped_file.h"
+#include "innsmouth/core/include/core.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utility>
+
+namespace Innsmouth {
+
+MappedFile::MappedFile(const std::filesystem::path &path) {
+  auto file_descriptor = open(path.c_str(), O_RDONLY);
+  CORE_ASSERT(file_descriptor >= 0, "Failed to open file for mapping");
+  size_ = std::filesystem::file_size(path);
+  if (size_ > 0) {
+    auto mapped_data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    CORE_ASSERT(mapped_data != MAP_FAILED, "Failed to map file");
+    madvise(mapped_data, size_, MADV_WILLNEED);
+    mapped_data_ = static_cast<char *>(mapped_data);
+  }
+  close(file_descriptor);
+}
+
+MappedFile::~MappedFile() {
+  if (mapped_data_ != nullptr) {
+    munmap(mapped_data_, size_);
+  }
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept {
+  mapped_data_ = std::exchange(other.mapped_data_, nullptr);
+  size_ = std::exchange(other.size_, 0);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  std::swap(mapped_data_, other.mapped_data_);
+  std::swap(size_, other.size_);
+  return *this;
+}
+
+std::span<const char> MappedFile::GetData() const {
+  return std::span(mapped_data_, size_);
+}
+
+std::size_t MappedFile::GetSize() const {
+  return size_;
+}
+
+} // namespace Innsmouth
\ No newline at end of file
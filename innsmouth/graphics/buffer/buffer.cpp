@@ -46,6 +46,10 @@ BufferInformation Buffer::CreateBuffer(std::size_t size, BufferUsageMask usage,
   return buffer_information;
 }
 
+bool Buffer::IsMapped() const {
+  return mapped_memory_ != nullptr;
+}
+
 VkBuffer Buffer::GetHandle() const {
   return buffer_;
 }
@@ -58,10 +62,26 @@ void Buffer::Unmap() {
   GraphicsAllocator::Get()->UnmapMemory(buffer_allocation_);
 }
 
+void Buffer::Flush(std::size_t offset, std::size_t size) {
+  GraphicsAllocator::Get()->FlushAllocation(buffer_allocation_, offset, size);
+}
+
+void Buffer::Invalidate(std::size_t offset, std::size_t size) {
+  GraphicsAllocator::Get()->InvalidateAllocation(buffer_allocation_, offset, size);
+}
+
 std::size_t Buffer::GetSize() const {
   return buffer_size_;
 }
 
+DescriptorBufferInfo Buffer::GetDescriptor() const {
+  DescriptorBufferInfo descriptor_buffer_info;
+  descriptor_buffer_info.buffer = buffer_;
+  descriptor_buffer_info.offset = 0;
+  descriptor_buffer_info.range = VK_WHOLE_SIZE;
+  return descriptor_buffer_info;
+}
+
 VkDeviceAddress Buffer::GetBufferAddress() const {
   BufferDeviceAddressInfo buffer_device_ai;
   buffer_device_ai.buffer = GetHandle();
@@ -17,6 +17,10 @@ class Buffer {
 public:
   static constexpr AllocationCreateMask CPU = AllocationCreateMaskBits::E_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
   static constexpr AllocationCreateMask MAPPED = CPU | AllocationCreateMaskBits::E_MAPPED_BIT;
+  // DEVICE LOCAL WHEN THE DEVICE EXPOSES IT AS HOST VISIBLE, IsMapped TELLS WHETHER A STAGING COPY IS NEEDED
+  static constexpr AllocationCreateMask UPLOAD = CPU | AllocationCreateMaskBits::E_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT | //
+                                                 AllocationCreateMaskBits::E_MAPPED_BIT;
+  static constexpr AllocationCreateMask READBACK = AllocationCreateMaskBits::E_HOST_ACCESS_RANDOM_BIT | AllocationCreateMaskBits::E_MAPPED_BIT;
 
   Buffer() = default;
 
@@ -32,13 +36,19 @@ public:
 
   void Map();
   void Unmap();
+  void Flush(std::size_t offset = 0, std::size_t size = VK_WHOLE_SIZE);
+  void Invalidate(std::size_t offset = 0, std::size_t size = VK_WHOLE_SIZE);
 
   template <typename T> std::span<T> GetMappedData();
   template <typename T> void SetData(std::span<const T> data, std::size_t byte_offset = 0);
 
+  bool IsMapped() const;
+
   VkBuffer GetHandle() const;
   VkDeviceAddress GetBufferAddress() const;
 
+  DescriptorBufferInfo GetDescriptor() const;
+
   std::size_t GetSize() const;
 
   static BufferInformation CreateBuffer(std::size_t size, BufferUsageMask usage, AllocationCreateMask allocation_mask);
@@ -1,6 +1,8 @@
 #include "command_buffer.h"
 #include "command_pool.h"
-#include "innsmouth/graphics/synchronization/fence.h"
+#include "innsmouth/graphics/synchronization/timeline_semaphore.h"
+#include "innsmouth/core/include/core.h"
+#include <vector>
 
 namespace Innsmouth {
 
@@ -47,12 +49,30 @@ const VkCommandBuffer *CommandBuffer::get() const {
 }
 
 void CommandBuffer::Submit() {
-  SubmitInfo submit_info;
-  submit_info.commandBufferCount = 1;
-  submit_info.pCommandBuffers = &command_buffer_;
-  Fence fence;
-  VK_CHECK(vkQueueSubmit(GraphicsContext::Get()->GetGraphicsQueue(), 1, submit_info, fence.GetHandle()));
-  fence.Wait();
+  auto timeline_value = Submit({}, {});
+  GraphicsContext::Get()->GetGraphicsTimeline().Wait(timeline_value);
+}
+
+uint64_t CommandBuffer::Submit(std::span<const SemaphoreSubmitInfo> wait_semaphores, std::span<const SemaphoreSubmitInfo> signal_semaphores) {
+  auto &graphics_timeline = GraphicsContext::Get()->GetGraphicsTimeline();
+  auto timeline_value = graphics_timeline.AdvancePendingValue();
+
+  std::vector<SemaphoreSubmitInfo> signal_semaphore_infos(signal_semaphores.begin(), signal_semaphores.end());
+  signal_semaphore_infos.emplace_back(graphics_timeline.GetSubmitInfo(timeline_value));
+
+  CommandBufferSubmitInfo command_buffer_si;
+  command_buffer_si.commandBuffer = command_buffer_;
+
+  SubmitInfo2 submit_info;
+  submit_info.waitSemaphoreInfoCount = wait_semaphores.size();
+  submit_info.pWaitSemaphoreInfos = wait_semaphores.data();
+  submit_info.commandBufferInfoCount = 1;
+  submit_info.pCommandBufferInfos = &command_buffer_si;
+  submit_info.signalSemaphoreInfoCount = signal_semaphore_infos.size();
+  submit_info.pSignalSemaphoreInfos = signal_semaphore_infos.data();
+
+  VK_CHECK(vkQueueSubmit2(GraphicsContext::Get()->GetGraphicsQueue(), 1, submit_info, VK_NULL_HANDLE));
+  return timeline_value;
 }
 
 void CommandBuffer::Begin(CommandBufferUsageMask usage) {
@@ -127,6 +147,10 @@ void CommandBuffer::CommandEnableDepthWrite(bool enabled) {
   vkCmdSetDepthWriteEnable(command_buffer_, enabled);
 }
 
+void CommandBuffer::CommandSetDepthCompareOp(CompareOp compare_operation) {
+  vkCmdSetDepthCompareOp(command_buffer_, static_cast<VkCompareOp>(compare_operation));
+}
+
 void CommandBuffer::CommandEnableStencilTest(bool enabled) {
   vkCmdSetStencilTestEnable(command_buffer_, enabled);
 }
@@ -208,8 +232,19 @@ void CommandBuffer::CommandBindIndexBuffer(const VkBuffer buffer, std::size_t of
   vkCmdBindIndexBuffer(command_buffer_, buffer, offset, index_type);
 }
 
-void CommandBuffer::CommandBindDescriptorSet(VkPipelineLayout pipeline_layout, VkDescriptorSet descriptor_set, uint32_t set) {
-  vkCmdBindDescriptorSets(command_buffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, set, 1, &descriptor_set, 0, nullptr);
+void CommandBuffer::CommandBindDescriptorSet(VkPipelineLayout pipeline_layout, VkDescriptorSet descriptor_set, uint32_t set,
+                                             PipelineBindPoint bind_point) {
+  vkCmdBindDescriptorSets(command_buffer_, VkPipelineBindPoint(bind_point), pipeline_layout, set, 1, &descriptor_set, 0, nullptr);
+}
+
+void CommandBuffer::CommandBindDescriptorBuffers(std::span<const DescriptorBufferBindingInfoEXT> binding_infos) {
+  auto descriptor_buffer_bis = reinterpret_cast<const VkDescriptorBufferBindingInfoEXT *>(binding_infos.data());
+  vkCmdBindDescriptorBuffersEXT(command_buffer_, binding_infos.size(), descriptor_buffer_bis);
+}
+
+void CommandBuffer::CommandSetDescriptorBufferOffset(VkPipelineLayout pipeline_layout, uint32_t set, uint32_t buffer_index, VkDeviceSize offset,
+                                                     PipelineBindPoint bind_point) {
+  vkCmdSetDescriptorBufferOffsetsEXT(command_buffer_, VkPipelineBindPoint(bind_point), pipeline_layout, set, 1, &buffer_index, &offset);
 }
 
 // DRAW
@@ -230,6 +265,24 @@ void CommandBuffer::CommandDrawIndirect(const VkBuffer buffer, uint64_t offset,
   vkCmdDrawIndirect(command_buffer_, buffer, offset, draw_count, stride);
 }
 
+void CommandBuffer::CommandDrawIndirectCount(VkBuffer buffer, std::size_t offset, VkBuffer count_buffer, std::size_t count_offset,
+                                             uint32_t max_draw_count, uint32_t stride) {
+  vkCmdDrawIndirectCount(command_buffer_, buffer, offset, count_buffer, count_offset, max_draw_count, stride);
+}
+
+void CommandBuffer::CommandDrawMeshTasks(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z) {
+  vkCmdDrawMeshTasksEXT(command_buffer_, group_count_x, group_count_y, group_count_z);
+}
+
+// COMPUTE
+void CommandBuffer::CommandDispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z) {
+  vkCmdDispatch(command_buffer_, group_count_x, group_count_y, group_count_z);
+}
+
+void CommandBuffer::CommandDispatchIndirect(VkBuffer buffer, std::size_t offset) {
+  vkCmdDispatchIndirect(command_buffer_, buffer, offset);
+}
+
 // PUSH DESCRIPTORS
 void CommandBuffer::CommandPushDescriptorSet(std::span<const DescriptorImageInfo> images, VkPipelineLayout layout, uint32_t set_number,
                                              uint32_t binding, DescriptorType descriptor_type, PipelineBindPoint bind_point) {
@@ -275,17 +328,24 @@ void CommandBuffer::CommandPushDescriptorSet(VkPipelineLayout layout, uint32_t s
   vkCmdPushDescriptorSetKHR(command_buffer_, VkPipelineBindPoint(bind_point), layout, set, 1, write_descriptor_set);
 }
 
-void CommandBuffer::CommandCopyBufferToImage(VkBuffer buffer, VkImage image, const Extent3D &extent) {
+void CommandBuffer::CommandPushDescriptorSetWithTemplate(const DescriptorUpdateTemplate &update_template, const void *data, std::size_t size) {
+  CORE_ASSERT(size == update_template.GetDataSize(), "Push descriptor data does not match the update template");
+  auto pipeline_layout = update_template.GetPipelineLayout();
+  vkCmdPushDescriptorSetWithTemplateKHR(command_buffer_, update_template.GetHandle(), pipeline_layout, update_template.GetSet(), data);
+}
+
+void CommandBuffer::CommandCopyBufferToImage(VkBuffer buffer, VkImage image, const Extent3D &extent, std::size_t buffer_offset,
+                                             uint32_t mip_level) {
   ImageSubresourceLayers subresource_layers;
 
   subresource_layers.aspectMask = ImageAspectMaskBits::E_COLOR_BIT;
-  subresource_layers.mipLevel = 0;
+  subresource_layers.mipLevel = mip_level;
   subresource_layers.baseArrayLayer = 0;
   subresource_layers.layerCount = 1;
 
   BufferImageCopy buffer_image_copy;
 
-  buffer_image_copy.bufferOffset = 0;
+  buffer_image_copy.bufferOffset = buffer_offset;
   buffer_image_copy.bufferRowLength = 0;
   buffer_image_copy.bufferImageHeight = 0;
   buffer_image_copy.imageSubresource = subresource_layers;
@@ -303,6 +363,15 @@ void CommandBuffer::CommandCopyBuffer(VkBuffer source, VkBuffer destination, std
   vkCmdCopyBuffer(command_buffer_, source, destination, 1, buffer_copy);
 }
 
+void CommandBuffer::CommandFillBuffer(VkBuffer buffer, std::size_t offset, std::size_t size, uint32_t data) {
+  vkCmdFillBuffer(command_buffer_, buffer, offset, size, data);
+}
+
+void CommandBuffer::CommandUpdateBuffer(VkBuffer buffer, std::size_t offset, std::span<const std::byte> data) {
+  CORE_ASSERT(data.size() <= 65536 && data.size() % 4 == 0, "Inline buffer updates take at most 64 KiB in whole words");
+  vkCmdUpdateBuffer(command_buffer_, buffer, offset, data.size(), data.data());
+}
+
 void CommandBuffer::CommandBuildAccelerationStructure(std::span<const AccelerationStructureBuildGeometryInfoKHR> build_geometry_infos,
                                                       std::span<const AccelerationStructureBuildRangeInfoKHR *> build_range_infos) {
   auto primitive_count = build_range_infos.size();
@@ -311,13 +380,59 @@ void CommandBuffer::CommandBuildAccelerationStructure(std::span<const Accelerati
   vkCmdBuildAccelerationStructuresKHR(command_buffer_, primitive_count, geometry_infos, range_infos);
 }
 
+void CommandBuffer::CommandBuildAccelerationStructureIndirect(std::span<const AccelerationStructureBuildGeometryInfoKHR> build_geometry_infos,
+                                                              std::span<const VkDeviceAddress> build_range_addresses,
+                                                              std::span<const uint32_t> build_range_strides,
+                                                              std::span<const uint32_t *const> max_primitive_counts) {
+  auto geometry_infos = reinterpret_cast<const VkAccelerationStructureBuildGeometryInfoKHR *>(build_geometry_infos.data());
+  vkCmdBuildAccelerationStructuresIndirectKHR(command_buffer_, build_geometry_infos.size(), geometry_infos, build_range_addresses.data(),
+                                              build_range_strides.data(), max_primitive_counts.data());
+}
+
+void CommandBuffer::CommandBuildMicromap(std::span<const MicromapBuildInfoEXT> build_infos) {
+  auto micromap_build_infos = reinterpret_cast<const VkMicromapBuildInfoEXT *>(build_infos.data());
+  vkCmdBuildMicromapsEXT(command_buffer_, build_infos.size(), micromap_build_infos);
+}
+
+void CommandBuffer::CommandCopyAccelerationStructureToMemory(VkAccelerationStructureKHR source, VkDeviceAddress destination) {
+  CopyAccelerationStructureToMemoryInfoKHR copy_info;
+  copy_info.src = source;
+  copy_info.dst.deviceAddress = destination;
+  copy_info.mode = CopyAccelerationStructureModeKHR::E_SERIALIZE_KHR;
+  vkCmdCopyAccelerationStructureToMemoryKHR(command_buffer_, copy_info);
+}
+
+void CommandBuffer::CommandCopyMemoryToAccelerationStructure(VkDeviceAddress source, VkAccelerationStructureKHR destination) {
+  CopyMemoryToAccelerationStructureInfoKHR copy_info;
+  copy_info.src.deviceAddress = source;
+  copy_info.dst = destination;
+  copy_info.mode = CopyAccelerationStructureModeKHR::E_DESERIALIZE_KHR;
+  vkCmdCopyMemoryToAccelerationStructureKHR(command_buffer_, copy_info);
+}
+
+void CommandBuffer::CommandWriteAccelerationStructuresProperties(std::span<const VkAccelerationStructureKHR> acceleration_structures,
+                                                                 QueryType query_type, VkQueryPool query_pool, uint32_t first_query) {
+  vkCmdWriteAccelerationStructuresPropertiesKHR(command_buffer_, acceleration_structures.size(), acceleration_structures.data(),
+                                                VkQueryType(query_type), query_pool, first_query);
+}
+
+// QUERY
+
+void CommandBuffer::CommandResetQueryPool(VkQueryPool query_pool, uint32_t first_query, uint32_t query_count) {
+  vkCmdResetQueryPool(command_buffer_, query_pool, first_query, query_count);
+}
+
+void CommandBuffer::CommandWriteTimestamp(PipelineStageMask2 stage, VkQueryPool query_pool, uint32_t query) {
+  vkCmdWriteTimestamp2(command_buffer_, stage.GetValue(), query_pool, query);
+}
+
 void CommandBuffer::CommandBlitImage(VkImage source_image, ImageLayout source_layout) {
   // vkCmdBlitImage(command_buffer_, source_image, source_layout,  );
 }
 
 void CommandBuffer::CommandTraceRay(const StridedDeviceAddressRegionKHR &raygen, const StridedDeviceAddressRegionKHR &miss,
-                                    const StridedDeviceAddressRegionKHR &hit, uint32_t width, uint32_t height, uint32_t depth) {
-  StridedDeviceAddressRegionKHR callable;
+                                    const StridedDeviceAddressRegionKHR &hit, const StridedDeviceAddressRegionKHR &callable, uint32_t width,
+                                    uint32_t height, uint32_t depth) {
   vkCmdTraceRaysKHR(command_buffer_, raygen, miss, hit, callable, width, height, depth);
 }
 
@@ -2,6 +2,7 @@
 #define INNSMOUTH_COMMAND_BUFFER_H
 
 #include "innsmouth/graphics/graphics_context/graphics_context.h"
+#include "innsmouth/graphics/descriptors/descriptor_update_template.h"
 #include <optional>
 #include <span>
 
@@ -29,6 +30,8 @@ public:
 
   void Submit();
 
+  uint64_t Submit(std::span<const SemaphoreSubmitInfo> wait_semaphores, std::span<const SemaphoreSubmitInfo> signal_semaphores);
+
   void BeginRendering();
 
   const VkCommandBuffer *get() const;
@@ -46,6 +49,7 @@ public:
   void CommandSetFrontFace(FrontFace front_face);
   void CommandEnableDepthTest(bool enabled);
   void CommandEnableDepthWrite(bool enabled);
+  void CommandSetDepthCompareOp(CompareOp compare_operation);
   void CommandEnableStencilTest(bool enabled);
 
   // DRAW
@@ -59,11 +63,24 @@ public:
 
   void CommandDrawIndirect(const VkBuffer buffer, uint64_t offset, uint32_t draw_count, uint32_t stride);
 
+  void CommandDrawIndirectCount(VkBuffer buffer, std::size_t offset, VkBuffer count_buffer, std::size_t count_offset, uint32_t max_draw_count,
+                                uint32_t stride = sizeof(DrawIndirectCommand));
+
+  void CommandDrawMeshTasks(uint32_t group_count_x, uint32_t group_count_y = 1, uint32_t group_count_z = 1);
+
+  // COMPUTE
+  void CommandDispatch(uint32_t group_count_x, uint32_t group_count_y = 1, uint32_t group_count_z = 1);
+  void CommandDispatchIndirect(VkBuffer buffer, std::size_t offset);
+
   // BIND
   void CommandBindPipeline(VkPipeline pipeline, PipelineBindPoint bind_point);
   void CommandBindVertexBuffer(const VkBuffer buffer, std::size_t offset);
   void CommandBindIndexBuffer(const VkBuffer buffer, std::size_t offset, VkIndexType index_type = VkIndexType::VK_INDEX_TYPE_UINT32);
-  void CommandBindDescriptorSet(VkPipelineLayout pipeline_layout, VkDescriptorSet descriptor_set, uint32_t set);
+  void CommandBindDescriptorSet(VkPipelineLayout pipeline_layout, VkDescriptorSet descriptor_set, uint32_t set,
+                                PipelineBindPoint bind_point = PipelineBindPoint::E_GRAPHICS);
+  void CommandBindDescriptorBuffers(std::span<const DescriptorBufferBindingInfoEXT> binding_infos);
+  void CommandSetDescriptorBufferOffset(VkPipelineLayout pipeline_layout, uint32_t set, uint32_t buffer_index, VkDeviceSize offset,
+                                        PipelineBindPoint bind_point);
 
   // BARRIER
   void CommandMemoryBarrier(PipelineStageMask2 source_stage, AccessMask2 source_access, PipelineStageMask2 destination_stage,
@@ -80,8 +97,10 @@ public:
                               std::span<const MemoryBarrier2> memory_barriers);
 
   // COPY
-  void CommandCopyBufferToImage(VkBuffer buffer, VkImage image, const Extent3D &extent);
+  void CommandCopyBufferToImage(VkBuffer buffer, VkImage image, const Extent3D &extent, std::size_t buffer_offset = 0, uint32_t mip_level = 0);
   void CommandCopyBuffer(VkBuffer source, VkBuffer destination, std::size_t from_offset, std::size_t to_offset, std::size_t size);
+  void CommandFillBuffer(VkBuffer buffer, std::size_t offset, std::size_t size, uint32_t data);
+  void CommandUpdateBuffer(VkBuffer buffer, std::size_t offset, std::span<const std::byte> data);
 
   // PUSH
   void CommandPushDescriptorSet(VkPipelineLayout layout, uint32_t set, uint32_t binding, const VkAccelerationStructureKHR &acceleration,
@@ -92,15 +111,38 @@ public:
   void CommandPushDescriptorSet(std::span<const DescriptorImageInfo> images, const VkPipelineLayout layout, uint32_t set_number,
                                 uint32_t binding, DescriptorType descriptor_type, PipelineBindPoint bind_point);
 
+  void CommandPushDescriptorSetWithTemplate(const DescriptorUpdateTemplate &update_template, const void *data, std::size_t size);
+
+  template <typename T> void CommandPushDescriptorSet(const DescriptorUpdateTemplate &update_template, const T &data);
+
   template <typename T> void CommandPushConstants(VkPipelineLayout layout, ShaderStageMask stage, const T &data, uint32_t offset = 0);
 
   void CommandBuildAccelerationStructure(std::span<const AccelerationStructureBuildGeometryInfoKHR> build_geometry_infos,
                                          std::span<const AccelerationStructureBuildRangeInfoKHR *> build_range_infos);
 
+  // RANGES ARE READ FROM THE DEVICE, ONE AccelerationStructureBuildRangeInfoKHR PER GEOMETRY AT EACH ADDRESS
+  void CommandBuildAccelerationStructureIndirect(std::span<const AccelerationStructureBuildGeometryInfoKHR> build_geometry_infos,
+                                                 std::span<const VkDeviceAddress> build_range_addresses,
+                                                 std::span<const uint32_t> build_range_strides,
+                                                 std::span<const uint32_t *const> max_primitive_counts);
+
+  void CommandBuildMicromap(std::span<const MicromapBuildInfoEXT> build_infos);
+
+  void CommandCopyAccelerationStructureToMemory(VkAccelerationStructureKHR source, VkDeviceAddress destination);
+  void CommandCopyMemoryToAccelerationStructure(VkDeviceAddress source, VkAccelerationStructureKHR destination);
+
+  void CommandWriteAccelerationStructuresProperties(std::span<const VkAccelerationStructureKHR> acceleration_structures, QueryType query_type,
+                                                    VkQueryPool query_pool, uint32_t first_query = 0);
+
+  // QUERY
+  void CommandResetQueryPool(VkQueryPool query_pool, uint32_t first_query, uint32_t query_count);
+  void CommandWriteTimestamp(PipelineStageMask2 stage, VkQueryPool query_pool, uint32_t query);
+
   void CommandBlitImage(VkImage source_image, ImageLayout source_layout);
 
   void CommandTraceRay(const StridedDeviceAddressRegionKHR &raygen, const StridedDeviceAddressRegionKHR &miss,
-                       const StridedDeviceAddressRegionKHR &hit, uint32_t width, uint32_t height, uint32_t depth);
+                       const StridedDeviceAddressRegionKHR &hit, const StridedDeviceAddressRegionKHR &callable, uint32_t width,
+                       uint32_t height, uint32_t depth);
 
 private:
   VkCommandBuffer command_buffer_{VK_NULL_HANDLE};
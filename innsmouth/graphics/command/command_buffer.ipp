@@ -7,6 +7,10 @@ template <typename T> void CommandBuffer::CommandPushConstants(VkPipelineLayout
   vkCmdPushConstants(command_buffer_, layout, stage.GetValue(), offset, sizeof(T), &data);
 }
 
+template <typename T> void CommandBuffer::CommandPushDescriptorSet(const DescriptorUpdateTemplate &update_template, const T &data) {
+  CommandPushDescriptorSetWithTemplate(update_template, &data, sizeof(T));
+}
+
 } // namespace Innsmouth
 
 #endif // INNSMOUTH_COMMAND_BUFFER_IPP
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "query_pool.h"
+#include <utility>
+
+namespace Innsmouth {
+
+QueryPool::QueryPool(QueryType query_type, uint32_t query_count) : query_count_(query_count) {
+  QueryPoolCreateInfo query_pool_ci;
+  query_pool_ci.queryType = query_type;
+  query_pool_ci.queryCount = query_count;
+  VK_CHECK(vkCreateQueryPool(GraphicsContext::Get()->GetDevice(), query_pool_ci, nullptr, &query_pool_));
+}
+
+QueryPool::~QueryPool() {
+  vkDestroyQueryPool(GraphicsContext::Get()->GetDevice(), query_pool_, nullptr);
+}
+
+QueryPool::QueryPool(QueryPool &&other) noexcept {
+  query_pool_ = std::exchange(other.query_pool_, VK_NULL_HANDLE);
+  query_count_ = std::exchange(other.query_count_, 0);
+}
+
+QueryPool &QueryPool::operator=(QueryPool &&other) noexcept {
+  std::swap(query_pool_, other.query_pool_);
+  std::swap(query_count_, other.query_count_);
+  return *this;
+}
+
+std::vector<uint64_t> QueryPool::GetResults(uint32_t first_query, uint32_t query_count) const {
+  std::vector<uint64_t> results(query_count);
+  QueryResultMask flags = QueryResultMaskBits::E_64_BIT | QueryResultMaskBits::E_WAIT_BIT;
+  VK_CHECK(vkGetQueryPoolResults(GraphicsContext::Get()->GetDevice(), query_pool_, first_query, query_count, results.size() * sizeof(uint64_t),
+                                 results.data(), sizeof(uint64_t), flags.GetValue()));
+  return results;
+}
+
+uint32_t QueryPool::GetQueryCount() const {
+  return query_count_;
+}
+
+const VkQueryPool QueryPool::GetHandle() const {
+  return query_pool_;
+}
+
+} // namespace Innsmouth
\ No newline at end of file
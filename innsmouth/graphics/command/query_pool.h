@@ -0,0 +1,34 @@
+#ifndef INNSMOUTH_QUERY_POOL_H
+#define INNSMOUTH_QUERY_POOL_H
+
+#include "innsmouth/graphics/graphics_context/graphics_context.h"
+#include <vector>
+
+namespace Innsmouth {
+
+class QueryPool {
+public:
+  QueryPool(QueryType query_type, uint32_t query_count);
+
+  ~QueryPool();
+
+  QueryPool(const QueryPool &) = delete;
+  QueryPool &operator=(const QueryPool &) = delete;
+
+  QueryPool(QueryPool &&other) noexcept;
+  QueryPool &operator=(QueryPool &&other) noexcept;
+
+  std::vector<uint64_t> GetResults(uint32_t first_query, uint32_t query_count) const;
+
+  uint32_t GetQueryCount() const;
+
+  const VkQueryPool GetHandle() const;
+
+private:
+  VkQueryPool query_pool_{VK_NULL_HANDLE};
+  uint32_t query_count_{0};
+};
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_QUERY_POOL_H
\ No newline at end of file
@@ -280,4 +280,12 @@ uint32_t GetFormatTexelBlockSize(Format format) {
   return GetFormatInformation(format).texel_block_size;
 }
 
+std::size_t GetFormatImageSize(Format format, const Extent3D &extent) {
+  const auto &information = GetFormatInformation(format);
+  std::size_t blocks_x = (extent.width + information.extent.width - 1) / information.extent.width;
+  std::size_t blocks_y = (extent.height + information.extent.height - 1) / information.extent.height;
+  std::size_t blocks_z = (extent.depth + information.extent.depth - 1) / information.extent.depth;
+  return blocks_x * blocks_y * blocks_z * information.texel_block_size;
+}
+
 } // end namespace Innsmouth
\ No newline at end of file
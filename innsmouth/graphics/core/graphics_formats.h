@@ -25,6 +25,8 @@ const FormatInformation &GetFormatInformation(Format format);
 
 uint32_t GetFormatTexelBlockSize(Format format);
 
+std::size_t GetFormatImageSize(Format format, const Extent3D &extent);
+
 } // namespace Innsmouth
 
 #endif // INNSMOUTH_FORMATS_H
\ No newline at end of file
@@ -13,6 +13,9 @@ AccessMask2 GetAccessMaskFromLayout(ImageLayout layout, bool destination) {
   case ImageLayout::E_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
     return AccessMaskBits2::E_DEPTH_STENCIL_ATTACHMENT_READ_BIT | AccessMaskBits2::E_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
   case ImageLayout::E_SHADER_READ_ONLY_OPTIMAL: return AccessMaskBits2::E_SHADER_READ_BIT | AccessMaskBits2::E_INPUT_ATTACHMENT_READ_BIT;
+  case ImageLayout::E_DEPTH_READ_ONLY_OPTIMAL:
+  case ImageLayout::E_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+    return AccessMaskBits2::E_DEPTH_STENCIL_ATTACHMENT_READ_BIT | AccessMaskBits2::E_SHADER_READ_BIT;
   case ImageLayout::E_TRANSFER_SRC_OPTIMAL: return AccessMaskBits2::E_TRANSFER_READ_BIT;
   case ImageLayout::E_TRANSFER_DST_OPTIMAL: return AccessMaskBits2::E_TRANSFER_WRITE_BIT;
   case ImageLayout::E_PREINITIALIZED: assert(destination == false); return AccessMaskBits2::E_HOST_WRITE_BIT;
@@ -32,6 +35,10 @@ PipelineStageMask2 GetPipelineStageMaskFromLayout(ImageLayout layout, bool desti
     return PipelineStageMaskBits2::E_EARLY_FRAGMENT_TESTS_BIT | PipelineStageMaskBits2::E_LATE_FRAGMENT_TESTS_BIT;
   case ImageLayout::E_SHADER_READ_ONLY_OPTIMAL:
     return PipelineStageMaskBits2::E_VERTEX_SHADER_BIT | PipelineStageMaskBits2::E_FRAGMENT_SHADER_BIT;
+  case ImageLayout::E_DEPTH_READ_ONLY_OPTIMAL:
+  case ImageLayout::E_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+    return PipelineStageMaskBits2::E_EARLY_FRAGMENT_TESTS_BIT | PipelineStageMaskBits2::E_LATE_FRAGMENT_TESTS_BIT |
+           PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT | PipelineStageMaskBits2::E_FRAGMENT_SHADER_BIT;
   case ImageLayout::E_PRESENT_SRC_KHR: return PipelineStageMaskBits2::E_ALL_COMMANDS_BIT;
   case ImageLayout::E_GENERAL: return PipelineStageMaskBits2::E_RAY_TRACING_SHADER_BIT_KHR | PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT;
   default: return destination ? PipelineStageMaskBits2::E_NONE : PipelineStageMaskBits2::E_ALL_COMMANDS_BIT;
@@ -0,0 +1,235 @@
+#include "bindless_table.h"
+#include "innsmouth/graphics/synchronization/timeline_semaphore.h"
+#include "innsmouth/graphics/command/command_buffer.h"
+#include "innsmouth/core/include/core.h"
+
+namespace Innsmouth {
+
+constexpr std::array<DescriptorType, BindlessTable::BINDINGS_COUNT> BINDLESS_DESCRIPTOR_TYPES = {
+  DescriptorType::E_COMBINED_IMAGE_SAMPLER, //
+  DescriptorType::E_STORAGE_IMAGE,          //
+  DescriptorType::E_SAMPLER,                //
+  DescriptorType::E_STORAGE_BUFFER,         //
+};
+
+// SLOT ALLOCATOR
+
+DescriptorSlotAllocator::DescriptorSlotAllocator(uint32_t capacity) : capacity_(capacity) {
+}
+
+uint32_t DescriptorSlotAllocator::Allocate() {
+  if (free_slots_.empty() == false) {
+    auto slot = free_slots_.back();
+    free_slots_.pop_back();
+    return slot;
+  }
+  if (next_slot_ == capacity_) return INVALID_SLOT;
+  return next_slot_++;
+}
+
+void DescriptorSlotAllocator::Free(uint32_t slot) {
+  free_slots_.emplace_back(slot);
+}
+
+bool DescriptorSlotAllocator::IsFull() const {
+  return free_slots_.empty() && next_slot_ == capacity_;
+}
+
+uint32_t DescriptorSlotAllocator::GetCapacity() const {
+  return capacity_;
+}
+
+// BINDLESS TABLE
+
+BindlessTable *BindlessTable::bindless_table_instance_ = nullptr;
+
+BindlessTable *BindlessTable::Get() {
+  return bindless_table_instance_;
+}
+
+BindlessTable::BindlessTable(const BindlessTableSpecification &specification)
+  : descriptor_buffer_backed_(GraphicsContext::Get()->IsDescriptorBufferEnabled()) {
+  slot_allocators_[std::to_underlying(BindlessBinding::E_TEXTURE)] = DescriptorSlotAllocator(specification.textures_count_);
+  slot_allocators_[std::to_underlying(BindlessBinding::E_STORAGE_IMAGE)] = DescriptorSlotAllocator(specification.storage_images_count_);
+  slot_allocators_[std::to_underlying(BindlessBinding::E_SAMPLER)] = DescriptorSlotAllocator(specification.samplers_count_);
+  slot_allocators_[std::to_underlying(BindlessBinding::E_STORAGE_BUFFER)] = DescriptorSlotAllocator(specification.storage_buffers_count_);
+  CreateDescriptorSetLayout();
+  CreateDescriptorSet();
+  bindless_table_instance_ = this;
+}
+
+BindlessTable::~BindlessTable() {
+  vkDestroyDescriptorPool(GraphicsContext::Get()->GetDevice(), descriptor_pool_, nullptr);
+  vkDestroyDescriptorSetLayout(GraphicsContext::Get()->GetDevice(), descriptor_set_layout_, nullptr);
+  bindless_table_instance_ = nullptr;
+}
+
+void BindlessTable::CreateDescriptorSetLayout() {
+  std::array<DescriptorSetLayoutBinding, BINDINGS_COUNT> set_bindings;
+  std::array<DescriptorBindingMask, BINDINGS_COUNT> binding_masks;
+  for (auto i = 0; i < BINDINGS_COUNT; i++) {
+    set_bindings[i].binding = i;
+    set_bindings[i].descriptorType = BINDLESS_DESCRIPTOR_TYPES[i];
+    set_bindings[i].descriptorCount = slot_allocators_[i].GetCapacity();
+    set_bindings[i].stageFlags = ShaderStageMaskBits::E_ALL;
+    binding_masks[i] = DescriptorBindingMaskBits::E_PARTIALLY_BOUND_BIT;
+    if (descriptor_buffer_backed_ == false) {
+      binding_masks[i] |= DescriptorBindingMaskBits::E_UPDATE_AFTER_BIND_BIT | DescriptorBindingMaskBits::E_UPDATE_UNUSED_WHILE_PENDING_BIT;
+    }
+  }
+
+  DescriptorSetLayoutBindingFlagsCreateInfo set_binding_flags_ci;
+  set_binding_flags_ci.bindingCount = binding_masks.size();
+  set_binding_flags_ci.pBindingFlags = binding_masks.data();
+
+  DescriptorSetLayoutCreateInfo descriptor_set_layout_ci;
+  descriptor_set_layout_ci.bindingCount = set_bindings.size();
+  descriptor_set_layout_ci.pBindings = set_bindings.data();
+  descriptor_set_layout_ci.flags = descriptor_buffer_backed_ ? DescriptorSetLayoutCreateMaskBits::E_DESCRIPTOR_BUFFER_BIT_EXT
+                                                             : DescriptorSetLayoutCreateMaskBits::E_UPDATE_AFTER_BIND_POOL_BIT;
+  descriptor_set_layout_ci.pNext = &set_binding_flags_ci;
+
+  VK_CHECK(vkCreateDescriptorSetLayout(GraphicsContext::Get()->GetDevice(), descriptor_set_layout_ci, nullptr, &descriptor_set_layout_));
+}
+
+void BindlessTable::CreateDescriptorSet() {
+  if (descriptor_buffer_backed_) {
+    descriptor_buffer_ = DescriptorBuffer(descriptor_set_layout_);
+    return;
+  }
+
+  std::array<DescriptorPoolSize, BINDINGS_COUNT> descriptor_pool_sizes;
+  for (auto i = 0; i < BINDINGS_COUNT; i++) {
+    descriptor_pool_sizes[i].type = BINDLESS_DESCRIPTOR_TYPES[i];
+    descriptor_pool_sizes[i].descriptorCount = slot_allocators_[i].GetCapacity();
+  }
+
+  DescriptorPoolCreateInfo descriptor_pool_ci;
+  descriptor_pool_ci.flags = DescriptorPoolCreateMaskBits::E_UPDATE_AFTER_BIND_BIT;
+  descriptor_pool_ci.maxSets = 1;
+  descriptor_pool_ci.poolSizeCount = descriptor_pool_sizes.size();
+  descriptor_pool_ci.pPoolSizes = descriptor_pool_sizes.data();
+  VK_CHECK(vkCreateDescriptorPool(GraphicsContext::Get()->GetDevice(), descriptor_pool_ci, nullptr, &descriptor_pool_));
+
+  DescriptorSetAllocateInfo descriptor_set_ai;
+  descriptor_set_ai.descriptorPool = descriptor_pool_;
+  descriptor_set_ai.descriptorSetCount = 1;
+  descriptor_set_ai.pSetLayouts = &descriptor_set_layout_;
+  VK_CHECK(vkAllocateDescriptorSets(GraphicsContext::Get()->GetDevice(), descriptor_set_ai, &descriptor_set_));
+}
+
+uint32_t BindlessTable::AllocateSlot(BindlessBinding binding) {
+  // SLOTS THE GPU IS DONE WITH GO BACK FIRST, SO THE FREE LIST IS REUSED BEFORE THE TABLE GROWS
+  released_slots_.Retire(GraphicsContext::Get()->GetRetiredFrameValue());
+  return slot_allocators_[std::to_underlying(binding)].Allocate();
+}
+
+void BindlessTable::WriteDescriptorBuffer(BindlessBinding binding, uint32_t slot, const DescriptorImageInfo *image_info,
+                                          const DescriptorBufferInfo *buffer_info) {
+  DescriptorAddressInfoEXT address_info;
+  DescriptorGetInfoEXT descriptor_gi;
+  descriptor_gi.type = BINDLESS_DESCRIPTOR_TYPES[std::to_underlying(binding)];
+  switch (binding) {
+  case BindlessBinding::E_TEXTURE:
+    descriptor_gi.data.pCombinedImageSampler = *image_info;
+    break;
+  case BindlessBinding::E_STORAGE_IMAGE:
+    descriptor_gi.data.pStorageImage = *image_info;
+    break;
+  case BindlessBinding::E_SAMPLER:
+    descriptor_gi.data.pSampler = &image_info->sampler;
+    break;
+  case BindlessBinding::E_STORAGE_BUFFER:
+    BufferDeviceAddressInfo buffer_device_ai;
+    buffer_device_ai.buffer = buffer_info->buffer;
+    address_info.address = vkGetBufferDeviceAddress(GraphicsContext::Get()->GetDevice(), buffer_device_ai) + buffer_info->offset;
+    address_info.range = buffer_info->range;
+    descriptor_gi.data.pStorageBuffer = address_info;
+    break;
+  }
+  descriptor_buffer_.Write(0, std::to_underlying(binding), slot, descriptor_gi);
+}
+
+void BindlessTable::Write(BindlessBinding binding, uint32_t slot, const DescriptorImageInfo *image_info,
+                          const DescriptorBufferInfo *buffer_info) {
+  if (descriptor_buffer_backed_) {
+    WriteDescriptorBuffer(binding, slot, image_info, buffer_info);
+    return;
+  }
+  WriteDescriptorSet write_descriptor_set;
+  write_descriptor_set.dstSet = descriptor_set_;
+  write_descriptor_set.dstBinding = std::to_underlying(binding);
+  write_descriptor_set.dstArrayElement = slot;
+  write_descriptor_set.descriptorType = BINDLESS_DESCRIPTOR_TYPES[std::to_underlying(binding)];
+  write_descriptor_set.descriptorCount = 1;
+  write_descriptor_set.pImageInfo = image_info;
+  write_descriptor_set.pBufferInfo = buffer_info;
+  vkUpdateDescriptorSets(GraphicsContext::Get()->GetDevice(), 1, write_descriptor_set, 0, nullptr);
+}
+
+uint32_t BindlessTable::AddTexture(const DescriptorImageInfo &image_info) {
+  auto slot = AllocateSlot(BindlessBinding::E_TEXTURE);
+  if (slot == INVALID_SLOT) return slot;
+  Write(BindlessBinding::E_TEXTURE, slot, &image_info, nullptr);
+  return slot;
+}
+
+uint32_t BindlessTable::AddStorageImage(VkImageView image_view) {
+  DescriptorImageInfo image_info;
+  image_info.imageView = image_view;
+  image_info.imageLayout = ImageLayout::E_GENERAL;
+  auto slot = AllocateSlot(BindlessBinding::E_STORAGE_IMAGE);
+  if (slot == INVALID_SLOT) return slot;
+  Write(BindlessBinding::E_STORAGE_IMAGE, slot, &image_info, nullptr);
+  return slot;
+}
+
+uint32_t BindlessTable::AddSampler(VkSampler sampler) {
+  DescriptorImageInfo image_info;
+  image_info.sampler = sampler;
+  auto slot = AllocateSlot(BindlessBinding::E_SAMPLER);
+  if (slot == INVALID_SLOT) return slot;
+  Write(BindlessBinding::E_SAMPLER, slot, &image_info, nullptr);
+  return slot;
+}
+
+uint32_t BindlessTable::AddStorageBuffer(const Buffer &buffer, VkDeviceSize offset, VkDeviceSize size) {
+  DescriptorBufferInfo buffer_info;
+  buffer_info.buffer = buffer.GetHandle();
+  buffer_info.offset = offset;
+  buffer_info.range = (size == VK_WHOLE_SIZE) ? buffer.GetSize() - offset : size;
+  auto slot = AllocateSlot(BindlessBinding::E_STORAGE_BUFFER);
+  if (slot == INVALID_SLOT) return slot;
+  Write(BindlessBinding::E_STORAGE_BUFFER, slot, nullptr, &buffer_info);
+  return slot;
+}
+
+void BindlessTable::Release(BindlessBinding binding, uint32_t slot) {
+  if (slot == INVALID_SLOT) return;
+  auto frame_value = GraphicsContext::Get()->GetGraphicsTimeline().GetNextValue();
+  released_slots_.Push(frame_value, [this, binding, slot] { slot_allocators_[std::to_underlying(binding)].Free(slot); });
+}
+
+void BindlessTable::CommandBind(CommandBuffer &command_buffer, VkPipelineLayout pipeline_layout, PipelineBindPoint bind_point) const {
+  if (descriptor_buffer_backed_) {
+    std::array descriptor_buffer_bis = {descriptor_buffer_.GetBindingInfo()};
+    command_buffer.CommandBindDescriptorBuffers(descriptor_buffer_bis);
+    command_buffer.CommandSetDescriptorBufferOffset(pipeline_layout, SET, 0, descriptor_buffer_.GetSetOffset(0), bind_point);
+  } else {
+    command_buffer.CommandBindDescriptorSet(pipeline_layout, descriptor_set_, SET, bind_point);
+  }
+}
+
+bool BindlessTable::IsDescriptorBufferBacked() const {
+  return descriptor_buffer_backed_;
+}
+
+VkDescriptorSetLayout BindlessTable::GetDescriptorSetLayout() const {
+  return descriptor_set_layout_;
+}
+
+VkDescriptorSet BindlessTable::GetDescriptorSet() const {
+  return descriptor_set_;
+}
+
+} // namespace Innsmouth
\ No newline at end of file
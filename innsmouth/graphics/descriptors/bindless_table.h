@@ -0,0 +1,97 @@
+#ifndef INNSMOUTH_BINDLESS_TABLE_H
+#define INNSMOUTH_BINDLESS_TABLE_H
+
+#include "descriptor_buffer.h"
+#include <array>
+#include <vector>
+
+namespace Innsmouth {
+
+class CommandBuffer;
+
+enum class BindlessBinding : uint32_t {
+  E_TEXTURE = 0,
+  E_STORAGE_IMAGE = 1,
+  E_SAMPLER = 2,
+  E_STORAGE_BUFFER = 3,
+};
+
+struct BindlessTableSpecification {
+  uint32_t textures_count_{16384};
+  uint32_t storage_images_count_{1024};
+  uint32_t samplers_count_{256};
+  uint32_t storage_buffers_count_{16384};
+};
+
+class DescriptorSlotAllocator {
+public:
+  static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+
+  DescriptorSlotAllocator() = default;
+
+  DescriptorSlotAllocator(uint32_t capacity);
+
+  uint32_t Allocate();
+  void Free(uint32_t slot);
+
+  bool IsFull() const;
+  uint32_t GetCapacity() const;
+
+private:
+  std::vector<uint32_t> free_slots_;
+  uint32_t next_slot_{0};
+  uint32_t capacity_{0};
+};
+
+class BindlessTable {
+public:
+  static constexpr uint32_t SET = 1;
+  static constexpr uint32_t BINDINGS_COUNT = 4;
+  static constexpr uint32_t INVALID_SLOT = DescriptorSlotAllocator::INVALID_SLOT;
+
+  BindlessTable(const BindlessTableSpecification &specification = {});
+
+  ~BindlessTable();
+
+  // A FULL TABLE RETURNS INVALID_SLOT, RELEASING IT IS A NO-OP
+  uint32_t AddTexture(const DescriptorImageInfo &image_info);
+  uint32_t AddStorageImage(VkImageView image_view);
+  uint32_t AddSampler(VkSampler sampler);
+  uint32_t AddStorageBuffer(const Buffer &buffer, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
+  void Release(BindlessBinding binding, uint32_t slot);
+
+  void CommandBind(CommandBuffer &command_buffer, VkPipelineLayout pipeline_layout, PipelineBindPoint bind_point) const;
+
+  bool IsDescriptorBufferBacked() const;
+
+  VkDescriptorSetLayout GetDescriptorSetLayout() const;
+  VkDescriptorSet GetDescriptorSet() const;
+
+  static BindlessTable *Get();
+
+protected:
+  void CreateDescriptorSetLayout();
+  void CreateDescriptorSet();
+
+  uint32_t AllocateSlot(BindlessBinding binding);
+
+  void Write(BindlessBinding binding, uint32_t slot, const DescriptorImageInfo *image_info, const DescriptorBufferInfo *buffer_info);
+  void WriteDescriptorBuffer(BindlessBinding binding, uint32_t slot, const DescriptorImageInfo *image_info,
+                             const DescriptorBufferInfo *buffer_info);
+
+private:
+  VkDescriptorSetLayout descriptor_set_layout_{VK_NULL_HANDLE};
+  VkDescriptorPool descriptor_pool_{VK_NULL_HANDLE};
+  VkDescriptorSet descriptor_set_{VK_NULL_HANDLE};
+  DescriptorBuffer descriptor_buffer_;
+  bool descriptor_buffer_backed_{false};
+  std::array<DescriptorSlotAllocator, BINDINGS_COUNT> slot_allocators_;
+  DeletionQueue released_slots_;
+
+  static BindlessTable *bindless_table_instance_;
+};
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_BINDLESS_TABLE_H
\ No newline at end of file
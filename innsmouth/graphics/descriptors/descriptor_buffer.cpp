@@ -0,0 +1,87 @@
+#include "descriptor_buffer.h"
+#include "innsmouth/core/include/core.h"
+
+namespace Innsmouth {
+
+DescriptorBuffer::DescriptorBuffer(VkDescriptorSetLayout set_layout, uint32_t sets_count) : set_layout_(set_layout) {
+  const auto &properties = GraphicsContext::Get()->GetDescriptorBufferProperties();
+
+  VkDeviceSize layout_size = 0;
+  vkGetDescriptorSetLayoutSizeEXT(GraphicsContext::Get()->GetDevice(), set_layout_, &layout_size);
+  set_size_ = AlignUp(layout_size, properties.descriptorBufferOffsetAlignment);
+
+  BufferUsageMask usage = BufferUsageMaskBits::E_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | //
+                          BufferUsageMaskBits::E_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT |  //
+                          BufferUsageMaskBits::E_SHADER_DEVICE_ADDRESS_BIT;
+
+  buffer_ = Buffer(set_size_ * sets_count, usage, Buffer::MAPPED);
+}
+
+DescriptorBuffer::DescriptorBuffer(DescriptorBuffer &&other) noexcept {
+  buffer_ = std::move(other.buffer_);
+  set_layout_ = std::exchange(other.set_layout_, VK_NULL_HANDLE);
+  set_size_ = std::exchange(other.set_size_, 0);
+  binding_offsets_ = std::move(other.binding_offsets_);
+}
+
+DescriptorBuffer &DescriptorBuffer::operator=(DescriptorBuffer &&other) noexcept {
+  std::swap(buffer_, other.buffer_);
+  std::swap(set_layout_, other.set_layout_);
+  std::swap(set_size_, other.set_size_);
+  std::swap(binding_offsets_, other.binding_offsets_);
+  return *this;
+}
+
+std::size_t DescriptorBuffer::GetDescriptorSize(DescriptorType descriptor_type) {
+  const auto &properties = GraphicsContext::Get()->GetDescriptorBufferProperties();
+  switch (descriptor_type) {
+  case DescriptorType::E_SAMPLER:
+    return properties.samplerDescriptorSize;
+  case DescriptorType::E_COMBINED_IMAGE_SAMPLER:
+    return properties.combinedImageSamplerDescriptorSize;
+  case DescriptorType::E_SAMPLED_IMAGE:
+    return properties.sampledImageDescriptorSize;
+  case DescriptorType::E_STORAGE_IMAGE:
+    return properties.storageImageDescriptorSize;
+  case DescriptorType::E_UNIFORM_BUFFER:
+    return properties.uniformBufferDescriptorSize;
+  case DescriptorType::E_STORAGE_BUFFER:
+    return properties.storageBufferDescriptorSize;
+  case DescriptorType::E_ACCELERATION_STRUCTURE_KHR:
+    return properties.accelerationStructureDescriptorSize;
+  default:
+    CORE_ASSERT(false, "Unsupported descriptor buffer type");
+  }
+  return 0;
+}
+
+VkDeviceSize DescriptorBuffer::GetBindingOffset(uint32_t binding) {
+  if (binding >= binding_offsets_.size()) {
+    binding_offsets_.resize(binding + 1, VK_WHOLE_SIZE);
+  }
+  if (binding_offsets_[binding] == VK_WHOLE_SIZE) {
+    vkGetDescriptorSetLayoutBindingOffsetEXT(GraphicsContext::Get()->GetDevice(), set_layout_, binding, &binding_offsets_[binding]);
+  }
+  return binding_offsets_[binding];
+}
+
+void DescriptorBuffer::Write(uint32_t set_index, uint32_t binding, uint32_t array_element, const DescriptorGetInfoEXT &descriptor_info) {
+  auto descriptor_size = GetDescriptorSize(descriptor_info.type);
+  auto offset = GetSetOffset(set_index) + GetBindingOffset(binding) + array_element * descriptor_size;
+  auto mapped_data = buffer_.GetMappedData<std::byte>();
+  vkGetDescriptorEXT(GraphicsContext::Get()->GetDevice(), descriptor_info, descriptor_size, mapped_data.data() + offset);
+}
+
+VkDeviceSize DescriptorBuffer::GetSetOffset(uint32_t set_index) const {
+  return set_index * set_size_;
+}
+
+DescriptorBufferBindingInfoEXT DescriptorBuffer::GetBindingInfo() const {
+  DescriptorBufferBindingInfoEXT descriptor_buffer_bi;
+  descriptor_buffer_bi.address = buffer_.GetBufferAddress();
+  descriptor_buffer_bi.usage = BufferUsageMaskBits::E_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | //
+                               BufferUsageMaskBits::E_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT;
+  return descriptor_buffer_bi;
+}
+
+} // namespace Innsmouth
\ No newline at end of file
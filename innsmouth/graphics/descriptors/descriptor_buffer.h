@@ -0,0 +1,42 @@
+#ifndef INNSMOUTH_DESCRIPTOR_BUFFER_H
+#define INNSMOUTH_DESCRIPTOR_BUFFER_H
+
+#include "innsmouth/graphics/buffer/buffer.h"
+#include <vector>
+
+namespace Innsmouth {
+
+class DescriptorBuffer {
+public:
+  DescriptorBuffer() = default;
+
+  DescriptorBuffer(VkDescriptorSetLayout set_layout, uint32_t sets_count = 1);
+
+  ~DescriptorBuffer() = default;
+
+  DescriptorBuffer(const DescriptorBuffer &) = delete;
+  DescriptorBuffer &operator=(const DescriptorBuffer &) = delete;
+
+  DescriptorBuffer(DescriptorBuffer &&other) noexcept;
+  DescriptorBuffer &operator=(DescriptorBuffer &&other) noexcept;
+
+  void Write(uint32_t set_index, uint32_t binding, uint32_t array_element, const DescriptorGetInfoEXT &descriptor_info);
+
+  VkDeviceSize GetSetOffset(uint32_t set_index) const;
+  DescriptorBufferBindingInfoEXT GetBindingInfo() const;
+
+  static std::size_t GetDescriptorSize(DescriptorType descriptor_type);
+
+protected:
+  VkDeviceSize GetBindingOffset(uint32_t binding);
+
+private:
+  Buffer buffer_;
+  VkDescriptorSetLayout set_layout_{VK_NULL_HANDLE};
+  VkDeviceSize set_size_{0};
+  std::vector<VkDeviceSize> binding_offsets_;
+};
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_DESCRIPTOR_BUFFER_H
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "descriptor_update_template.h"
+#include "innsmouth/core/include/core.h"
+#include <algorithm>
+#include <vector>
+
+namespace Innsmouth {
+
+std::size_t DescriptorUpdateTemplate::GetDescriptorDataSize(DescriptorType descriptor_type) {
+  switch (descriptor_type) {
+  case DescriptorType::E_SAMPLER:
+  case DescriptorType::E_COMBINED_IMAGE_SAMPLER:
+  case DescriptorType::E_SAMPLED_IMAGE:
+  case DescriptorType::E_STORAGE_IMAGE:
+  case DescriptorType::E_INPUT_ATTACHMENT:
+    return sizeof(VkDescriptorImageInfo);
+  case DescriptorType::E_UNIFORM_BUFFER:
+  case DescriptorType::E_STORAGE_BUFFER:
+  case DescriptorType::E_UNIFORM_BUFFER_DYNAMIC:
+  case DescriptorType::E_STORAGE_BUFFER_DYNAMIC:
+    return sizeof(VkDescriptorBufferInfo);
+  case DescriptorType::E_UNIFORM_TEXEL_BUFFER:
+  case DescriptorType::E_STORAGE_TEXEL_BUFFER:
+    return sizeof(VkBufferView);
+  case DescriptorType::E_ACCELERATION_STRUCTURE_KHR:
+    return sizeof(VkAccelerationStructureKHR);
+  default:
+    CORE_ASSERT(false, "Unsupported descriptor update template type");
+  }
+  return 0;
+}
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(std::span<const DescriptorSetLayoutBinding> set_bindings, VkPipelineLayout pipeline_layout,
+                                                   uint32_t set, PipelineBindPoint bind_point)
+  : pipeline_layout_(pipeline_layout), set_(set) {
+  std::vector<DescriptorSetLayoutBinding> bindings(set_bindings.begin(), set_bindings.end());
+  std::ranges::sort(bindings, std::less(), &DescriptorSetLayoutBinding::binding);
+
+  // ENTRIES FOLLOW BINDING ORDER, SO A STRUCT WITH ONE MEMBER PER BINDING MATCHES THE LAYOUT
+  std::vector<DescriptorUpdateTemplateEntry> template_entries;
+  for (const auto &binding : bindings) {
+    auto descriptor_size = GetDescriptorDataSize(binding.descriptorType);
+    data_size_ = AlignUp(data_size_, alignof(VkDescriptorImageInfo));
+    auto &template_entry = template_entries.emplace_back();
+    template_entry.dstBinding = binding.binding;
+    template_entry.dstArrayElement = 0;
+    template_entry.descriptorCount = binding.descriptorCount;
+    template_entry.descriptorType = binding.descriptorType;
+    template_entry.offset = data_size_;
+    template_entry.stride = descriptor_size;
+    data_size_ += descriptor_size * binding.descriptorCount;
+  }
+
+  DescriptorUpdateTemplateCreateInfo descriptor_update_template_ci;
+  descriptor_update_template_ci.descriptorUpdateEntryCount = template_entries.size();
+  descriptor_update_template_ci.pDescriptorUpdateEntries = template_entries.data();
+  descriptor_update_template_ci.templateType = DescriptorUpdateTemplateType::E_PUSH_DESCRIPTORS;
+  descriptor_update_template_ci.pipelineBindPoint = bind_point;
+  descriptor_update_template_ci.pipelineLayout = pipeline_layout;
+  descriptor_update_template_ci.set = set;
+
+  VK_CHECK(vkCreateDescriptorUpdateTemplate(GraphicsContext::Get()->GetDevice(), descriptor_update_template_ci, nullptr,
+                                            &descriptor_update_template_));
+}
+
+DescriptorUpdateTemplate::~DescriptorUpdateTemplate() {
+  vkDestroyDescriptorUpdateTemplate(GraphicsContext::Get()->GetDevice(), descriptor_update_template_, nullptr);
+}
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(DescriptorUpdateTemplate &&other) noexcept {
+  descriptor_update_template_ = std::exchange(other.descriptor_update_template_, VK_NULL_HANDLE);
+  pipeline_layout_ = std::exchange(other.pipeline_layout_, VK_NULL_HANDLE);
+  set_ = std::exchange(other.set_, 0);
+  data_size_ = std::exchange(other.data_size_, 0);
+}
+
+DescriptorUpdateTemplate &DescriptorUpdateTemplate::operator=(DescriptorUpdateTemplate &&other) noexcept {
+  std::swap(descriptor_update_template_, other.descriptor_update_template_);
+  std::swap(pipeline_layout_, other.pipeline_layout_);
+  std::swap(set_, other.set_);
+  std::swap(data_size_, other.data_size_);
+  return *this;
+}
+
+VkDescriptorUpdateTemplate DescriptorUpdateTemplate::GetHandle() const {
+  return descriptor_update_template_;
+}
+
+VkPipelineLayout DescriptorUpdateTemplate::GetPipelineLayout() const {
+  return pipeline_layout_;
+}
+
+uint32_t DescriptorUpdateTemplate::GetSet() const {
+  return set_;
+}
+
+std::size_t DescriptorUpdateTemplate::GetDataSize() const {
+  return data_size_;
+}
+
+} // namespace Innsmouth
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef INNSMOUTH_DESCRIPTOR_UPDATE_TEMPLATE_H
+#define INNSMOUTH_DESCRIPTOR_UPDATE_TEMPLATE_H
+
+#include "innsmouth/graphics/graphics_context/graphics_context.h"
+#include <span>
+
+namespace Innsmouth {
+
+class DescriptorUpdateTemplate {
+public:
+  DescriptorUpdateTemplate() = default;
+
+  DescriptorUpdateTemplate(std::span<const DescriptorSetLayoutBinding> set_bindings, VkPipelineLayout pipeline_layout, uint32_t set,
+                           PipelineBindPoint bind_point);
+
+  ~DescriptorUpdateTemplate();
+
+  DescriptorUpdateTemplate(const DescriptorUpdateTemplate &) = delete;
+  DescriptorUpdateTemplate &operator=(const DescriptorUpdateTemplate &) = delete;
+
+  DescriptorUpdateTemplate(DescriptorUpdateTemplate &&other) noexcept;
+  DescriptorUpdateTemplate &operator=(DescriptorUpdateTemplate &&other) noexcept;
+
+  VkDescriptorUpdateTemplate GetHandle() const;
+  VkPipelineLayout GetPipelineLayout() const;
+  uint32_t GetSet() const;
+  std::size_t GetDataSize() const;
+
+  static std::size_t GetDescriptorDataSize(DescriptorType descriptor_type);
+
+private:
+  VkDescriptorUpdateTemplate descriptor_update_template_{VK_NULL_HANDLE};
+  VkPipelineLayout pipeline_layout_{VK_NULL_HANDLE};
+  uint32_t set_{0};
+  std::size_t data_size_{0};
+};
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_DESCRIPTOR_UPDATE_TEMPLATE_H
\ No newline at end of file
@@ -69,8 +69,11 @@ AllocationInformation GraphicsAllocator::AllocateBuffer(const BufferCreateInfo &
                                  AllocationCreateMaskBits::E_HOST_ACCESS_RANDOM_BIT;
 
   auto has_cpu = allocation_mask.HasAnyBits(cpu_bit);
+  auto allow_transfer = allocation_mask.HasBits(AllocationCreateMaskBits::E_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT);
 
   VmaMemoryUsage memory_usage = has_cpu ? VMA_MEMORY_USAGE_AUTO_PREFER_HOST : VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+  // LET VMA PICK HOST VISIBLE DEVICE MEMORY, OR PLAIN DEVICE MEMORY THAT IS LEFT UNMAPPED
+  if (allow_transfer) memory_usage = VMA_MEMORY_USAGE_AUTO;
 
   VmaAllocationCreateInfo vma_allocation_ci{};
   {
@@ -103,6 +106,14 @@ void GraphicsAllocator::UnmapMemory(VmaAllocation allocation) {
   vmaUnmapMemory(vma_allocator_, allocation);
 }
 
+void GraphicsAllocator::FlushAllocation(VmaAllocation allocation, std::size_t offset, std::size_t size) {
+  VK_CHECK(vmaFlushAllocation(vma_allocator_, allocation, offset, size));
+}
+
+void GraphicsAllocator::InvalidateAllocation(VmaAllocation allocation, std::size_t offset, std::size_t size) {
+  VK_CHECK(vmaInvalidateAllocation(vma_allocator_, allocation, offset, size));
+}
+
 void GraphicsAllocator::CopyMemoryToAllocation(std::span<const std::byte> source, VmaAllocation destination, std::size_t offset) {
   vmaCopyMemoryToAllocation(vma_allocator_, source.data(), destination, offset, source.size());
 }
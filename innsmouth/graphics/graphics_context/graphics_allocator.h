@@ -28,6 +28,9 @@ public:
 
   void UnmapMemory(VmaAllocation allocation);
 
+  void FlushAllocation(VmaAllocation allocation, std::size_t offset, std::size_t size);
+  void InvalidateAllocation(VmaAllocation allocation, std::size_t offset, std::size_t size);
+
   void DestroyImage(VkImage image, VmaAllocation allocation);
 
   void DestroyBuffer(VkBuffer buffer, VmaAllocation allocation);
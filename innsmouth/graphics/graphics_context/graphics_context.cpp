@@ -1,6 +1,8 @@
 #include <GLFW/glfw3.h>
 #include "graphics_context.h"
 #include "graphics_tools.h"
+#include "innsmouth/graphics/synchronization/timeline_semaphore.h"
+#include <algorithm>
 #include <print>
 #include <vector>
 
@@ -32,14 +34,71 @@ uint32_t GraphicsContext::GetGraphicsQueueIndex() const {
   return graphics_queue_index_;
 }
 
+bool GraphicsContext::IsDescriptorBufferEnabled() const {
+  return descriptor_buffer_enabled_;
+}
+
+bool GraphicsContext::IsMeshShaderEnabled() const {
+  return mesh_shader_enabled_;
+}
+
+bool GraphicsContext::IsTextureCompressionBCEnabled() const {
+  return texture_compression_bc_enabled_;
+}
+
+bool GraphicsContext::IsAccelerationStructureIndirectBuildEnabled() const {
+  return acceleration_structure_indirect_build_enabled_;
+}
+
+const PhysicalDeviceDescriptorBufferPropertiesEXT &GraphicsContext::GetDescriptorBufferProperties() const {
+  return descriptor_buffer_properties_;
+}
+
+bool GraphicsContext::IsOpacityMicromapEnabled() const {
+  return opacity_micromap_enabled_;
+}
+
+const PhysicalDeviceOpacityMicromapPropertiesEXT &GraphicsContext::GetOpacityMicromapProperties() const {
+  return opacity_micromap_properties_;
+}
+
+TimelineSemaphore &GraphicsContext::GetGraphicsTimeline() {
+  return *graphics_timeline_;
+}
+
+DeletionQueue &GraphicsContext::GetDeletionQueue() {
+  return deletion_queue_;
+}
+
+void GraphicsContext::DeferDeletion(DeletionQueue::Deleter &&deleter) {
+  deletion_queue_.Push(graphics_timeline_->GetNextValue(), std::move(deleter));
+}
+
+void GraphicsContext::RetireFrame(uint64_t completed_frame_value) {
+  retired_frame_value_ = std::max(retired_frame_value_, completed_frame_value);
+  deletion_queue_.Retire(retired_frame_value_);
+}
+
+uint64_t GraphicsContext::GetRetiredFrameValue() const {
+  return retired_frame_value_;
+}
+
 GraphicsContext::GraphicsContext() {
   CreateInstance();
   PickPhysicalDevice();
+  QueryDescriptorBufferSupport();
+  QueryMeshShaderSupport();
+  QueryTextureCompressionSupport();
+  QueryAccelerationStructureIndirectBuildSupport();
+  QueryOpacityMicromapSupport();
   CreateDevice();
   graphics_context_instance_ = this;
+  graphics_timeline_ = std::make_unique<TimelineSemaphore>();
 }
 
 GraphicsContext::~GraphicsContext() {
+  vkDeviceWaitIdle(device_);
+  deletion_queue_.Flush();
 }
 
 std::vector<const char *> GraphicsContext::GetInstanceLayers() const {
@@ -126,6 +185,64 @@ void GraphicsContext::PickPhysicalDevice() {
   }
 }
 
+void GraphicsContext::QueryDescriptorBufferSupport() {
+  if (IsDeviceExtensionSupported(physical_device_, VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) == false) return;
+
+  PhysicalDeviceDescriptorBufferFeaturesEXT descriptor_buffer_features;
+  PhysicalDeviceFeatures2 physical_device_features_2;
+  physical_device_features_2.pNext = &descriptor_buffer_features;
+  vkGetPhysicalDeviceFeatures2(physical_device_, physical_device_features_2);
+
+  PhysicalDeviceProperties2 physical_device_properties_2;
+  physical_device_properties_2.pNext = &descriptor_buffer_properties_;
+  vkGetPhysicalDeviceProperties2(physical_device_, physical_device_properties_2);
+
+  // PUSH DESCRIPTORS ARE USED ALONGSIDE THE DESCRIPTOR BUFFER
+  descriptor_buffer_enabled_ = descriptor_buffer_features.descriptorBuffer && descriptor_buffer_properties_.bufferlessPushDescriptors;
+}
+
+void GraphicsContext::QueryMeshShaderSupport() {
+  if (IsDeviceExtensionSupported(physical_device_, VK_EXT_MESH_SHADER_EXTENSION_NAME) == false) return;
+
+  PhysicalDeviceMeshShaderFeaturesEXT mesh_shader_features;
+  PhysicalDeviceFeatures2 physical_device_features_2;
+  physical_device_features_2.pNext = &mesh_shader_features;
+  vkGetPhysicalDeviceFeatures2(physical_device_, physical_device_features_2);
+
+  mesh_shader_enabled_ = mesh_shader_features.taskShader && mesh_shader_features.meshShader;
+}
+
+void GraphicsContext::QueryTextureCompressionSupport() {
+  PhysicalDeviceFeatures2 physical_device_features_2;
+  vkGetPhysicalDeviceFeatures2(physical_device_, physical_device_features_2);
+
+  texture_compression_bc_enabled_ = physical_device_features_2.features.textureCompressionBC;
+}
+
+void GraphicsContext::QueryAccelerationStructureIndirectBuildSupport() {
+  PhysicalDeviceAccelerationStructureFeaturesKHR acceleration_structure_features;
+  PhysicalDeviceFeatures2 physical_device_features_2;
+  physical_device_features_2.pNext = &acceleration_structure_features;
+  vkGetPhysicalDeviceFeatures2(physical_device_, physical_device_features_2);
+
+  acceleration_structure_indirect_build_enabled_ = acceleration_structure_features.accelerationStructureIndirectBuild;
+}
+
+void GraphicsContext::QueryOpacityMicromapSupport() {
+  if (IsDeviceExtensionSupported(physical_device_, VK_EXT_OPACITY_MICROMAP_EXTENSION_NAME) == false) return;
+
+  PhysicalDeviceOpacityMicromapFeaturesEXT opacity_micromap_features;
+  PhysicalDeviceFeatures2 physical_device_features_2;
+  physical_device_features_2.pNext = &opacity_micromap_features;
+  vkGetPhysicalDeviceFeatures2(physical_device_, physical_device_features_2);
+
+  PhysicalDeviceProperties2 physical_device_properties_2;
+  physical_device_properties_2.pNext = &opacity_micromap_properties_;
+  vkGetPhysicalDeviceProperties2(physical_device_, physical_device_properties_2);
+
+  opacity_micromap_enabled_ = opacity_micromap_features.micromap;
+}
+
 void GraphicsContext::CreateDevice() {
   graphics_queue_index_ = PickPhysicalDeviceQueue(physical_device_);
 
@@ -150,13 +267,41 @@ void GraphicsContext::CreateDevice() {
 
   PhysicalDeviceAccelerationStructureFeaturesKHR physical_device_acceleration_structure_features;
   physical_device_acceleration_structure_features.accelerationStructure = true;
+  physical_device_acceleration_structure_features.accelerationStructureIndirectBuild = acceleration_structure_indirect_build_enabled_;
   physical_device_acceleration_structure_features.pNext = &physical_device_ray_query_features;
 
+  PhysicalDeviceDescriptorBufferFeaturesEXT physical_device_descriptor_buffer_features;
+  physical_device_descriptor_buffer_features.descriptorBuffer = true;
+
+  PhysicalDeviceMeshShaderFeaturesEXT physical_device_mesh_shader_features;
+  physical_device_mesh_shader_features.taskShader = true;
+  physical_device_mesh_shader_features.meshShader = true;
+
+  PhysicalDeviceOpacityMicromapFeaturesEXT physical_device_opacity_micromap_features;
+  physical_device_opacity_micromap_features.micromap = true;
+
+  void *optional_features = &physical_device_acceleration_structure_features;
+
+  if (descriptor_buffer_enabled_) {
+    required_device_extensions.emplace_back(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+    physical_device_descriptor_buffer_features.pNext = std::exchange(optional_features, &physical_device_descriptor_buffer_features);
+  }
+
+  if (mesh_shader_enabled_) {
+    required_device_extensions.emplace_back(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+    physical_device_mesh_shader_features.pNext = std::exchange(optional_features, &physical_device_mesh_shader_features);
+  }
+
+  if (opacity_micromap_enabled_) {
+    required_device_extensions.emplace_back(VK_EXT_OPACITY_MICROMAP_EXTENSION_NAME);
+    physical_device_opacity_micromap_features.pNext = std::exchange(optional_features, &physical_device_opacity_micromap_features);
+  }
+
   PhysicalDeviceVulkan14Features physical_device_features_14;
   physical_device_features_14.maintenance5 = true;
   physical_device_features_14.maintenance6 = true;
   physical_device_features_14.pushDescriptor = true;
-  physical_device_features_14.pNext = &physical_device_acceleration_structure_features;
+  physical_device_features_14.pNext = optional_features;
 
   PhysicalDeviceVulkan13Features physical_device_features_13;
   physical_device_features_13.synchronization2 = true;
@@ -167,12 +312,17 @@ void GraphicsContext::CreateDevice() {
   physical_device_features_12.bufferDeviceAddress = true;
   physical_device_features_12.descriptorIndexing = true;
   physical_device_features_12.shaderSampledImageArrayNonUniformIndexing = true;
+  physical_device_features_12.shaderStorageImageArrayNonUniformIndexing = true;
+  physical_device_features_12.shaderStorageBufferArrayNonUniformIndexing = true;
   physical_device_features_12.descriptorBindingSampledImageUpdateAfterBind = true;
+  physical_device_features_12.descriptorBindingStorageImageUpdateAfterBind = true;
+  physical_device_features_12.descriptorBindingStorageBufferUpdateAfterBind = true;
   physical_device_features_12.descriptorBindingUpdateUnusedWhilePending = true;
   physical_device_features_12.descriptorBindingPartiallyBound = true;
   physical_device_features_12.descriptorBindingVariableDescriptorCount = true;
   physical_device_features_12.runtimeDescriptorArray = true;
   physical_device_features_12.drawIndirectCount = true;
+  physical_device_features_12.timelineSemaphore = true;
   physical_device_features_12.pNext = &physical_device_features_13;
 
   PhysicalDeviceVulkan11Features physical_device_features_11;
@@ -182,6 +332,8 @@ void GraphicsContext::CreateDevice() {
   PhysicalDeviceFeatures2 physical_device_features_2;
   physical_device_features_2.pNext = &physical_device_features_11;
   physical_device_features_2.features.multiDrawIndirect = true;
+  physical_device_features_2.features.drawIndirectFirstInstance = true;
+  physical_device_features_2.features.textureCompressionBC = texture_compression_bc_enabled_;
 
   DeviceCreateInfo device_ci{};
   device_ci.pQueueCreateInfos = device_queue_cis.data();
@@ -2,9 +2,13 @@
 #define INNSMOUTH_GRAPHICS_CONTEXT_H
 
 #include "graphics_tools.h"
+#include "innsmouth/graphics/synchronization/deletion_queue.h"
+#include <memory>
 
 namespace Innsmouth {
 
+class TimelineSemaphore;
+
 class GraphicsContext {
 public:
   GraphicsContext();
@@ -18,12 +22,39 @@ public:
   const VkQueue GetGraphicsQueue() const;
   uint32_t GetGraphicsQueueIndex() const;
 
+  bool IsDescriptorBufferEnabled() const;
+  const PhysicalDeviceDescriptorBufferPropertiesEXT &GetDescriptorBufferProperties() const;
+
+  bool IsMeshShaderEnabled() const;
+  bool IsTextureCompressionBCEnabled() const;
+  bool IsAccelerationStructureIndirectBuildEnabled() const;
+
+  bool IsOpacityMicromapEnabled() const;
+  const PhysicalDeviceOpacityMicromapPropertiesEXT &GetOpacityMicromapProperties() const;
+
+  TimelineSemaphore &GetGraphicsTimeline();
+  DeletionQueue &GetDeletionQueue();
+
+  // RUNS ONCE THE FRAME BEING RECORDED HAS COMPLETED
+  void DeferDeletion(DeletionQueue::Deleter &&deleter);
+
+  // ONLY FRAME VALUES RETIRE, AN IMMEDIATE SUBMIT INSIDE A FRAME TAKES THE VALUE THE DELETERS OF THAT FRAME ARE TAGGED WITH
+  void RetireFrame(uint64_t completed_frame_value);
+  uint64_t GetRetiredFrameValue() const;
+
+  template <typename T> void DeferDestruction(T &&object);
+
   static GraphicsContext *Get();
 
 protected:
   void CreateInstance();
   void PickPhysicalDevice();
   void CreateDevice();
+  void QueryDescriptorBufferSupport();
+  void QueryMeshShaderSupport();
+  void QueryTextureCompressionSupport();
+  void QueryAccelerationStructureIndirectBuildSupport();
+  void QueryOpacityMicromapSupport();
 
   std::vector<const char *> GetInstanceLayers() const;
 
@@ -34,9 +65,21 @@ private:
   VkDevice device_{VK_NULL_HANDLE};
   int32_t graphics_queue_index_{-1};
   VkQueue graphics_queue_{VK_NULL_HANDLE};
+  bool descriptor_buffer_enabled_{false};
+  PhysicalDeviceDescriptorBufferPropertiesEXT descriptor_buffer_properties_;
+  bool mesh_shader_enabled_{false};
+  bool texture_compression_bc_enabled_{false};
+  bool acceleration_structure_indirect_build_enabled_{false};
+  bool opacity_micromap_enabled_{false};
+  PhysicalDeviceOpacityMicromapPropertiesEXT opacity_micromap_properties_;
+  std::unique_ptr<TimelineSemaphore> graphics_timeline_;
+  DeletionQueue deletion_queue_;
+  uint64_t retired_frame_value_{0};
   static GraphicsContext *graphics_context_instance_;
 };
 
 } // namespace Innsmouth
 
+#include "graphics_context.ipp"
+
 #endif // INNSMOUTH_GRAPHICS_CONTEXT_H
\ No newline at end of file
@@ -0,0 +1,14 @@
+#ifndef INNSMOUTH_GRAPHICS_CONTEXT_IPP
+#define INNSMOUTH_GRAPHICS_CONTEXT_IPP
+
+namespace Innsmouth {
+
+template <typename T> void GraphicsContext::DeferDestruction(T &&object) {
+  // DELETERS MUST BE COPYABLE, MOVE-ONLY OBJECTS ARE HELD THROUGH A SHARED POINTER
+  auto holder = std::make_shared<std::remove_cvref_t<T>>(std::forward<T>(object));
+  DeferDeletion([holder]() mutable { holder.reset(); });
+}
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_GRAPHICS_CONTEXT_IPP
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "graphics_tools.h"
 #include <print>
 #include <ranges>
+#include <algorithm>
 #include <vulkan/vk_enum_string_helper.h>
 
 namespace Innsmouth {
@@ -27,6 +28,11 @@ std::vector<const char *> GetRequiredDeviceExtensions() {
   };
 }
 
+bool IsDeviceExtensionSupported(const VkPhysicalDevice physical_device, std::string_view extension_name) {
+  auto extensions = Enumerate<ExtensionProperties>(vkEnumerateDeviceExtensionProperties, physical_device, nullptr);
+  return std::ranges::any_of(extensions, [extension_name](const auto &extension) { return extension_name == extension.extensionName; });
+}
+
 bool EvaluatePhysicalDevice(const VkPhysicalDevice physical_device) {
 
   VkPhysicalDeviceProperties device_properties{};
@@ -4,6 +4,7 @@
 #include "innsmouth/core/include/type_tools.h"
 #include "innsmouth/graphics/core/graphics_types.h"
 #include <source_location>
+#include <string_view>
 #include <vector>
 
 namespace Innsmouth {
@@ -27,6 +28,8 @@ int32_t PickPhysicalDeviceQueue(const VkPhysicalDevice physical_device);
 
 std::vector<const char *> GetRequiredDeviceExtensions();
 
+bool IsDeviceExtensionSupported(const VkPhysicalDevice physical_device, std::string_view extension_name);
+
 } // namespace Innsmouth
 
 #endif // INNSMOUTH_GRAPHICS_TOOLS_H
\ No newline at end of file
@@ -1,10 +1,13 @@
 #include "image.h"
-#include "sampler.h"
+#include "sampler_cache.h"
+#include "image_view_cache.h"
 #include "innsmouth/graphics/core/structure_tools.h"
+#include "innsmouth/graphics/core/graphics_formats.h"
 #include "innsmouth/graphics/buffer/buffer.h"
 #include "innsmouth/graphics/command/command_buffer.h"
 #include "innsmouth/graphics/synchronization/fence.h"
 #include "innsmouth/core/include/core.h"
+#include <algorithm>
 #include <print>
 
 namespace Innsmouth {
@@ -44,8 +47,16 @@ Image::Image(ImageType type, ImageViewType view_type, const ImageSpecification &
 }
 
 Image::~Image() {
-  vkDestroyImageView(GraphicsContext::Get()->GetDevice(), GetImageView(), nullptr);
-  GraphicsAllocator::Get()->DestroyImage(image_, vma_allocation_);
+  SamplerCache::Get()->Release(image_sampler_);
+  if (image_ == VK_NULL_HANDLE) return;
+  // THE VIEWS, THE IMAGE AND ITS MEMORY GO TOGETHER ONCE NO FRAME IN FLIGHT CAN USE THEM
+  auto image_views = ImageViewCache::Get()->Release(image_);
+  GraphicsContext::Get()->DeferDeletion([image = image_, allocation = vma_allocation_, image_views] {
+    for (auto image_view : image_views) {
+      vkDestroyImageView(GraphicsContext::Get()->GetDevice(), image_view, nullptr);
+    }
+    GraphicsAllocator::Get()->DestroyImage(image, allocation);
+  });
 }
 
 void Image::Initialize(ImageType image_type, ImageViewType view_type, const ImageSpecification &image_specification,
@@ -54,8 +65,8 @@ void Image::Initialize(ImageType image_type, ImageViewType view_type, const Imag
   auto aspect_mask = GetAspectMask(GetFormat());
   auto subresource = GetImageSubresourceRange(aspect_mask, 0, GetLevelCoount(), 0, GetLayerCoount());
   image_ = CreateImage(image_type, image_specification_, vma_allocation_);
-  image_view_ = CreateImageView(GetImage(), GetFormat(), view_type, subresource);
-  image_sampler_ = sampler_specification.has_value() ? Sampler::CreateSampler(sampler_specification.value()) : nullptr;
+  image_view_ = ImageViewCache::Get()->Acquire(GetImage(), ImageViewDescription(GetFormat(), view_type, subresource));
+  image_sampler_ = sampler_specification.has_value() ? SamplerCache::Get()->Acquire(sampler_specification.value()) : nullptr;
 }
 
 void Image::GenerateMipmaps() {
@@ -67,7 +78,7 @@ void Image::SetImageLayout(ImageLayout new_layout, CommandBuffer *command_buffer
   auto access1 = GetAccessMaskFromLayout(new_layout, true);
   auto stage0 = GetPipelineStageMaskFromLayout(current_layout_, false);
   auto stage1 = GetPipelineStageMaskFromLayout(new_layout, true);
-  auto subresource = GetImageSubresourceRange(ImageAspectMaskBits::E_COLOR_BIT);
+  auto subresource = GetImageSubresourceRange(GetAspectMask(GetFormat()), 0, GetLevelCoount(), 0, GetLayerCoount());
   command_buffer->CommandImageMemoryBarrier(GetImage(), current_layout_, new_layout, stage0, stage1, access0, access1, subresource);
   current_layout_ = new_layout;
 }
@@ -77,13 +88,23 @@ void Image::SetImageData(std::span<const std::byte> data) {
   buffer.SetData<std::byte>(data);
   CommandBuffer command_buffer(GraphicsContext::Get()->GetGraphicsQueueIndex());
   command_buffer.Begin();
-  SetImageLayout(ImageLayout::E_TRANSFER_DST_OPTIMAL, &command_buffer);
-  command_buffer.CommandCopyBufferToImage(buffer.GetHandle(), GetImage(), GetExtent());
-  SetImageLayout(ImageLayout::E_SHADER_READ_ONLY_OPTIMAL, &command_buffer);
+  CommandSetImageData(command_buffer, buffer.GetHandle(), 0, data.size());
   command_buffer.End();
   command_buffer.Submit();
 }
 
+void Image::CommandSetImageData(CommandBuffer &command_buffer, VkBuffer buffer, std::size_t buffer_offset, std::size_t size) {
+  SetImageLayout(ImageLayout::E_TRANSFER_DST_OPTIMAL, &command_buffer);
+  // LEVELS ARE TIGHTLY PACKED FROM THE LARGEST, SIZES FOLLOW THE FORMAT BLOCK LAYOUT
+  std::size_t offset = 0;
+  for (auto level = 0; level < GetLevelCoount() && offset < size; level++) {
+    auto extent = Extent3D(std::max(GetExtent().width >> level, 1u), std::max(GetExtent().height >> level, 1u), 1);
+    command_buffer.CommandCopyBufferToImage(buffer, GetImage(), extent, buffer_offset + offset, level);
+    offset += GetFormatImageSize(GetFormat(), extent);
+  }
+  SetImageLayout(ImageLayout::E_SHADER_READ_ONLY_OPTIMAL, &command_buffer);
+}
+
 Image::Image(Image &&other) noexcept {
   image_ = std::exchange(other.image_, VK_NULL_HANDLE);
   vma_allocation_ = std::exchange(other.vma_allocation_, VK_NULL_HANDLE);
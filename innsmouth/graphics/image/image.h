@@ -50,6 +50,7 @@ public:
   static VkImage CreateImage(ImageType image_type, const ImageSpecification &image_specification, VmaAllocation &out_allocation);
 
   void SetImageData(std::span<const std::byte> data);
+  void CommandSetImageData(CommandBuffer &command_buffer, VkBuffer buffer, std::size_t buffer_offset, std::size_t size);
   void SetImageLayout(ImageLayout new_layout, CommandBuffer *command_buffer);
 
 protected:
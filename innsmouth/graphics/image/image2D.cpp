@@ -1,9 +1,18 @@
 #include "image2D.h"
 #include "innsmouth/core/include/image_wrapper.h"
+#include "innsmouth/core/include/ktx_wrapper.h"
+#include "innsmouth/core/include/image_ingest.h"
+#include "innsmouth/core/include/core.h"
+#include "innsmouth/graphics/buffer/buffer.h"
+#include "innsmouth/graphics/command/command_buffer.h"
 
 namespace Innsmouth {
 
 Image2D::Image2D(const std::filesystem::path &image_path, const std::optional<SamplerSpecification> &sampler_specification) {
+  if (image_path.extension() == ".ktx2") {
+    LoadKtx(image_path, sampler_specification);
+    return;
+  }
   ImageWrapper image_wrapper(image_path);
   ImageUsageMask usage_mask = ImageUsageMaskBits::E_SAMPLED_BIT | ImageUsageMaskBits::E_TRANSFER_DST_BIT;
   Create(image_wrapper.GetWidth(), image_wrapper.GetHeight(), Format::E_R8G8B8A8_UNORM, usage_mask, sampler_specification);
@@ -16,6 +25,12 @@ Image2D::Image2D(uint32_t width, uint32_t height, Format format, ImageUsageMask
   Create(width, height, format, usage_mask, SamplerSpecification());
 }
 
+Image2D::Image2D(uint32_t width, uint32_t height, Format format, uint32_t levels,
+                 const std::optional<SamplerSpecification> &sampler_specification) {
+  ImageUsageMask usage_mask = ImageUsageMaskBits::E_SAMPLED_BIT | ImageUsageMaskBits::E_TRANSFER_DST_BIT;
+  Create(width, height, format, usage_mask, sampler_specification, levels);
+}
+
 Image2D::Image2D(uint32_t width, uint32_t height, std::span<const std::byte> data,
                  const std::optional<SamplerSpecification> &sampler_specification) {
   ImageUsageMask usage_mask = ImageUsageMaskBits::E_SAMPLED_BIT | ImageUsageMaskBits::E_TRANSFER_DST_BIT;
@@ -23,10 +38,76 @@ Image2D::Image2D(uint32_t width, uint32_t height, std::span<const std::byte> dat
   SetImageData(data);
 }
 
+Format GetConversionFormat(ImageConversion conversion) {
+  switch (conversion) {
+  case ImageConversion::E_RGBA16F_LINEAR:
+  case ImageConversion::E_RGBA16F_HDR:
+    return Format::E_R16G16B16A16_SFLOAT;
+  case ImageConversion::E_RG8_NORMAL:
+    return Format::E_R8G8_UNORM;
+  case ImageConversion::E_RGBA8_SRGB:
+    return Format::E_R8G8B8A8_SRGB;
+  default:
+    return Format::E_R8G8B8A8_UNORM;
+  }
+}
+
+std::vector<Image2D> Image2D::Load(std::span<const std::filesystem::path> image_paths,
+                                   const std::optional<SamplerSpecification> &sampler_specification,
+                                   std::span<const ImageConversion> conversions) {
+  std::vector<Image2D> images(image_paths.size());
+  std::vector<std::filesystem::path> ingest_paths;
+  std::vector<ImageConversion> ingest_conversions;
+  std::vector<std::size_t> ingest_images;
+  for (auto i = 0; i < image_paths.size(); i++) {
+    if (image_paths[i].extension() == ".ktx2") {
+      images[i] = Image2D(image_paths[i], sampler_specification);
+    } else {
+      ingest_paths.emplace_back(image_paths[i]);
+      ingest_conversions.emplace_back(i < conversions.size() ? conversions[i] : ImageConversion::E_RGBA8);
+      ingest_images.emplace_back(i);
+    }
+  }
+  if (ingest_paths.empty()) return images;
+
+  auto infos = ProbeImages(ingest_paths, ingest_conversions);
+  std::vector<std::size_t> offsets;
+  std::size_t staging_size = 0;
+  for (const auto &info : infos) {
+    offsets.emplace_back(staging_size);
+    staging_size = AlignUp(staging_size + info.GetSize(), 16);
+  }
+
+  // WORKERS DECODE AND CONVERT STRAIGHT INTO THE MAPPED STAGING BUFFER
+  Buffer staging_buffer(staging_size, BufferUsageMaskBits::E_TRANSFER_SRC_BIT, Buffer::MAPPED);
+  IngestImages(ingest_paths, infos, offsets, staging_buffer.GetMappedData<std::byte>());
+  staging_buffer.Flush();
+
+  CommandBuffer command_buffer(GraphicsContext::Get()->GetGraphicsQueueIndex());
+  command_buffer.Begin();
+  for (auto i = 0; i < ingest_paths.size(); i++) {
+    auto &image = images[ingest_images[i]];
+    image = Image2D(infos[i].width_, infos[i].height_, GetConversionFormat(infos[i].conversion_), 1, sampler_specification);
+    image.CommandSetImageData(command_buffer, staging_buffer.GetHandle(), offsets[i], infos[i].GetSize());
+  }
+  command_buffer.End();
+  command_buffer.Submit();
+  return images;
+}
+
+void Image2D::LoadKtx(const std::filesystem::path &image_path, const std::optional<SamplerSpecification> &sampler_specification) {
+  KtxWrapper ktx_wrapper(image_path, GraphicsContext::Get()->IsTextureCompressionBCEnabled());
+  ImageUsageMask usage_mask = ImageUsageMaskBits::E_SAMPLED_BIT | ImageUsageMaskBits::E_TRANSFER_DST_BIT;
+  auto format = static_cast<Format>(ktx_wrapper.GetFormat());
+  Create(ktx_wrapper.GetWidth(), ktx_wrapper.GetHeight(), format, usage_mask, sampler_specification, ktx_wrapper.GetLevelCount());
+  SetImageData(ktx_wrapper.GetData());
+}
+
 void Image2D::Create(uint32_t width, uint32_t height, Format format, ImageUsageMask usage_mask,
-                     const std::optional<SamplerSpecification> &sampler_specification) {
+                     const std::optional<SamplerSpecification> &sampler_specification, uint32_t levels) {
   ImageSpecification image_specification;
   image_specification.extent_ = Extent3D(width, height, 1);
+  image_specification.levels_ = levels;
   image_specification.format_ = format;
   image_specification.usage_ = usage_mask;
   Initialize(ImageType::E_2D, ImageViewType::E_2D, image_specification, sampler_specification);
@@ -3,6 +3,7 @@
 
 #include <filesystem>
 #include "image.h"
+#include "innsmouth/core/include/image_ingest.h"
 
 namespace Innsmouth {
 
@@ -14,6 +15,8 @@ public:
 
   Image2D(const std::filesystem::path &image_path, const std::optional<SamplerSpecification> &sampler_specification = std::nullopt);
 
+  Image2D(uint32_t width, uint32_t height, Format format, uint32_t levels, const std::optional<SamplerSpecification> &sampler_specification);
+
   Image2D(uint32_t width, uint32_t height, std::span<const std::byte> data,
           const std::optional<SamplerSpecification> &sampler_specification = std::nullopt);
 
@@ -21,9 +24,15 @@ public:
 
   Image2D &operator=(Image2D &&other) noexcept = default;
 
+  static std::vector<Image2D> Load(std::span<const std::filesystem::path> image_paths,
+                                   const std::optional<SamplerSpecification> &sampler_specification = std::nullopt,
+                                   std::span<const ImageConversion> conversions = {});
+
 protected:
   void Create(uint32_t width, uint32_t height, Format format, ImageUsageMask usage_mask,
-              const std::optional<SamplerSpecification> &sampler_specification);
+              const std::optional<SamplerSpecification> &sampler_specification, uint32_t levels = 1);
+
+  void LoadKtx(const std::filesystem::path &image_path, const std::optional<SamplerSpecification> &sampler_specification);
 };
 
 } // namespace Innsmouth
@@ -3,12 +3,17 @@
 
 namespace Innsmouth {
 
-ImageDepth::ImageDepth(uint32_t width, uint32_t height, Format format) {
+ImageDepth::ImageDepth(uint32_t width, uint32_t height, Format format, ImageUsageMask optional_usage) {
   ImageSpecification depth_image_specification;
   depth_image_specification.extent_ = Extent3D(width, height, 1);
   depth_image_specification.format_ = format;
-  depth_image_specification.usage_ = ImageUsageMaskBits::E_DEPTH_STENCIL_ATTACHMENT_BIT;
-  Initialize(ImageType::E_2D, ImageViewType::E_2D, depth_image_specification);
+  depth_image_specification.usage_ = optional_usage | ImageUsageMaskBits::E_DEPTH_STENCIL_ATTACHMENT_BIT;
+  // DEPTH IS NOT FILTERABLE, SAMPLED DEPTH GETS A NEAREST SAMPLER
+  std::optional<SamplerSpecification> sampler_specification;
+  if (optional_usage.HasBits(ImageUsageMaskBits::E_SAMPLED_BIT)) {
+    sampler_specification = SamplerSpecification(Filter::E_NEAREST, Filter::E_NEAREST, SamplerMipmapMode::E_NEAREST);
+  }
+  Initialize(ImageType::E_2D, ImageViewType::E_2D, depth_image_specification, sampler_specification);
 }
 
 } // namespace Innsmouth
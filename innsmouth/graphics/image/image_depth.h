@@ -9,7 +9,7 @@ class ImageDepth : public Image {
 public:
   ImageDepth() = default;
 
-  ImageDepth(uint32_t width, uint32_t height, Format format = Format::E_D32_SFLOAT);
+  ImageDepth(uint32_t width, uint32_t height, Format format = Format::E_D32_SFLOAT, ImageUsageMask optional_usage = ImageUsageMask());
 
   ImageDepth(ImageDepth &&other) noexcept = default;
 
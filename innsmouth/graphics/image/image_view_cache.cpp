@@ -0,0 +1,75 @@
+#include "image_view_cache.h"
+#include "image.h"
+
+namespace Innsmouth {
+
+bool ImageViewDescription::operator==(const ImageViewDescription &other) const {
+  return format_ == other.format_ && view_type_ == other.view_type_ && subresource_.aspectMask == other.subresource_.aspectMask &&
+         subresource_.baseMipLevel == other.subresource_.baseMipLevel && subresource_.levelCount == other.subresource_.levelCount &&
+         subresource_.baseArrayLayer == other.subresource_.baseArrayLayer && subresource_.layerCount == other.subresource_.layerCount;
+}
+
+std::size_t ImageViewDescriptionHash::operator()(const ImageViewDescription &description) const {
+  std::size_t seed = 0;
+  HashCombine(seed, description.format_);
+  HashCombine(seed, description.view_type_);
+  HashCombine(seed, description.subresource_.aspectMask.GetValue());
+  HashCombine(seed, description.subresource_.baseMipLevel);
+  HashCombine(seed, description.subresource_.levelCount);
+  HashCombine(seed, description.subresource_.baseArrayLayer);
+  HashCombine(seed, description.subresource_.layerCount);
+  return seed;
+}
+
+ImageViewCache *ImageViewCache::image_view_cache_instance_ = nullptr;
+
+ImageViewCache *ImageViewCache::Get() {
+  return image_view_cache_instance_;
+}
+
+ImageViewCache::ImageViewCache() {
+  image_view_cache_instance_ = this;
+}
+
+ImageViewCache::~ImageViewCache() {
+  vkDeviceWaitIdle(GraphicsContext::Get()->GetDevice());
+  for (const auto &[image, views] : image_views_) {
+    for (const auto &[description, image_view] : views) {
+      vkDestroyImageView(GraphicsContext::Get()->GetDevice(), image_view, nullptr);
+    }
+  }
+  image_view_cache_instance_ = nullptr;
+}
+
+VkImageView ImageViewCache::Acquire(VkImage image, const ImageViewDescription &description) {
+  std::lock_guard lock(mutex_);
+  auto &image_view = image_views_[image][description];
+  if (image_view == VK_NULL_HANDLE) {
+    image_view = Image::CreateImageView(image, description.format_, description.view_type_, description.subresource_);
+  }
+  return image_view;
+}
+
+std::vector<VkImageView> ImageViewCache::Release(VkImage image) {
+  std::lock_guard lock(mutex_);
+  std::vector<VkImageView> released_views;
+  auto image_it = image_views_.find(image);
+  if (image_it == image_views_.end()) return released_views;
+  for (const auto &[description, image_view] : image_it->second) {
+    released_views.emplace_back(image_view);
+  }
+  // A RECYCLED HANDLE OF A NEW IMAGE MUST NOT FIND THE VIEWS OF THIS ONE
+  image_views_.erase(image_it);
+  return released_views;
+}
+
+std::size_t ImageViewCache::GetSize() const {
+  std::lock_guard lock(mutex_);
+  std::size_t size = 0;
+  for (const auto &[image, views] : image_views_) {
+    size += views.size();
+  }
+  return size;
+}
+
+} // namespace Innsmouth
\ No newline at end of file
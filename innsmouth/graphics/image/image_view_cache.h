@@ -0,0 +1,50 @@
+#ifndef INNSMOUTH_IMAGE_VIEW_CACHE_H
+#define INNSMOUTH_IMAGE_VIEW_CACHE_H
+
+#include "innsmouth/graphics/graphics_context/graphics_context.h"
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+namespace Innsmouth {
+
+struct ImageViewDescription {
+  Format format_{Format::E_UNDEFINED};
+  ImageViewType view_type_{ImageViewType::E_2D};
+  ImageSubresourceRange subresource_;
+
+  bool operator==(const ImageViewDescription &other) const;
+};
+
+struct ImageViewDescriptionHash {
+  std::size_t operator()(const ImageViewDescription &description) const;
+};
+
+// VIEWS BELONG TO THEIR IMAGE, EQUAL DESCRIPTIONS OF ONE IMAGE SHARE A VIEW AND ALL OF THEM GO AWAY WITH THE IMAGE
+class ImageViewCache {
+public:
+  ImageViewCache();
+
+  ~ImageViewCache();
+
+  VkImageView Acquire(VkImage image, const ImageViewDescription &description);
+
+  // FORGETS THE IMAGE, THE CALLER DESTROYS THE RETURNED VIEWS TOGETHER WITH IT
+  std::vector<VkImageView> Release(VkImage image);
+
+  std::size_t GetSize() const;
+
+  static ImageViewCache *Get();
+
+private:
+  using ImageViews = std::unordered_map<ImageViewDescription, VkImageView, ImageViewDescriptionHash>;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<VkImage, ImageViews> image_views_;
+
+  static ImageViewCache *image_view_cache_instance_;
+};
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_IMAGE_VIEW_CACHE_H
\ No newline at end of file
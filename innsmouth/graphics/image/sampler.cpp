@@ -21,6 +21,15 @@ VkSampler Sampler::GetHandle() const {
   return sampler_;
 }
 
+std::size_t SamplerSpecificationHash::operator()(const SamplerSpecification &specification) const {
+  std::size_t seed = 0;
+  HashCombine(seed, specification.min_filter_);
+  HashCombine(seed, specification.mag_filter_);
+  HashCombine(seed, specification.mipmap_mode_);
+  HashCombine(seed, specification.address_mode_);
+  return seed;
+}
+
 VkSampler Sampler::CreateSampler(const SamplerSpecification &specification) {
   VkSampler sampler = VK_NULL_HANDLE;
   SamplerCreateInfo sampler_ci;
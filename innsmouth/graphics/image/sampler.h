@@ -10,6 +10,12 @@ struct SamplerSpecification {
   Filter mag_filter_ = Filter::E_LINEAR;
   SamplerMipmapMode mipmap_mode_ = SamplerMipmapMode::E_LINEAR;
   SamplerAddressMode address_mode_ = SamplerAddressMode::E_CLAMP_TO_EDGE;
+
+  bool operator==(const SamplerSpecification &other) const = default;
+};
+
+struct SamplerSpecificationHash {
+  std::size_t operator()(const SamplerSpecification &specification) const;
 };
 
 class Sampler {
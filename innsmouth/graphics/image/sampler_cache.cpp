@@ -0,0 +1,51 @@
+#include "sampler_cache.h"
+
+namespace Innsmouth {
+
+SamplerCache *SamplerCache::sampler_cache_instance_ = nullptr;
+
+SamplerCache *SamplerCache::Get() {
+  return sampler_cache_instance_;
+}
+
+SamplerCache::SamplerCache() {
+  sampler_cache_instance_ = this;
+}
+
+SamplerCache::~SamplerCache() {
+  vkDeviceWaitIdle(GraphicsContext::Get()->GetDevice());
+  for (const auto &[specification, cached_sampler] : samplers_) {
+    vkDestroySampler(GraphicsContext::Get()->GetDevice(), cached_sampler.sampler_, nullptr);
+  }
+  sampler_cache_instance_ = nullptr;
+}
+
+VkSampler SamplerCache::Acquire(const SamplerSpecification &specification) {
+  std::lock_guard lock(mutex_);
+  auto &cached_sampler = samplers_[specification];
+  if (cached_sampler.sampler_ == VK_NULL_HANDLE) {
+    cached_sampler.sampler_ = Sampler::CreateSampler(specification);
+    specifications_.emplace(cached_sampler.sampler_, specification);
+  }
+  cached_sampler.references_++;
+  return cached_sampler.sampler_;
+}
+
+void SamplerCache::Release(VkSampler sampler) {
+  if (sampler == VK_NULL_HANDLE) return;
+  std::lock_guard lock(mutex_);
+  auto specification_it = specifications_.find(sampler);
+  if (specification_it == specifications_.end()) return;
+  auto sampler_it = samplers_.find(specification_it->second);
+  if (--sampler_it->second.references_ > 0) return;
+  samplers_.erase(sampler_it);
+  specifications_.erase(specification_it);
+  GraphicsContext::Get()->DeferDeletion([sampler] { vkDestroySampler(GraphicsContext::Get()->GetDevice(), sampler, nullptr); });
+}
+
+std::size_t SamplerCache::GetSize() const {
+  std::lock_guard lock(mutex_);
+  return samplers_.size();
+}
+
+} // namespace Innsmouth
\ No newline at end of file
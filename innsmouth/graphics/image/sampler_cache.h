@@ -0,0 +1,38 @@
+#ifndef INNSMOUTH_SAMPLER_CACHE_H
+#define INNSMOUTH_SAMPLER_CACHE_H
+
+#include "sampler.h"
+#include <mutex>
+#include <unordered_map>
+
+namespace Innsmouth {
+
+class SamplerCache {
+public:
+  SamplerCache();
+
+  ~SamplerCache();
+
+  VkSampler Acquire(const SamplerSpecification &specification);
+  void Release(VkSampler sampler);
+
+  std::size_t GetSize() const;
+
+  static SamplerCache *Get();
+
+private:
+  struct CachedSampler {
+    VkSampler sampler_{VK_NULL_HANDLE};
+    uint32_t references_{0};
+  };
+
+  mutable std::mutex mutex_;
+  std::unordered_map<SamplerSpecification, CachedSampler, SamplerSpecificationHash> samplers_;
+  std::unordered_map<VkSampler, SamplerSpecification> specifications_;
+
+  static SamplerCache *sampler_cache_instance_;
+};
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_SAMPLER_CACHE_H
\ No newline at end of file
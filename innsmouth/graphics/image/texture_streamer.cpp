@@ -0,0 +1,255 @@
+#include "texture_streamer.h"
+#include "innsmouth/graphics/command/command_buffer.h"
+#include "innsmouth/graphics/descriptors/bindless_table.h"
+#include "innsmouth/graphics/graphics_context/graphics_context.h"
+#include "innsmouth/graphics/core/graphics_formats.h"
+#include "innsmouth/core/include/image_ingest.h"
+#include "innsmouth/core/include/ktx_wrapper.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace Innsmouth {
+
+void GenerateMipChain(std::span<std::byte> data, std::span<const std::size_t> level_offsets, uint32_t width, uint32_t height) {
+  for (auto level = 1; level < level_offsets.size(); level++) {
+    auto next_width = std::max(width / 2, 1u), next_height = std::max(height / 2, 1u);
+    auto source = data.subspan(level_offsets[level - 1]);
+    auto destination = data.subspan(level_offsets[level]);
+    for (auto y = 0; y < next_height; y++) {
+      for (auto x = 0; x < next_width; x++) {
+        auto x0 = std::min(2 * x, width - 1), x1 = std::min(2 * x + 1, width - 1);
+        auto y0 = std::min(2 * y, height - 1), y1 = std::min(2 * y + 1, height - 1);
+        for (auto c = 0; c < 4; c++) {
+          auto texel = [&](uint32_t u, uint32_t v) { return uint32_t(source[4 * (v * width + u) + c]); };
+          auto sum = texel(x0, y0) + texel(x1, y0) + texel(x0, y1) + texel(x1, y1);
+          destination[4 * (y * next_width + x) + c] = std::byte((sum + 2) / 4);
+        }
+      }
+    }
+    width = next_width;
+    height = next_height;
+  }
+}
+
+std::shared_ptr<const TextureSource> DecodeTextureSource(const std::filesystem::path &path, ImageConversion conversion) {
+  auto source = std::make_shared<TextureSource>();
+  std::optional<KtxWrapper> ktx_wrapper;
+  ImageIngestInfo ingest_info;
+  if (path.extension() == ".ktx2") {
+    ktx_wrapper.emplace(path, GraphicsContext::Get()->IsTextureCompressionBCEnabled());
+    source->format_ = static_cast<Format>(ktx_wrapper->GetFormat());
+    source->width_ = ktx_wrapper->GetWidth();
+    source->height_ = ktx_wrapper->GetHeight();
+    source->levels_ = ktx_wrapper->GetLevelCount();
+  } else {
+    ingest_info = ProbeImage(path, conversion);
+    source->format_ = conversion == ImageConversion::E_RGBA8_SRGB ? Format::E_R8G8B8A8_SRGB : Format::E_R8G8B8A8_UNORM;
+    source->width_ = ingest_info.width_;
+    source->height_ = ingest_info.height_;
+    source->levels_ = std::bit_width(std::max(source->width_, source->height_));
+  }
+  std::size_t offset = 0;
+  for (auto level = 0; level < source->levels_; level++) {
+    source->level_offsets_.emplace_back(offset);
+    offset += GetFormatImageSize(source->format_, Extent3D{std::max(source->width_ >> level, 1u), std::max(source->height_ >> level, 1u), 1});
+  }
+  if (ktx_wrapper) {
+    source->data_.assign(ktx_wrapper->GetData().begin(), ktx_wrapper->GetData().end());
+  } else {
+    // THE BASE LEVEL IS CONVERTED IN PLACE, THE REST OF THE CHAIN IS FILTERED FROM IT
+    source->data_.resize(offset);
+    IngestImage(path, ingest_info, source->data_);
+    GenerateMipChain(source->data_, source->level_offsets_, source->width_, source->height_);
+  }
+  return source;
+}
+
+TextureStreamer::TextureStreamer(const TextureStreamerSpecification &specification) : specification_(specification) {
+  std::array<std::byte, 4> white;
+  white.fill(std::byte(0xff));
+  placeholder_ = Image2D(1, 1, white, SamplerSpecification());
+  placeholder_slot_ = BindlessTable::Get()->AddTexture(placeholder_.GetDescriptor());
+  std::array<std::byte, 4> flat_normal = {std::byte(0x80), std::byte(0x80), std::byte(0xff), std::byte(0xff)};
+  normal_placeholder_ = Image2D(1, 1, flat_normal, SamplerSpecification());
+  normal_placeholder_slot_ = BindlessTable::Get()->AddTexture(normal_placeholder_.GetDescriptor());
+  CORE_ASSERT(normal_placeholder_slot_ != BindlessTable::INVALID_SLOT, "No bindless slots for the texture placeholders");
+  BufferUsageMask usage = BufferUsageMaskBits::E_STORAGE_BUFFER_BIT | BufferUsageMaskBits::E_TRANSFER_DST_BIT;
+  slot_table_ = Buffer(specification_.capacity_ * sizeof(uint32_t), usage, {});
+  decode_thread_ = std::jthread([this](std::stop_token stop_token) { DecodeLoop(stop_token); });
+}
+
+TextureStreamer::~TextureStreamer() {
+  decode_thread_.request_stop();
+  decode_thread_.join();
+  for (auto i = 0; i < textures_.size(); i++) {
+    if (textures_[i].image_) BindlessTable::Get()->Release(BindlessBinding::E_TEXTURE, slots_[i]);
+  }
+  BindlessTable::Get()->Release(BindlessBinding::E_TEXTURE, placeholder_slot_);
+  BindlessTable::Get()->Release(BindlessBinding::E_TEXTURE, normal_placeholder_slot_);
+}
+
+void TextureStreamer::DecodeLoop(std::stop_token stop_token) {
+  while (stop_token.stop_requested() == false) {
+    DecodeJob job;
+    {
+      std::unique_lock lock(mutex_);
+      if (decode_condition_.wait(lock, stop_token, [this] { return decode_queue_.empty() == false; }) == false) return;
+      job = std::move(decode_queue_.front());
+      decode_queue_.pop_front();
+    }
+    auto source = DecodeTextureSource(job.path_, job.conversion_);
+    std::scoped_lock lock(mutex_);
+    decoded_sources_.emplace_back(job.texture_, std::move(source));
+  }
+}
+
+uint32_t TextureStreamer::Register(const std::filesystem::path &path, const SamplerSpecification &sampler_specification,
+                                   ImageConversion conversion) {
+  CORE_ASSERT(textures_.size() < specification_.capacity_, "Texture streamer is full");
+  CORE_ASSERT(conversion == ImageConversion::E_RGBA8 || conversion == ImageConversion::E_RGBA8_SRGB, "Streamed textures are RGBA8");
+  uint32_t texture = textures_.size();
+  textures_.emplace_back().sampler_specification_ = sampler_specification;
+  slots_.emplace_back(conversion == ImageConversion::E_RGBA8_SRGB ? placeholder_slot_ : normal_placeholder_slot_);
+  slots_dirty_ = true;
+  {
+    std::scoped_lock lock(mutex_);
+    decode_queue_.emplace_back(texture, path, conversion);
+  }
+  decode_condition_.notify_one();
+  return texture;
+}
+
+void TextureStreamer::Request(uint32_t texture, float screen_size) {
+  auto &streamed_texture = textures_[texture];
+  auto same_frame = streamed_texture.requested_frame_ == frame_;
+  streamed_texture.requested_size_ = same_frame ? std::max(streamed_texture.requested_size_, screen_size) : screen_size;
+  streamed_texture.requested_frame_ = frame_;
+}
+
+uint32_t TextureStreamer::GetDesiredLevel(uint32_t texture_size, float screen_size) {
+  return uint32_t(std::max(0.0f, std::floor(std::log2(float(texture_size) / std::max(screen_size, 1.0f)))));
+}
+
+std::size_t TextureStreamer::GetResidentSize(const StreamedTexture &texture, uint32_t level) const {
+  if (texture.source_ == nullptr || level >= texture.source_->levels_) return 0;
+  return texture.source_->data_.size() - texture.source_->level_offsets_[level];
+}
+
+std::vector<uint32_t> TextureStreamer::GetTargetLevels() const {
+  std::vector<uint32_t> targets(textures_.size());
+  std::vector<uint32_t> order;
+  std::size_t total_size = 0;
+  for (auto i = 0; i < textures_.size(); i++) {
+    const auto &texture = textures_[i];
+    targets[i] = texture.resident_level_;
+    if (texture.source_ == nullptr) continue;
+    const auto &source = *texture.source_;
+    auto requested = frame_ - texture.requested_frame_ <= specification_.request_lifetime_ && texture.requested_size_ > 0.0f;
+    auto desired = requested ? GetDesiredLevel(std::max(source.width_, source.height_), texture.requested_size_) : texture.initial_level_;
+    targets[i] = std::min(desired, texture.initial_level_);
+    // REQUESTED TEXTURES KEEP THEIR FINER LEVELS UNTIL REQUESTS STOP OR THE BUDGET RUNS OUT
+    targets[i] = requested ? std::min(targets[i], texture.resident_level_) : targets[i];
+    total_size += GetResidentSize(texture, targets[i]);
+    order.emplace_back(i);
+  }
+  // OVER BUDGET: LEAST RECENTLY REQUESTED TEXTURES DROP ONE LEVEL PER PASS, NEVER PAST THEIR INITIAL LEVEL
+  std::ranges::sort(order, {}, [this](uint32_t i) { return textures_[i].requested_frame_; });
+  for (auto changed = true; total_size > specification_.budget_ && changed;) {
+    changed = false;
+    for (auto i : order) {
+      if (total_size <= specification_.budget_) break;
+      if (targets[i] >= textures_[i].initial_level_) continue;
+      total_size -= GetResidentSize(textures_[i], targets[i]);
+      total_size += GetResidentSize(textures_[i], ++targets[i]);
+      changed = true;
+    }
+  }
+  return targets;
+}
+
+void TextureStreamer::Update(CommandBuffer &command_buffer) {
+  frame_++;
+
+  {
+    std::scoped_lock lock(mutex_);
+    for (auto &[index, source] : decoded_sources_) {
+      auto &texture = textures_[index];
+      auto size = std::max(source->width_, source->height_);
+      texture.initial_level_ = 0;
+      while ((size >> texture.initial_level_) > specification_.resident_size_ && texture.initial_level_ + 1 < source->levels_) {
+        texture.initial_level_++;
+      }
+      texture.source_ = std::move(source);
+    }
+    decoded_sources_.clear();
+  }
+
+  auto targets = GetTargetLevels();
+
+  std::vector<uint32_t> uploads;
+  std::size_t upload_size = 0;
+  for (auto i = 0; i < textures_.size(); i++) {
+    if (textures_[i].source_ == nullptr || targets[i] == textures_[i].resident_level_) continue;
+    auto size = AlignUp(GetResidentSize(textures_[i], targets[i]), 16);
+    auto promotion = targets[i] < textures_[i].resident_level_;
+    if (promotion && upload_size + size > specification_.upload_size_per_frame_ && uploads.empty() == false) continue;
+    uploads.emplace_back(i);
+    upload_size += size;
+  }
+
+  if (uploads.empty() && slots_dirty_ == false) return;
+
+  auto table_size = slots_.size() * sizeof(uint32_t);
+  Buffer staging_buffer(upload_size + table_size, BufferUsageMaskBits::E_TRANSFER_SRC_BIT, Buffer::CPU);
+
+  // EVERY RESIDENCY CHANGE IS A NEW IMAGE AND SLOT, SO FRAMES IN FLIGHT KEEP SAMPLING THE OLD ONE
+  std::size_t offset = 0;
+  for (auto i : uploads) {
+    auto &texture = textures_[i];
+    const auto &source = *texture.source_;
+    auto level = targets[i];
+    auto data = std::span(source.data_).subspan(source.level_offsets_[level]);
+    auto width = std::max(source.width_ >> level, 1u), height = std::max(source.height_ >> level, 1u);
+    auto image = std::make_unique<Image2D>(width, height, source.format_, source.levels_ - level, texture.sampler_specification_);
+    // A FULL TABLE KEEPS THE CURRENT RESIDENCY, THE TEXTURE IS PICKED AGAIN NEXT FRAME
+    auto slot = BindlessTable::Get()->AddTexture(image->GetDescriptor());
+    if (slot == BindlessTable::INVALID_SLOT) continue;
+    staging_buffer.SetData(data, offset);
+    image->CommandSetImageData(command_buffer, staging_buffer.GetHandle(), offset, data.size());
+    offset += AlignUp(data.size(), 16);
+    if (texture.image_) {
+      BindlessTable::Get()->Release(BindlessBinding::E_TEXTURE, slots_[i]);
+      GraphicsContext::Get()->DeferDestruction(std::move(texture.image_));
+    }
+    resident_size_ = resident_size_ + data.size() - GetResidentSize(texture, texture.resident_level_);
+    slots_[i] = slot;
+    texture.image_ = std::move(image);
+    texture.resident_level_ = level;
+    slots_dirty_ = true;
+  }
+
+  staging_buffer.SetData<uint32_t>(slots_, offset);
+  command_buffer.CommandBufferMemoryBarrier(slot_table_.GetHandle(), PipelineStageMaskBits2::E_ALL_COMMANDS_BIT, AccessMask2(),
+                                            PipelineStageMaskBits2::E_COPY_BIT, AccessMaskBits2::E_TRANSFER_WRITE_BIT);
+  command_buffer.CommandCopyBuffer(staging_buffer.GetHandle(), slot_table_.GetHandle(), offset, 0, table_size);
+  command_buffer.CommandBufferMemoryBarrier(slot_table_.GetHandle(), PipelineStageMaskBits2::E_COPY_BIT, AccessMaskBits2::E_TRANSFER_WRITE_BIT,
+                                            PipelineStageMaskBits2::E_ALL_COMMANDS_BIT, AccessMaskBits2::E_SHADER_STORAGE_READ_BIT);
+  slots_dirty_ = false;
+
+  GraphicsContext::Get()->DeferDestruction(std::move(staging_buffer));
+}
+
+DescriptorBufferInfo TextureStreamer::GetSlotTableDescriptor() const {
+  return slot_table_.GetDescriptor();
+}
+
+std::size_t TextureStreamer::GetResidentSize() const {
+  return resident_size_;
+}
+
+std::size_t TextureStreamer::GetTexturesCount() const {
+  return textures_.size();
+}
+
+} // namespace Innsmouth
\ No newline at end of file
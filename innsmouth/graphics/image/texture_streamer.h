@@ -0,0 +1,103 @@
+#ifndef INNSMOUTH_TEXTURE_STREAMER_H
+#define INNSMOUTH_TEXTURE_STREAMER_H
+
+#include "image2D.h"
+#include "innsmouth/graphics/buffer/buffer.h"
+#include "innsmouth/core/include/core.h"
+#include "innsmouth/core/include/image_ingest.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Innsmouth {
+
+class CommandBuffer;
+
+struct TextureStreamerSpecification {
+  std::size_t budget_ = 256_MiB;
+  std::size_t upload_size_per_frame_ = 16_MiB;
+  uint32_t resident_size_ = 64;
+  uint32_t request_lifetime_ = 120;
+  uint32_t capacity_ = 4096;
+};
+
+struct TextureSource {
+  Format format_;
+  uint32_t width_{0};
+  uint32_t height_{0};
+  uint32_t levels_{0};
+  std::vector<std::byte> data_;
+  std::vector<std::size_t> level_offsets_;
+};
+
+class TextureStreamer {
+public:
+  TextureStreamer(const TextureStreamerSpecification &specification = TextureStreamerSpecification());
+
+  ~TextureStreamer();
+
+  TextureStreamer(const TextureStreamer &) = delete;
+  TextureStreamer &operator=(const TextureStreamer &) = delete;
+
+  // COLOR TEXTURES ARE E_RGBA8_SRGB AND WAIT AS WHITE, NORMAL MAPS ARE E_RGBA8 AND WAIT AS A FLAT NORMAL
+  uint32_t Register(const std::filesystem::path &path, const SamplerSpecification &sampler_specification,
+                    ImageConversion conversion = ImageConversion::E_RGBA8_SRGB);
+
+  void Request(uint32_t texture, float screen_size);
+
+  void Update(CommandBuffer &command_buffer);
+
+  DescriptorBufferInfo GetSlotTableDescriptor() const;
+
+  std::size_t GetResidentSize() const;
+  std::size_t GetTexturesCount() const;
+
+  static uint32_t GetDesiredLevel(uint32_t texture_size, float screen_size);
+
+protected:
+  struct DecodeJob {
+    uint32_t texture_;
+    std::filesystem::path path_;
+    ImageConversion conversion_;
+  };
+
+  struct StreamedTexture {
+    SamplerSpecification sampler_specification_;
+    std::shared_ptr<const TextureSource> source_;
+    std::unique_ptr<Image2D> image_;
+    uint32_t resident_level_{UINT32_MAX};
+    uint32_t initial_level_{0};
+    float requested_size_{0.0f};
+    uint64_t requested_frame_{0};
+  };
+
+  void DecodeLoop(std::stop_token stop_token);
+
+  std::vector<uint32_t> GetTargetLevels() const;
+
+  std::size_t GetResidentSize(const StreamedTexture &texture, uint32_t level) const;
+
+private:
+  TextureStreamerSpecification specification_;
+  std::vector<StreamedTexture> textures_;
+  std::vector<uint32_t> slots_;
+  Image2D placeholder_;
+  uint32_t placeholder_slot_{0};
+  Image2D normal_placeholder_;
+  uint32_t normal_placeholder_slot_{0};
+  Buffer slot_table_;
+  std::size_t resident_size_{0};
+  uint64_t frame_{0};
+  bool slots_dirty_{false};
+  std::mutex mutex_;
+  std::condition_variable_any decode_condition_;
+  std::deque<DecodeJob> decode_queue_;
+  std::vector<std::pair<uint32_t, std::shared_ptr<const TextureSource>>> decoded_sources_;
+  std::jthread decode_thread_;
+};
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_TEXTURE_STREAMER_H
\ No newline at end of file
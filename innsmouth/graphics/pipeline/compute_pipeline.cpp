@@ -0,0 +1,64 @@
+#include "compute_pipeline.h"
+
+namespace Innsmouth {
+
+VkPipeline CreateComputePipeline(const ShaderModule &shader_module, VkPipelineLayout pipeline_layout, PipelineCreateMask pipeline_create_mask) {
+  ShaderModuleCreateInfo shader_module_ci;
+  shader_module_ci.codeSize = shader_module.GetSize();
+  shader_module_ci.pCode = shader_module.GetBinaryData().data();
+
+  ComputePipelineCreateInfo compute_pipeline_ci;
+  compute_pipeline_ci.stage.stage = shader_module.GetShaderStage();
+  compute_pipeline_ci.stage.pNext = &shader_module_ci;
+  compute_pipeline_ci.stage.pName = "main";
+  compute_pipeline_ci.layout = pipeline_layout;
+  compute_pipeline_ci.flags = pipeline_create_mask;
+
+  VkPipeline compute_pipeline = VK_NULL_HANDLE;
+  VK_CHECK(vkCreateComputePipelines(GraphicsContext::Get()->GetDevice(), nullptr, 1, compute_pipeline_ci, nullptr, &compute_pipeline));
+  return compute_pipeline;
+}
+
+ComputePipeline::ComputePipeline(const std::filesystem::path &shader_path) {
+  std::array<ShaderModule, 1> shader_modules = {ShaderModule(shader_path)};
+
+  descriptor_set_layouts_ = CreateDescriptorSetLayouts(shader_modules);
+  pipeline_layout_ = CreatePipelineLayout(descriptor_set_layouts_, GetPushConstantRanges(shader_modules));
+  push_descriptor_template_ = CreatePushDescriptorTemplate(shader_modules, pipeline_layout_, PipelineBindPoint::E_COMPUTE);
+  compute_pipeline_ = CreateComputePipeline(shader_modules[0], pipeline_layout_, GetPipelineCreateMask(descriptor_set_layouts_));
+}
+
+ComputePipeline::~ComputePipeline() {
+  vkDestroyPipeline(GraphicsContext::Get()->GetDevice(), compute_pipeline_, nullptr);
+  vkDestroyPipelineLayout(GraphicsContext::Get()->GetDevice(), pipeline_layout_, nullptr);
+  DestroyDescriptorSetLayouts(descriptor_set_layouts_);
+}
+
+ComputePipeline::ComputePipeline(ComputePipeline &&other) noexcept {
+  compute_pipeline_ = std::exchange(other.compute_pipeline_, VK_NULL_HANDLE);
+  pipeline_layout_ = std::exchange(other.pipeline_layout_, VK_NULL_HANDLE);
+  descriptor_set_layouts_ = std::move(other.descriptor_set_layouts_);
+  push_descriptor_template_ = std::move(other.push_descriptor_template_);
+}
+
+ComputePipeline &ComputePipeline::operator=(ComputePipeline &&other) noexcept {
+  std::swap(compute_pipeline_, other.compute_pipeline_);
+  std::swap(pipeline_layout_, other.pipeline_layout_);
+  std::swap(descriptor_set_layouts_, other.descriptor_set_layouts_);
+  std::swap(push_descriptor_template_, other.push_descriptor_template_);
+  return *this;
+}
+
+VkPipelineLayout ComputePipeline::GetPipelineLayout() const {
+  return pipeline_layout_;
+}
+
+VkPipeline ComputePipeline::GetPipeline() const {
+  return compute_pipeline_;
+}
+
+const DescriptorUpdateTemplate &ComputePipeline::GetPushDescriptorTemplate() const {
+  return push_descriptor_template_;
+}
+
+} // namespace Innsmouth
\ No newline at end of file
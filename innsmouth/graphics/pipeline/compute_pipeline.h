@@ -0,0 +1,36 @@
+#ifndef INNSMOUTH_COMPUTE_PIPELINE_H
+#define INNSMOUTH_COMPUTE_PIPELINE_H
+
+#include "pipeline_tools.h"
+#include <filesystem>
+
+namespace Innsmouth {
+
+class ComputePipeline {
+public:
+  ComputePipeline() = default;
+
+  ComputePipeline(const std::filesystem::path &shader_path);
+
+  ~ComputePipeline();
+
+  ComputePipeline(const ComputePipeline &) = delete;
+  ComputePipeline &operator=(const ComputePipeline &) = delete;
+
+  ComputePipeline(ComputePipeline &&other) noexcept;
+  ComputePipeline &operator=(ComputePipeline &&other) noexcept;
+
+  VkPipelineLayout GetPipelineLayout() const;
+  VkPipeline GetPipeline() const;
+  const DescriptorUpdateTemplate &GetPushDescriptorTemplate() const;
+
+private:
+  VkPipeline compute_pipeline_{VK_NULL_HANDLE};
+  VkPipelineLayout pipeline_layout_{VK_NULL_HANDLE};
+  std::vector<VkDescriptorSetLayout> descriptor_set_layouts_;
+  DescriptorUpdateTemplate push_descriptor_template_;
+};
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_COMPUTE_PIPELINE_H
\ No newline at end of file
@@ -8,8 +8,12 @@
 
 namespace Innsmouth {
 
+bool IsMeshPipeline(std::span<const ShaderModule> shader_modules) {
+  return std::ranges::contains(shader_modules, ShaderStageMaskBits::E_MESH_BIT_EXT, &ShaderModule::GetShaderStage);
+}
+
 VkPipeline CreateGraphicsPipeline(const GraphicsPipelineSpecification &specification, std::span<const ShaderModule> shader_modules,
-                                  VkPipelineLayout pipeline_layout) {
+                                  VkPipelineLayout pipeline_layout, PipelineCreateMask pipeline_create_mask) {
   std::vector<ShaderModuleCreateInfo> shader_modules_cis(shader_modules.size());
   std::vector<PipelineShaderStageCreateInfo> shader_stages_cis(shader_modules.size());
 
@@ -75,11 +79,13 @@ VkPipeline CreateGraphicsPipeline(const GraphicsPipelineSpecification &specifica
   depth_stencil_state_ci.stencilTestEnable = false;
 
   // COLOR BLENDING STATE
-  auto color_blend_attachment_state = GetColorBlendAttachmentState(true);
+  // ONE STATE PER COLOR ATTACHMENT, DEPTH ONLY PIPELINES HAVE NONE
+  std::vector<PipelineColorBlendAttachmentState> color_blend_attachment_states(specification.color_formats_.size(),
+                                                                               GetColorBlendAttachmentState(true));
 
   PipelineColorBlendStateCreateInfo color_blending_state_ci;
-  color_blending_state_ci.attachmentCount = 1;
-  color_blending_state_ci.pAttachments = &color_blend_attachment_state;
+  color_blending_state_ci.attachmentCount = color_blend_attachment_states.size();
+  color_blending_state_ci.pAttachments = color_blend_attachment_states.data();
 
   // RENDERING CREATE INFO
   PipelineRenderingCreateInfo pipeline_rendering_ci;
@@ -93,8 +99,8 @@ VkPipeline CreateGraphicsPipeline(const GraphicsPipelineSpecification &specifica
 
   graphics_pipeline_ci.stageCount = shader_stages_cis.size();
   graphics_pipeline_ci.pStages = shader_stages_cis.data();
-  graphics_pipeline_ci.pVertexInputState = &vertex_input_state_ci;
-  graphics_pipeline_ci.pInputAssemblyState = &input_assembly_state_ci;
+  graphics_pipeline_ci.pVertexInputState = IsMeshPipeline(shader_modules) ? nullptr : &vertex_input_state_ci;
+  graphics_pipeline_ci.pInputAssemblyState = IsMeshPipeline(shader_modules) ? nullptr : &input_assembly_state_ci;
   graphics_pipeline_ci.pViewportState = &viewport_state_ci;
   graphics_pipeline_ci.pRasterizationState = &rasterization_state_ci;
   graphics_pipeline_ci.pMultisampleState = &multisample_state_ci;
@@ -102,6 +108,7 @@ VkPipeline CreateGraphicsPipeline(const GraphicsPipelineSpecification &specifica
   graphics_pipeline_ci.pColorBlendState = &color_blending_state_ci;
   graphics_pipeline_ci.pDynamicState = &dynamic_state_ci;
   graphics_pipeline_ci.layout = pipeline_layout;
+  graphics_pipeline_ci.flags = pipeline_create_mask;
   graphics_pipeline_ci.pNext = &pipeline_rendering_ci;
 
   VkPipeline graphics_pipeline = VK_NULL_HANDLE;
@@ -113,6 +120,10 @@ VkPipelineLayout GraphicsPipeline::GetPipelineLayout() const {
   return pipeline_layout_;
 }
 
+const DescriptorUpdateTemplate &GraphicsPipeline::GetPushDescriptorTemplate() const {
+  return push_descriptor_template_;
+}
+
 VkPipeline GraphicsPipeline::GetPipeline() const {
   return graphics_pipeline_;
 }
@@ -128,8 +139,10 @@ GraphicsPipeline::GraphicsPipeline(const GraphicsPipelineSpecification &pipeline
   }
 
   descriptor_set_layouts_ = CreateDescriptorSetLayouts(shader_modules);
-  pipeline_layout_ = CreatePipelineLayout(descriptor_set_layouts_, shader_modules[0].GetPushConstantRanges());
-  graphics_pipeline_ = CreateGraphicsPipeline(pipeline_specification, shader_modules, pipeline_layout_);
+  pipeline_layout_ = CreatePipelineLayout(descriptor_set_layouts_, GetPushConstantRanges(shader_modules));
+  push_descriptor_template_ = CreatePushDescriptorTemplate(shader_modules, pipeline_layout_, PipelineBindPoint::E_GRAPHICS);
+  graphics_pipeline_ =
+    CreateGraphicsPipeline(pipeline_specification, shader_modules, pipeline_layout_, GetPipelineCreateMask(descriptor_set_layouts_));
 }
 
 GraphicsPipeline::~GraphicsPipeline() {
@@ -139,12 +152,14 @@ GraphicsPipeline::GraphicsPipeline(GraphicsPipeline &&other) noexcept {
   graphics_pipeline_ = std::exchange(other.graphics_pipeline_, VK_NULL_HANDLE);
   pipeline_layout_ = std::exchange(other.pipeline_layout_, VK_NULL_HANDLE);
   descriptor_set_layouts_ = std::move(other.descriptor_set_layouts_);
+  push_descriptor_template_ = std::move(other.push_descriptor_template_);
 }
 
 GraphicsPipeline &GraphicsPipeline::operator=(GraphicsPipeline &&other) noexcept {
   std::swap(graphics_pipeline_, other.graphics_pipeline_);
   std::swap(pipeline_layout_, other.pipeline_layout_);
   std::swap(descriptor_set_layouts_, other.descriptor_set_layouts_);
+  std::swap(push_descriptor_template_, other.push_descriptor_template_);
   return *this;
 }
 
@@ -30,12 +30,14 @@ public:
 
   VkPipelineLayout GetPipelineLayout() const;
   VkPipeline GetPipeline() const;
+  const DescriptorUpdateTemplate &GetPushDescriptorTemplate() const;
   std::span<const VkDescriptorSetLayout> GetDescriptorSetLayouts() const;
 
 private:
   VkPipeline graphics_pipeline_{VK_NULL_HANDLE};
   VkPipelineLayout pipeline_layout_{VK_NULL_HANDLE};
   std::vector<VkDescriptorSetLayout> descriptor_set_layouts_;
+  DescriptorUpdateTemplate push_descriptor_template_;
 };
 
 } // namespace Innsmouth
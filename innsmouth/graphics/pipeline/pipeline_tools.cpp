@@ -1,4 +1,7 @@
 #include "pipeline_tools.h"
+#include "innsmouth/graphics/descriptors/bindless_table.h"
+#include "innsmouth/core/include/core.h"
+#include <algorithm>
 
 namespace Innsmouth {
 
@@ -51,26 +54,91 @@ void MergeDescriptorSets(DescriptorSetLayoutBindingMap &destination, const Descr
   }
 }
 
+DescriptorSetLayoutBindingMap GetPushDescriptorSets(std::span<const ShaderModule> shader_modules) {
+  DescriptorSetLayoutBindingMap push_descriptor_sets;
+  for (const auto &shader_module : shader_modules) {
+    MergeDescriptorSets(push_descriptor_sets, shader_module.GetPushDescriptorSetLayoutBindings());
+  }
+  return push_descriptor_sets;
+}
+
 std::vector<VkDescriptorSetLayout> CreateDescriptorSetLayouts(std::span<const ShaderModule> shader_modules) {
   std::vector<VkDescriptorSetLayout> descriptor_sets;
-  DescriptorSetLayoutBindingMap push_descriptor_sets;
+  DescriptorSetLayoutBindingMap push_descriptor_sets = GetPushDescriptorSets(shader_modules);
   DescriptorSetLayoutBindingMap pool_descriptor_sets;
   for (const auto &shader_module : shader_modules) {
-    MergeDescriptorSets(push_descriptor_sets, shader_module.GetPushDescriptorSetLayoutBindings());
     MergeDescriptorSets(pool_descriptor_sets, shader_module.GetPoolDescriptorSetLayoutBindings());
   }
 
   descriptor_sets.resize(push_descriptor_sets.size() + pool_descriptor_sets.size());
 
+  // EVERY SET OF A LAYOUT THAT USES A DESCRIPTOR BUFFER MUST BE CREATED FOR ONE
+  auto bindless_table = BindlessTable::Get();
+  auto descriptor_buffer_backed = bindless_table != nullptr && bindless_table->IsDescriptorBufferBacked() &&
+                                  pool_descriptor_sets.contains(BindlessTable::SET);
+  CORE_ASSERT(descriptor_buffer_backed == false || pool_descriptor_sets.size() == 1, "Descriptor buffer layouts only take the bindless set");
+
+  DescriptorSetLayoutCreateMask push_descriptor_mask = DescriptorSetLayoutCreateMaskBits::E_PUSH_DESCRIPTOR_BIT;
+  if (descriptor_buffer_backed) {
+    push_descriptor_mask |= DescriptorSetLayoutCreateMaskBits::E_DESCRIPTOR_BUFFER_BIT_EXT;
+  }
+
   for (const auto &[set, bindings] : push_descriptor_sets) {
-    descriptor_sets[set] = CreateDescriptorSetLayout(bindings, DescriptorSetLayoutCreateMaskBits::E_PUSH_DESCRIPTOR_BIT);
+    descriptor_sets[set] = CreateDescriptorSetLayout(bindings, push_descriptor_mask);
   }
 
   for (const auto &[set, bindings] : pool_descriptor_sets) {
-    descriptor_sets[set] = CreateDescriptorSetLayout(bindings, DescriptorSetLayoutCreateMaskBits::E_UPDATE_AFTER_BIND_POOL_BIT);
+    if (set == BindlessTable::SET && BindlessTable::Get() != nullptr) {
+      descriptor_sets[set] = BindlessTable::Get()->GetDescriptorSetLayout();
+    } else {
+      descriptor_sets[set] = CreateDescriptorSetLayout(bindings, DescriptorSetLayoutCreateMaskBits::E_UPDATE_AFTER_BIND_POOL_BIT);
+    }
   }
 
   return descriptor_sets;
 }
 
+std::vector<PushConstantRange> GetPushConstantRanges(std::span<const ShaderModule> shader_modules) {
+  std::vector<PushConstantRange> push_constant_ranges;
+  for (const auto &shader_module : shader_modules) {
+    for (const auto &range : shader_module.GetPushConstantRanges()) {
+      if (push_constant_ranges.empty()) {
+        push_constant_ranges.emplace_back(range);
+        continue;
+      }
+      // STAGES SHARING A PUSH CONSTANT BLOCK ARE MERGED INTO ONE RANGE
+      auto &merged = push_constant_ranges.front();
+      auto end = std::max(merged.offset + merged.size, range.offset + range.size);
+      merged.offset = std::min(merged.offset, range.offset);
+      merged.size = end - merged.offset;
+      merged.stageFlags |= range.stageFlags;
+    }
+  }
+  return push_constant_ranges;
+}
+
+void DestroyDescriptorSetLayouts(std::span<const VkDescriptorSetLayout> set_layouts) {
+  // THE BINDLESS LAYOUT IS OWNED BY THE TABLE
+  auto bindless_table = BindlessTable::Get();
+  for (auto set_layout : set_layouts) {
+    if (bindless_table != nullptr && set_layout == bindless_table->GetDescriptorSetLayout()) continue;
+    vkDestroyDescriptorSetLayout(GraphicsContext::Get()->GetDevice(), set_layout, nullptr);
+  }
+}
+
+PipelineCreateMask GetPipelineCreateMask(std::span<const VkDescriptorSetLayout> set_layouts) {
+  auto bindless_table = BindlessTable::Get();
+  if (bindless_table == nullptr || bindless_table->IsDescriptorBufferBacked() == false) return PipelineCreateMask();
+  auto uses_descriptor_buffer = std::ranges::contains(set_layouts, bindless_table->GetDescriptorSetLayout());
+  return uses_descriptor_buffer ? PipelineCreateMask(PipelineCreateMaskBits::E_DESCRIPTOR_BUFFER_BIT_EXT) : PipelineCreateMask();
+}
+
+DescriptorUpdateTemplate CreatePushDescriptorTemplate(std::span<const ShaderModule> shader_modules, VkPipelineLayout pipeline_layout,
+                                                      PipelineBindPoint bind_point) {
+  auto push_descriptor_sets = GetPushDescriptorSets(shader_modules);
+  if (push_descriptor_sets.empty()) return DescriptorUpdateTemplate();
+  const auto &[set, bindings] = *push_descriptor_sets.begin();
+  return DescriptorUpdateTemplate(bindings, pipeline_layout, set, bind_point);
+}
+
 } // namespace Innsmouth
\ No newline at end of file
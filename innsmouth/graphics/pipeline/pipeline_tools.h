@@ -2,11 +2,17 @@
 #define INNSMOUTH_PIPELINE_TOOLS_H
 
 #include "shader_module.h"
+#include "innsmouth/graphics/descriptors/descriptor_update_template.h"
 
 namespace Innsmouth {
 
 VkPipelineLayout CreatePipelineLayout(std::span<const VkDescriptorSetLayout> set_layouts, std::span<const PushConstantRange> push_constants);
 std::vector<VkDescriptorSetLayout> CreateDescriptorSetLayouts(std::span<const ShaderModule> shader_modules);
+void DestroyDescriptorSetLayouts(std::span<const VkDescriptorSetLayout> set_layouts);
+std::vector<PushConstantRange> GetPushConstantRanges(std::span<const ShaderModule> shader_modules);
+PipelineCreateMask GetPipelineCreateMask(std::span<const VkDescriptorSetLayout> set_layouts);
+DescriptorUpdateTemplate CreatePushDescriptorTemplate(std::span<const ShaderModule> shader_modules, VkPipelineLayout pipeline_layout,
+                                                      PipelineBindPoint bind_point);
 
 } // namespace Innsmouth
 
@@ -50,7 +50,8 @@ auto GetRayTracingShaderGroups(std::span<const ShaderGroupPaths> shader_groups,
 }
 
 VkPipeline CreateRayTracingPipeline(std::span<const ShaderGroupPaths> shader_groups, std::span<const ShaderModule> shader_modules,
-                                    VkPipelineLayout pipeline_layout, uint32_t maximum_recursion_depth) {
+                                    VkPipelineLayout pipeline_layout, uint32_t maximum_recursion_depth,
+                                    PipelineCreateMask pipeline_create_mask) {
 
   std::vector<ShaderModuleCreateInfo> shader_modules_cis(shader_modules.size());
   std::vector<PipelineShaderStageCreateInfo> shader_stages_cis(shader_modules.size());
@@ -76,6 +77,7 @@ VkPipeline CreateRayTracingPipeline(std::span<const ShaderGroupPaths> shader_gro
   ray_tracing_pipeline_ci.maxPipelineRayRecursionDepth = maximum_recursion_depth;
   ray_tracing_pipeline_ci.pDynamicState = &dynamic_state_ci;
   ray_tracing_pipeline_ci.layout = pipeline_layout;
+  ray_tracing_pipeline_ci.flags = pipeline_create_mask;
 
   VkPipeline ray_tracing_pipeline = VK_NULL_HANDLE;
   VK_CHECK(vkCreateRayTracingPipelinesKHR(GraphicsContext::Get()->GetDevice(), VK_NULL_HANDLE, VK_NULL_HANDLE, 1, ray_tracing_pipeline_ci,
@@ -84,15 +86,18 @@ VkPipeline CreateRayTracingPipeline(std::span<const ShaderGroupPaths> shader_gro
   return ray_tracing_pipeline;
 }
 
-RayTracingPipeline::RayTracingPipeline(std::vector<ShaderGroupPaths> shader_groups, uint32_t maximum_recursion_depth) {
+RayTracingPipeline::RayTracingPipeline(std::vector<ShaderGroupPaths> shader_groups, uint32_t maximum_recursion_depth,
+                                       PipelineCreateMask pipeline_create_mask) {
   std::vector<ShaderModule> shader_modules;
   for (const auto &shader_group : shader_groups) {
     shader_modules.insert(shader_modules.end(), shader_group.begin(), shader_group.end());
   }
 
   descriptor_set_layouts_ = CreateDescriptorSetLayouts(shader_modules);
-  pipeline_layout_ = CreatePipelineLayout(descriptor_set_layouts_, shader_modules[0].GetPushConstantRanges());
-  ray_tracing_pipeline_ = CreateRayTracingPipeline(shader_groups, shader_modules, pipeline_layout_, maximum_recursion_depth);
+  pipeline_layout_ = CreatePipelineLayout(descriptor_set_layouts_, GetPushConstantRanges(shader_modules));
+  push_descriptor_template_ = CreatePushDescriptorTemplate(shader_modules, pipeline_layout_, PipelineBindPoint::E_RAY_TRACING_KHR);
+  ray_tracing_pipeline_ = CreateRayTracingPipeline(shader_groups, shader_modules, pipeline_layout_, maximum_recursion_depth,
+                                                   GetPipelineCreateMask(descriptor_set_layouts_) | pipeline_create_mask);
 }
 
 VkPipelineLayout RayTracingPipeline::GetPipelineLayout() const {
@@ -103,16 +108,22 @@ VkPipeline RayTracingPipeline::GetPipeline() const {
   return ray_tracing_pipeline_;
 }
 
+const DescriptorUpdateTemplate &RayTracingPipeline::GetPushDescriptorTemplate() const {
+  return push_descriptor_template_;
+}
+
 RayTracingPipeline::RayTracingPipeline(RayTracingPipeline &&other) noexcept {
   ray_tracing_pipeline_ = std::exchange(other.ray_tracing_pipeline_, VK_NULL_HANDLE);
   pipeline_layout_ = std::exchange(other.pipeline_layout_, VK_NULL_HANDLE);
   descriptor_set_layouts_ = std::move(other.descriptor_set_layouts_);
+  push_descriptor_template_ = std::move(other.push_descriptor_template_);
 }
 
 RayTracingPipeline &RayTracingPipeline::operator=(RayTracingPipeline &&other) noexcept {
   std::swap(ray_tracing_pipeline_, other.ray_tracing_pipeline_);
   std::swap(pipeline_layout_, other.pipeline_layout_);
   std::swap(descriptor_set_layouts_, other.descriptor_set_layouts_);
+  std::swap(push_descriptor_template_, other.push_descriptor_template_);
   return *this;
 }
 
@@ -18,7 +18,9 @@ class RayTracingPipeline {
 public:
   RayTracingPipeline() = default;
 
-  RayTracingPipeline(std::vector<ShaderGroupPaths> shader_groups, uint32_t maximum_recursion_depth = 1);
+  // E_RAY_TRACING_OPACITY_MICROMAP_BIT_EXT IN pipeline_create_mask FOR SCENES WITH OPACITY MICROMAPS
+  RayTracingPipeline(std::vector<ShaderGroupPaths> shader_groups, uint32_t maximum_recursion_depth = 1,
+                     PipelineCreateMask pipeline_create_mask = PipelineCreateMask());
 
   RayTracingPipeline(const RayTracingPipeline &) = delete;
   RayTracingPipeline &operator=(const RayTracingPipeline &) = delete;
@@ -28,11 +30,13 @@ public:
 
   VkPipelineLayout GetPipelineLayout() const;
   VkPipeline GetPipeline() const;
+  const DescriptorUpdateTemplate &GetPushDescriptorTemplate() const;
 
 private:
   VkPipeline ray_tracing_pipeline_{VK_NULL_HANDLE};
   VkPipelineLayout pipeline_layout_{VK_NULL_HANDLE};
   std::vector<VkDescriptorSetLayout> descriptor_set_layouts_;
+  DescriptorUpdateTemplate push_descriptor_template_;
   ShaderGroupCounts shader_group_counts_;
 };
 
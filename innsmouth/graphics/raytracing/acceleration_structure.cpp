@@ -1,4 +1,5 @@
 #include "acceleration_structure.h"
+#include "innsmouth/graphics/command/command_buffer.h"
 
 namespace Innsmouth {
 
@@ -6,38 +7,71 @@ BufferUsageMask scratch_usage = BufferUsageMaskBits::E_SHADER_DEVICE_ADDRESS_BIT
 BufferUsageMask blas_usage = BufferUsageMaskBits::E_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | BufferUsageMaskBits::E_SHADER_DEVICE_ADDRESS_BIT;
 
 AccelerationStructure::AccelerationStructure(const BottomLevelGeometry &bottom_geometry) {
+  CommandBuffer command_buffer(GraphicsContext::Get()->GetGraphicsQueueIndex());
+  command_buffer.Begin();
+  auto scratch_buffer = RecordBottomLevel(command_buffer, bottom_geometry);
+  command_buffer.End();
+  command_buffer.Submit();
+}
+
+AccelerationStructure::AccelerationStructure(std::span<const BottomLevelAccelerationStructureInstances> bottom_instances) {
+  auto instance_buffer = CreateInstanceBuffer(bottom_instances);
+  CommandBuffer command_buffer(GraphicsContext::Get()->GetGraphicsQueueIndex());
+  command_buffer.Begin();
+  auto scratch_buffer = RecordTopLevel(command_buffer, instance_buffer, GetTotalInstancesCount(bottom_instances));
+  command_buffer.End();
+  command_buffer.Submit();
+}
+
+AccelerationStructure::AccelerationStructure(CommandBuffer &command_buffer, const BottomLevelGeometry &bottom_geometry,
+                                             std::vector<Buffer> &build_buffers) {
+  build_buffers.emplace_back(RecordBottomLevel(command_buffer, bottom_geometry));
+}
+
+AccelerationStructure::AccelerationStructure(CommandBuffer &command_buffer,
+                                             std::span<const BottomLevelAccelerationStructureInstances> bottom_instances,
+                                             std::vector<Buffer> &build_buffers) {
+  auto instance_buffer = CreateInstanceBuffer(bottom_instances);
+  auto scratch_buffer = RecordTopLevel(command_buffer, instance_buffer, GetTotalInstancesCount(bottom_instances));
+  build_buffers.emplace_back(std::move(instance_buffer));
+  build_buffers.emplace_back(std::move(scratch_buffer));
+}
+
+void AccelerationStructure::CreateAccelerationBuffer(std::size_t size) {
+  auto buffer_information = Buffer::CreateBuffer(size, blas_usage, AllocationCreateMaskBits::E_DEDICATED_MEMORY_BIT);
+  acceleration_buffer_ = buffer_information.buffer_;
+  buffer_allocation_ = buffer_information.buffer_allocation_;
+}
+
+Buffer AccelerationStructure::RecordBottomLevel(CommandBuffer &command_buffer, const BottomLevelGeometry &bottom_geometry) {
   auto acceleration_structure_sizes = GetAccelerationStructureSize(bottom_geometry);
   auto main_size = acceleration_structure_sizes.accelerationStructureSize;
   auto scratch_size = acceleration_structure_sizes.buildScratchSize;
-  auto buffer_information = Buffer::CreateBuffer(main_size, blas_usage, AllocationCreateMaskBits::E_DEDICATED_MEMORY_BIT);
-  acceleration_buffer_ = buffer_information.buffer_;
-  buffer_allocation_ = buffer_information.buffer_allocation_;
+  CreateAccelerationBuffer(main_size);
   Buffer scrath_buffer(scratch_size, scratch_usage, AllocationCreateMaskBits::E_DEDICATED_MEMORY_BIT);
   std::array<AccelerationInformation, 1> acceleration_information;
   acceleration_information[0].acceleration_offset_ = 0;
   acceleration_information[0].scratch_offset_ = 0;
   acceleration_information[0].acceleration_size_ = main_size;
-  auto acceleration_structures = BuildAccelerationStructures(acceleration_buffer_, scrath_buffer.GetBufferAddress(), acceleration_information,
-                                                             std::span(&bottom_geometry, 1));
-
+  auto acceleration_structures = BuildAccelerationStructures(command_buffer, acceleration_buffer_, scrath_buffer.GetBufferAddress(),
+                                                             acceleration_information, std::span(&bottom_geometry, 1));
   acceleration_structure_ = acceleration_structures[0];
+  return scrath_buffer;
 }
 
-AccelerationStructure::AccelerationStructure(std::span<const BottomLevelAccelerationStructureInstances> bottom_instances) {
-  uint32_t primitive_count = GetTotalInstancesCount(bottom_instances);
-  auto acceleration_structure_sizes = GetAccelerationStructureSize(primitive_count);
+Buffer AccelerationStructure::RecordTopLevel(CommandBuffer &command_buffer, const Buffer &instance_buffer, uint32_t instances_count) {
+  auto acceleration_structure_sizes = GetAccelerationStructureSize(instances_count);
   auto main_size = acceleration_structure_sizes.accelerationStructureSize;
   auto scratch_size = acceleration_structure_sizes.buildScratchSize;
-  auto buffer_information = Buffer::CreateBuffer(main_size, blas_usage, AllocationCreateMaskBits::E_DEDICATED_MEMORY_BIT);
-  acceleration_buffer_ = buffer_information.buffer_;
-  buffer_allocation_ = buffer_information.buffer_allocation_;
+  CreateAccelerationBuffer(main_size);
   Buffer scrath_buffer(scratch_size, scratch_usage, AllocationCreateMaskBits::E_DEDICATED_MEMORY_BIT);
   AccelerationInformation acceleration_information;
   acceleration_information.acceleration_offset_ = 0;
   acceleration_information.scratch_offset_ = 0;
   acceleration_information.acceleration_size_ = main_size;
-  acceleration_structure_ =
-    BuildAccelerationStructures(acceleration_buffer_, scrath_buffer.GetBufferAddress(), acceleration_information, bottom_instances);
+  acceleration_structure_ = BuildAccelerationStructures(command_buffer, acceleration_buffer_, scrath_buffer.GetBufferAddress(),
+                                                        acceleration_information, instance_buffer.GetBufferAddress(), instances_count);
+  return scrath_buffer;
 }
 
 AccelerationStructure::AccelerationStructure(AccelerationStructure &&other) noexcept {
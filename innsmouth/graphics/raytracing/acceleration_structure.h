@@ -6,6 +6,9 @@
 
 namespace Innsmouth {
 
+class CommandBuffer;
+class QueryPool;
+
 class AccelerationStructure {
 public:
   AccelerationStructure() = default;
@@ -15,6 +18,13 @@ public:
   AccelerationStructure(const BottomLevelGeometry &bottom_geometry);
   AccelerationStructure(std::span<const BottomLevelAccelerationStructureInstances> bottom_instances);
 
+  AccelerationStructure(CommandBuffer &command_buffer, const BottomLevelGeometry &bottom_geometry, std::vector<Buffer> &build_buffers);
+  AccelerationStructure(CommandBuffer &command_buffer, std::span<const BottomLevelAccelerationStructureInstances> bottom_instances,
+                        std::vector<Buffer> &build_buffers);
+
+  // RECORDS A DESERIALIZING COPY OF A BLOB PRODUCED BY Serialize, THE STAGING BUFFER GOES TO build_buffers
+  AccelerationStructure(CommandBuffer &command_buffer, std::span<const std::byte> serialized, std::vector<Buffer> &build_buffers);
+
   AccelerationStructure(const AccelerationStructure &) = delete;
   AccelerationStructure &operator=(const AccelerationStructure &) = delete;
 
@@ -23,15 +33,34 @@ public:
 
   VkAccelerationStructureKHR GetAccelerationStructure() const;
 
-  static std::vector<VkAccelerationStructureKHR> BuildAccelerationStructures(VkBuffer main_buffer, VkDeviceAddress scratch_buffer,
+  static std::vector<VkAccelerationStructureKHR> BuildAccelerationStructures(CommandBuffer &command_buffer, VkBuffer main_buffer,
+                                                                             VkDeviceAddress scratch_buffer,
                                                                              std::span<const AccelerationInformation> acceleration_information,
                                                                              std::span<const BottomLevelGeometry> bottom_geometries);
 
-  static VkAccelerationStructureKHR BuildAccelerationStructures(VkBuffer main_buffer, VkDeviceAddress scratch_buffer,
+  static VkAccelerationStructureKHR BuildAccelerationStructures(CommandBuffer &command_buffer, VkBuffer main_buffer,
+                                                                VkDeviceAddress scratch_buffer,
                                                                 const AccelerationInformation &acceleration_information,
-                                                                std::span<const BottomLevelAccelerationStructureInstances> bottom_instances);
+                                                                VkDeviceAddress instances, uint32_t instances_count);
+
+  // SERIALIZING TAKES THREE STEPS, EACH ONE ONLY AFTER THE COMMANDS OF THE PREVIOUS ONE COMPLETED: THE SIZE QUERY,
+  // THE COPIES INTO A READBACK BUFFER SIZED FROM THE QUERY RESULTS, THEN READING THE BLOBS BACK
+  static void CommandWriteSerializedSizes(CommandBuffer &command_buffer, std::span<const AccelerationStructure> acceleration_structures,
+                                          const QueryPool &query_pool);
+  static Buffer CommandSerialize(CommandBuffer &command_buffer, std::span<const AccelerationStructure> acceleration_structures,
+                                 std::span<const uint64_t> sizes);
+  static std::vector<std::vector<std::byte>> ReadSerialized(Buffer &readback_buffer, std::span<const uint64_t> sizes);
+
+  static bool IsCompatible(std::span<const std::byte> serialized);
+
+  static Buffer CreateInstanceBuffer(std::span<const BottomLevelAccelerationStructureInstances> bottom_instances);
 
 protected:
+  Buffer RecordBottomLevel(CommandBuffer &command_buffer, const BottomLevelGeometry &bottom_geometry);
+  Buffer RecordTopLevel(CommandBuffer &command_buffer, const Buffer &instance_buffer, uint32_t instances_count);
+
+  void CreateAccelerationBuffer(std::size_t size);
+
 private:
   VkAccelerationStructureKHR acceleration_structure_{VK_NULL_HANDLE};
   VkBuffer acceleration_buffer_{VK_NULL_HANDLE};
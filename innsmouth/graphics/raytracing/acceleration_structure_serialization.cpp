@@ -0,0 +1,116 @@
+#include "innsmouth/core/include/core.h"
+#include "acceleration_structure.h"
+#include "innsmouth/graphics/command/command_buffer.h"
+#include "innsmouth/graphics/command/query_pool.h"
+#include <cstring>
+
+namespace Innsmouth {
+
+// DRIVER UUID, COMPATIBILITY UUID, SERIALIZED SIZE, DESERIALIZED SIZE, HANDLES COUNT
+constexpr std::size_t SERIALIZED_SIZE_OFFSET = 2 * VK_UUID_SIZE;
+constexpr std::size_t DESERIALIZED_SIZE_OFFSET = SERIALIZED_SIZE_OFFSET + sizeof(uint64_t);
+constexpr std::size_t HANDLES_COUNT_OFFSET = DESERIALIZED_SIZE_OFFSET + sizeof(uint64_t);
+constexpr std::size_t SERIALIZED_HEADER_SIZE = HANDLES_COUNT_OFFSET + sizeof(uint64_t);
+constexpr std::size_t SERIALIZED_ALIGNMENT = 256;
+
+BufferUsageMask serialization_usage = BufferUsageMaskBits::E_SHADER_DEVICE_ADDRESS_BIT | //
+                                      BufferUsageMaskBits::E_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
+
+uint64_t GetSerializedField(std::span<const std::byte> serialized, std::size_t offset) {
+  uint64_t value = 0;
+  std::memcpy(&value, serialized.data() + offset, sizeof(value));
+  return value;
+}
+
+// COPIES NEED 256 BYTE ALIGNED ADDRESSES, BUFFERS ARE OVERALLOCATED AND THE BASE IS ALIGNED
+std::size_t GetAlignedBase(const Buffer &buffer) {
+  auto address = buffer.GetBufferAddress();
+  return AlignUp(address, SERIALIZED_ALIGNMENT) - address;
+}
+
+AccelerationStructure::AccelerationStructure(CommandBuffer &command_buffer, std::span<const std::byte> serialized,
+                                             std::vector<Buffer> &build_buffers) {
+  CORE_ASSERT(IsCompatible(serialized), "Serialized acceleration structure is not compatible with the device");
+  CORE_ASSERT(GetSerializedField(serialized, HANDLES_COUNT_OFFSET) == 0, "Only bottom level acceleration structures can be deserialized");
+  auto deserialized_size = GetSerializedField(serialized, DESERIALIZED_SIZE_OFFSET);
+  CreateAccelerationBuffer(deserialized_size);
+  AccelerationInformation acceleration_information;
+  acceleration_information.acceleration_size_ = deserialized_size;
+  acceleration_structure_ = CreateAccelerationStructure(acceleration_buffer_, acceleration_information,
+                                                        AccelerationStructureTypeKHR::E_BOTTOM_LEVEL_KHR);
+
+  Buffer staging_buffer(serialized.size() + SERIALIZED_ALIGNMENT, serialization_usage, Buffer::CPU);
+  auto base = GetAlignedBase(staging_buffer);
+  staging_buffer.SetData(serialized, base);
+  command_buffer.CommandCopyMemoryToAccelerationStructure(staging_buffer.GetBufferAddress() + base, acceleration_structure_);
+  build_buffers.emplace_back(std::move(staging_buffer));
+}
+
+bool AccelerationStructure::IsCompatible(std::span<const std::byte> serialized) {
+  if (serialized.size() < SERIALIZED_HEADER_SIZE || GetSerializedField(serialized, SERIALIZED_SIZE_OFFSET) != serialized.size()) {
+    return false;
+  }
+  AccelerationStructureVersionInfoKHR version_info;
+  version_info.pVersionData = reinterpret_cast<const uint8_t *>(serialized.data());
+  VkAccelerationStructureCompatibilityKHR compatibility;
+  vkGetDeviceAccelerationStructureCompatibilityKHR(GraphicsContext::Get()->GetDevice(), version_info, &compatibility);
+  return AccelerationStructureCompatibilityKHR(compatibility) == AccelerationStructureCompatibilityKHR::E_COMPATIBLE_KHR;
+}
+
+std::vector<std::size_t> GetSerializedOffsets(std::span<const uint64_t> sizes, std::size_t &total_size) {
+  std::vector<std::size_t> offsets(sizes.size());
+  total_size = 0;
+  for (auto i = 0; i < sizes.size(); i++) {
+    offsets[i] = total_size;
+    total_size = AlignUp(total_size + sizes[i], SERIALIZED_ALIGNMENT);
+  }
+  return offsets;
+}
+
+void AccelerationStructure::CommandWriteSerializedSizes(CommandBuffer &command_buffer,
+                                                        std::span<const AccelerationStructure> acceleration_structures,
+                                                        const QueryPool &query_pool) {
+  std::vector<VkAccelerationStructureKHR> handles;
+  for (const auto &acceleration_structure : acceleration_structures) {
+    handles.emplace_back(acceleration_structure.GetAccelerationStructure());
+  }
+  command_buffer.CommandResetQueryPool(query_pool.GetHandle(), 0, handles.size());
+  // THE BUILDS MAY HAVE BEEN RECORDED EARLIER IN THIS COMMAND BUFFER
+  command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                                      AccessMaskBits2::E_ACCELERATION_STRUCTURE_WRITE_BIT_KHR,
+                                      PipelineStageMaskBits2::E_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                                      AccessMaskBits2::E_ACCELERATION_STRUCTURE_READ_BIT_KHR);
+  command_buffer.CommandWriteAccelerationStructuresProperties(handles, QueryType::E_ACCELERATION_STRUCTURE_SERIALIZATION_SIZE_KHR,
+                                                              query_pool.GetHandle());
+}
+
+Buffer AccelerationStructure::CommandSerialize(CommandBuffer &command_buffer, std::span<const AccelerationStructure> acceleration_structures,
+                                               std::span<const uint64_t> sizes) {
+  std::size_t total_size = 0;
+  auto offsets = GetSerializedOffsets(sizes, total_size);
+  Buffer readback_buffer(total_size + SERIALIZED_ALIGNMENT, serialization_usage, Buffer::READBACK);
+  auto base = GetAlignedBase(readback_buffer);
+  for (auto i = 0; i < acceleration_structures.size(); i++) {
+    command_buffer.CommandCopyAccelerationStructureToMemory(acceleration_structures[i].GetAccelerationStructure(),
+                                                            readback_buffer.GetBufferAddress() + base + offsets[i]);
+  }
+  command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, AccessMaskBits2::E_TRANSFER_WRITE_BIT,
+                                      PipelineStageMaskBits2::E_HOST_BIT, AccessMaskBits2::E_HOST_READ_BIT);
+  return readback_buffer;
+}
+
+std::vector<std::vector<std::byte>> AccelerationStructure::ReadSerialized(Buffer &readback_buffer, std::span<const uint64_t> sizes) {
+  std::size_t total_size = 0;
+  auto offsets = GetSerializedOffsets(sizes, total_size);
+  auto base = GetAlignedBase(readback_buffer);
+  readback_buffer.Invalidate();
+  auto mapped_data = readback_buffer.GetMappedData<std::byte>();
+  std::vector<std::vector<std::byte>> serialized(sizes.size());
+  for (auto i = 0; i < sizes.size(); i++) {
+    auto blob = mapped_data.subspan(base + offsets[i], sizes[i]);
+    serialized[i].assign(blob.begin(), blob.end());
+  }
+  return serialized;
+}
+
+} // namespace Innsmouth
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "acceleration_structure_tools.h"
 #include "innsmouth/core/include/core.h"
+#include <algorithm>
 
 namespace Innsmouth {
 
@@ -18,23 +19,27 @@ VkAccelerationStructureKHR CreateAccelerationStructure(VkBuffer main_buffer, con
 AccelerationStructureBuildGeometryInfoKHR GetBuildGeometryInformation(std::span<const AccelerationStructureGeometryKHR> geometries,
                                                                       VkDeviceAddress scratch_buffer,
                                                                       VkAccelerationStructureKHR acceleration_structure,
-                                                                      AccelerationStructureTypeKHR type) {
+                                                                      AccelerationStructureTypeKHR type, BuildAccelerationStructureMaskKHR flags,
+                                                                      BuildAccelerationStructureModeKHR mode) {
   AccelerationStructureBuildGeometryInfoKHR geometry_bi;
-  geometry_bi.flags = BuildAccelerationStructureMaskBitsKHR::E_PREFER_FAST_TRACE_BIT_KHR;
-  geometry_bi.mode = BuildAccelerationStructureModeKHR::E_BUILD_KHR;
+  geometry_bi.flags = flags;
+  geometry_bi.mode = mode;
   geometry_bi.type = type;
   geometry_bi.geometryCount = geometries.size();
   geometry_bi.pGeometries = geometries.data();
+  // UPDATES REFIT IN PLACE
+  geometry_bi.srcAccelerationStructure = mode == BuildAccelerationStructureModeKHR::E_UPDATE_KHR ? acceleration_structure : VK_NULL_HANDLE;
   geometry_bi.dstAccelerationStructure = acceleration_structure;
   geometry_bi.scratchData.deviceAddress = scratch_buffer;
   return geometry_bi;
 }
 
-AccelerationStructureBuildSizesInfoKHR GetAccelerationStructureSize(const BottomLevelGeometry &bottom_geometry) {
+AccelerationStructureBuildSizesInfoKHR GetAccelerationStructureSize(const BottomLevelGeometry &bottom_geometry,
+                                                                    BuildAccelerationStructureMaskKHR flags) {
   auto device = GraphicsContext::Get()->GetDevice();
   auto geometries = bottom_geometry.GetGeometries();
   AccelerationStructureBuildGeometryInfoKHR geometry_bi;
-  geometry_bi.flags = BuildAccelerationStructureMaskBitsKHR::E_PREFER_FAST_TRACE_BIT_KHR;
+  geometry_bi.flags = flags;
   geometry_bi.type = AccelerationStructureTypeKHR::E_BOTTOM_LEVEL_KHR;
   geometry_bi.geometryCount = geometries.size();
   geometry_bi.pGeometries = geometries.data();
@@ -60,16 +65,18 @@ AccelerationStructureBuildSizesInfoKHR GetAccelerationStructureSize(uint32_t ins
 }
 
 AccelerationSize GetAccelerationStructureSize(std::span<const BottomLevelGeometry> bottom_geometries,
-                                              std::span<AccelerationInformation> out_information) {
+                                              std::span<AccelerationInformation> out_information, BuildAccelerationStructureMaskKHR flags) {
   auto alignment = 256;
   std::size_t total_acceleration_size = 0, total_scratch_size = 0;
   for (auto i = 0; i < bottom_geometries.size(); i++) {
-    auto build_sizes_info = GetAccelerationStructureSize(bottom_geometries[i]);
+    auto build_sizes_info = GetAccelerationStructureSize(bottom_geometries[i], flags);
+    // SCRATCH IS SHARED BY BUILDS AND UPDATES OF THE SAME STRUCTURE
+    auto scratch_size = std::max(build_sizes_info.buildScratchSize, build_sizes_info.updateScratchSize);
     out_information[i].acceleration_offset_ = total_acceleration_size;
     out_information[i].acceleration_size_ = build_sizes_info.accelerationStructureSize;
     out_information[i].scratch_offset_ = total_scratch_size;
     total_acceleration_size = AlignUp(total_acceleration_size + build_sizes_info.accelerationStructureSize, alignment);
-    total_scratch_size = AlignUp(total_scratch_size + build_sizes_info.buildScratchSize, alignment);
+    total_scratch_size = AlignUp(total_scratch_size + scratch_size, alignment);
   }
   return AccelerationSize(total_acceleration_size, total_scratch_size);
 }
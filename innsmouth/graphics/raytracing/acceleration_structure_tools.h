@@ -12,6 +12,7 @@ struct InstanceData {
 struct BottomLevelAccelerationStructureInstances {
   std::vector<InstanceData> instances_;
   VkAccelerationStructureKHR acceleration_structure_{VK_NULL_HANDLE};
+  uint32_t shader_binding_table_offset_ = 0;
 };
 
 struct AccelerationSize {
@@ -19,24 +20,34 @@ struct AccelerationSize {
   std::size_t total_scratch_size = 0;
 };
 
+constexpr BuildAccelerationStructureMaskKHR STATIC_BUILD_FLAGS = BuildAccelerationStructureMaskBitsKHR::E_PREFER_FAST_TRACE_BIT_KHR;
+constexpr BuildAccelerationStructureMaskKHR DYNAMIC_BUILD_FLAGS = STATIC_BUILD_FLAGS | BuildAccelerationStructureMaskBitsKHR::E_ALLOW_UPDATE_BIT_KHR;
+
 struct AccelerationInformation {
   std::size_t acceleration_offset_ = 0;
   std::size_t acceleration_size_ = 0;
   std::size_t scratch_offset_ = 0;
 };
 
-AccelerationStructureBuildSizesInfoKHR GetAccelerationStructureSize(const BottomLevelGeometry &bottom_geometry);
-AccelerationSize GetAccelerationStructureSize(std::span<const BottomLevelGeometry> geometries, std::span<AccelerationInformation> out);
+AccelerationStructureBuildSizesInfoKHR GetAccelerationStructureSize(const BottomLevelGeometry &bottom_geometry,
+                                                                    BuildAccelerationStructureMaskKHR flags = STATIC_BUILD_FLAGS);
+AccelerationSize GetAccelerationStructureSize(std::span<const BottomLevelGeometry> geometries, std::span<AccelerationInformation> out,
+                                              BuildAccelerationStructureMaskKHR flags = STATIC_BUILD_FLAGS);
 AccelerationStructureBuildSizesInfoKHR GetAccelerationStructureSize(uint32_t instances);
 uint32_t GetTotalInstancesCount(std::span<const BottomLevelAccelerationStructureInstances> bottom_instances);
 
+TransformMatrixKHR ConvertTransform(const Matrix4f &matrix);
+VkDeviceAddress GetBottomLevelAccelerationStructuresAddress(VkAccelerationStructureKHR acceleration_structure);
+
 VkAccelerationStructureKHR CreateAccelerationStructure(VkBuffer acceleration_buffer, const AccelerationInformation &acceleration_information,
                                                        AccelerationStructureTypeKHR type);
 
 AccelerationStructureBuildGeometryInfoKHR GetBuildGeometryInformation(std::span<const AccelerationStructureGeometryKHR> geometries,
                                                                       VkDeviceAddress scratch_buffer,
                                                                       VkAccelerationStructureKHR acceleration_structure,
-                                                                      AccelerationStructureTypeKHR type);
+                                                                      AccelerationStructureTypeKHR type,
+                                                                      BuildAccelerationStructureMaskKHR flags = STATIC_BUILD_FLAGS,
+                                                                      BuildAccelerationStructureModeKHR mode = BuildAccelerationStructureModeKHR::E_BUILD_KHR);
 
 } // namespace Innsmouth
 
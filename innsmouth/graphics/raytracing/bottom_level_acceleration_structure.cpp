@@ -7,7 +7,7 @@
 namespace Innsmouth {
 
 std::vector<VkAccelerationStructureKHR>
-AccelerationStructure::BuildAccelerationStructures(VkBuffer main_buffer, VkDeviceAddress scratch_buffer,
+AccelerationStructure::BuildAccelerationStructures(CommandBuffer &command_buffer, VkBuffer main_buffer, VkDeviceAddress scratch_buffer,
                                                    std::span<const AccelerationInformation> acceleration_informations,
                                                    std::span<const BottomLevelGeometry> bottom_geometries) {
 
@@ -40,11 +40,7 @@ AccelerationStructure::BuildAccelerationStructures(VkBuffer main_buffer, VkDevic
     geometry_infos[i] = GetBuildGeometryInformation(bottom_geometry.GetGeometries(), scratch_address, acceleration_structures[i], type);
   }
 
-  CommandBuffer command_buffer(GraphicsContext::Get()->GetGraphicsQueueIndex());
-  command_buffer.Begin();
   command_buffer.CommandBuildAccelerationStructure(geometry_infos, range_pointers);
-  command_buffer.End();
-  command_buffer.Submit();
 
   return acceleration_structures;
 }
@@ -7,7 +7,8 @@ void BottomLevelGeometry::AddTriangleGeometry(const TriangleGeometrySpecificatio
   AccelerationStructureGeometryKHR geometry;
   AccelerationStructureBuildRangeInfoKHR range;
   geometry.geometryType = GeometryTypeKHR::E_TRIANGLES_KHR;
-  geometry.flags = GeometryMaskBitsKHR::E_OPAQUE_BIT_KHR;
+  auto non_opaque = GeometryMaskBitsKHR::E_NO_DUPLICATE_ANY_HIT_INVOCATION_BIT_KHR;
+  geometry.flags = specification.opaque_ ? GeometryMaskBitsKHR::E_OPAQUE_BIT_KHR : non_opaque;
   geometry.geometry.triangles.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR;
   geometry.geometry.triangles.vertexFormat = VK_FORMAT_R32G32B32_SFLOAT;
   geometry.geometry.triangles.vertexData.deviceAddress = specification.vbo_offset_;
@@ -16,8 +17,22 @@ void BottomLevelGeometry::AddTriangleGeometry(const TriangleGeometrySpecificatio
   geometry.geometry.triangles.indexData.deviceAddress = specification.ibo_offset_;
   geometry.geometry.triangles.vertexStride = specification.vertex_stride_;
 
-  range.firstVertex = 0;
-  range.primitiveOffset = 0;
+  if (specification.opacity_micromap_ != VK_NULL_HANDLE) {
+    auto link = std::make_shared<OpacityMicromapLink>();
+    link->usage_counts_.assign(specification.opacity_micromap_usage_counts_.begin(), specification.opacity_micromap_usage_counts_.end());
+    link->triangles_opacity_micromap_.indexType = IndexType::E_UINT32;
+    link->triangles_opacity_micromap_.indexBuffer.deviceAddress = specification.opacity_micromap_indices_;
+    link->triangles_opacity_micromap_.indexStride = sizeof(int32_t);
+    link->triangles_opacity_micromap_.usageCountsCount = link->usage_counts_.size();
+    link->triangles_opacity_micromap_.pUsageCounts = link->usage_counts_.data();
+    link->triangles_opacity_micromap_.micromap = specification.opacity_micromap_;
+    geometry.geometry.triangles.pNext = &link->triangles_opacity_micromap_;
+    opacity_micromap_links_.emplace_back(std::move(link));
+  }
+
+  // ALL GEOMETRIES SHARE ONE INDEX BUFFER, THE RANGE SELECTS THE MESH SO gl_PrimitiveID STAYS LOCAL TO THE GEOMETRY
+  range.firstVertex = specification.first_vertex_;
+  range.primitiveOffset = specification.first_index_ * sizeof(uint32_t);
   range.primitiveCount = specification.indices_count_ / 3;
 
   geometries_.emplace_back(geometry);
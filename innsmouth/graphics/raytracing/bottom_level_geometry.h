@@ -3,6 +3,7 @@
 
 #include "innsmouth/graphics/graphics_context/graphics_context.h"
 #include "innsmouth/mathematics/include/mathematics_types.h"
+#include <memory>
 #include <vector>
 
 namespace Innsmouth {
@@ -13,6 +14,18 @@ struct TriangleGeometrySpecification {
   std::size_t vertices_count_ = 0;
   std::size_t indices_count_ = 0;
   std::size_t vertex_stride_ = 0;
+  uint32_t first_index_ = 0;
+  uint32_t first_vertex_ = 0;
+  bool opaque_ = true;
+  // NON OPAQUE ONLY, ONE INDEX PER TRIANGLE INTO THE MICROMAP OR A SPECIAL INDEX, ANY-HIT RUNS FOR UNKNOWN STATES ONLY
+  VkMicromapEXT opacity_micromap_ = VK_NULL_HANDLE;
+  VkDeviceAddress opacity_micromap_indices_ = 0;
+  std::span<const MicromapUsageEXT> opacity_micromap_usage_counts_;
+};
+
+struct OpacityMicromapLink {
+  AccelerationStructureTrianglesOpacityMicromapEXT triangles_opacity_micromap_;
+  std::vector<MicromapUsageEXT> usage_counts_;
 };
 
 class BottomLevelGeometry {
@@ -31,6 +44,8 @@ public:
 private:
   std::vector<AccelerationStructureGeometryKHR> geometries_;
   std::vector<AccelerationStructureBuildRangeInfoKHR> ranges_;
+  // pNext TARGETS OF THE GEOMETRIES, SHARED SO COPIES OF THE GEOMETRY STAY VALID
+  std::vector<std::shared_ptr<const OpacityMicromapLink>> opacity_micromap_links_;
 };
 
 } // namespace Innsmouth
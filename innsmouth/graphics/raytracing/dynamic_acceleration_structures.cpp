@@ -0,0 +1,138 @@
+#include "dynamic_acceleration_structures.h"
+#include "innsmouth/graphics/command/command_buffer.h"
+#include "innsmouth/core/include/core.h"
+
+namespace Innsmouth {
+
+float GetSurfaceArea(const Vector3f &bounds_min, const Vector3f &bounds_max) {
+  auto extent = glm::max(bounds_max - bounds_min, Vector3f(0.0f));
+  return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+}
+
+DynamicAccelerationStructures::DynamicAccelerationStructures(std::span<const BottomLevelGeometry> bottom_geometries,
+                                                             const RefitPolicy &policy)
+  : bottom_geometries_(bottom_geometries.begin(), bottom_geometries.end()), policy_(policy) {
+  CORE_ASSERT(bottom_geometries_.empty() == false, "Dynamic acceleration structures need geometry");
+  acceleration_informations_.resize(bottom_geometries_.size());
+  auto sizes = GetAccelerationStructureSize(bottom_geometries_, acceleration_informations_, DYNAMIC_BUILD_FLAGS);
+
+  BufferUsageMask acceleration_usage =
+    BufferUsageMaskBits::E_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | BufferUsageMaskBits::E_SHADER_DEVICE_ADDRESS_BIT;
+  BufferUsageMask scratch_usage = BufferUsageMaskBits::E_SHADER_DEVICE_ADDRESS_BIT | BufferUsageMaskBits::E_STORAGE_BUFFER_BIT;
+  acceleration_buffer_ = Buffer(sizes.total_acceleration_size, acceleration_usage, AllocationCreateMaskBits::E_DEDICATED_MEMORY_BIT);
+  scratch_buffer_ = Buffer(sizes.total_scratch_size, scratch_usage, AllocationCreateMaskBits::E_DEDICATED_MEMORY_BIT);
+
+  for (const auto &acceleration_information : acceleration_informations_) {
+    acceleration_structures_.emplace_back(CreateAccelerationStructure(acceleration_buffer_.GetHandle(), acceleration_information,
+                                                                      AccelerationStructureTypeKHR::E_BOTTOM_LEVEL_KHR));
+  }
+  states_.resize(bottom_geometries_.size());
+  for (auto &state : states_) {
+    state.pending_ = true;
+  }
+}
+
+DynamicAccelerationStructures::~DynamicAccelerationStructures() {
+  for (auto acceleration_structure : acceleration_structures_) {
+    vkDestroyAccelerationStructureKHR(GraphicsContext::Get()->GetDevice(), acceleration_structure, nullptr);
+  }
+}
+
+void DynamicAccelerationStructures::Update(uint32_t index, const Vector3f &bounds_min, const Vector3f &bounds_max) {
+  states_[index].area_ = GetSurfaceArea(bounds_min, bounds_max);
+  states_[index].pending_ = true;
+}
+
+void DynamicAccelerationStructures::Record(CommandBuffer &command_buffer) {
+  refits_count_ = 0;
+  rebuilds_count_ = 0;
+
+  std::vector<AccelerationStructureBuildGeometryInfoKHR> geometry_infos;
+  std::vector<const AccelerationStructureBuildRangeInfoKHR *> range_pointers;
+
+  for (auto i = 0; i < states_.size(); i++) {
+    auto &state = states_[i];
+    if (state.pending_ == false) continue;
+    auto degraded = state.refits_ >= policy_.max_refits_;
+    degraded = degraded || (state.built_area_ > 0.0f && state.area_ > policy_.max_bounds_growth_ * state.built_area_);
+    auto rebuild = state.built_ == false || degraded;
+    auto mode = rebuild ? BuildAccelerationStructureModeKHR::E_BUILD_KHR : BuildAccelerationStructureModeKHR::E_UPDATE_KHR;
+    auto scratch_address = scratch_buffer_.GetBufferAddress() + acceleration_informations_[i].scratch_offset_;
+    geometry_infos.emplace_back(GetBuildGeometryInformation(bottom_geometries_[i].GetGeometries(), scratch_address, acceleration_structures_[i],
+                                                            AccelerationStructureTypeKHR::E_BOTTOM_LEVEL_KHR, DYNAMIC_BUILD_FLAGS, mode));
+    range_pointers.emplace_back(bottom_geometries_[i].GetRanges().data());
+    if (rebuild) {
+      state.refits_ = 0;
+      state.built_area_ = state.area_;
+      state.built_ = true;
+      rebuilds_count_++;
+    } else {
+      state.refits_++;
+      refits_count_++;
+    }
+    state.pending_ = false;
+  }
+
+  if (geometry_infos.empty()) return;
+
+  // THE SCRATCH AND THE STRUCTURES ARE REUSED, EARLIER BUILDS AND TRACES MUST BE DONE WITH THEM
+  auto readers = PipelineStageMaskBits2::E_RAY_TRACING_SHADER_BIT_KHR | PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT |
+                 PipelineStageMaskBits2::E_FRAGMENT_SHADER_BIT;
+  auto build = PipelineStageMaskBits2::E_ACCELERATION_STRUCTURE_BUILD_BIT_KHR;
+  auto build_access = AccessMaskBits2::E_ACCELERATION_STRUCTURE_READ_BIT_KHR | AccessMaskBits2::E_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+  command_buffer.CommandMemoryBarrier(readers | build, AccessMaskBits2::E_ACCELERATION_STRUCTURE_WRITE_BIT_KHR, build, build_access);
+  command_buffer.CommandBuildAccelerationStructure(geometry_infos, range_pointers);
+  command_buffer.CommandMemoryBarrier(build, AccessMaskBits2::E_ACCELERATION_STRUCTURE_WRITE_BIT_KHR, readers | build,
+                                      AccessMaskBits2::E_ACCELERATION_STRUCTURE_READ_BIT_KHR);
+}
+
+VkAccelerationStructureKHR DynamicAccelerationStructures::GetAccelerationStructure(uint32_t index) const {
+  return acceleration_structures_[index];
+}
+
+std::size_t DynamicAccelerationStructures::GetCount() const {
+  return acceleration_structures_.size();
+}
+
+uint32_t DynamicAccelerationStructures::GetRefitsCount() const {
+  return refits_count_;
+}
+
+uint32_t DynamicAccelerationStructures::GetRebuildsCount() const {
+  return rebuilds_count_;
+}
+
+void DynamicAccelerationStructures::SetPolicy(const RefitPolicy &policy) {
+  policy_ = policy;
+}
+
+const RefitPolicy &DynamicAccelerationStructures::GetPolicy() const {
+  return policy_;
+}
+
+DynamicAccelerationStructures::DynamicAccelerationStructures(DynamicAccelerationStructures &&other) noexcept {
+  bottom_geometries_ = std::move(other.bottom_geometries_);
+  acceleration_informations_ = std::move(other.acceleration_informations_);
+  acceleration_structures_ = std::move(other.acceleration_structures_);
+  states_ = std::move(other.states_);
+  acceleration_buffer_ = std::move(other.acceleration_buffer_);
+  scratch_buffer_ = std::move(other.scratch_buffer_);
+  policy_ = std::exchange(other.policy_, RefitPolicy());
+  refits_count_ = std::exchange(other.refits_count_, 0);
+  rebuilds_count_ = std::exchange(other.rebuilds_count_, 0);
+}
+
+DynamicAccelerationStructures &DynamicAccelerationStructures::operator=(DynamicAccelerationStructures &&other) noexcept {
+  std::swap(bottom_geometries_, other.bottom_geometries_);
+  std::swap(acceleration_informations_, other.acceleration_informations_);
+  std::swap(acceleration_structures_, other.acceleration_structures_);
+  std::swap(states_, other.states_);
+  std::swap(acceleration_buffer_, other.acceleration_buffer_);
+  std::swap(scratch_buffer_, other.scratch_buffer_);
+  std::swap(policy_, other.policy_);
+  std::swap(refits_count_, other.refits_count_);
+  std::swap(rebuilds_count_, other.rebuilds_count_);
+  return *this;
+}
+
+} // namespace Innsmouth
\ No newline at end of file
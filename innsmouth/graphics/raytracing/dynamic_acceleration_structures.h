@@ -0,0 +1,69 @@
+#ifndef INNSMOUTH_DYNAMIC_ACCELERATION_STRUCTURES_H
+#define INNSMOUTH_DYNAMIC_ACCELERATION_STRUCTURES_H
+
+#include "innsmouth/graphics/buffer/buffer.h"
+#include "acceleration_structure_tools.h"
+
+namespace Innsmouth {
+
+class CommandBuffer;
+
+// A REFIT KEEPS THE TOPOLOGY OF THE LAST BUILD, TRACE COST GROWS AS VERTICES DRIFT AWAY FROM IT
+struct RefitPolicy {
+  uint32_t max_refits_ = 120;
+  float max_bounds_growth_ = 1.5f; // SURFACE AREA OF THE BOUNDS AGAINST THE LAST BUILD
+};
+
+struct DynamicAccelerationState {
+  uint32_t refits_ = 0;
+  float built_area_ = 0.0f;
+  float area_ = 0.0f;
+  bool built_ = false;
+  bool pending_ = false;
+};
+
+// BOTTOM LEVEL STRUCTURES OVER VERTICES THAT CHANGE EVERY FRAME, ALL UPDATES GO OUT IN ONE BUILD COMMAND
+class DynamicAccelerationStructures {
+public:
+  DynamicAccelerationStructures() = default;
+
+  DynamicAccelerationStructures(std::span<const BottomLevelGeometry> bottom_geometries, const RefitPolicy &policy = RefitPolicy());
+
+  ~DynamicAccelerationStructures();
+
+  DynamicAccelerationStructures(const DynamicAccelerationStructures &) = delete;
+  DynamicAccelerationStructures &operator=(const DynamicAccelerationStructures &) = delete;
+
+  DynamicAccelerationStructures(DynamicAccelerationStructures &&other) noexcept;
+  DynamicAccelerationStructures &operator=(DynamicAccelerationStructures &&other) noexcept;
+
+  // VERTICES OF THE STRUCTURE CHANGED, EMPTY BOUNDS DISABLE THE GROWTH HEURISTIC
+  void Update(uint32_t index, const Vector3f &bounds_min = Vector3f(0.0f), const Vector3f &bounds_max = Vector3f(0.0f));
+
+  // BUILDS NEW AND DEGRADED STRUCTURES, REFITS THE REST OF THE UPDATED ONES, VERTEX WRITES MUST BE VISIBLE TO THE BUILD STAGE
+  void Record(CommandBuffer &command_buffer);
+
+  VkAccelerationStructureKHR GetAccelerationStructure(uint32_t index) const;
+  std::size_t GetCount() const;
+
+  uint32_t GetRefitsCount() const;
+  uint32_t GetRebuildsCount() const;
+
+  void SetPolicy(const RefitPolicy &policy);
+  const RefitPolicy &GetPolicy() const;
+
+private:
+  std::vector<BottomLevelGeometry> bottom_geometries_;
+  std::vector<AccelerationInformation> acceleration_informations_;
+  std::vector<VkAccelerationStructureKHR> acceleration_structures_;
+  std::vector<DynamicAccelerationState> states_;
+  Buffer acceleration_buffer_;
+  Buffer scratch_buffer_;
+  RefitPolicy policy_;
+  uint32_t refits_count_ = 0;
+  uint32_t rebuilds_count_ = 0;
+};
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_DYNAMIC_ACCELERATION_STRUCTURES_H
\ No newline at end of file
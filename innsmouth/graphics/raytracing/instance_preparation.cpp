@@ -0,0 +1,180 @@
+#include "instance_preparation.h"
+#include "innsmouth/graphics/command/command_buffer.h"
+#include "innsmouth/core/include/core.h"
+
+namespace Innsmouth {
+
+constexpr uint32_t INSTANCE_PREPARATION_GROUP_SIZE = 64;
+
+struct InstancePreparationConstants {
+  Vector4f camera;
+  Vector4f relevance_min;
+  Vector4f relevance_max;
+  float projection_scale;
+  float error_threshold;
+  uint32_t instances_count;
+};
+
+struct InstancePreparationDescriptors {
+  DescriptorBufferInfo instances;
+  DescriptorBufferInfo lods;
+  DescriptorBufferInfo out_instances;
+  DescriptorBufferInfo range;
+};
+
+InstancePreparation::InstancePreparation(std::span<const TopLevelInstance> instances, std::span<const TopLevelLod> lods)
+  : instances_count_(instances.size()) {
+  CORE_ASSERT(instances.empty() == false, "Instance preparation needs instances");
+  auto device = GraphicsContext::Get()->GetDevice();
+
+  BufferUsageMask table_usage = BufferUsageMaskBits::E_STORAGE_BUFFER_BIT | BufferUsageMaskBits::E_TRANSFER_DST_BIT;
+  BufferUsageMask instance_usage = BufferUsageMaskBits::E_STORAGE_BUFFER_BIT | BufferUsageMaskBits::E_TRANSFER_DST_BIT |
+                                   BufferUsageMaskBits::E_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
+                                   BufferUsageMaskBits::E_SHADER_DEVICE_ADDRESS_BIT;
+  BufferUsageMask range_usage = instance_usage | BufferUsageMaskBits::E_INDIRECT_BUFFER_BIT;
+  BufferUsageMask acceleration_usage =
+    BufferUsageMaskBits::E_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | BufferUsageMaskBits::E_SHADER_DEVICE_ADDRESS_BIT;
+  BufferUsageMask scratch_usage = BufferUsageMaskBits::E_SHADER_DEVICE_ADDRESS_BIT | BufferUsageMaskBits::E_STORAGE_BUFFER_BIT;
+
+  instance_table_buffer_ = Buffer(instances.size_bytes(), table_usage, Buffer::CPU);
+  instance_table_buffer_.SetData(instances);
+  lod_table_buffer_ = Buffer(std::max(lods.size_bytes(), sizeof(TopLevelLod)), table_usage, Buffer::CPU);
+  lod_table_buffer_.SetData(lods);
+  instance_buffer_ = Buffer(instances_count_ * sizeof(AccelerationStructureInstanceKHR), instance_usage, {});
+  range_buffer_ = Buffer(sizeof(AccelerationStructureBuildRangeInfoKHR), range_usage, {});
+
+  // SIZED FOR EVERY INSTANCE SURVIVING, THE STRUCTURE IS REBUILT IN PLACE
+  auto sizes = GetAccelerationStructureSize(instances_count_);
+  acceleration_buffer_ = Buffer(sizes.accelerationStructureSize, acceleration_usage, AllocationCreateMaskBits::E_DEDICATED_MEMORY_BIT);
+  scratch_buffer_ = Buffer(sizes.buildScratchSize, scratch_usage, AllocationCreateMaskBits::E_DEDICATED_MEMORY_BIT);
+  AccelerationInformation acceleration_information;
+  acceleration_information.acceleration_size_ = sizes.accelerationStructureSize;
+  acceleration_structure_ =
+    CreateAccelerationStructure(acceleration_buffer_.GetHandle(), acceleration_information, AccelerationStructureTypeKHR::E_TOP_LEVEL_KHR);
+
+  pipeline_ = ComputePipeline(GetInnsmouthShadersDirectory() / "ray" / "instance_preparation.comp.spv");
+}
+
+InstancePreparation::~InstancePreparation() {
+  vkDestroyAccelerationStructureKHR(GraphicsContext::Get()->GetDevice(), acceleration_structure_, nullptr);
+}
+
+void InstancePreparation::CommandSetInstances(CommandBuffer &command_buffer, uint32_t first_instance,
+                                              std::span<const TopLevelInstance> instances, std::vector<Buffer> &build_buffers) {
+  CORE_ASSERT(first_instance + instances.size() <= instances_count_, "Instances out of the table");
+  if (instances.empty()) return;
+  Buffer staging_buffer(instances.size_bytes(), BufferUsageMaskBits::E_TRANSFER_SRC_BIT, Buffer::CPU);
+  staging_buffer.SetData(instances);
+  auto offset = first_instance * sizeof(TopLevelInstance);
+  command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT, AccessMask2(), PipelineStageMaskBits2::E_ALL_TRANSFER_BIT,
+                                      AccessMask2());
+  command_buffer.CommandCopyBuffer(staging_buffer.GetHandle(), instance_table_buffer_.GetHandle(), 0, offset, instances.size_bytes());
+  command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_ALL_TRANSFER_BIT, AccessMaskBits2::E_TRANSFER_WRITE_BIT,
+                                      PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT, AccessMaskBits2::E_SHADER_STORAGE_READ_BIT);
+  build_buffers.emplace_back(std::move(staging_buffer));
+}
+
+void InstancePreparation::Record(CommandBuffer &command_buffer, const InstanceCullingSpecification &specification) {
+  auto indirect_build = GraphicsContext::Get()->IsAccelerationStructureIndirectBuildEnabled();
+  auto build = PipelineStageMaskBits2::E_ACCELERATION_STRUCTURE_BUILD_BIT_KHR;
+  auto readers = PipelineStageMaskBits2::E_RAY_TRACING_SHADER_BIT_KHR | PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT |
+                 PipelineStageMaskBits2::E_FRAGMENT_SHADER_BIT;
+
+  // THE LAST BUILD READ THE INSTANCES AND THE RANGE, TRACES READ THE STRUCTURE THAT IS ABOUT TO BE OVERWRITTEN
+  command_buffer.CommandMemoryBarrier(readers | build, AccessMask2(), PipelineStageMaskBits2::E_ALL_TRANSFER_BIT, AccessMask2());
+  command_buffer.CommandFillBuffer(range_buffer_.GetHandle(), 0, range_buffer_.GetSize(), 0);
+  // WITHOUT INDIRECT BUILDS EVERY SLOT IS BUILT, A ZERO REFERENCE MAKES THE ONES PAST THE SURVIVORS INACTIVE
+  if (indirect_build == false) {
+    command_buffer.CommandFillBuffer(instance_buffer_.GetHandle(), 0, instance_buffer_.GetSize(), 0);
+  }
+  command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_ALL_TRANSFER_BIT, AccessMaskBits2::E_TRANSFER_WRITE_BIT,
+                                      PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT,
+                                      AccessMaskBits2::E_SHADER_STORAGE_READ_BIT | AccessMaskBits2::E_SHADER_STORAGE_WRITE_BIT);
+
+  InstancePreparationConstants constants;
+  constants.camera = Vector4f(specification.camera_position_, specification.max_distance_);
+  constants.relevance_min = Vector4f(specification.relevance_min_, 0.0f);
+  constants.relevance_max = Vector4f(specification.relevance_max_, 0.0f);
+  constants.projection_scale = specification.projection_scale_;
+  constants.error_threshold = specification.error_threshold_;
+  constants.instances_count = instances_count_;
+
+  InstancePreparationDescriptors descriptors;
+  descriptors.instances = instance_table_buffer_.GetDescriptor();
+  descriptors.lods = lod_table_buffer_.GetDescriptor();
+  descriptors.out_instances = instance_buffer_.GetDescriptor();
+  descriptors.range = range_buffer_.GetDescriptor();
+
+  command_buffer.CommandBindPipeline(pipeline_.GetPipeline(), PipelineBindPoint::E_COMPUTE);
+  command_buffer.CommandPushConstants(pipeline_.GetPipelineLayout(), ShaderStageMaskBits::E_COMPUTE_BIT, constants);
+  command_buffer.CommandPushDescriptorSet(pipeline_.GetPushDescriptorTemplate(), descriptors);
+  command_buffer.CommandDispatch((instances_count_ + INSTANCE_PREPARATION_GROUP_SIZE - 1) / INSTANCE_PREPARATION_GROUP_SIZE);
+  command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT, AccessMaskBits2::E_SHADER_STORAGE_WRITE_BIT, build,
+                                      AccessMaskBits2::E_SHADER_READ_BIT | AccessMaskBits2::E_INDIRECT_COMMAND_READ_BIT);
+
+  std::array<AccelerationStructureGeometryKHR, 1> geometries;
+  geometries[0].geometryType = GeometryTypeKHR::E_INSTANCES_KHR;
+  geometries[0].geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
+  geometries[0].geometry.instances.data.deviceAddress = instance_buffer_.GetBufferAddress();
+  std::array<AccelerationStructureBuildGeometryInfoKHR, 1> geometry_bi;
+  geometry_bi[0] = GetBuildGeometryInformation(geometries, scratch_buffer_.GetBufferAddress(), acceleration_structure_,
+                                               AccelerationStructureTypeKHR::E_TOP_LEVEL_KHR);
+
+  if (indirect_build) {
+    std::array<VkDeviceAddress, 1> range_addresses = {range_buffer_.GetBufferAddress()};
+    std::array<uint32_t, 1> range_strides = {sizeof(AccelerationStructureBuildRangeInfoKHR)};
+    std::array<const uint32_t *, 1> max_primitive_counts = {&instances_count_};
+    command_buffer.CommandBuildAccelerationStructureIndirect(geometry_bi, range_addresses, range_strides, max_primitive_counts);
+  } else {
+    std::array<AccelerationStructureBuildRangeInfoKHR, 1> build_ranges;
+    build_ranges[0].primitiveCount = instances_count_;
+    std::array<const AccelerationStructureBuildRangeInfoKHR *, 1> build_range_pointers = {build_ranges.data()};
+    command_buffer.CommandBuildAccelerationStructure(geometry_bi, build_range_pointers);
+  }
+
+  command_buffer.CommandMemoryBarrier(build, AccessMaskBits2::E_ACCELERATION_STRUCTURE_WRITE_BIT_KHR, readers,
+                                      AccessMaskBits2::E_ACCELERATION_STRUCTURE_READ_BIT_KHR);
+}
+
+VkAccelerationStructureKHR InstancePreparation::GetAccelerationStructure() const {
+  return acceleration_structure_;
+}
+
+uint32_t InstancePreparation::GetInstancesCount() const {
+  return instances_count_;
+}
+
+const Buffer &InstancePreparation::GetInstanceTableBuffer() const {
+  return instance_table_buffer_;
+}
+
+const Buffer &InstancePreparation::GetInstanceBuffer() const {
+  return instance_buffer_;
+}
+
+InstancePreparation::InstancePreparation(InstancePreparation &&other) noexcept {
+  acceleration_structure_ = std::exchange(other.acceleration_structure_, VK_NULL_HANDLE);
+  acceleration_buffer_ = std::move(other.acceleration_buffer_);
+  scratch_buffer_ = std::move(other.scratch_buffer_);
+  instance_table_buffer_ = std::move(other.instance_table_buffer_);
+  lod_table_buffer_ = std::move(other.lod_table_buffer_);
+  instance_buffer_ = std::move(other.instance_buffer_);
+  range_buffer_ = std::move(other.range_buffer_);
+  pipeline_ = std::move(other.pipeline_);
+  instances_count_ = std::exchange(other.instances_count_, 0);
+}
+
+InstancePreparation &InstancePreparation::operator=(InstancePreparation &&other) noexcept {
+  std::swap(acceleration_structure_, other.acceleration_structure_);
+  std::swap(acceleration_buffer_, other.acceleration_buffer_);
+  std::swap(scratch_buffer_, other.scratch_buffer_);
+  std::swap(instance_table_buffer_, other.instance_table_buffer_);
+  std::swap(lod_table_buffer_, other.lod_table_buffer_);
+  std::swap(instance_buffer_, other.instance_buffer_);
+  std::swap(range_buffer_, other.range_buffer_);
+  std::swap(pipeline_, other.pipeline_);
+  std::swap(instances_count_, other.instances_count_);
+  return *this;
+}
+
+} // namespace Innsmouth
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef INNSMOUTH_INSTANCE_PREPARATION_H
+#define INNSMOUTH_INSTANCE_PREPARATION_H
+
+#include "innsmouth/graphics/buffer/buffer.h"
+#include "innsmouth/graphics/pipeline/compute_pipeline.h"
+#include "acceleration_structure_tools.h"
+#include <limits>
+
+namespace Innsmouth {
+
+class CommandBuffer;
+
+// ONE ENTRY OF THE DEVICE INSTANCE TABLE, MATCHES shaders/ray/instance_preparation.comp
+struct TopLevelInstance {
+  TransformMatrixKHR transform_;
+  Vector3f center_; // OBJECT SPACE BOUNDING SPHERE
+  float radius_ = 0.0f;
+  uint32_t custom_index_ = 0;
+  uint32_t mask_ = 0xff;
+  uint32_t shader_binding_table_offset_ = 0;
+  uint32_t flags_ = 0;
+  uint32_t lods_offset_ = 0; // FINEST FIRST
+  uint32_t lods_count_ = 0;
+};
+
+// MATCHES shaders/ray/instance_preparation.comp, THE OFFSET TAKES THE SLOT THAT WAS TAIL PADDING IN BOTH LAYOUTS
+struct TopLevelLod {
+  VkDeviceAddress acceleration_structure_reference_ = 0;
+  float error_ = 0.0f;                       // OBJECT SPACE, AS IN MeshLod
+  uint32_t shader_binding_table_offset_ = 0; // ADDED TO THE ONE OF THE INSTANCE, EACH LOD HAS ITS OWN HIT RECORDS
+};
+
+static_assert(sizeof(TopLevelLod) == 16, "TopLevelLod must match the std430 stride of the shader");
+
+struct InstanceCullingSpecification {
+  Vector3f camera_position_{0.0f};
+  float max_distance_ = std::numeric_limits<float>::max();
+  Vector3f relevance_min_{std::numeric_limits<float>::lowest()};
+  Vector3f relevance_max_{std::numeric_limits<float>::max()};
+  float projection_scale_ = 0.0f; // PROJECTION[1][1] * VIEWPORT HEIGHT / 2, ZERO KEEPS THE FINEST LOD
+  float error_threshold_ = 1.0f;  // PIXELS
+};
+
+// WRITES THE TOP LEVEL INSTANCES ON THE DEVICE, CULLED AND WITH A BOTTOM LEVEL LOD PICKED PER INSTANCE, THEN BUILDS FROM THE DEVICE COUNT
+class InstancePreparation {
+public:
+  InstancePreparation() = default;
+
+  InstancePreparation(std::span<const TopLevelInstance> instances, std::span<const TopLevelLod> lods);
+
+  ~InstancePreparation();
+
+  InstancePreparation(const InstancePreparation &) = delete;
+  InstancePreparation &operator=(const InstancePreparation &) = delete;
+
+  InstancePreparation(InstancePreparation &&other) noexcept;
+  InstancePreparation &operator=(InstancePreparation &&other) noexcept;
+
+  // TABLE ENTRIES CHANGED ON THE HOST, THE STAGING BUFFER GOES TO build_buffers
+  void CommandSetInstances(CommandBuffer &command_buffer, uint32_t first_instance, std::span<const TopLevelInstance> instances,
+                           std::vector<Buffer> &build_buffers);
+
+  // REBUILDS IN PLACE, EARLIER TRACES MUST BE DONE AND WRITES TO THE REFERENCED BOTTOM LEVEL STRUCTURES VISIBLE TO THE BUILD STAGE
+  void Record(CommandBuffer &command_buffer, const InstanceCullingSpecification &specification);
+
+  VkAccelerationStructureKHR GetAccelerationStructure() const;
+  uint32_t GetInstancesCount() const;
+
+  // TABLE ENTRIES CAN BE WRITTEN ON THE DEVICE BETWEEN RECORDS
+  const Buffer &GetInstanceTableBuffer() const;
+
+  // THE INSTANCES OF THE LAST BUILD, INDEXED BY THE INSTANCE ID OF A HIT
+  const Buffer &GetInstanceBuffer() const;
+
+private:
+  VkAccelerationStructureKHR acceleration_structure_{VK_NULL_HANDLE};
+  Buffer acceleration_buffer_;
+  Buffer scratch_buffer_;
+  Buffer instance_table_buffer_;
+  Buffer lod_table_buffer_;
+  Buffer instance_buffer_;
+  Buffer range_buffer_;
+  ComputePipeline pipeline_;
+  uint32_t instances_count_ = 0;
+};
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_INSTANCE_PREPARATION_H
\ No newline at end of file
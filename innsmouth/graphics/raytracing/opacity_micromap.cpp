@@ -0,0 +1,109 @@
+#include "opacity_micromap.h"
+#include "innsmouth/graphics/command/command_buffer.h"
+#include "innsmouth/core/include/core.h"
+#include <map>
+
+namespace Innsmouth {
+
+std::vector<MicromapUsageEXT> GetMicromapUsageCounts(std::span<const MicromapTriangleEXT> triangles) {
+  std::map<std::pair<uint32_t, uint32_t>, uint32_t> counts;
+  for (const auto &triangle : triangles) {
+    counts[{triangle.subdivisionLevel, triangle.format}]++;
+  }
+  std::vector<MicromapUsageEXT> usage_counts;
+  for (const auto &[key, count] : counts) {
+    usage_counts.emplace_back(count, key.first, key.second);
+  }
+  return usage_counts;
+}
+
+OpacityMicromap::OpacityMicromap(CommandBuffer &command_buffer, std::span<const std::byte> data,
+                                 std::span<const MicromapTriangleEXT> triangles, std::span<const int32_t> indices,
+                                 std::vector<Buffer> &build_buffers) {
+  auto device = GraphicsContext::Get()->GetDevice();
+
+  // A MICROMAP CANNOT BE EMPTY, SPECIAL INDICES ALONE STILL NEED ONE TO POINT AT
+  std::array<std::byte, 1> placeholder_data{};
+  std::array<MicromapTriangleEXT, 1> placeholder_triangle = {MicromapTriangleEXT(0, 0, uint16_t(OpacityMicromapFormatEXT::E_4_STATE_EXT))};
+  if (triangles.empty()) {
+    data = placeholder_data;
+    triangles = placeholder_triangle;
+  }
+
+  auto usage_counts = GetMicromapUsageCounts(triangles);
+
+  MicromapBuildInfoEXT micromap_bi;
+  micromap_bi.type = MicromapTypeEXT::E_OPACITY_MICROMAP_EXT;
+  micromap_bi.flags = BuildMicromapMaskBitsEXT::E_PREFER_FAST_TRACE_BIT_EXT;
+  micromap_bi.mode = BuildMicromapModeEXT::E_BUILD_EXT;
+  micromap_bi.usageCountsCount = usage_counts.size();
+  micromap_bi.pUsageCounts = usage_counts.data();
+
+  MicromapBuildSizesInfoEXT sizes;
+  vkGetMicromapBuildSizesEXT(device, VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR, micromap_bi, sizes);
+
+  BufferUsageMask micromap_usage = BufferUsageMaskBits::E_MICROMAP_STORAGE_BIT_EXT | BufferUsageMaskBits::E_SHADER_DEVICE_ADDRESS_BIT;
+  BufferUsageMask input_usage = BufferUsageMaskBits::E_MICROMAP_BUILD_INPUT_READ_ONLY_BIT_EXT | BufferUsageMaskBits::E_SHADER_DEVICE_ADDRESS_BIT;
+  BufferUsageMask index_usage =
+    BufferUsageMaskBits::E_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR | BufferUsageMaskBits::E_SHADER_DEVICE_ADDRESS_BIT;
+  BufferUsageMask scratch_usage = BufferUsageMaskBits::E_STORAGE_BUFFER_BIT | BufferUsageMaskBits::E_SHADER_DEVICE_ADDRESS_BIT;
+
+  micromap_buffer_ = Buffer(sizes.micromapSize, micromap_usage, AllocationCreateMaskBits::E_DEDICATED_MEMORY_BIT);
+  index_buffer_ = Buffer(std::max(indices.size_bytes(), sizeof(int32_t)), index_usage, Buffer::CPU);
+  index_buffer_.SetData(indices);
+
+  Buffer data_buffer(data.size(), input_usage, Buffer::CPU);
+  data_buffer.SetData(data);
+  Buffer triangle_buffer(triangles.size_bytes(), input_usage, Buffer::CPU);
+  triangle_buffer.SetData(triangles);
+  Buffer scratch_buffer(std::max<std::size_t>(sizes.buildScratchSize, 1), scratch_usage, {});
+
+  MicromapCreateInfoEXT micromap_ci;
+  micromap_ci.buffer = micromap_buffer_.GetHandle();
+  micromap_ci.size = sizes.micromapSize;
+  micromap_ci.type = MicromapTypeEXT::E_OPACITY_MICROMAP_EXT;
+  VK_CHECK(vkCreateMicromapEXT(device, micromap_ci, nullptr, &micromap_));
+
+  micromap_bi.dstMicromap = micromap_;
+  micromap_bi.data.deviceAddress = data_buffer.GetBufferAddress();
+  micromap_bi.triangleArray.deviceAddress = triangle_buffer.GetBufferAddress();
+  micromap_bi.triangleArrayStride = sizeof(MicromapTriangleEXT);
+  micromap_bi.scratchData.deviceAddress = scratch_buffer.GetBufferAddress();
+
+  command_buffer.CommandBuildMicromap(std::span(&micromap_bi, 1));
+
+  build_buffers.emplace_back(std::move(data_buffer));
+  build_buffers.emplace_back(std::move(triangle_buffer));
+  build_buffers.emplace_back(std::move(scratch_buffer));
+}
+
+OpacityMicromap::~OpacityMicromap() {
+  vkDestroyMicromapEXT(GraphicsContext::Get()->GetDevice(), micromap_, nullptr);
+}
+
+VkMicromapEXT OpacityMicromap::GetMicromap() const {
+  return micromap_;
+}
+
+VkDeviceAddress OpacityMicromap::GetIndicesAddress(uint32_t first_triangle) const {
+  return index_buffer_.GetBufferAddress() + first_triangle * sizeof(int32_t);
+}
+
+std::size_t OpacityMicromap::GetSize() const {
+  return micromap_buffer_.GetSize() + index_buffer_.GetSize();
+}
+
+OpacityMicromap::OpacityMicromap(OpacityMicromap &&other) noexcept {
+  micromap_ = std::exchange(other.micromap_, VK_NULL_HANDLE);
+  micromap_buffer_ = std::move(other.micromap_buffer_);
+  index_buffer_ = std::move(other.index_buffer_);
+}
+
+OpacityMicromap &OpacityMicromap::operator=(OpacityMicromap &&other) noexcept {
+  std::swap(micromap_, other.micromap_);
+  std::swap(micromap_buffer_, other.micromap_buffer_);
+  std::swap(index_buffer_, other.index_buffer_);
+  return *this;
+}
+
+} // namespace Innsmouth
\ No newline at end of file
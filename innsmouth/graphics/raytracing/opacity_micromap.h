@@ -0,0 +1,40 @@
+#ifndef INNSMOUTH_OPACITY_MICROMAP_H
+#define INNSMOUTH_OPACITY_MICROMAP_H
+
+#include "innsmouth/graphics/buffer/buffer.h"
+#include <vector>
+
+namespace Innsmouth {
+
+class CommandBuffer;
+
+// OPACITY STATES OF MICRO-TRIANGLES, REFERENCED BY ONE INDEX PER TRIANGLE FROM THE BOTTOM LEVEL GEOMETRY
+class OpacityMicromap {
+public:
+  OpacityMicromap() = default;
+
+  // RECORDS THE BUILD, THE INPUT AND SCRATCH BUFFERS GO TO build_buffers, BARRIER BEFORE THE STRUCTURES THAT USE IT ARE BUILT
+  OpacityMicromap(CommandBuffer &command_buffer, std::span<const std::byte> data, std::span<const MicromapTriangleEXT> triangles,
+                  std::span<const int32_t> indices, std::vector<Buffer> &build_buffers);
+
+  ~OpacityMicromap();
+
+  OpacityMicromap(const OpacityMicromap &) = delete;
+  OpacityMicromap &operator=(const OpacityMicromap &) = delete;
+
+  OpacityMicromap(OpacityMicromap &&other) noexcept;
+  OpacityMicromap &operator=(OpacityMicromap &&other) noexcept;
+
+  VkMicromapEXT GetMicromap() const;
+  VkDeviceAddress GetIndicesAddress(uint32_t first_triangle = 0) const;
+  std::size_t GetSize() const;
+
+private:
+  VkMicromapEXT micromap_{VK_NULL_HANDLE};
+  Buffer micromap_buffer_;
+  Buffer index_buffer_;
+};
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_OPACITY_MICROMAP_H
\ No newline at end of file
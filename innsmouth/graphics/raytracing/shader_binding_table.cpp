@@ -1,7 +1,10 @@
 #include "shader_binding_table.h"
 #include "innsmouth/core/include/core.h"
 #include "innsmouth/graphics/command/command_buffer.h"
+#include <algorithm>
+#include <cstring>
 #include <print>
+#include <ranges>
 
 namespace Innsmouth {
 
@@ -13,80 +16,160 @@ PhysicalDeviceRayTracingPipelinePropertiesKHR GetRayTracingPipelineProperties()
   return ray_tracing_pipeline_properties;
 }
 
-auto GetShaderBindingTableSize(const ShaderGroupSpecification &shader_groups, uint32_t aligned_handle_size, uint32_t group_alignment) {
-  auto raygen_region_size = AlignUp(shader_groups.raygen_ * aligned_handle_size, group_alignment);
-  auto miss_region_size = AlignUp(shader_groups.miss_ * aligned_handle_size, group_alignment);
-  auto hit_region_size = AlignUp(shader_groups.hit_ * aligned_handle_size, group_alignment);
-  auto callable_region_size = AlignUp(shader_groups.callable_ * aligned_handle_size, group_alignment);
-  return raygen_region_size + miss_region_size + hit_region_size + callable_region_size;
-}
-
-void ShaderBindingTable::SetTables(const ShaderGroupSpecification &shader_groups, uint32_t aligned_handle_size, uint32_t group_alignment) {
-  auto sbt_address = sbt_buffer_.GetBufferAddress();
-
-  raygen_shader_binding_table_.size = aligned_handle_size; // AlignUp(shader_groups.raygen_ * aligned_handle_size, group_alignment);
-  raygen_shader_binding_table_.stride = aligned_handle_size;
-  raygen_shader_binding_table_.deviceAddress = sbt_address;
-
-  miss_shader_binding_table_.size = AlignUp(shader_groups.miss_ * aligned_handle_size, group_alignment);
-  miss_shader_binding_table_.stride = aligned_handle_size;
-  miss_shader_binding_table_.deviceAddress = sbt_address + AlignUp(shader_groups.raygen_ * aligned_handle_size, group_alignment);
-
-  hit_shader_binding_table_.size = AlignUp(shader_groups.hit_ * aligned_handle_size, group_alignment);
-  hit_shader_binding_table_.stride = aligned_handle_size;
-  hit_shader_binding_table_.deviceAddress = miss_shader_binding_table_.deviceAddress + miss_shader_binding_table_.size;
-
-  callable_shader_binding_table_.size = AlignUp(shader_groups.callable_ * aligned_handle_size, group_alignment);
-  callable_shader_binding_table_.stride = aligned_handle_size;
-  callable_shader_binding_table_.deviceAddress = hit_shader_binding_table_.deviceAddress + hit_shader_binding_table_.size;
-}
+ShaderBindingTableBuilder GetShaderBindingTableBuilder(const ShaderGroupSpecification &shader_groups, std::span<const uint32_t> hit_groups,
+                                                       std::span<const std::byte> hit_data, uint32_t hit_data_size) {
+  ShaderBindingTableBuilder builder(shader_groups);
+  for (auto i = 0; i < shader_groups.raygen_; i++) {
+    builder.AddRecord(ShaderRecordRegion::E_RAYGEN, i);
+  }
+  for (auto i = 0; i < shader_groups.miss_; i++) {
+    builder.AddRecord(ShaderRecordRegion::E_MISS, i);
+  }
+  for (auto i = 0; i < shader_groups.callable_; i++) {
+    builder.AddRecord(ShaderRecordRegion::E_CALLABLE, i);
+  }
 
-void CopyRegion(std::span<const std::byte> source, Buffer &destination, uint32_t count, uint32_t &offset, uint32_t &index, uint32_t handle_size,
-                uint32_t aligned_handle_size, uint32_t base_alignment) {
-  for (auto i = 0; i < count; i++) {
-    destination.SetData<std::byte>(source.subspan(index * handle_size, handle_size), offset);
-    offset += aligned_handle_size;
-    index++;
+  // WITHOUT RECORD DATA EVERY HIT GROUP GETS ONE RECORD, AS BEFORE
+  auto hit_records_count = hit_data_size == 0 ? shader_groups.hit_ : hit_data.size() / hit_data_size;
+  CORE_ASSERT(hit_groups.empty() || hit_groups.size() == hit_records_count, "Expected one hit group per hit record");
+  for (auto i = 0; i < hit_records_count; i++) {
+    auto hit_group = hit_groups.empty() ? (hit_data_size == 0 ? i : 0) : hit_groups[i];
+    auto data = hit_data_size == 0 ? std::span<const std::byte>() : hit_data.subspan(i * hit_data_size, hit_data_size);
+    builder.AddRecord(ShaderRecordRegion::E_HIT, hit_group, data);
   }
-  offset = AlignUp(offset, base_alignment);
+  return builder;
 }
 
-void ShaderBindingTable::CreateShaderBindingTable(VkPipeline pipeline, const ShaderGroupSpecification &shader_groups) {
+void ShaderBindingTable::CreateShaderBindingTable(VkPipeline pipeline, const ShaderBindingTableBuilder &builder) {
   auto ray_tracing_properties = GetRayTracingPipelineProperties();
-  auto handle_size = ray_tracing_properties.shaderGroupHandleSize;
+  auto base_alignment = ray_tracing_properties.shaderGroupBaseAlignment;
+  const auto &shader_groups = builder.GetShaderGroups();
   auto group_count = shader_groups.raygen_ + shader_groups.miss_ + shader_groups.hit_ + shader_groups.callable_;
 
-  std::vector<std::byte> handles(group_count * handle_size);
-  VK_CHECK(vkGetRayTracingShaderGroupHandlesKHR(GraphicsContext::Get()->GetDevice(), pipeline, 0, group_count, handles.size(), handles.data()));
+  handle_size_ = ray_tracing_properties.shaderGroupHandleSize;
+  group_handles_.resize(group_count * handle_size_);
+  VK_CHECK(vkGetRayTracingShaderGroupHandlesKHR(GraphicsContext::Get()->GetDevice(), pipeline, 0, group_count, group_handles_.size(),
+                                                group_handles_.data()));
+
+  // REGIONS FOLLOW THE GROUP ORDER OF THE PIPELINE: RAYGEN, MISS, HIT, CALLABLE
+  std::array<StridedDeviceAddressRegionKHR, SHADER_RECORD_REGIONS_COUNT> regions;
+  std::size_t buffer_size = 0;
+  uint32_t first_group = 0;
+  for (auto i = 0; i < SHADER_RECORD_REGIONS_COUNT; i++) {
+    auto region = ShaderRecordRegion(i);
+    first_groups_[i] = first_group;
+    groups_counts_[i] = builder.GetGroupsCount(region);
+    records_counts_[i] = builder.GetRecords(region).size();
+    record_data_sizes_[i] = builder.GetRecordDataSize(region);
+    first_group += groups_counts_[i];
+
+    // EVERY RAYGEN RECORD CAN START A TRACE, SO EACH ONE SITS ON THE BASE ALIGNMENT
+    auto alignment = region == ShaderRecordRegion::E_RAYGEN ? base_alignment : ray_tracing_properties.shaderGroupHandleAlignment;
+    auto stride = AlignUp(handle_size_ + record_data_sizes_[i], alignment);
+    CORE_ASSERT(stride <= ray_tracing_properties.maxShaderGroupStride, "Shader record exceeds the maximum shader group stride");
+
+    regions[i].deviceAddress = buffer_size;
+    regions[i].stride = stride;
+    regions[i].size = AlignUp(records_counts_[i] * stride, base_alignment);
+    buffer_size += regions[i].size;
+  }
 
-  auto base_alignment = ray_tracing_properties.shaderGroupBaseAlignment;
-  auto aligned_handle_size = AlignUp(handle_size, ray_tracing_properties.shaderGroupHandleAlignment);
-  auto aligned_buffer_size = GetShaderBindingTableSize(shader_groups, aligned_handle_size, base_alignment);
+  std::vector<std::byte> table(std::max(buffer_size, std::size_t(base_alignment)));
+  for (auto i = 0; i < SHADER_RECORD_REGIONS_COUNT; i++) {
+    for (const auto &[record_index, record] : std::views::enumerate(builder.GetRecords(ShaderRecordRegion(i)))) {
+      auto record_data = GetRecordData(ShaderRecordRegion(i), record.group_, record.data_);
+      std::memcpy(table.data() + regions[i].deviceAddress + record_index * regions[i].stride, record_data.data(), record_data.size());
+    }
+  }
 
+  // REBAR OR UMA MEMORY IS WRITTEN IN PLACE, OTHERWISE THE TABLE GOES THROUGH A STAGING COPY
   BufferUsageMask sbt_usage = BufferUsageMaskBits::E_SHADER_BINDING_TABLE_BIT_KHR | BufferUsageMaskBits::E_TRANSFER_DST_BIT |
                               BufferUsageMaskBits::E_SHADER_DEVICE_ADDRESS_BIT;
+  sbt_buffer_ = Buffer(table.size(), sbt_usage, Buffer::UPLOAD | AllocationCreateMaskBits::E_DEDICATED_MEMORY_BIT);
+
+  if (sbt_buffer_.IsMapped()) {
+    sbt_buffer_.SetData<std::byte>(table);
+  } else {
+    Buffer staging_buffer(table.size(), BufferUsageMaskBits::E_TRANSFER_SRC_BIT, Buffer::CPU);
+    staging_buffer.SetData<std::byte>(table);
+    CommandBuffer command_buffer(GraphicsContext::Get()->GetGraphicsQueueIndex());
+    command_buffer.Begin();
+    command_buffer.CommandCopyBuffer(staging_buffer.GetHandle(), sbt_buffer_.GetHandle(), 0, 0, table.size());
+    command_buffer.End();
+    command_buffer.Submit();
+  }
 
-  Buffer scratch_buffer(aligned_buffer_size, BufferUsageMaskBits::E_TRANSFER_SRC_BIT, Buffer::CPU);
-  sbt_buffer_ = Buffer(aligned_buffer_size, sbt_usage, AllocationCreateMaskBits::E_DEDICATED_MEMORY_BIT);
+  auto sbt_address = sbt_buffer_.GetBufferAddress();
+  for (auto &region : regions) {
+    region.deviceAddress += sbt_address;
+  }
+  raygen_shader_binding_table_ = regions[std::to_underlying(ShaderRecordRegion::E_RAYGEN)];
+  raygen_shader_binding_table_.size = raygen_shader_binding_table_.stride;
+  miss_shader_binding_table_ = regions[std::to_underlying(ShaderRecordRegion::E_MISS)];
+  hit_shader_binding_table_ = regions[std::to_underlying(ShaderRecordRegion::E_HIT)];
+  callable_shader_binding_table_ = regions[std::to_underlying(ShaderRecordRegion::E_CALLABLE)];
+}
 
-  SetTables(shader_groups, aligned_handle_size, ray_tracing_properties.shaderGroupBaseAlignment);
+std::vector<std::byte> ShaderBindingTable::GetRecordData(ShaderRecordRegion region, uint32_t group, std::span<const std::byte> data) const {
+  auto index = std::to_underlying(region);
+  CORE_ASSERT(group < groups_counts_[index], "Shader record group is out of range");
+  CORE_ASSERT(data.size() <= record_data_sizes_[index], "Shader record data exceeds the reserved size");
+  std::vector<std::byte> record_data(AlignUp(handle_size_ + record_data_sizes_[index], 4));
+  auto handle = std::span<const std::byte>(group_handles_).subspan((first_groups_[index] + group) * handle_size_, handle_size_);
+  std::ranges::copy(handle, record_data.begin());
+  std::ranges::copy(data, record_data.begin() + handle_size_);
+  return record_data;
+}
 
-  uint32_t offset = 0;
-  uint32_t index = 0;
+void ShaderBindingTable::SetRecord(CommandBuffer &command_buffer, ShaderRecordRegion region, uint32_t index, uint32_t group,
+                                   std::span<const std::byte> data) {
+  CORE_ASSERT(index < GetRecordsCount(region), "Shader record index is out of range");
+  const auto &table = GetRegion(region);
+  auto offset = table.deviceAddress - sbt_buffer_.GetBufferAddress() + index * table.stride;
+  auto record_data = GetRecordData(region, group, data);
+  command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_RAY_TRACING_SHADER_BIT_KHR, AccessMask2(),
+                                      PipelineStageMaskBits2::E_ALL_TRANSFER_BIT, AccessMask2());
+  command_buffer.CommandUpdateBuffer(sbt_buffer_.GetHandle(), offset, record_data);
+  command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_ALL_TRANSFER_BIT, AccessMaskBits2::E_TRANSFER_WRITE_BIT,
+                                      PipelineStageMaskBits2::E_RAY_TRACING_SHADER_BIT_KHR,
+                                      AccessMaskBits2::E_SHADER_BINDING_TABLE_READ_BIT_KHR);
+}
 
-  CopyRegion(handles, scratch_buffer, shader_groups.raygen_, offset, index, handle_size, aligned_handle_size, base_alignment);
-  CopyRegion(handles, scratch_buffer, shader_groups.miss_, offset, index, handle_size, aligned_handle_size, base_alignment);
-  CopyRegion(handles, scratch_buffer, shader_groups.hit_, offset, index, handle_size, aligned_handle_size, base_alignment);
+ShaderBindingTable::ShaderBindingTable(VkPipeline pipeline, const ShaderGroupSpecification &shader_groups) {
+  CreateShaderBindingTable(pipeline, GetShaderBindingTableBuilder(shader_groups, {}, {}, 0));
+}
 
-  CommandBuffer command_buffer(GraphicsContext::Get()->GetGraphicsQueueIndex());
-  command_buffer.Begin();
-  command_buffer.CommandCopyBuffer(scratch_buffer.GetHandle(), sbt_buffer_.GetHandle(), 0, 0, scratch_buffer.GetSize());
-  command_buffer.End();
-  command_buffer.Submit();
+ShaderBindingTable::ShaderBindingTable(VkPipeline pipeline, const ShaderGroupSpecification &shader_groups, std::span<const uint32_t> hit_groups,
+                                       std::span<const std::byte> hit_data, uint32_t hit_data_size) {
+  CreateShaderBindingTable(pipeline, GetShaderBindingTableBuilder(shader_groups, hit_groups, hit_data, hit_data_size));
 }
 
-ShaderBindingTable::ShaderBindingTable(VkPipeline pipeline, const ShaderGroupSpecification &shader_groups) {
-  CreateShaderBindingTable(pipeline, shader_groups);
+ShaderBindingTable::ShaderBindingTable(VkPipeline pipeline, const ShaderBindingTableBuilder &builder) {
+  CreateShaderBindingTable(pipeline, builder);
+}
+
+const StridedDeviceAddressRegionKHR &ShaderBindingTable::GetRegion(ShaderRecordRegion region) const {
+  switch (region) {
+  case ShaderRecordRegion::E_RAYGEN: return raygen_shader_binding_table_;
+  case ShaderRecordRegion::E_MISS: return miss_shader_binding_table_;
+  case ShaderRecordRegion::E_HIT: return hit_shader_binding_table_;
+  default: return callable_shader_binding_table_;
+  }
+}
+
+StridedDeviceAddressRegionKHR ShaderBindingTable::GetRaygenRegion(uint32_t index) const {
+  CORE_ASSERT(index < GetRecordsCount(ShaderRecordRegion::E_RAYGEN), "Raygen record index is out of range");
+  auto raygen_region = raygen_shader_binding_table_;
+  raygen_region.deviceAddress += index * raygen_region.stride;
+  return raygen_region;
+}
+
+uint32_t ShaderBindingTable::GetRecordsCount(ShaderRecordRegion region) const {
+  return records_counts_[std::to_underlying(region)];
+}
+
+uint32_t ShaderBindingTable::GetHitRecordsCount() const {
+  return GetRecordsCount(ShaderRecordRegion::E_HIT);
 }
 
 } // namespace Innsmouth
\ No newline at end of file
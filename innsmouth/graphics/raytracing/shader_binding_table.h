@@ -2,15 +2,11 @@
 #define INNSMOUTH_SHADER_BINDING_TABLE_H
 
 #include "innsmouth/graphics/buffer/buffer.h"
+#include "shader_binding_table_builder.h"
 
 namespace Innsmouth {
 
-struct ShaderGroupSpecification {
-  uint32_t raygen_ = 0;
-  uint32_t miss_ = 0;
-  uint32_t hit_ = 0;
-  uint32_t callable_ = 0;
-};
+class CommandBuffer;
 
 class ShaderBindingTable {
 public:
@@ -18,10 +14,33 @@ public:
 
   ShaderBindingTable(VkPipeline pipeline, const ShaderGroupSpecification &shader_groups);
 
+  // ONE HIT RECORD PER GEOMETRY, THE HANDLE OF hit_groups[i] FOLLOWED BY THE i-TH SLICE OF hit_data (shaderRecordEXT)
+  ShaderBindingTable(VkPipeline pipeline, const ShaderGroupSpecification &shader_groups, std::span<const uint32_t> hit_groups,
+                     std::span<const std::byte> hit_data, uint32_t hit_data_size);
+
+  template <typename T>
+  ShaderBindingTable(VkPipeline pipeline, const ShaderGroupSpecification &shader_groups, std::span<const uint32_t> hit_groups,
+                     std::span<const T> hit_data);
+
+  ShaderBindingTable(VkPipeline pipeline, const ShaderBindingTableBuilder &builder);
+
+  // RECORDED INTO THE FRAME, TRACES STILL IN FLIGHT KEEP READING THE OLD RECORD
+  void SetRecord(CommandBuffer &command_buffer, ShaderRecordRegion region, uint32_t index, uint32_t group,
+                 std::span<const std::byte> data = {});
+
+  template <typename T>
+  void SetRecord(CommandBuffer &command_buffer, ShaderRecordRegion region, uint32_t index, uint32_t group, const T &data);
+
+  const StridedDeviceAddressRegionKHR &GetRegion(ShaderRecordRegion region) const;
+  StridedDeviceAddressRegionKHR GetRaygenRegion(uint32_t index) const;
+
+  uint32_t GetRecordsCount(ShaderRecordRegion region) const;
+  uint32_t GetHitRecordsCount() const;
+
 protected:
-  void CreateShaderBindingTable(VkPipeline pipeline, const ShaderGroupSpecification &shader_groups);
+  void CreateShaderBindingTable(VkPipeline pipeline, const ShaderBindingTableBuilder &builder);
 
-  void SetTables(const ShaderGroupSpecification &shader_groups, uint32_t aligned_handle_size, uint32_t group_alignment);
+  std::vector<std::byte> GetRecordData(ShaderRecordRegion region, uint32_t group, std::span<const std::byte> data) const;
 
 public:
   Buffer sbt_buffer_;
@@ -29,8 +48,18 @@ public:
   StridedDeviceAddressRegionKHR miss_shader_binding_table_;
   StridedDeviceAddressRegionKHR hit_shader_binding_table_;
   StridedDeviceAddressRegionKHR callable_shader_binding_table_;
+
+private:
+  std::vector<std::byte> group_handles_;
+  uint32_t handle_size_{0};
+  std::array<uint32_t, SHADER_RECORD_REGIONS_COUNT> first_groups_{};
+  std::array<uint32_t, SHADER_RECORD_REGIONS_COUNT> groups_counts_{};
+  std::array<uint32_t, SHADER_RECORD_REGIONS_COUNT> records_counts_{};
+  std::array<uint32_t, SHADER_RECORD_REGIONS_COUNT> record_data_sizes_{};
 };
 
 } // namespace Innsmouth
 
+#include "shader_binding_table.ipp"
+
 #endif // INNSMOUTH_SHADER_BINDING_TABLE_H
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef INNSMOUTH_SHADER_BINDING_TABLE_IPP
+#define INNSMOUTH_SHADER_BINDING_TABLE_IPP
+
+namespace Innsmouth {
+
+template <typename T>
+ShaderBindingTable::ShaderBindingTable(VkPipeline pipeline, const ShaderGroupSpecification &shader_groups, std::span<const uint32_t> hit_groups,
+                                       std::span<const T> hit_data)
+  : ShaderBindingTable(pipeline, shader_groups, hit_groups, std::as_bytes(hit_data), sizeof(T)) {
+}
+
+template <typename T>
+void ShaderBindingTable::SetRecord(CommandBuffer &command_buffer, ShaderRecordRegion region, uint32_t index, uint32_t group, const T &data) {
+  SetRecord(command_buffer, region, index, group, std::as_bytes(std::span(&data, 1)));
+}
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_SHADER_BINDING_TABLE_IPP
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "shader_binding_table_builder.h"
+#include "innsmouth/core/include/core.h"
+#include <algorithm>
+
+namespace Innsmouth {
+
+ShaderBindingTableBuilder::ShaderBindingTableBuilder(const ShaderGroupSpecification &shader_groups) : shader_groups_(shader_groups) {
+}
+
+uint32_t ShaderBindingTableBuilder::AddRecord(ShaderRecordRegion region, uint32_t group, std::span<const std::byte> data) {
+  CORE_ASSERT(group < GetGroupsCount(region), "Shader record group is out of range");
+  auto &records = records_[std::to_underlying(region)];
+  auto &record = records.emplace_back();
+  record.group_ = group;
+  record.data_.assign(data.begin(), data.end());
+  ReserveRecordData(region, data.size());
+  return records.size() - 1;
+}
+
+void ShaderBindingTableBuilder::ReserveRecordData(ShaderRecordRegion region, uint32_t size) {
+  auto &record_data_size = record_data_sizes_[std::to_underlying(region)];
+  record_data_size = std::max(record_data_size, size);
+}
+
+const ShaderGroupSpecification &ShaderBindingTableBuilder::GetShaderGroups() const {
+  return shader_groups_;
+}
+
+uint32_t ShaderBindingTableBuilder::GetGroupsCount(ShaderRecordRegion region) const {
+  switch (region) {
+  case ShaderRecordRegion::E_RAYGEN: return shader_groups_.raygen_;
+  case ShaderRecordRegion::E_MISS: return shader_groups_.miss_;
+  case ShaderRecordRegion::E_HIT: return shader_groups_.hit_;
+  case ShaderRecordRegion::E_CALLABLE: return shader_groups_.callable_;
+  default: return 0;
+  }
+}
+
+std::span<const ShaderRecord> ShaderBindingTableBuilder::GetRecords(ShaderRecordRegion region) const {
+  return records_[std::to_underlying(region)];
+}
+
+uint32_t ShaderBindingTableBuilder::GetRecordDataSize(ShaderRecordRegion region) const {
+  return record_data_sizes_[std::to_underlying(region)];
+}
+
+} // namespace Innsmouth
\ No newline at end of file
@@ -0,0 +1,60 @@
+#ifndef INNSMOUTH_SHADER_BINDING_TABLE_BUILDER_H
+#define INNSMOUTH_SHADER_BINDING_TABLE_BUILDER_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Innsmouth {
+
+struct ShaderGroupSpecification {
+  uint32_t raygen_ = 0;
+  uint32_t miss_ = 0;
+  uint32_t hit_ = 0;
+  uint32_t callable_ = 0;
+};
+
+enum class ShaderRecordRegion : uint32_t {
+  E_RAYGEN,
+  E_MISS,
+  E_HIT,
+  E_CALLABLE,
+};
+
+constexpr uint32_t SHADER_RECORD_REGIONS_COUNT = 4;
+
+// group_ COUNTS FROM THE FIRST GROUP OF ITS REGION, data_ FOLLOWS THE HANDLE (shaderRecordEXT)
+struct ShaderRecord {
+  uint32_t group_ = 0;
+  std::vector<std::byte> data_;
+};
+
+class ShaderBindingTableBuilder {
+public:
+  ShaderBindingTableBuilder(const ShaderGroupSpecification &shader_groups);
+
+  uint32_t AddRecord(ShaderRecordRegion region, uint32_t group, std::span<const std::byte> data = {});
+
+  template <typename T> uint32_t AddRecord(ShaderRecordRegion region, uint32_t group, const T &data);
+
+  // INLINE DATA OF EVERY RECORD IN THE REGION IS PADDED TO AT LEAST size, SO LATER REWRITES CAN GROW
+  void ReserveRecordData(ShaderRecordRegion region, uint32_t size);
+
+  const ShaderGroupSpecification &GetShaderGroups() const;
+  uint32_t GetGroupsCount(ShaderRecordRegion region) const;
+  std::span<const ShaderRecord> GetRecords(ShaderRecordRegion region) const;
+  uint32_t GetRecordDataSize(ShaderRecordRegion region) const;
+
+private:
+  ShaderGroupSpecification shader_groups_;
+  std::array<std::vector<ShaderRecord>, SHADER_RECORD_REGIONS_COUNT> records_;
+  std::array<uint32_t, SHADER_RECORD_REGIONS_COUNT> record_data_sizes_{};
+};
+
+} // namespace Innsmouth
+
+#include "shader_binding_table_builder.ipp"
+
+#endif // INNSMOUTH_SHADER_BINDING_TABLE_BUILDER_H
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef INNSMOUTH_SHADER_BINDING_TABLE_BUILDER_IPP
+#define INNSMOUTH_SHADER_BINDING_TABLE_BUILDER_IPP
+
+namespace Innsmouth {
+
+template <typename T> uint32_t ShaderBindingTableBuilder::AddRecord(ShaderRecordRegion region, uint32_t group, const T &data) {
+  return AddRecord(region, group, std::as_bytes(std::span(&data, 1)));
+}
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_SHADER_BINDING_TABLE_BUILDER_IPP
\ No newline at end of file
@@ -25,7 +25,7 @@ TransformMatrixKHR ConvertTransform(const Matrix4f &matrix) {
   return out;
 }
 
-auto GetBottomLevelAccelerationStructuresAddress(VkAccelerationStructureKHR acceleration_structure) {
+VkDeviceAddress GetBottomLevelAccelerationStructuresAddress(VkAccelerationStructureKHR acceleration_structure) {
   AccelerationStructureDeviceAddressInfoKHR device_address_info;
   device_address_info.accelerationStructure = acceleration_structure;
   auto address = vkGetAccelerationStructureDeviceAddressKHR(GraphicsContext::Get()->GetDevice(), device_address_info);
@@ -41,6 +41,7 @@ auto GetInstanceVector(std::span<const BottomLevelAccelerationStructureInstances
       acceleration_structure_instance.transform = ConvertTransform(instance.transform_);
       acceleration_structure_instance.instanceCustomIndex = instance_index;
       acceleration_structure_instance.mask = 0xff;
+      acceleration_structure_instance.instanceShaderBindingTableRecordOffset = bottom_instance.shader_binding_table_offset_;
       acceleration_structure_instance.accelerationStructureReference = buffer_device_address;
       instance_vector.emplace_back(acceleration_structure_instance);
     }
@@ -48,23 +49,24 @@ auto GetInstanceVector(std::span<const BottomLevelAccelerationStructureInstances
   return instance_vector;
 }
 
-VkAccelerationStructureKHR
-AccelerationStructure::BuildAccelerationStructures(VkBuffer main_buffer, VkDeviceAddress scratch,
-                                                   const AccelerationInformation &acceleration_information,
-                                                   std::span<const BottomLevelAccelerationStructureInstances> bottom_instances) {
-  uint32_t primitive_count = GetTotalInstancesCount(bottom_instances);
-
+Buffer AccelerationStructure::CreateInstanceBuffer(std::span<const BottomLevelAccelerationStructureInstances> bottom_instances) {
   auto usage = BufferUsageMaskBits::E_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR | BufferUsageMaskBits::E_SHADER_DEVICE_ADDRESS_BIT;
-  auto size = sizeof(AccelerationStructureInstanceKHR) * primitive_count;
+  auto size = sizeof(AccelerationStructureInstanceKHR) * std::max(GetTotalInstancesCount(bottom_instances), 1u);
   Buffer instance_buffer(size, usage, Buffer::CPU);
 
   auto instance_vector = GetInstanceVector(bottom_instances);
   instance_buffer.SetData<AccelerationStructureInstanceKHR>(instance_vector);
+  return instance_buffer;
+}
 
+VkAccelerationStructureKHR
+AccelerationStructure::BuildAccelerationStructures(CommandBuffer &command_buffer, VkBuffer main_buffer, VkDeviceAddress scratch,
+                                                   const AccelerationInformation &acceleration_information, VkDeviceAddress instances,
+                                                   uint32_t instances_count) {
   std::array<AccelerationStructureGeometryKHR, 1> geometries;
   geometries[0].geometryType = GeometryTypeKHR::E_INSTANCES_KHR;
   geometries[0].geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
-  geometries[0].geometry.instances.data.deviceAddress = instance_buffer.GetBufferAddress();
+  geometries[0].geometry.instances.data.deviceAddress = instances;
 
   std::array<AccelerationStructureBuildGeometryInfoKHR, 1> geometry_bi;
 
@@ -76,14 +78,10 @@ AccelerationStructure::BuildAccelerationStructures(VkBuffer main_buffer, VkDevic
   std::array<AccelerationStructureBuildRangeInfoKHR, 1> build_ranges;
   std::array<const AccelerationStructureBuildRangeInfoKHR *, 1> build_range_pointers;
 
-  build_ranges[0].primitiveCount = primitive_count;
+  build_ranges[0].primitiveCount = instances_count;
   build_range_pointers[0] = build_ranges.data();
 
-  CommandBuffer command_buffer(GraphicsContext::Get()->GetGraphicsQueueIndex());
-  command_buffer.Begin();
   command_buffer.CommandBuildAccelerationStructure(geometry_bi, build_range_pointers);
-  command_buffer.End();
-  command_buffer.Submit();
 
   return acceleration_structure;
 }
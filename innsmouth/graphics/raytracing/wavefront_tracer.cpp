@@ -0,0 +1,378 @@
+#include "wavefront_tracer.h"
+#include "innsmouth/graphics/command/command_buffer.h"
+#include "innsmouth/graphics/descriptors/bindless_table.h"
+#include "innsmouth/graphics/synchronization/timeline_semaphore.h"
+#include "innsmouth/core/include/core.h"
+#include <algorithm>
+
+namespace Innsmouth {
+
+// SIZES AND INDICES OF shaders/ray/wavefront.glsl
+constexpr uint32_t WAVEFRONT_TILE_SIZE = 8;
+constexpr uint32_t WAVEFRONT_MATERIAL_BINS = 256;
+constexpr std::size_t WAVEFRONT_RAY_SIZE = 48;
+constexpr std::size_t WAVEFRONT_HIT_SIZE = 32;
+constexpr std::size_t WAVEFRONT_COUNTER_SIZE = 16;
+constexpr uint32_t QUEUE_RAYS = 0;
+constexpr uint32_t QUEUE_HITS = 2;
+constexpr uint32_t QUEUE_SHADOWS = 3;
+constexpr uint32_t QUEUES_COUNT = 4;
+constexpr uint32_t QUEUE_NONE = 0xffffffff;
+
+struct WavefrontConstants {
+  Vector3f camera_position;
+  uint32_t accumulated_samples;
+  uint32_t samples_per_frame;
+  uint32_t max_bounces;
+  uint32_t progressive;
+  uint32_t sample_index;
+  uint32_t bounce;
+  uint32_t queue;
+  uint32_t reset_queue;
+  uint32_t width;
+  uint32_t height;
+};
+
+struct WavefrontGenerateDescriptors {
+  DescriptorBufferInfo rays;
+  DescriptorBufferInfo shadows;
+  DescriptorBufferInfo counters;
+};
+
+struct WavefrontPrepareDescriptors {
+  DescriptorBufferInfo counters;
+  DescriptorBufferInfo bins;
+};
+
+struct WavefrontExtendDescriptors {
+  VkAccelerationStructureKHR tlas;
+  DescriptorBufferInfo rays;
+  DescriptorBufferInfo hits;
+  DescriptorBufferInfo counters;
+  DescriptorBufferInfo bins;
+  DescriptorBufferInfo radiance;
+  DescriptorBufferInfo vertices;
+  DescriptorBufferInfo indices;
+  DescriptorBufferInfo records;
+};
+
+struct WavefrontScanDescriptors {
+  DescriptorBufferInfo bins;
+};
+
+struct WavefrontScatterDescriptors {
+  DescriptorBufferInfo hits;
+  DescriptorBufferInfo sorted_hits;
+  DescriptorBufferInfo counters;
+  DescriptorBufferInfo bins;
+};
+
+struct WavefrontShadeDescriptors {
+  DescriptorBufferInfo hits;
+  DescriptorBufferInfo sorted_hits;
+  DescriptorBufferInfo rays;
+  DescriptorBufferInfo next_rays;
+  DescriptorBufferInfo shadows;
+  DescriptorBufferInfo counters;
+  DescriptorBufferInfo radiance;
+  DescriptorBufferInfo vertices;
+  DescriptorBufferInfo indices;
+  DescriptorBufferInfo records;
+  DescriptorBufferInfo instances;
+};
+
+struct WavefrontShadowDescriptors {
+  VkAccelerationStructureKHR tlas;
+  DescriptorBufferInfo shadows;
+  DescriptorBufferInfo counters;
+  DescriptorBufferInfo radiance;
+  DescriptorBufferInfo vertices;
+  DescriptorBufferInfo indices;
+  DescriptorBufferInfo records;
+};
+
+struct WavefrontResolveDescriptors {
+  DescriptorBufferInfo radiance;
+  DescriptorImageInfo target;
+};
+
+// EVERY STAGE READS WHAT THE PREVIOUS ONE WROTE, THE COUNTERS ARE ALSO READ AS DISPATCH ARGUMENTS
+void CommandWavefrontBarrier(CommandBuffer &command_buffer) {
+  command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT, AccessMaskBits2::E_SHADER_STORAGE_WRITE_BIT,
+                                      PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT | PipelineStageMaskBits2::E_DRAW_INDIRECT_BIT,
+                                      AccessMaskBits2::E_SHADER_STORAGE_READ_BIT | AccessMaskBits2::E_SHADER_STORAGE_WRITE_BIT |
+                                        AccessMaskBits2::E_INDIRECT_COMMAND_READ_BIT);
+}
+
+WavefrontTracer::WavefrontTracer(uint32_t width, uint32_t height) : width_(width), height_(height) {
+  CORE_ASSERT(width_ > 0 && height_ > 0, "Wavefront tracer needs pixels");
+  // EVERY QUEUE HOLDS AT MOST ONE ENTRY PER PIXEL, PATHS ARE TRACED ONE SAMPLE AT A TIME
+  std::size_t pixels = std::size_t(width_) * height_;
+  BufferUsageMask storage_usage = BufferUsageMaskBits::E_STORAGE_BUFFER_BIT | BufferUsageMaskBits::E_TRANSFER_DST_BIT;
+  BufferUsageMask counters_usage = storage_usage | BufferUsageMaskBits::E_INDIRECT_BUFFER_BIT;
+
+  for (auto &ray_queue : ray_queues_) {
+    ray_queue = Buffer(pixels * WAVEFRONT_RAY_SIZE, storage_usage, {});
+  }
+  hit_queue_ = Buffer(pixels * WAVEFRONT_HIT_SIZE, storage_usage, {});
+  sorted_hits_buffer_ = Buffer(pixels * sizeof(uint32_t), storage_usage, {});
+  shadow_queue_ = Buffer(pixels * WAVEFRONT_RAY_SIZE, storage_usage, {});
+  radiance_buffer_ = Buffer(pixels * sizeof(Vector4f), storage_usage, {});
+  counters_buffer_ = Buffer(QUEUES_COUNT * WAVEFRONT_COUNTER_SIZE, counters_usage, {});
+  bins_buffer_ = Buffer(WAVEFRONT_MATERIAL_BINS * sizeof(uint32_t), storage_usage, {});
+
+  auto shaders_directory = GetInnsmouthShadersDirectory() / "ray";
+  generate_pipeline_ = ComputePipeline(shaders_directory / "wavefront_generate.comp.spv");
+  prepare_pipeline_ = ComputePipeline(shaders_directory / "wavefront_prepare.comp.spv");
+  extend_pipeline_ = ComputePipeline(shaders_directory / "wavefront_extend.comp.spv");
+  scan_pipeline_ = ComputePipeline(shaders_directory / "wavefront_scan.comp.spv");
+  scatter_pipeline_ = ComputePipeline(shaders_directory / "wavefront_scatter.comp.spv");
+  shade_pipeline_ = ComputePipeline(shaders_directory / "wavefront_shade.comp.spv");
+  shadow_pipeline_ = ComputePipeline(shaders_directory / "wavefront_shadow.comp.spv");
+  resolve_pipeline_ = ComputePipeline(shaders_directory / "wavefront_resolve.comp.spv");
+
+  VkPhysicalDeviceProperties physical_device_properties{};
+  vkGetPhysicalDeviceProperties(GraphicsContext::Get()->GetPhysicalDevice(), &physical_device_properties);
+  timestamp_period_ = physical_device_properties.limits.timestampPeriod;
+}
+
+void WavefrontTracer::Record(CommandBuffer &command_buffer, const WavefrontScene &scene, const WavefrontSettings &settings,
+                             const DescriptorImageInfo &target) {
+  ReadTimestamps();
+
+  auto samples = settings.progressive_ ? settings.samples_per_frame_ : 1;
+  auto bounces = settings.progressive_ ? settings.max_bounces_ : 1;
+  auto stages_count = samples * (1 + 3 * bounces + (settings.progressive_ ? 1 : 0)) + 1;
+  auto free_timestamps = std::ranges::find(timestamps_, false, &WavefrontTimestamps::pending_);
+  current_timestamps_ = uint32_t(free_timestamps - timestamps_.begin());
+  if (free_timestamps == timestamps_.end()) timestamps_.emplace_back();
+  auto &timestamps = timestamps_[current_timestamps_];
+  if (timestamps.query_pool_ == nullptr || timestamps.query_pool_->GetQueryCount() < 2 * stages_count) {
+    if (timestamps.query_pool_ != nullptr) GraphicsContext::Get()->DeferDestruction(std::move(timestamps.query_pool_));
+    timestamps.query_pool_ = std::make_unique<QueryPool>(QueryType::E_TIMESTAMP, 2 * stages_count);
+  }
+  command_buffer.CommandResetQueryPool(timestamps.query_pool_->GetHandle(), 0, 2 * stages_count);
+  timestamps.query_stages_.clear();
+
+  WavefrontConstants constants(settings.camera_position_, settings.accumulated_samples_, samples, settings.max_bounces_,
+                               settings.progressive_ ? 1 : 0, 0, 0, QUEUE_NONE, QUEUE_NONE, width_, height_);
+
+  auto tile_groups_x = (width_ + WAVEFRONT_TILE_SIZE - 1) / WAVEFRONT_TILE_SIZE;
+  auto tile_groups_y = (height_ + WAVEFRONT_TILE_SIZE - 1) / WAVEFRONT_TILE_SIZE;
+
+  auto prepare = [&](uint32_t queue, uint32_t reset_queue) {
+    WavefrontPrepareDescriptors descriptors(counters_buffer_.GetDescriptor(), bins_buffer_.GetDescriptor());
+    constants.queue = queue;
+    constants.reset_queue = reset_queue;
+    command_buffer.CommandBindPipeline(prepare_pipeline_.GetPipeline(), PipelineBindPoint::E_COMPUTE);
+    command_buffer.CommandPushDescriptorSet(prepare_pipeline_.GetPushDescriptorTemplate(), descriptors);
+    command_buffer.CommandPushConstants(prepare_pipeline_.GetPipelineLayout(), ShaderStageMaskBits::E_COMPUTE_BIT, constants);
+    command_buffer.CommandDispatch(1);
+    CommandWavefrontBarrier(command_buffer);
+  };
+
+  auto queue_offset = [](uint32_t queue) { return queue * WAVEFRONT_COUNTER_SIZE; };
+
+  // THE LAST FRAME IS DONE WITH THE QUEUES BEFORE THEY ARE CLEARED
+  command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT | PipelineStageMaskBits2::E_DRAW_INDIRECT_BIT,
+                                      AccessMask2(), PipelineStageMaskBits2::E_ALL_TRANSFER_BIT, AccessMask2());
+  command_buffer.CommandFillBuffer(radiance_buffer_.GetHandle(), 0, radiance_buffer_.GetSize(), 0);
+
+  for (uint32_t sample = 0; sample < samples; sample++) {
+    constants.sample_index = sample;
+    constants.bounce = 0;
+
+    if (sample > 0) {
+      command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT | PipelineStageMaskBits2::E_DRAW_INDIRECT_BIT,
+                                          AccessMask2(), PipelineStageMaskBits2::E_ALL_TRANSFER_BIT, AccessMask2());
+    }
+    command_buffer.CommandFillBuffer(counters_buffer_.GetHandle(), 0, counters_buffer_.GetSize(), 0);
+    command_buffer.CommandMemoryBarrier(PipelineStageMaskBits2::E_ALL_TRANSFER_BIT, AccessMaskBits2::E_TRANSFER_WRITE_BIT,
+                                        PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT,
+                                        AccessMaskBits2::E_SHADER_STORAGE_READ_BIT | AccessMaskBits2::E_SHADER_STORAGE_WRITE_BIT);
+
+    BeginStage(command_buffer, WavefrontStage::E_GENERATE);
+    {
+      WavefrontGenerateDescriptors descriptors(ray_queues_[0].GetDescriptor(), shadow_queue_.GetDescriptor(),
+                                               counters_buffer_.GetDescriptor());
+      command_buffer.CommandBindPipeline(generate_pipeline_.GetPipeline(), PipelineBindPoint::E_COMPUTE);
+      command_buffer.CommandPushDescriptorSet(generate_pipeline_.GetPushDescriptorTemplate(), descriptors);
+      command_buffer.CommandPushConstants(generate_pipeline_.GetPipelineLayout(), ShaderStageMaskBits::E_COMPUTE_BIT, constants);
+      command_buffer.CommandDispatch(tile_groups_x, tile_groups_y);
+      CommandWavefrontBarrier(command_buffer);
+    }
+    EndStage(command_buffer);
+
+    for (uint32_t bounce = 0; bounce < bounces; bounce++) {
+      auto current = bounce % 2;
+      auto next = (bounce + 1) % 2;
+      constants.bounce = bounce;
+
+      BeginStage(command_buffer, WavefrontStage::E_EXTEND);
+      {
+        prepare(QUEUE_RAYS + current, QUEUE_HITS);
+        WavefrontExtendDescriptors descriptors(scene.tlas_, ray_queues_[current].GetDescriptor(), hit_queue_.GetDescriptor(),
+                                               counters_buffer_.GetDescriptor(), bins_buffer_.GetDescriptor(),
+                                               radiance_buffer_.GetDescriptor(), scene.vertices_, scene.indices_, scene.geometry_records_);
+        command_buffer.CommandBindPipeline(extend_pipeline_.GetPipeline(), PipelineBindPoint::E_COMPUTE);
+        command_buffer.CommandPushDescriptorSet(extend_pipeline_.GetPushDescriptorTemplate(), descriptors);
+        BindlessTable::Get()->CommandBind(command_buffer, extend_pipeline_.GetPipelineLayout(), PipelineBindPoint::E_COMPUTE);
+        command_buffer.CommandPushConstants(extend_pipeline_.GetPipelineLayout(), ShaderStageMaskBits::E_COMPUTE_BIT, constants);
+        command_buffer.CommandDispatchIndirect(counters_buffer_.GetHandle(), queue_offset(QUEUE_RAYS + current));
+        CommandWavefrontBarrier(command_buffer);
+      }
+      EndStage(command_buffer);
+
+      // COUNTING SORT OF THE HITS BY MATERIAL, NEIGHBOURING INVOCATIONS OF THE SHADE PASS READ THE SAME MESH
+      BeginStage(command_buffer, WavefrontStage::E_SORT);
+      {
+        prepare(QUEUE_HITS, QUEUE_RAYS + next);
+        WavefrontScanDescriptors scan_descriptors(bins_buffer_.GetDescriptor());
+        command_buffer.CommandBindPipeline(scan_pipeline_.GetPipeline(), PipelineBindPoint::E_COMPUTE);
+        command_buffer.CommandPushDescriptorSet(scan_pipeline_.GetPushDescriptorTemplate(), scan_descriptors);
+        command_buffer.CommandDispatch(1);
+        CommandWavefrontBarrier(command_buffer);
+
+        WavefrontScatterDescriptors scatter_descriptors(hit_queue_.GetDescriptor(), sorted_hits_buffer_.GetDescriptor(),
+                                                        counters_buffer_.GetDescriptor(), bins_buffer_.GetDescriptor());
+        command_buffer.CommandBindPipeline(scatter_pipeline_.GetPipeline(), PipelineBindPoint::E_COMPUTE);
+        command_buffer.CommandPushDescriptorSet(scatter_pipeline_.GetPushDescriptorTemplate(), scatter_descriptors);
+        command_buffer.CommandPushConstants(scatter_pipeline_.GetPipelineLayout(), ShaderStageMaskBits::E_COMPUTE_BIT, constants);
+        command_buffer.CommandDispatchIndirect(counters_buffer_.GetHandle(), queue_offset(QUEUE_HITS));
+        CommandWavefrontBarrier(command_buffer);
+      }
+      EndStage(command_buffer);
+
+      BeginStage(command_buffer, WavefrontStage::E_SHADE);
+      {
+        WavefrontShadeDescriptors descriptors(hit_queue_.GetDescriptor(), sorted_hits_buffer_.GetDescriptor(),
+                                              ray_queues_[current].GetDescriptor(), ray_queues_[next].GetDescriptor(),
+                                              shadow_queue_.GetDescriptor(), counters_buffer_.GetDescriptor(),
+                                              radiance_buffer_.GetDescriptor(), scene.vertices_, scene.indices_, scene.geometry_records_,
+                                              scene.instances_);
+        command_buffer.CommandBindPipeline(shade_pipeline_.GetPipeline(), PipelineBindPoint::E_COMPUTE);
+        command_buffer.CommandPushDescriptorSet(shade_pipeline_.GetPushDescriptorTemplate(), descriptors);
+        command_buffer.CommandPushConstants(shade_pipeline_.GetPipelineLayout(), ShaderStageMaskBits::E_COMPUTE_BIT, constants);
+        command_buffer.CommandDispatchIndirect(counters_buffer_.GetHandle(), queue_offset(QUEUE_HITS));
+        CommandWavefrontBarrier(command_buffer);
+      }
+      EndStage(command_buffer);
+    }
+
+    if (settings.progressive_ == false) continue;
+
+    BeginStage(command_buffer, WavefrontStage::E_SHADOW);
+    {
+      prepare(QUEUE_SHADOWS, QUEUE_NONE);
+      WavefrontShadowDescriptors descriptors(scene.tlas_, shadow_queue_.GetDescriptor(), counters_buffer_.GetDescriptor(),
+                                             radiance_buffer_.GetDescriptor(), scene.vertices_, scene.indices_, scene.geometry_records_);
+      command_buffer.CommandBindPipeline(shadow_pipeline_.GetPipeline(), PipelineBindPoint::E_COMPUTE);
+      command_buffer.CommandPushDescriptorSet(shadow_pipeline_.GetPushDescriptorTemplate(), descriptors);
+      BindlessTable::Get()->CommandBind(command_buffer, shadow_pipeline_.GetPipelineLayout(), PipelineBindPoint::E_COMPUTE);
+      command_buffer.CommandPushConstants(shadow_pipeline_.GetPipelineLayout(), ShaderStageMaskBits::E_COMPUTE_BIT, constants);
+      command_buffer.CommandDispatchIndirect(counters_buffer_.GetHandle(), queue_offset(QUEUE_SHADOWS));
+      CommandWavefrontBarrier(command_buffer);
+    }
+    EndStage(command_buffer);
+  }
+
+  BeginStage(command_buffer, WavefrontStage::E_RESOLVE);
+  {
+    WavefrontResolveDescriptors descriptors(radiance_buffer_.GetDescriptor(), target);
+    command_buffer.CommandBindPipeline(resolve_pipeline_.GetPipeline(), PipelineBindPoint::E_COMPUTE);
+    command_buffer.CommandPushDescriptorSet(resolve_pipeline_.GetPushDescriptorTemplate(), descriptors);
+    command_buffer.CommandPushConstants(resolve_pipeline_.GetPipelineLayout(), ShaderStageMaskBits::E_COMPUTE_BIT, constants);
+    command_buffer.CommandDispatch(tile_groups_x, tile_groups_y);
+  }
+  EndStage(command_buffer);
+
+  timestamps.frame_value_ = GraphicsContext::Get()->GetGraphicsTimeline().GetNextValue();
+  timestamps.pending_ = true;
+}
+
+void WavefrontTracer::BeginStage(CommandBuffer &command_buffer, WavefrontStage stage) {
+  auto &timestamps = timestamps_[current_timestamps_];
+  auto query = uint32_t(2 * timestamps.query_stages_.size());
+  command_buffer.CommandWriteTimestamp(PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT, timestamps.query_pool_->GetHandle(), query);
+  timestamps.query_stages_.emplace_back(stage);
+}
+
+void WavefrontTracer::EndStage(CommandBuffer &command_buffer) {
+  auto &timestamps = timestamps_[current_timestamps_];
+  auto query = uint32_t(2 * timestamps.query_stages_.size() - 1);
+  command_buffer.CommandWriteTimestamp(PipelineStageMaskBits2::E_COMPUTE_SHADER_BIT, timestamps.query_pool_->GetHandle(), query);
+}
+
+void WavefrontTracer::ReadTimestamps() {
+  auto retired_value = GraphicsContext::Get()->GetRetiredFrameValue();
+  for (auto &timestamps : timestamps_) {
+    if (timestamps.pending_ == false || timestamps.frame_value_ > retired_value) continue;
+    timestamps.pending_ = false;
+    // SEVERAL RECORDS CAN RETIRE TOGETHER, ONLY THE NEWEST ONE IS SHOWN
+    if (timestamps.frame_value_ < stage_milliseconds_value_) continue;
+    auto results = timestamps.query_pool_->GetResults(0, 2 * timestamps.query_stages_.size());
+    stage_milliseconds_.fill(0.0f);
+    for (auto i = 0; i < timestamps.query_stages_.size(); i++) {
+      auto ticks = results[2 * i + 1] - results[2 * i];
+      stage_milliseconds_[static_cast<uint32_t>(timestamps.query_stages_[i])] += ticks * timestamp_period_ / 1'000'000.0f;
+    }
+    stage_milliseconds_value_ = timestamps.frame_value_;
+  }
+}
+
+const std::array<float, WAVEFRONT_STAGES_COUNT> &WavefrontTracer::GetStageMilliseconds() const {
+  return stage_milliseconds_;
+}
+
+WavefrontTracer::WavefrontTracer(WavefrontTracer &&other) noexcept {
+  width_ = std::exchange(other.width_, 0);
+  height_ = std::exchange(other.height_, 0);
+  ray_queues_ = std::move(other.ray_queues_);
+  hit_queue_ = std::move(other.hit_queue_);
+  sorted_hits_buffer_ = std::move(other.sorted_hits_buffer_);
+  shadow_queue_ = std::move(other.shadow_queue_);
+  radiance_buffer_ = std::move(other.radiance_buffer_);
+  counters_buffer_ = std::move(other.counters_buffer_);
+  bins_buffer_ = std::move(other.bins_buffer_);
+  generate_pipeline_ = std::move(other.generate_pipeline_);
+  prepare_pipeline_ = std::move(other.prepare_pipeline_);
+  extend_pipeline_ = std::move(other.extend_pipeline_);
+  scan_pipeline_ = std::move(other.scan_pipeline_);
+  scatter_pipeline_ = std::move(other.scatter_pipeline_);
+  shade_pipeline_ = std::move(other.shade_pipeline_);
+  shadow_pipeline_ = std::move(other.shadow_pipeline_);
+  resolve_pipeline_ = std::move(other.resolve_pipeline_);
+  timestamps_ = std::move(other.timestamps_);
+  current_timestamps_ = std::exchange(other.current_timestamps_, 0);
+  stage_milliseconds_value_ = std::exchange(other.stage_milliseconds_value_, 0);
+  stage_milliseconds_ = std::exchange(other.stage_milliseconds_, {});
+  timestamp_period_ = std::exchange(other.timestamp_period_, 0.0f);
+}
+
+WavefrontTracer &WavefrontTracer::operator=(WavefrontTracer &&other) noexcept {
+  std::swap(width_, other.width_);
+  std::swap(height_, other.height_);
+  std::swap(ray_queues_, other.ray_queues_);
+  std::swap(hit_queue_, other.hit_queue_);
+  std::swap(sorted_hits_buffer_, other.sorted_hits_buffer_);
+  std::swap(shadow_queue_, other.shadow_queue_);
+  std::swap(radiance_buffer_, other.radiance_buffer_);
+  std::swap(counters_buffer_, other.counters_buffer_);
+  std::swap(bins_buffer_, other.bins_buffer_);
+  std::swap(generate_pipeline_, other.generate_pipeline_);
+  std::swap(prepare_pipeline_, other.prepare_pipeline_);
+  std::swap(extend_pipeline_, other.extend_pipeline_);
+  std::swap(scan_pipeline_, other.scan_pipeline_);
+  std::swap(scatter_pipeline_, other.scatter_pipeline_);
+  std::swap(shade_pipeline_, other.shade_pipeline_);
+  std::swap(shadow_pipeline_, other.shadow_pipeline_);
+  std::swap(resolve_pipeline_, other.resolve_pipeline_);
+  std::swap(timestamps_, other.timestamps_);
+  std::swap(current_timestamps_, other.current_timestamps_);
+  std::swap(stage_milliseconds_value_, other.stage_milliseconds_value_);
+  std::swap(stage_milliseconds_, other.stage_milliseconds_);
+  std::swap(timestamp_period_, other.timestamp_period_);
+  return *this;
+}
+
+} // namespace Innsmouth
\ No newline at end of file
@@ -0,0 +1,103 @@
+#ifndef INNSMOUTH_WAVEFRONT_TRACER_H
+#define INNSMOUTH_WAVEFRONT_TRACER_H
+
+#include "innsmouth/graphics/buffer/buffer.h"
+#include "innsmouth/graphics/command/query_pool.h"
+#include "innsmouth/graphics/pipeline/compute_pipeline.h"
+#include <array>
+#include <memory>
+
+namespace Innsmouth {
+
+class CommandBuffer;
+
+enum class WavefrontStage : uint32_t {
+  E_GENERATE,
+  E_EXTEND,
+  E_SORT,
+  E_SHADE,
+  E_SHADOW,
+  E_RESOLVE,
+};
+
+constexpr uint32_t WAVEFRONT_STAGES_COUNT = 6;
+
+// WHAT THE RAY TRACING PIPELINE GETS FROM ITS DESCRIPTORS AND THE SHADER BINDING TABLE
+struct WavefrontScene {
+  VkAccelerationStructureKHR tlas_{VK_NULL_HANDLE};
+  DescriptorBufferInfo instances_; // AccelerationStructureInstanceKHR THE TOP LEVEL STRUCTURE WAS BUILT FROM
+  DescriptorBufferInfo vertices_;
+  DescriptorBufferInfo indices_;
+  DescriptorBufferInfo geometry_records_; // ONE PER HIT RECORD, IN SHADER BINDING TABLE ORDER
+};
+
+struct WavefrontSettings {
+  Vector3f camera_position_{0.0f};
+  uint32_t accumulated_samples_ = 0;
+  uint32_t samples_per_frame_ = 1;
+  uint32_t max_bounces_ = 4;
+  bool progressive_ = true;
+};
+
+// THE TIMESTAMPS OF ONE RECORD, READ ONLY ONCE THE FRAME THAT WROTE THEM RETIRED SO READING NEVER WAITS
+struct WavefrontTimestamps {
+  std::unique_ptr<QueryPool> query_pool_;
+  std::vector<WavefrontStage> query_stages_;
+  uint64_t frame_value_ = 0;
+  bool pending_ = false;
+};
+
+// PATH TRACING WITH RAY QUERIES IN COMPUTE, EVERY STAGE IS ITS OWN DISPATCH OVER QUEUES IN STORAGE BUFFERS
+class WavefrontTracer {
+public:
+  WavefrontTracer() = default;
+
+  WavefrontTracer(uint32_t width, uint32_t height);
+
+  ~WavefrontTracer() = default;
+
+  WavefrontTracer(const WavefrontTracer &) = delete;
+  WavefrontTracer &operator=(const WavefrontTracer &) = delete;
+
+  WavefrontTracer(WavefrontTracer &&other) noexcept;
+  WavefrontTracer &operator=(WavefrontTracer &&other) noexcept;
+
+  // TARGET IS AN RGBA32F STORAGE IMAGE IN THE GENERAL LAYOUT, WRITES TO THE SCENE BUFFERS MUST BE VISIBLE TO COMPUTE
+  void Record(CommandBuffer &command_buffer, const WavefrontScene &scene, const WavefrontSettings &settings,
+              const DescriptorImageInfo &target);
+
+  // TIMINGS OF THE LAST RECORD WHOSE FRAME RETIRED
+  const std::array<float, WAVEFRONT_STAGES_COUNT> &GetStageMilliseconds() const;
+
+private:
+  void ReadTimestamps();
+  void BeginStage(CommandBuffer &command_buffer, WavefrontStage stage);
+  void EndStage(CommandBuffer &command_buffer);
+
+  uint32_t width_ = 0;
+  uint32_t height_ = 0;
+  std::array<Buffer, 2> ray_queues_;
+  Buffer hit_queue_;
+  Buffer sorted_hits_buffer_;
+  Buffer shadow_queue_;
+  Buffer radiance_buffer_;
+  Buffer counters_buffer_;
+  Buffer bins_buffer_;
+  ComputePipeline generate_pipeline_;
+  ComputePipeline prepare_pipeline_;
+  ComputePipeline extend_pipeline_;
+  ComputePipeline scan_pipeline_;
+  ComputePipeline scatter_pipeline_;
+  ComputePipeline shade_pipeline_;
+  ComputePipeline shadow_pipeline_;
+  ComputePipeline resolve_pipeline_;
+  std::vector<WavefrontTimestamps> timestamps_; // ONE PER FRAME IN FLIGHT
+  uint32_t current_timestamps_ = 0;
+  uint64_t stage_milliseconds_value_ = 0;
+  std::array<float, WAVEFRONT_STAGES_COUNT> stage_milliseconds_{};
+  float timestamp_period_ = 0.0f;
+};
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_WAVEFRONT_TRACER_H
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "deletion_queue.h"
+
+namespace Innsmouth {
+
+void DeletionQueue::Push(uint64_t timeline_value, Deleter &&deleter) {
+  std::lock_guard lock(mutex_);
+  pending_deleters_.emplace_back(timeline_value, std::move(deleter));
+}
+
+void DeletionQueue::Retire(uint64_t completed_value) {
+  std::vector<Deleter> retired_deleters;
+  {
+    std::lock_guard lock(mutex_);
+    while (pending_deleters_.empty() == false && pending_deleters_.front().timeline_value_ <= completed_value) {
+      retired_deleters.emplace_back(std::move(pending_deleters_.front().deleter_));
+      pending_deleters_.pop_front();
+    }
+  }
+  for (auto &deleter : retired_deleters) {
+    deleter();
+  }
+}
+
+void DeletionQueue::Flush() {
+  while (true) {
+    std::deque<PendingDeleter> pending_deleters;
+    {
+      std::lock_guard lock(mutex_);
+      if (pending_deleters_.empty()) return;
+      std::swap(pending_deleters, pending_deleters_);
+    }
+    for (auto &pending_deleter : pending_deleters) {
+      pending_deleter.deleter_();
+    }
+  }
+}
+
+std::size_t DeletionQueue::GetSize() const {
+  std::lock_guard lock(mutex_);
+  return pending_deleters_.size();
+}
+
+} // namespace Innsmouth
@@ -0,0 +1,37 @@
+#ifndef INNSMOUTH_DELETION_QUEUE_H
+#define INNSMOUTH_DELETION_QUEUE_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Innsmouth {
+
+// WORKER THREADS PUSH TOO, DELETERS RUN OUTSIDE THE LOCK AND MAY PUSH MORE DELETERS
+class DeletionQueue {
+public:
+  using Deleter = std::function<void()>;
+
+  void Push(uint64_t timeline_value, Deleter &&deleter);
+
+  void Retire(uint64_t completed_value);
+
+  void Flush();
+
+  std::size_t GetSize() const;
+
+private:
+  struct PendingDeleter {
+    uint64_t timeline_value_;
+    Deleter deleter_;
+  };
+
+  std::deque<PendingDeleter> pending_deleters_;
+  mutable std::mutex mutex_;
+};
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_DELETION_QUEUE_H
@@ -20,4 +20,11 @@ Semaphore &Semaphore::operator=(Semaphore &&other) noexcept {
   return *this;
 }
 
+SemaphoreSubmitInfo Semaphore::GetSubmitInfo(PipelineStageMask2 stage) const {
+  SemaphoreSubmitInfo semaphore_submit_info;
+  semaphore_submit_info.semaphore = semaphore_;
+  semaphore_submit_info.stageMask = stage;
+  return semaphore_submit_info;
+}
+
 } // namespace Innsmouth
\ No newline at end of file
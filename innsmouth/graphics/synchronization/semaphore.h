@@ -25,6 +25,8 @@ public:
     return &semaphore_;
   }
 
+  SemaphoreSubmitInfo GetSubmitInfo(PipelineStageMask2 stage) const;
+
 private:
   VkSemaphore semaphore_{VK_NULL_HANDLE};
 };
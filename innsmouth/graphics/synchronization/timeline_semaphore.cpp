@@ -0,0 +1,83 @@
+#include "timeline_semaphore.h"
+#include <algorithm>
+#include <utility>
+
+namespace Innsmouth {
+
+TimelineSemaphore::TimelineSemaphore(uint64_t initial_value) : pending_value_(initial_value) {
+  SemaphoreTypeCreateInfo semaphore_type_ci;
+  semaphore_type_ci.semaphoreType = SemaphoreType::E_TIMELINE;
+  semaphore_type_ci.initialValue = initial_value;
+
+  SemaphoreCreateInfo semaphore_ci;
+  semaphore_ci.pNext = &semaphore_type_ci;
+
+  VK_CHECK(vkCreateSemaphore(GraphicsContext::Get()->GetDevice(), semaphore_ci, nullptr, &semaphore_));
+}
+
+TimelineSemaphore::~TimelineSemaphore() {
+  vkDestroySemaphore(GraphicsContext::Get()->GetDevice(), semaphore_, nullptr);
+}
+
+TimelineSemaphore::TimelineSemaphore(TimelineSemaphore &&other) noexcept {
+  semaphore_ = std::exchange(other.semaphore_, VK_NULL_HANDLE);
+  pending_value_ = std::exchange(other.pending_value_, 0);
+}
+
+TimelineSemaphore &TimelineSemaphore::operator=(TimelineSemaphore &&other) noexcept {
+  std::swap(semaphore_, other.semaphore_);
+  std::swap(pending_value_, other.pending_value_);
+  return *this;
+}
+
+uint64_t TimelineSemaphore::GetValue() const {
+  uint64_t value = 0;
+  VK_CHECK(vkGetSemaphoreCounterValue(GraphicsContext::Get()->GetDevice(), semaphore_, &value));
+  return value;
+}
+
+uint64_t TimelineSemaphore::GetPendingValue() const {
+  return pending_value_;
+}
+
+uint64_t TimelineSemaphore::GetNextValue() const {
+  return pending_value_ + 1;
+}
+
+uint64_t TimelineSemaphore::AdvancePendingValue() {
+  return ++pending_value_;
+}
+
+bool TimelineSemaphore::IsCompleted(uint64_t value) const {
+  return GetValue() >= value;
+}
+
+void TimelineSemaphore::Wait(uint64_t value, uint64_t timeout) const {
+  SemaphoreWaitInfo semaphore_wi;
+  semaphore_wi.semaphoreCount = 1;
+  semaphore_wi.pSemaphores = &semaphore_;
+  semaphore_wi.pValues = &value;
+  VK_CHECK(vkWaitSemaphores(GraphicsContext::Get()->GetDevice(), semaphore_wi, timeout));
+}
+
+void TimelineSemaphore::Signal(uint64_t value) {
+  SemaphoreSignalInfo semaphore_si;
+  semaphore_si.semaphore = semaphore_;
+  semaphore_si.value = value;
+  VK_CHECK(vkSignalSemaphore(GraphicsContext::Get()->GetDevice(), semaphore_si));
+  pending_value_ = std::max(pending_value_, value);
+}
+
+SemaphoreSubmitInfo TimelineSemaphore::GetSubmitInfo(uint64_t value, PipelineStageMask2 stage) const {
+  SemaphoreSubmitInfo semaphore_submit_info;
+  semaphore_submit_info.semaphore = semaphore_;
+  semaphore_submit_info.value = value;
+  semaphore_submit_info.stageMask = stage;
+  return semaphore_submit_info;
+}
+
+VkSemaphore TimelineSemaphore::GetHandle() const {
+  return semaphore_;
+}
+
+} // namespace Innsmouth
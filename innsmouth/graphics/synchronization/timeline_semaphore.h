@@ -0,0 +1,43 @@
+#ifndef INNSMOUTH_TIMELINE_SEMAPHORE_H
+#define INNSMOUTH_TIMELINE_SEMAPHORE_H
+
+#include "innsmouth/graphics/graphics_context/graphics_context.h"
+
+namespace Innsmouth {
+
+class TimelineSemaphore {
+public:
+  TimelineSemaphore(uint64_t initial_value = 0);
+
+  ~TimelineSemaphore();
+
+  TimelineSemaphore(const TimelineSemaphore &) = delete;
+  TimelineSemaphore &operator=(const TimelineSemaphore &) = delete;
+
+  TimelineSemaphore(TimelineSemaphore &&other) noexcept;
+  TimelineSemaphore &operator=(TimelineSemaphore &&other) noexcept;
+
+  uint64_t GetValue() const;
+  uint64_t GetPendingValue() const;
+  // SIGNALED BY THE NEXT SUBMIT, THE FRAME BEING RECORDED WHEN NOTHING ELSE IS SUBMITTED BEFORE IT
+  uint64_t GetNextValue() const;
+
+  uint64_t AdvancePendingValue();
+
+  bool IsCompleted(uint64_t value) const;
+
+  void Wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+  void Signal(uint64_t value);
+
+  SemaphoreSubmitInfo GetSubmitInfo(uint64_t value, PipelineStageMask2 stage = PipelineStageMaskBits2::E_ALL_COMMANDS_BIT) const;
+
+  VkSemaphore GetHandle() const;
+
+private:
+  VkSemaphore semaphore_{VK_NULL_HANDLE};
+  uint64_t pending_value_{0};
+};
+
+} // namespace Innsmouth
+
+#endif // INNSMOUTH_TIMELINE_SEMAPHORE_H
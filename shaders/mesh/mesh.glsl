@@ -0,0 +1,59 @@
+#ifndef MESH_GLSL
+#define MESH_GLSL
+
+// COUNTS THE BASE LEVEL, lods[0] IS THE FULL MESH
+#define MESH_MAX_LODS 4
+
+struct MeshLod {
+  uint indices_offset;
+  uint indices_size;
+  float error;
+};
+
+struct Primitive {
+  int color_texture_index;
+  int normal_texture_index;
+  uint vertices_offset;
+  uint indices_offset;
+  uint indices_size;
+  float position_offset[3];
+  float position_scale[3];
+  float center[3];
+  float radius;
+  uint lods_count;
+  MeshLod lods[MESH_MAX_LODS];
+  uint instances_offset;
+  uint instances_count;
+  float alpha_cutoff;
+};
+
+struct PackedVertex {
+  uint position_xy;
+  uint position_zw;
+  uint normal;
+  uint uv;
+};
+
+vec3 DecodeOctahedral(vec2 encoded) {
+  vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+  float t = max(-normal.z, 0.0);
+  normal.xy += vec2(normal.x >= 0.0 ? -t : t, normal.y >= 0.0 ? -t : t);
+  return normalize(normal);
+}
+
+vec3 DecodePosition(PackedVertex vertex, Primitive primitive) {
+  vec3 position = vec3(unpackUnorm2x16(vertex.position_xy), unpackUnorm2x16(vertex.position_zw).x);
+  vec3 offset = vec3(primitive.position_offset[0], primitive.position_offset[1], primitive.position_offset[2]);
+  vec3 scale = vec3(primitive.position_scale[0], primitive.position_scale[1], primitive.position_scale[2]);
+  return offset + position * scale;
+}
+
+vec3 DecodeNormal(PackedVertex vertex) {
+  return DecodeOctahedral(unpackSnorm2x16(vertex.normal));
+}
+
+vec2 DecodeUV(PackedVertex vertex) {
+  return unpackHalf2x16(vertex.uv);
+}
+
+#endif // MESH_GLSL
\ No newline at end of file
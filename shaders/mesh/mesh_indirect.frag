@@ -1,22 +1,36 @@
 #version 460
 
 #extension GL_EXT_nonuniform_qualifier : require
-#extension GL_EXT_ray_query : require
-
-struct Primitive {
-  int color_texture_index;
-  int normal_texture_index;
-  uint vertices_offset;
-  uint indices_offset;
-  uint indices_size;
-};
+#extension GL_GOOGLE_include_directive : require
+
+#include "mesh.glsl"
 
-layout (binding = 1, set = 0) uniform accelerationStructureEXT tlas;
+layout (push_constant) uniform PushConstants {
+  vec2 inverse_visibility_size; // ONE OVER THE VISIBILITY EXTENT IN FULL RESOLUTION PIXELS
+} pc;
+
+// SHADOW, AO
+layout (binding = 1, set = 0) uniform sampler2D visibility_texture;
 
 layout (binding = 2, set = 0) readonly buffer Primitives {
 	Primitive primitives[];
 };
 
+layout (binding = 4, set = 0) readonly buffer TextureSlots {
+	uint texture_slots[];
+};
+
+// MATRICES DO NOT FIT THE 128 BYTES OF PUSH CONSTANTS EVERY DEVICE GUARANTEES
+layout (binding = 5, set = 0) readonly buffer Camera {
+  mat4 projection;
+  mat4 view;
+  mat4 model;
+  mat4 inverse_view_projection;
+  mat4 previous_view_projection;
+  vec4 camera_position;
+  vec4 light;             // XYZ POSITION, W RADIUS
+} camera;
+
 layout (binding = 0, set = 1) uniform sampler2D textures[];
 
 // INPUT
@@ -28,29 +42,46 @@ layout (location = 3) in flat uint in_draw_id;
 // OUTPUT
 layout (location = 0) out vec4 out_color;
 
+// NO TANGENTS IN THE PACKED VERTEX, THE FRAME COMES FROM SCREEN SPACE DERIVATIVES OF POSITION AND UV
+vec3 PerturbNormal(vec3 normal, vec3 position, vec2 uv, vec2 encoded) {
+  vec3 dp_dx = dFdx(position);
+  vec3 dp_dy = dFdy(position);
+  vec2 duv_dx = dFdx(uv);
+  vec2 duv_dy = dFdy(uv);
+  vec3 dp_dy_perp = cross(dp_dy, normal);
+  vec3 dp_dx_perp = cross(normal, dp_dx);
+  vec3 tangent = dp_dy_perp * duv_dx.x + dp_dx_perp * duv_dy.x;
+  vec3 bitangent = dp_dy_perp * duv_dx.y + dp_dx_perp * duv_dy.y;
+  float scale = inversesqrt(max(max(dot(tangent, tangent), dot(bitangent, bitangent)), 1e-20));
+  // Z IS RECONSTRUCTED, THE SAME TWO CHANNELS E_RG8_NORMAL KEEPS
+  vec2 xy = encoded * 2.0 - 1.0;
+  vec3 tangent_normal = vec3(xy, sqrt(max(1.0 - dot(xy, xy), 0.0)));
+  return normalize(mat3(tangent * scale, bitangent * scale, normal) * tangent_normal);
+}
+
 void main() {
 
   Primitive primitive = primitives[nonuniformEXT(in_draw_id)];
 
-  vec4 ambient = texture(textures[primitive.color_texture_index], in_uv);
-
-  vec3 normal_texture = vec3(0.0);
+  vec4 ambient = vec4(1.0);
+  if (primitive.color_texture_index >= 0) {
+    ambient = texture(textures[nonuniformEXT(texture_slots[primitive.color_texture_index])], in_uv);
+  }
 
-  vec3 normal = in_normal;
+  vec3 normal = normalize(in_normal);
+  if (primitive.normal_texture_index >= 0) {
+    vec2 encoded = texture(textures[nonuniformEXT(texture_slots[primitive.normal_texture_index])], in_uv).xy;
+    normal = PerturbNormal(normal, in_position, in_uv, encoded);
+  }
 
-  vec3 flash = vec3(0.0, 500.0, 0.0);
-  vec3 sun = normalize(flash - in_position);
-  float steps = distance(flash, in_position);
+  vec2 visibility = texture(visibility_texture, gl_FragCoord.xy * pc.inverse_visibility_size).xy;
 
-  rayQueryEXT rq;
-	rayQueryInitializeEXT(rq, tlas, gl_RayFlagsTerminateOnFirstHitEXT, 0xff, in_position, 0.1f, sun, steps + 1.0);
-	rayQueryProceedEXT(rq);
+  vec3 sun = normalize(camera.light.xyz - in_position);
 
   float NdotL = clamp(dot(sun, normal), 0.0, 1.0);
-  bool hit = rayQueryGetIntersectionTypeEXT(rq, true) == gl_RayQueryCommittedIntersectionNoneEXT;
-  NdotL *= hit ? 1.0 : 0.01;
+  NdotL *= mix(0.01, 1.0, visibility.x);
 
-  vec3 color = 0.5 * ambient.rgb + vec3(0.4, 0.4, 0.1) * NdotL;
+  vec3 color = 0.5 * ambient.rgb * visibility.y + vec3(0.4, 0.4, 0.1) * NdotL;
 
   out_color = vec4(color, 1.0);
 }
\ No newline at end of file
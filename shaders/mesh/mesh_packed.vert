@@ -0,0 +1,53 @@
+#version 460
+#extension GL_ARB_shader_draw_parameters: require
+#extension GL_GOOGLE_include_directive : require
+
+#include "mesh.glsl"
+
+layout (binding = 0, set = 0) readonly buffer Vertices {
+	PackedVertex vertices[];
+};
+
+layout (binding = 2, set = 0) readonly buffer Primitives {
+	Primitive primitives[];
+};
+
+layout (binding = 3, set = 0) readonly buffer Instances {
+	mat4 instance_transforms[];
+};
+
+// MATRICES DO NOT FIT THE 128 BYTES OF PUSH CONSTANTS EVERY DEVICE GUARANTEES
+layout (binding = 5, set = 0) readonly buffer Camera {
+  mat4 projection;
+  mat4 view;
+  mat4 model;
+  mat4 inverse_view_projection;
+  mat4 previous_view_projection;
+  vec4 camera_position;
+  vec4 light;             // XYZ POSITION, W RADIUS
+} camera;
+
+// OUTPUT
+layout (location = 0) out vec3 out_position;
+layout (location = 1) out vec3 out_normal;
+layout (location = 2) out vec2 out_uv;
+layout (location = 3) out flat uint out_drawid;
+
+// DEPTH PREPASS AND SHADING MUST PRODUCE BITWISE EQUAL DEPTH
+invariant gl_Position;
+
+void main() {
+	PackedVertex vertex = vertices[gl_VertexIndex];
+
+	vec3 position = DecodePosition(vertex, primitives[gl_DrawIDARB]);
+	vec3 normal = DecodeNormal(vertex);
+
+	mat4 model = camera.model * instance_transforms[gl_InstanceIndex];
+
+	out_position = vec3(model * vec4(position, 1.0));
+	out_normal = mat3(transpose(inverse(model))) * normal;
+	out_uv = DecodeUV(vertex);
+	out_drawid = gl_DrawIDARB;
+
+  gl_Position = camera.projection * camera.view * model * vec4(position, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#version 460
+
+// INPUT
+layout (location = 0) in vec3 in_position;
+layout (location = 1) in vec3 in_normal;
+layout (location = 2) in flat uint in_meshlet;
+
+// OUTPUT
+layout (location = 0) out vec4 out_color;
+
+vec3 GetMeshletColor(uint meshlet_index) {
+  uint hash = meshlet_index * 2654435761u;
+  return vec3(hash & 0xff, (hash >> 8) & 0xff, (hash >> 16) & 0xff) / 255.0;
+}
+
+void main() {
+  vec3 sun = normalize(vec3(0.3, 1.0, 0.2));
+  float NdotL = clamp(dot(normalize(in_normal), sun), 0.0, 1.0);
+  vec3 color = GetMeshletColor(in_meshlet) * (0.2 + 0.8 * NdotL);
+  out_color = vec4(color, 1.0);
+}
\ No newline at end of file
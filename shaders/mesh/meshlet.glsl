@@ -0,0 +1,61 @@
+#ifndef MESHLET_GLSL
+#define MESHLET_GLSL
+
+#define MESHLET_MAX_VERTICES 64
+#define MESHLET_MAX_TRIANGLES 124
+#define MESHLET_TASK_GROUP_SIZE 32
+#define MESHLET_MESH_GROUP_SIZE 32
+
+struct Vertex {
+	float px, py, pz;
+	float nx, ny, nz;
+	float uvx, uvy;
+};
+
+struct Meshlet {
+  vec3 center;
+  float radius;
+  vec3 cone_axis;
+  float cone_cutoff;
+  uint vertices_offset;
+  uint triangles_offset;
+  uint vertices_count;
+  uint triangles_count;
+};
+
+struct MeshletPayload {
+  uint meshlets[MESHLET_TASK_GROUP_SIZE];
+};
+
+// MATRICES DO NOT FIT THE 128 BYTES OF PUSH CONSTANTS EVERY DEVICE GUARANTEES
+layout (binding = 6, set = 0) readonly buffer Camera {
+  mat4 projection;
+  mat4 view;
+  mat4 model;
+  mat4 normal_matrix; // TRANSPOSED INVERSE OF model
+} camera;
+
+uvec3 UnpackTriangle(uint triangle) {
+  return uvec3(triangle & 0xff, (triangle >> 8) & 0xff, (triangle >> 16) & 0xff);
+}
+
+// camera_position IS IN OBJECT SPACE
+bool IsMeshletVisible(Meshlet meshlet, vec3 camera_position) {
+  vec3 center = (camera.view * camera.model * vec4(meshlet.center, 1.0)).xyz;
+  float scale = max(max(length(camera.model[0].xyz), length(camera.model[1].xyz)), length(camera.model[2].xyz));
+  float radius = meshlet.radius * scale;
+
+  // FRUSTUM
+  vec2 frustum_x = normalize(vec2(camera.projection[0][0], 1.0));
+  vec2 frustum_y = normalize(vec2(abs(camera.projection[1][1]), 1.0));
+  bool visible = center.z - radius < 0.0;
+  visible = visible && abs(center.x) * frustum_x.x + center.z * frustum_x.y < radius;
+  visible = visible && abs(center.y) * frustum_y.x + center.z * frustum_y.y < radius;
+
+  // NORMAL CONE
+  vec3 direction = meshlet.center - camera_position;
+  visible = visible && dot(direction, meshlet.cone_axis) < meshlet.cone_cutoff * length(direction) + meshlet.radius;
+  return visible;
+}
+
+#endif // MESHLET_GLSL
\ No newline at end of file
@@ -0,0 +1,39 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+
+#include "meshlet.glsl"
+
+layout (binding = 0, set = 0) readonly buffer Vertices {
+  Vertex vertices[];
+};
+
+layout (binding = 1, set = 0) readonly buffer Meshlets {
+  Meshlet meshlets[];
+};
+
+layout (binding = 2, set = 0) readonly buffer MeshletVertices {
+  uint meshlet_vertices[];
+};
+
+layout (binding = 3, set = 0) readonly buffer MeshletTriangles {
+  uint meshlet_triangles[];
+};
+
+// OUTPUT
+layout (location = 0) out vec3 out_position;
+layout (location = 1) out vec3 out_normal;
+layout (location = 2) out flat uint out_meshlet;
+
+// EMULATES meshlet.mesh: ONE INSTANCE PER MESHLET, THREE VERTICES PER PACKED TRIANGLE
+void main() {
+  Meshlet meshlet = meshlets[gl_InstanceIndex];
+  uint local_vertex = UnpackTriangle(meshlet_triangles[gl_VertexIndex / 3])[gl_VertexIndex % 3];
+  Vertex vertex = vertices[meshlet_vertices[meshlet.vertices_offset + local_vertex]];
+
+  vec4 position = camera.model * vec4(vertex.px, vertex.py, vertex.pz, 1.0);
+  out_position = position.xyz;
+  out_normal = mat3(camera.normal_matrix) * vec3(vertex.nx, vertex.ny, vertex.nz);
+  out_meshlet = gl_InstanceIndex;
+
+  gl_Position = camera.projection * camera.view * position;
+}
\ No newline at end of file
@@ -17,4 +17,23 @@ mat2 rotate(float a) {
   return mat2(cos(a), sin(a), -sin(a), cos(a));
 }
 
+// PCG HASH, ONE STATE PER PIXEL AND SAMPLE
+uint pcg(inout uint state) {
+  state = state * 747796405u + 2891336453u;
+  uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+  return (word >> 22u) ^ word;
+}
+
+float random(inout uint state) {
+  return float(pcg(state)) / 4294967296.0;
+}
+
+vec3 sample_cosine_hemisphere(vec3 normal, inout uint state) {
+  float r = sqrt(random(state));
+  float phi = 6.28318530718 * random(state);
+  vec3 tangent = normalize(abs(normal.y) < 0.999 ? cross(normal, vec3(0.0, 1.0, 0.0)) : cross(normal, vec3(1.0, 0.0, 0.0)));
+  vec3 bitangent = cross(normal, tangent);
+  return normalize(r * cos(phi) * tangent + r * sin(phi) * bitangent + sqrt(max(0.0, 1.0 - r * r)) * normal);
+}
+
 #endif // COMMON_GLSL
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef WAVEFRONT_GLSL
+#define WAVEFRONT_GLSL
+
+#include "common.glsl"
+
+#define WAVEFRONT_GROUP_SIZE 64
+#define MATERIAL_BINS 256
+
+// INDICES INTO THE COUNTERS, THE TWO RAY QUEUES ALTERNATE BETWEEN BOUNCES
+#define QUEUE_RAYS 0
+#define QUEUE_HITS 2
+#define QUEUE_SHADOWS 3
+#define QUEUE_NONE 0xffffffffu
+
+layout (push_constant) uniform PushConstants {
+  float camera_position_x, camera_position_y, camera_position_z;
+  uint accumulated_samples;
+  uint samples_per_frame;
+  uint max_bounces;
+  uint progressive;
+  uint sample_index; // SAMPLE OF THE FRAME BEING TRACED
+  uint bounce;       // BOUNCE OF THE RAYS BEING EXTENDED
+  uint queue;        // QUEUE THE PREPARE PASS WRITES THE DISPATCH OF
+  uint reset_queue;  // QUEUE THE PREPARE PASS EMPTIES
+  uint width;
+  uint height;
+} pc;
+
+struct QueuedRay {
+  vec3 origin;
+  uint pixel;
+  vec3 direction;
+  uint seed;
+  vec3 throughput;
+  uint bounce;
+};
+
+struct QueuedHit {
+  uint ray; // INDEX INTO THE RAY QUEUE BEING EXTENDED
+  uint record;
+  uint primitive;
+  uint instance;
+  vec2 barycentrics;
+  uint material;
+  uint padding;
+};
+
+// DISPATCH ARGUMENTS FIRST, THE HOST DISPATCHES EVERY STAGE INDIRECTLY FROM THE QUEUE IT CONSUMES
+struct QueueCounter {
+  uint groups_x;
+  uint groups_y;
+  uint groups_z;
+  uint count;
+};
+
+// THE HIT REGION OF THE SHADER BINDING TABLE AS A BUFFER, SHADER BINDING TABLE OFFSET + GEOMETRY INDEX
+struct GeometryRecord {
+  uint first_index;
+  uint mesh_index;
+  int color_texture_index; // BINDLESS SLOT
+  int normal_texture_index;
+  uint vertex_offset;
+  float alpha_cutoff;
+};
+
+// ROW MAJOR 3x4 TRANSFORM, AS IN VkAccelerationStructureInstanceKHR
+struct AccelerationStructureInstance {
+  float transform[12];
+  uint custom_index_and_mask;
+  uint shader_binding_table_offset_and_flags;
+  uvec2 acceleration_structure_reference;
+};
+
+// SAME AS mesh.rmiss
+vec3 sky(vec3 direction) {
+  float t = 0.5 * direction.y + 0.5;
+  return mix(vec3(0.6, 0.1, 0.1), vec3(0.9, 0.8, 0.7), t);
+}
+
+#endif // WAVEFRONT_GLSL
\ No newline at end of file
@@ -0,0 +1,34 @@
+#ifndef WAVEFRONT_ALPHA_GLSL
+#define WAVEFRONT_ALPHA_GLSL
+
+// NEEDS vertices, indices, records AND THE BINDLESS textures DECLARED BY THE STAGE
+
+// ALPHA TEST OF A CANDIDATE, THE QUERY COUNTERPART OF mesh.rahit
+bool is_candidate_opaque(rayQueryEXT rq) {
+  GeometryRecord record = records[rayQueryGetIntersectionInstanceShaderBindingTableRecordOffsetEXT(rq, false) +
+                                  rayQueryGetIntersectionGeometryIndexEXT(rq, false)];
+  if (record.color_texture_index < 0) return true;
+
+  uint triangle_index = record.first_index + rayQueryGetIntersectionPrimitiveIndexEXT(rq, false) * 3;
+  vec2 barycentric = rayQueryGetIntersectionBarycentricsEXT(rq, false);
+
+  Vertex v0 = vertices[record.vertex_offset + indices[triangle_index + 0]];
+  Vertex v1 = vertices[record.vertex_offset + indices[triangle_index + 1]];
+  Vertex v2 = vertices[record.vertex_offset + indices[triangle_index + 2]];
+
+  vec2 uv = (1.0 - barycentric.x - barycentric.y) * vec2(v0.uvx, v0.uvy) + barycentric.x * vec2(v1.uvx, v1.uvy) +
+            barycentric.y * vec2(v2.uvx, v2.uvy);
+
+  return textureLod(textures[nonuniformEXT(record.color_texture_index)], uv, 0.0).a >= record.alpha_cutoff;
+}
+
+// NON OPAQUE CANDIDATES ONLY COME FROM ALPHA TESTED GEOMETRY, A MICROMAP ALREADY RESOLVED THE REST
+void resolve_candidates(rayQueryEXT rq) {
+  while (rayQueryProceedEXT(rq)) {
+    if (rayQueryGetIntersectionTypeEXT(rq, false) == gl_RayQueryCandidateIntersectionTriangleEXT && is_candidate_opaque(rq)) {
+      rayQueryConfirmIntersectionEXT(rq);
+    }
+  }
+}
+
+#endif // WAVEFRONT_ALPHA_GLSL
\ No newline at end of file
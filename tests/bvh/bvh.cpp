@@ -0,0 +1,124 @@
+#include "innsmouth/asset/include/bounding_volume_hierarchy.h"
+#include <array>
+#include <print>
+#include <random>
+
+using namespace Innsmouth;
+
+// EVERY RAY IS CHECKED AGAINST A BRUTE FORCE MOLLER-TRUMBORE OVER THE WHOLE SOUP
+
+struct SoupCase {
+  const char *name_;
+  uint32_t triangles_count_;
+  float triangle_size_;
+  BoundingVolumeHierarchySpecification specification_;
+};
+
+RayHit IntersectBruteForce(std::span<const Vector3f> positions, const Ray &ray) {
+  RayHit hit;
+  hit.t_ = ray.t_max_;
+  for (auto i = 0u; i < positions.size() / 3; i++) {
+    auto edge1 = positions[3 * i + 1] - positions[3 * i];
+    auto edge2 = positions[3 * i + 2] - positions[3 * i];
+    auto p = glm::cross(ray.direction_, edge2);
+    auto determinant = glm::dot(edge1, p);
+    if (determinant == 0.0f) continue;
+    auto s = ray.origin_ - positions[3 * i];
+    auto q = glm::cross(s, edge1);
+    auto u = glm::dot(s, p) / determinant;
+    auto v = glm::dot(ray.direction_, q) / determinant;
+    auto t = glm::dot(edge2, q) / determinant;
+    if (u < 0.0f || v < 0.0f || u + v > 1.0f || t <= ray.t_min_ || t >= hit.t_) continue;
+    hit = RayHit(t, u, v, i);
+  }
+  return hit;
+}
+
+std::vector<Vector3f> MakeSoup(std::mt19937 &generator, uint32_t triangles_count, float triangle_size) {
+  std::uniform_real_distribution<float> center(-10.0f, 10.0f);
+  std::uniform_real_distribution<float> offset(-triangle_size, triangle_size);
+  std::vector<Vector3f> positions;
+  for (auto i = 0; i < triangles_count; i++) {
+    auto triangle_center = Vector3f(center(generator), center(generator), center(generator));
+    for (auto corner = 0; corner < 3; corner++) {
+      positions.emplace_back(triangle_center + Vector3f(offset(generator), offset(generator), offset(generator)));
+    }
+  }
+  return positions;
+}
+
+Ray MakeRay(std::mt19937 &generator, std::span<const Vector3f> positions, uint32_t ray_index) {
+  std::uniform_real_distribution<float> coordinate(-15.0f, 15.0f);
+  std::uniform_int_distribution<std::size_t> triangle(0, positions.size() / 3 - 1);
+  Ray ray;
+  ray.origin_ = Vector3f(coordinate(generator), coordinate(generator), coordinate(generator));
+  ray.direction_ = glm::normalize(Vector3f(coordinate(generator), coordinate(generator), coordinate(generator)));
+  // HALF OF THE RAYS AIM AT A TRIANGLE SO SPARSE SOUPS STILL GET HITS
+  if (ray_index % 2 == 0) {
+    auto first = 3 * triangle(generator);
+    auto centroid = (positions[first] + positions[first + 1] + positions[first + 2]) / 3.0f;
+    ray.direction_ = glm::normalize(centroid - ray.origin_);
+  }
+  // AXIS ALIGNED DIRECTIONS HAVE ZERO COMPONENTS, CLIPPED INTERVALS EXERCISE t_min AND t_max
+  if (ray_index % 7 == 0) ray.direction_ = Vector3f(0.0f, 0.0f, ray_index % 3 ? 1.0f : -1.0f);
+  if (ray_index % 5 == 0) ray.t_max_ = 8.0f;
+  if (ray_index % 3 == 0) ray.t_min_ = 2.0f;
+  return ray;
+}
+
+bool TestRays(std::mt19937 &generator, const char *name, std::span<const Vector3f> positions, const BoundingVolumeHierarchy &bvh) {
+  uint32_t hits = 0, mismatches = 0, occlusion_mismatches = 0;
+  for (auto ray_index = 0u; ray_index < 2000; ray_index++) {
+    auto ray = MakeRay(generator, positions, ray_index);
+    auto hit = bvh.Intersect(ray);
+    auto expected = IntersectBruteForce(positions, ray);
+    hits += hit.IsHit();
+    auto same_t = std::abs(hit.t_ - expected.t_) <= 1.0e-4f * std::max(1.0f, expected.t_);
+    if (hit.IsHit() != expected.IsHit() || (hit.IsHit() && same_t == false)) mismatches++;
+    if (bvh.IsOccluded(ray) != expected.IsHit()) occlusion_mismatches++;
+  }
+
+  std::println("{}: {} triangles, {} nodes, {} hits, {} mismatches, {} occlusion mismatches", name, bvh.GetTrianglesCount(),
+               bvh.GetNodes().size(), hits, mismatches, occlusion_mismatches);
+  return mismatches == 0 && occlusion_mismatches == 0;
+}
+
+bool TestSoup(std::mt19937 &generator, const SoupCase &soup_case) {
+  auto positions = MakeSoup(generator, soup_case.triangles_count_, soup_case.triangle_size_);
+  BoundingVolumeHierarchy bvh(positions, soup_case.specification_);
+  return TestRays(generator, soup_case.name_, positions, bvh);
+}
+
+// A REFIT HIERARCHY KEEPS THE OLD TOPOLOGY BUT MUST STILL FIND EVERY HIT OF THE MOVED TRIANGLES
+bool TestRefit(std::mt19937 &generator) {
+  auto positions = MakeSoup(generator, 3000, 0.5f);
+  BoundingVolumeHierarchy bvh(positions);
+  std::uniform_real_distribution<float> offset(-2.0f, 2.0f);
+  for (auto &position : positions) {
+    position = Vector3f(1.5f * position.x, position.y + 0.1f * position.x * position.x, position.z) + Vector3f(offset(generator));
+  }
+  bvh.Refit(positions);
+  return TestRays(generator, "refit", positions, bvh);
+}
+
+int main() {
+  BoundingVolumeHierarchySpecification parallel;
+  parallel.parallel_threshold_ = 1024;
+  BoundingVolumeHierarchySpecification few_bins;
+  few_bins.bins_count_ = 2;
+  few_bins.max_leaf_size_ = 1;
+
+  std::array soup_cases = {
+    SoupCase("single", 1, 5.0f, {}),         SoupCase("partial block", 3, 2.0f, {}), SoupCase("small", 37, 1.0f, {}),
+    SoupCase("medium", 2000, 0.5f, {}),      SoupCase("parallel", 20000, 0.2f, parallel), SoupCase("few bins", 500, 0.5f, few_bins),
+    SoupCase("overlapping", 300, 8.0f, {}),
+  };
+
+  std::mt19937 generator(7);
+  auto passed = true;
+  for (const auto &soup_case : soup_cases) {
+    passed = TestSoup(generator, soup_case) && passed;
+  }
+  passed = TestRefit(generator) && passed;
+  return passed ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "innsmouth/core/include/image_ingest.h"
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <print>
+#include <random>
+
+using namespace Innsmouth;
+
+// THE KERNELS TAKE SIMD PATHS ON WHOLE BLOCKS AND SCALAR PATHS ON THE TAIL, EVERY COUNT UP TO A FEW BLOCKS CHECKS BOTH
+
+std::vector<uint8_t> ExpandReference(std::span<const uint8_t> source, uint32_t channels) {
+  std::vector<uint8_t> output;
+  for (auto i = 0; i < source.size() / channels; i++) {
+    auto texel = source.data() + channels * i;
+    auto gray = channels < 3;
+    output.insert(output.end(), {texel[0], gray ? texel[0] : texel[1], gray ? texel[0] : texel[2],
+                                 channels == 2 || channels == 4 ? texel[channels - 1] : uint8_t(0xff)});
+  }
+  return output;
+}
+
+bool TestExpandToRGBA8(std::mt19937 &generator) {
+  std::uniform_int_distribution<uint32_t> byte(0, 255);
+  for (auto channels = 1u; channels <= 4; channels++) {
+    for (auto pixels = 0u; pixels < 67; pixels++) {
+      std::vector<uint8_t> source(pixels * channels);
+      for (auto &value : source) {
+        value = byte(generator);
+      }
+      std::vector<std::byte> output(4 * pixels);
+      ExpandToRGBA8(source, channels, output);
+      auto reference = ExpandReference(source, channels);
+      if (std::memcmp(output.data(), reference.data(), reference.size()) != 0) {
+        std::println("ExpandToRGBA8 mismatch: {} channels, {} pixels", channels, pixels);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool TestConvertToRGBA16F(std::mt19937 &generator) {
+  // ROUNDING TIES, THE OVERFLOW EDGE, HALF SUBNORMALS AND NON FINITE VALUES
+  std::vector<float> values = {0.0f, -0.0f, 1.0f, -1.0f, 1.000488f, 2049.0f, 2051.0f, 65504.0f, 65519.0f, 65520.0f, 1.0e+10f,
+                               6.1e-5f, -1e-5f, 5.9e-8f, 3.0e-8f, 1.0e-10f, std::numeric_limits<float>::denorm_min(),
+                               std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+                               std::numeric_limits<float>::quiet_NaN()};
+  std::uniform_int_distribution<uint32_t> bits;
+  for (auto i = 0; i < 4096; i++) {
+    values.emplace_back(std::bit_cast<float>(bits(generator)));
+  }
+
+  for (auto channels = 1u; channels <= 4; channels++) {
+    auto pixels = values.size() / channels;
+    auto source = std::span<const float>(values).first(pixels * channels);
+    std::vector<std::byte> output(8 * pixels);
+    ConvertToRGBA16F(source, channels, output);
+    for (auto i = 0; i < pixels; i++) {
+      auto texel = source.data() + channels * i;
+      auto gray = channels < 3;
+      std::array<float, 4> rgba = {texel[0], gray ? texel[0] : texel[1], gray ? texel[0] : texel[2],
+                                   (channels == 2 || channels == 4) ? texel[channels - 1] : 1.0f};
+      std::array<uint16_t, 4> halves;
+      std::memcpy(halves.data(), output.data() + 8 * i, sizeof(halves));
+      for (auto c = 0; c < 4; c++) {
+        if (halves[c] != FloatToHalf(rgba[c])) {
+          std::println("ConvertToRGBA16F mismatch: {} -> {:#06x}, expected {:#06x}", rgba[c], halves[c], FloatToHalf(rgba[c]));
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool TestLinearizeToRGBA16F(std::mt19937 &generator) {
+  std::uniform_int_distribution<uint32_t> byte(0, 255);
+  auto srgb = [](uint8_t value) {
+    auto unorm = float(value) / 255.0f;
+    return FloatToHalf(unorm <= 0.04045f ? unorm / 12.92f : std::pow((unorm + 0.055f) / 1.055f, 2.4f));
+  };
+  for (auto channels = 1u; channels <= 4; channels++) {
+    for (auto pixels = 0u; pixels < 67; pixels++) {
+      std::vector<uint8_t> source(pixels * channels);
+      for (auto &value : source) {
+        value = byte(generator);
+      }
+      std::vector<std::byte> output(8 * pixels);
+      LinearizeToRGBA16F(source, channels, output);
+      for (auto i = 0; i < pixels; i++) {
+        auto texel = source.data() + channels * i;
+        auto gray = channels < 3;
+        // ALPHA IS LINEAR ALREADY
+        std::array<uint16_t, 4> expected = {srgb(texel[0]), srgb(gray ? texel[0] : texel[1]), srgb(gray ? texel[0] : texel[2]),
+                                            (channels == 2 || channels == 4) ? FloatToHalf(texel[channels - 1] / 255.0f) : uint16_t(0x3c00)};
+        if (std::memcmp(output.data() + 8 * i, expected.data(), sizeof(expected)) != 0) {
+          std::println("LinearizeToRGBA16F mismatch: {} channels, {} pixels, texel {}", channels, pixels, i);
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool TestPackNormalRG8(std::mt19937 &generator) {
+  std::uniform_int_distribution<uint32_t> byte(0, 255);
+  for (auto channels = 2u; channels <= 4; channels++) {
+    for (auto pixels = 0u; pixels < 67; pixels++) {
+      std::vector<uint8_t> source(pixels * channels);
+      for (auto &value : source) {
+        value = byte(generator);
+      }
+      std::vector<std::byte> output(2 * pixels);
+      PackNormalRG8(source, channels, output);
+      std::vector<uint8_t> reference;
+      for (auto i = 0; i < pixels; i++) {
+        reference.insert(reference.end(), {source[channels * i + 0], source[channels * i + 1]});
+      }
+      if (std::memcmp(output.data(), reference.data(), reference.size()) != 0) {
+        std::println("PackNormalRG8 mismatch: {} channels, {} pixels", channels, pixels);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+int main() {
+  std::mt19937 generator(7);
+  auto passed = TestExpandToRGBA8(generator);
+  passed = TestConvertToRGBA16F(generator) && passed;
+  passed = TestLinearizeToRGBA16F(generator) && passed;
+  passed = TestPackNormalRG8(generator) && passed;
+  return passed ? 0 : 1;
+}
\ No newline at end of file